@@ -6,6 +6,7 @@ const logger = require('./logger')('Channel');
 const workerLogger = require('./logger')('mediasoup-worker');
 const utils = require('./utils');
 const errors = require('./errors');
+const msgpack = require('./msgpack');
 
 // netstring length for a 65536 bytes payload.
 const NS_MAX_SIZE = 65543;
@@ -14,16 +15,21 @@ const REQUEST_TIMEOUT = 5000;
 
 class Channel extends EventEmitter
 {
-	constructor(socket)
+	constructor(socket, options)
 	{
-		logger.debug('constructor()');
+		logger.debug('constructor() [options:%o]', options);
 
 		super();
 		this.setMaxListeners(Infinity);
 
+		options = options || {};
+
 		// Unix Socket instance.
 		this._socket = socket;
 
+		// Whether requests are sent in binary (MessagePack) format.
+		this._binary = options.format === 'binary';
+
 		this._pendingSent = new Map();
 
 		// Buffer for incomplete data received from the Channel's socket.
@@ -32,6 +38,9 @@ class Channel extends EventEmitter
 		// Last binary notification received.
 		this._lastBinaryNotification = null;
 
+		// Chunks of the message being received in chunks.
+		this._chunks = [];
+
 		// Read Channel responses/notifications from the worker.
 		this._socket.on('data', (buffer) =>
 		{
@@ -42,18 +51,6 @@ class Channel extends EventEmitter
 			else
 			{
 				this._recvBuffer = Buffer.concat([ this._recvBuffer, buffer ], this._recvBuffer.length + buffer.length);
-
-				if (this._recvBuffer.length > NS_MAX_SIZE)
-				{
-					logger.error('recvBuffer is full, discarding all the data in it');
-
-					// Reset the recvBuffer and exit.
-					this._recvBuffer = null;
-					// Just in case.
-					this._lastBinaryNotification = null;
-
-					return;
-				}
 			}
 
 			while (true) // eslint-disable-line no-constant-condition
@@ -72,6 +69,7 @@ class Channel extends EventEmitter
 					this._recvBuffer = null;
 					// Just in case.
 					this._lastBinaryNotification = null;
+					this._chunks = [];
 
 					return;
 				}
@@ -79,6 +77,19 @@ class Channel extends EventEmitter
 				// Incomplete netstring.
 				if (nsPayload === -1)
 				{
+					// The worker batches messages so the buffer may contain many of them,
+					// but a single incomplete message can not be bigger than this.
+					if (this._recvBuffer.length > NS_MAX_SIZE)
+					{
+						logger.error('recvBuffer is full, discarding all the data in it');
+
+						// Reset the recvBuffer.
+						this._recvBuffer = null;
+						// Just in case.
+						this._lastBinaryNotification = null;
+						this._chunks = [];
+					}
+
 					return;
 				}
 
@@ -87,7 +98,8 @@ class Channel extends EventEmitter
 				{
 					try
 					{
-						// We can receive JSON messages (Channel messages) or log strings.
+						// We can receive JSON or binary messages (Channel messages) or log
+						// strings.
 						switch (nsPayload[0])
 						{
 							// 123 = '{' (a Channel JSON messsage).
@@ -110,8 +122,35 @@ class Channel extends EventEmitter
 								workerLogger.error(nsPayload.toString(null, 1));
 								break;
 
+							// 67 = 'C' (a chunk of a big Channel message, the second byte
+							// is 1 if more chunks follow).
+							case 67:
+							{
+								this._chunks.push(nsPayload.slice(2));
+
+								if (nsPayload[1] === 1)
+									break;
+
+								let payload = Buffer.concat(this._chunks);
+
+								this._chunks = [];
+
+								if (payload[0] === 123)
+									this._processMessage(JSON.parse(payload));
+								else
+									this._processMessage(msgpack.decode(payload));
+
+								break;
+							}
+
 							default:
-								workerLogger.error('unexpected data: %s', nsPayload.toString());
+							{
+								// A Channel binary (MessagePack) message.
+								if (msgpack.isMsgPack(nsPayload))
+									this._processMessage(msgpack.decode(nsPayload));
+								else
+									workerLogger.error('unexpected data: %s', nsPayload.toString());
+							}
 						}
 					}
 					catch (error)
@@ -190,7 +229,8 @@ class Channel extends EventEmitter
 		logger.debug('request() [method:%s, id:%s]', method, id);
 
 		let request = { id, method, internal, data };
-		let ns = netstring.nsWrite(JSON.stringify(request));
+		let ns = netstring.nsWrite(
+			this._binary ? msgpack.encode(request) : JSON.stringify(request));
 
 		if (Buffer.byteLength(ns) > NS_MAX_SIZE)
 			return Promise.reject(new Error('request too big'));
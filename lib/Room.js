@@ -30,11 +30,15 @@ class Room extends EventEmitter
 		// Map of Peer instances indexed by `peerName`.
 		this._peers = new Map();
 
+		// Map of 'close' listeners indexed by the RtpReceiver instances (of other
+		// Rooms) linked to this Room.
+		this._linkedRtpReceivers = new Map();
+
 		// Closed flag.
 		this._closed = false;
 
 		// Subscribe to notifications.
-		this._channel.on(this._internal.roomId, (event) =>
+		this._channel.on(this._internal.roomId, (event, data) =>
 		{
 			switch (event)
 			{
@@ -44,6 +48,20 @@ class Room extends EventEmitter
 					break;
 				}
 
+				case 'dominantspeakerchange':
+				{
+					let peer = this._peers.get(data.peerName);
+
+					if (!peer)
+						return;
+
+					let rtpReceiver = peer.rtpReceivers
+						.find((rtpReceiver) => rtpReceiver._internal.rtpReceiverId === data.rtpReceiverId);
+
+					this.emit('dominantspeakerchange', peer, rtpReceiver);
+					break;
+				}
+
 				default:
 					logger.error('ignoring unknown event "%s"', event);
 			}
@@ -92,6 +110,12 @@ class Room extends EventEmitter
 			peer.close(undefined, true);
 		}
 
+		// Unlink every linked RtpReceiver.
+		for (let rtpReceiver of Array.from(this._linkedRtpReceivers.keys()))
+		{
+			this._unlinkRtpReceiver(rtpReceiver);
+		}
+
 		if (!dontSendChannel)
 		{
 			// Send Channel request.
@@ -112,16 +136,32 @@ class Room extends EventEmitter
 	/**
 	 * Dump the Room.
 	 *
+	 * @param {Object} [options]
+	 * @param {Array<String>} [options.fields] - Entries of the Room to include.
+	 * @param {Array<String>} [options.peerFields] - Entries of each Peer to include.
+	 * @param {Number} [options.limit] - Max number of Peers to include.
+	 * @param {Number} [options.cursor] - `nextCursor` of the previous page.
+	 *
 	 * @return {Promise}
 	 */
-	dump()
+	dump(options)
 	{
-		logger.debug('dump()');
+		logger.debug('dump() [options:%o]', options);
 
 		if (this._closed)
 			return Promise.reject(new errors.InvalidStateError('Room closed'));
 
-		return this._channel.request('room.dump', this._internal)
+		options = options || {};
+
+		let data =
+		{
+			fields     : options.fields,
+			peerFields : options.peerFields,
+			limit      : options.limit,
+			cursor     : options.cursor
+		};
+
+		return this._channel.request('room.dump', this._internal, data)
 			.then((data) =>
 			{
 				logger.debug('"room.dump" request succeeded');
@@ -181,7 +221,20 @@ class Room extends EventEmitter
 		};
 		let sandbox =
 		{
-			getPeer : this.getPeer.bind(this)
+			getPeer : (peerName) =>
+			{
+				let peer = this.getPeer(peerName);
+
+				if (peer)
+					return peer;
+
+				// The RtpSender may belong to a linked RtpReceiver.
+				for (let rtpReceiver of this._linkedRtpReceivers.keys())
+				{
+					if (rtpReceiver.associatedPeer.name === peerName)
+						return rtpReceiver.associatedPeer;
+				}
+			}
 		};
 
 		// Create a Peer instance.
@@ -223,6 +276,71 @@ class Room extends EventEmitter
 		return this._peers.get(peerName);
 	}
 
+	/**
+	 * Forward the media of a RtpReceiver of another Room of the same Server to
+	 * the Peers of this Room. The link is removed when the RtpReceiver or any of
+	 * both Rooms is closed.
+	 *
+	 * @param {RtpReceiver} rtpReceiver
+	 *
+	 * @return {Promise}
+	 */
+	linkRtpReceiver(rtpReceiver)
+	{
+		logger.debug('linkRtpReceiver()');
+
+		if (this._closed)
+			return Promise.reject(new errors.InvalidStateError('Room closed'));
+
+		if (rtpReceiver.closed)
+			return Promise.reject(new errors.InvalidStateError('RtpReceiver closed'));
+
+		if (rtpReceiver._internal.roomId === this._internal.roomId)
+			return Promise.reject(new Error('RtpReceiver belongs to this Room'));
+
+		if (this._linkedRtpReceivers.has(rtpReceiver))
+			return Promise.reject(new Error('RtpReceiver already linked'));
+
+		let internal =
+		{
+			roomId        : this._internal.roomId,
+			sourceRoomId  : rtpReceiver._internal.roomId,
+			rtpReceiverId : rtpReceiver._internal.rtpReceiverId
+		};
+
+		// Must be set before the request since new RtpSenders are notified before
+		// the response.
+		let onClose = () => this._unlinkRtpReceiver(rtpReceiver);
+
+		this._linkedRtpReceivers.set(rtpReceiver, onClose);
+		rtpReceiver.on('close', onClose);
+
+		return this._channel.request('room.linkRtpReceiver', internal)
+			.then(() =>
+			{
+				logger.debug('"room.linkRtpReceiver" request succeeded');
+			})
+			.catch((error) =>
+			{
+				logger.error('"room.linkRtpReceiver" request failed: %s', error);
+
+				this._unlinkRtpReceiver(rtpReceiver);
+
+				throw error;
+			});
+	}
+
+	_unlinkRtpReceiver(rtpReceiver)
+	{
+		let onClose = this._linkedRtpReceivers.get(rtpReceiver);
+
+		if (!onClose)
+			return;
+
+		rtpReceiver.removeListener('close', onClose);
+		this._linkedRtpReceivers.delete(rtpReceiver);
+	}
+
 	_setCapabilities(capabilities)
 	{
 		for (let kind of KINDS)
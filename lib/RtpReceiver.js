@@ -283,6 +283,77 @@ class RtpReceiver extends EventEmitter
 				throw error;
 			});
 	}
+
+	/**
+	 * Enable or disable the shared memory ring for raw RTP packets.
+	 *
+	 * @param {Boolean} enabled
+	 * @param {Number} [size] - Ring data size in bytes.
+	 *
+	 * @return {Promise} Resolves to the ring info (name, size, headerSize) or
+	 * undefined if disabled.
+	 */
+	setRtpRawRing(enabled, size)
+	{
+		logger.debug('setRtpRawRing() [enabled:%s, size:%s]', enabled, size);
+
+		if (this._closed)
+			return Promise.reject(new errors.InvalidStateError('RtpReceiver closed'));
+
+		let data = { enabled: !!enabled };
+
+		if (size)
+			data.size = size;
+
+		return this._channel.request('rtpReceiver.setRtpRawRing', this._internal, data)
+			.then((data) =>
+			{
+				logger.debug('"rtpReceiver.setRtpRawRing" request succeeded');
+
+				return data;
+			})
+			.catch((error) =>
+			{
+				logger.error('"rtpReceiver.setRtpRawRing" request failed: %s', error);
+
+				throw error;
+			});
+	}
+
+	/**
+	 * Enable or disable recording into a file.
+	 *
+	 * @param {Boolean} enabled
+	 * @param {Object} [options]
+	 * @param {String} options.path - File path (overwritten if it exists).
+	 * @param {String} [options.format] - "ivf", "ogg", "h264" or "rtpdump"
+	 * (by default the one of the codec, or "rtpdump" for other codecs).
+	 *
+	 * @return {Promise} Resolves to the recording info or undefined if disabled.
+	 */
+	setRecording(enabled, options)
+	{
+		logger.debug('setRecording() [enabled:%s, options:%o]', enabled, options);
+
+		if (this._closed)
+			return Promise.reject(new errors.InvalidStateError('RtpReceiver closed'));
+
+		let data = Object.assign({}, options, { enabled: !!enabled });
+
+		return this._channel.request('rtpReceiver.setRecording', this._internal, data)
+			.then((data) =>
+			{
+				logger.debug('"rtpReceiver.setRecording" request succeeded');
+
+				return data;
+			})
+			.catch((error) =>
+			{
+				logger.error('"rtpReceiver.setRecording" request failed: %s', error);
+
+				throw error;
+			});
+	}
 }
 
 module.exports = RtpReceiver;
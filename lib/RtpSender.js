@@ -248,6 +248,76 @@ class RtpSender extends EventEmitter
 				throw error;
 			});
 	}
+
+	/**
+	 * Select the simulcast encoding to forward.
+	 *
+	 * @param {Number} index - Index of the encoding in the RtpReceiver parameters.
+	 *
+	 * @return {Promise} Resolves to this.
+	 */
+	setTargetEncoding(index)
+	{
+		logger.debug('setTargetEncoding() [index:%s]', index);
+
+		if (this._closed)
+			return Promise.reject(new errors.InvalidStateError('RtpSender closed'));
+
+		// Send Channel request.
+		return this._channel.request('rtpSender.setTargetEncoding', this._internal, { index: index })
+			.then(() =>
+			{
+				logger.debug('"rtpSender.setTargetEncoding" request succeeded');
+
+				return this;
+			})
+			.catch((error) =>
+			{
+				logger.error('"rtpSender.setTargetEncoding" request failed: %s', error);
+
+				throw error;
+			});
+	}
+
+	/**
+	 * Select the maximum VP8/VP9 spatial and temporal layers to forward.
+	 *
+	 * @param {Object} layers
+	 * @param {Number} [layers.spatialLayer] - Unchanged if not given.
+	 * @param {Number} [layers.temporalLayer] - Unchanged if not given.
+	 *
+	 * @return {Promise} Resolves to this.
+	 */
+	setTargetLayers(layers)
+	{
+		logger.debug('setTargetLayers() [layers:%o]', layers);
+
+		if (this._closed)
+			return Promise.reject(new errors.InvalidStateError('RtpSender closed'));
+
+		layers = layers || {};
+
+		let data =
+		{
+			spatialLayer  : layers.spatialLayer,
+			temporalLayer : layers.temporalLayer
+		};
+
+		// Send Channel request.
+		return this._channel.request('rtpSender.setTargetLayers', this._internal, data)
+			.then(() =>
+			{
+				logger.debug('"rtpSender.setTargetLayers" request succeeded');
+
+				return this;
+			})
+			.catch((error) =>
+			{
+				logger.error('"rtpSender.setTargetLayers" request failed: %s', error);
+
+				throw error;
+			});
+	}
 }
 
 module.exports = RtpSender;
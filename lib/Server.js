@@ -21,7 +21,8 @@ const VALID_WORKER_PARAMETERS =
 	'rtcMinPort',
 	'rtcMaxPort',
 	'dtlsCertificateFile',
-	'dtlsPrivateKeyFile'
+	'dtlsPrivateKeyFile',
+	'channelFormat'
 ];
 
 class Server extends EventEmitter
@@ -203,6 +204,40 @@ class Server extends EventEmitter
 			});
 	}
 
+	/**
+	 * Get the stats of the Server (counters and histograms of every worker).
+	 *
+	 * @param {Object} [options]
+	 * @param {String} [options.format] - 'prometheus' (default) or 'json'.
+	 *
+	 * @return {Promise}
+	 */
+	getStats(options)
+	{
+		logger.debug('getStats() [options:%o]', options);
+
+		if (this._closed)
+			return Promise.reject(new errors.InvalidStateError('Server closed'));
+
+		let promises = [];
+
+		for (let worker of this._workers)
+		{
+			promises.push(worker.getStats(options));
+		}
+
+		return Promise.all(promises)
+			.then((datas) =>
+			{
+				let json =
+				{
+					workers : datas
+				};
+
+				return json;
+			});
+	}
+
 	/**
 	 * Update Server settings.
 	 *
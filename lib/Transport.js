@@ -249,6 +249,87 @@ class Transport extends EventEmitter
 				throw error;
 			});
 	}
+
+	/**
+	 * Enable or disable pacing of the RTP packets sent by this transport.
+	 *
+	 * @param {Object} options
+	 * @param {Boolean} options.enabled
+	 * @param {Number} [options.bitrate] - Pacing bitrate (bps). If not given it
+	 *   is derived from the bandwidth estimation of the remote peer.
+	 *
+	 * @return {Promise} Resolves to this.
+	 */
+	setPacer(options)
+	{
+		logger.debug('setPacer() [options:%o]', options);
+
+		if (this._closed)
+			return Promise.reject(new errors.InvalidStateError('Transport closed'));
+
+		options = options || {};
+
+		let data =
+		{
+			enabled : Boolean(options.enabled),
+			bitrate : options.bitrate
+		};
+
+		// Send Channel request.
+		return this._channel.request('transport.setPacer', this._internal, data)
+			.then(() =>
+			{
+				logger.debug('"transport.setPacer" request succeeded');
+
+				return this;
+			})
+			.catch((error) =>
+			{
+				logger.error('"transport.setPacer" request failed: %s', error);
+
+				throw error;
+			});
+	}
+
+	/**
+	 * Dump the latest RTP and RTCP packet headers into a file.
+	 *
+	 * @param {Object} options
+	 * @param {String} options.path - Path of the file.
+	 * @param {String} [options.format] - 'pcap' (default) or 'json'.
+	 *
+	 * @return {Promise} Resolves to the number of dumped packets.
+	 */
+	dumpPacketTrace(options)
+	{
+		logger.debug('dumpPacketTrace() [options:%o]', options);
+
+		if (this._closed)
+			return Promise.reject(new errors.InvalidStateError('Transport closed'));
+
+		options = options || {};
+
+		let data =
+		{
+			path   : options.path,
+			format : options.format
+		};
+
+		// Send Channel request.
+		return this._channel.request('transport.dumpPacketTrace', this._internal, data)
+			.then((data) =>
+			{
+				logger.debug('"transport.dumpPacketTrace" request succeeded');
+
+				return data.numRecords;
+			})
+			.catch((error) =>
+			{
+				logger.error('"transport.dumpPacketTrace" request failed: %s', error);
+
+				throw error;
+			});
+	}
 }
 
 module.exports = Transport;
@@ -58,8 +58,17 @@ class Worker extends EventEmitter
 		// Create the mediasoup-worker child process.
 		this._child = spawn(workerPath, spawnArgs, spawnOptions);
 
+		// Channel format given to the worker (if any).
+		let channelFormat = 'json';
+
+		for (let parameter of parameters)
+		{
+			if (parameter.startsWith('--channelFormat='))
+				channelFormat = parameter.slice('--channelFormat='.length);
+		}
+
 		// Channel instance.
-		this._channel = new Channel(this._child.stdio[CHANNEL_FD]);
+		this._channel = new Channel(this._child.stdio[CHANNEL_FD], { format: channelFormat });
 
 		// Set of Room instances.
 		this._rooms = new Set();
@@ -154,6 +163,32 @@ class Worker extends EventEmitter
 			});
 	}
 
+	getStats(options)
+	{
+		logger.debug('getStats() [options:%o]', options);
+
+		options = options || {};
+
+		let data =
+		{
+			format : options.format
+		};
+
+		return this._channel.request('worker.getStats', null, data)
+			.then((data) =>
+			{
+				logger.debug('"worker.getStats" request succeeded');
+
+				return data;
+			})
+			.catch((error) =>
+			{
+				logger.error('"worker.getStats" request failed: %s', error);
+
+				throw error;
+			});
+	}
+
 	updateSettings(options)
 	{
 		logger.debug('updateSettings() [options:%o]', options);
@@ -0,0 +1,373 @@
+'use strict';
+
+/**
+ * Minimal MessagePack codec used by the Channel in binary format. It mirrors
+ * the subset implemented by the worker (Channel::MsgPack).
+ */
+
+function encodeString(str, chunks)
+{
+	let data = Buffer.from(str, 'utf8');
+	let len = data.length;
+	let header;
+
+	if (len <= 31)
+	{
+		header = Buffer.from([ 0xa0 | len ]);
+	}
+	else if (len <= 0xff)
+	{
+		header = Buffer.from([ 0xd9, len ]);
+	}
+	else if (len <= 0xffff)
+	{
+		header = Buffer.alloc(3);
+		header[0] = 0xda;
+		header.writeUInt16BE(len, 1);
+	}
+	else
+	{
+		header = Buffer.alloc(5);
+		header[0] = 0xdb;
+		header.writeUInt32BE(len, 1);
+	}
+
+	chunks.push(header, data);
+}
+
+function encodeLength(len, fix, type16, type32, chunks)
+{
+	let header;
+
+	if (len <= 15)
+	{
+		header = Buffer.from([ fix | len ]);
+	}
+	else if (len <= 0xffff)
+	{
+		header = Buffer.alloc(3);
+		header[0] = type16;
+		header.writeUInt16BE(len, 1);
+	}
+	else
+	{
+		header = Buffer.alloc(5);
+		header[0] = type32;
+		header.writeUInt32BE(len, 1);
+	}
+
+	chunks.push(header);
+}
+
+function encodeNumber(value, chunks)
+{
+	let buffer;
+
+	if (Number.isInteger(value) && value >= 0 && value <= 0xffffffff)
+	{
+		if (value <= 0x7f)
+		{
+			buffer = Buffer.from([ value ]);
+		}
+		else if (value <= 0xff)
+		{
+			buffer = Buffer.from([ 0xcc, value ]);
+		}
+		else if (value <= 0xffff)
+		{
+			buffer = Buffer.alloc(3);
+			buffer[0] = 0xcd;
+			buffer.writeUInt16BE(value, 1);
+		}
+		else
+		{
+			buffer = Buffer.alloc(5);
+			buffer[0] = 0xce;
+			buffer.writeUInt32BE(value, 1);
+		}
+	}
+	else if (Number.isInteger(value) && value < 0 && value >= -0x80000000)
+	{
+		if (value >= -32)
+		{
+			buffer = Buffer.from([ value & 0xff ]);
+		}
+		else if (value >= -0x80)
+		{
+			buffer = Buffer.alloc(2);
+			buffer[0] = 0xd0;
+			buffer.writeInt8(value, 1);
+		}
+		else if (value >= -0x8000)
+		{
+			buffer = Buffer.alloc(3);
+			buffer[0] = 0xd1;
+			buffer.writeInt16BE(value, 1);
+		}
+		else
+		{
+			buffer = Buffer.alloc(5);
+			buffer[0] = 0xd2;
+			buffer.writeInt32BE(value, 1);
+		}
+	}
+	// Everything else (including big integers) as float 64.
+	else
+	{
+		buffer = Buffer.alloc(9);
+		buffer[0] = 0xcb;
+		buffer.writeDoubleBE(value, 1);
+	}
+
+	chunks.push(buffer);
+}
+
+function encodeValue(value, chunks)
+{
+	if (value === null || value === undefined)
+	{
+		chunks.push(Buffer.from([ 0xc0 ]));
+	}
+	else if (typeof value === 'boolean')
+	{
+		chunks.push(Buffer.from([ value ? 0xc3 : 0xc2 ]));
+	}
+	else if (typeof value === 'number')
+	{
+		encodeNumber(value, chunks);
+	}
+	else if (typeof value === 'string')
+	{
+		encodeString(value, chunks);
+	}
+	else if (Array.isArray(value))
+	{
+		encodeLength(value.length, 0x90, 0xdc, 0xdd, chunks);
+
+		for (let item of value)
+		{
+			encodeValue(item, chunks);
+		}
+	}
+	else if (typeof value === 'object')
+	{
+		// Like JSON.stringify(), ignore undefined members.
+		let keys = Object.keys(value).filter((key) => value[key] !== undefined);
+
+		encodeLength(keys.length, 0x80, 0xde, 0xdf, chunks);
+
+		for (let key of keys)
+		{
+			encodeString(key, chunks);
+			encodeValue(value[key], chunks);
+		}
+	}
+	else
+	{
+		throw new TypeError(`cannot encode value of type ${typeof value}`);
+	}
+}
+
+function decodeValue(buffer, state)
+{
+	let type = buffer.readUInt8(state.pos++);
+	let len;
+	let value;
+
+	// positive fixint.
+	if (type <= 0x7f)
+		return type;
+	// negative fixint.
+	if (type >= 0xe0)
+		return type - 0x100;
+	// fixmap.
+	if ((type & 0xf0) === 0x80)
+		return decodeMap(buffer, state, type & 0x0f);
+	// fixarray.
+	if ((type & 0xf0) === 0x90)
+		return decodeArray(buffer, state, type & 0x0f);
+	// fixstr.
+	if ((type & 0xe0) === 0xa0)
+		return decodeString(buffer, state, type & 0x1f);
+
+	switch (type)
+	{
+		case 0xc0:
+			return null;
+
+		case 0xc2:
+			return false;
+
+		case 0xc3:
+			return true;
+
+		case 0xc4:
+		case 0xd9:
+			len = buffer.readUInt8(state.pos);
+			state.pos += 1;
+			return decodeString(buffer, state, len);
+
+		case 0xc5:
+		case 0xda:
+			len = buffer.readUInt16BE(state.pos);
+			state.pos += 2;
+			return decodeString(buffer, state, len);
+
+		case 0xc6:
+		case 0xdb:
+			len = buffer.readUInt32BE(state.pos);
+			state.pos += 4;
+			return decodeString(buffer, state, len);
+
+		case 0xca:
+			value = buffer.readFloatBE(state.pos);
+			state.pos += 4;
+			return value;
+
+		case 0xcb:
+			value = buffer.readDoubleBE(state.pos);
+			state.pos += 8;
+			return value;
+
+		case 0xcc:
+			value = buffer.readUInt8(state.pos);
+			state.pos += 1;
+			return value;
+
+		case 0xcd:
+			value = buffer.readUInt16BE(state.pos);
+			state.pos += 2;
+			return value;
+
+		case 0xce:
+			value = buffer.readUInt32BE(state.pos);
+			state.pos += 4;
+			return value;
+
+		case 0xcf:
+			value = (buffer.readUInt32BE(state.pos) * 0x100000000) + buffer.readUInt32BE(state.pos + 4);
+			state.pos += 8;
+			return value;
+
+		case 0xd0:
+			value = buffer.readInt8(state.pos);
+			state.pos += 1;
+			return value;
+
+		case 0xd1:
+			value = buffer.readInt16BE(state.pos);
+			state.pos += 2;
+			return value;
+
+		case 0xd2:
+			value = buffer.readInt32BE(state.pos);
+			state.pos += 4;
+			return value;
+
+		case 0xd3:
+			value = (buffer.readInt32BE(state.pos) * 0x100000000) + buffer.readUInt32BE(state.pos + 4);
+			state.pos += 8;
+			return value;
+
+		case 0xdc:
+			len = buffer.readUInt16BE(state.pos);
+			state.pos += 2;
+			return decodeArray(buffer, state, len);
+
+		case 0xdd:
+			len = buffer.readUInt32BE(state.pos);
+			state.pos += 4;
+			return decodeArray(buffer, state, len);
+
+		case 0xde:
+			len = buffer.readUInt16BE(state.pos);
+			state.pos += 2;
+			return decodeMap(buffer, state, len);
+
+		case 0xdf:
+			len = buffer.readUInt32BE(state.pos);
+			state.pos += 4;
+			return decodeMap(buffer, state, len);
+
+		default:
+			throw new TypeError(`unsupported MessagePack type 0x${type.toString(16)}`);
+	}
+}
+
+function decodeString(buffer, state, len)
+{
+	if (state.pos + len > buffer.length)
+		throw new RangeError('truncated MessagePack string');
+
+	let str = buffer.toString('utf8', state.pos, state.pos + len);
+
+	state.pos += len;
+
+	return str;
+}
+
+function decodeArray(buffer, state, len)
+{
+	let array = new Array(len);
+
+	for (let i = 0; i < len; i++)
+	{
+		array[i] = decodeValue(buffer, state);
+	}
+
+	return array;
+}
+
+function decodeMap(buffer, state, len)
+{
+	let map = {};
+
+	for (let i = 0; i < len; i++)
+	{
+		let key = decodeValue(buffer, state);
+
+		if (typeof key !== 'string')
+			throw new TypeError('MessagePack map key is not a string');
+
+		map[key] = decodeValue(buffer, state);
+	}
+
+	return map;
+}
+
+/**
+ * Encode the given value into a Buffer.
+ */
+exports.encode = function(value)
+{
+	let chunks = [];
+
+	encodeValue(value, chunks);
+
+	return Buffer.concat(chunks);
+};
+
+/**
+ * Decode the given Buffer.
+ */
+exports.decode = function(buffer)
+{
+	let state = { pos: 0 };
+	let value = decodeValue(buffer, state);
+
+	if (state.pos !== buffer.length)
+		throw new RangeError('trailing data in MessagePack message');
+
+	return value;
+};
+
+/**
+ * Whether the given Buffer looks like a MessagePack map.
+ */
+exports.isMsgPack = function(buffer)
+{
+	if (!buffer.length)
+		return false;
+
+	return (buffer[0] & 0xf0) === 0x80 || buffer[0] === 0xde || buffer[0] === 0xdf;
+};
@@ -398,6 +398,7 @@ class RTCPeerConnectionPlanB extends RTCPeerConnectionCommon
 
 				// SSRCs.
 				objMedia.ssrcs = [];
+				objMedia.ssrcGroups = [];
 
 				for (let rtpSender of self._peer.rtpSenders)
 				{
@@ -411,19 +412,36 @@ class RTCPeerConnectionPlanB extends RTCPeerConnectionCommon
 
 					for (let encoding of rtpSender.rtpParameters.encodings)
 					{
-						objMedia.ssrcs.push(
-							{
-								id        : encoding.ssrc,
-								attribute : 'cname',
-								value     : rtpSender.rtpParameters.rtcp.cname
-							});
+						let ssrcs = [ encoding.ssrc ];
 
-						objMedia.ssrcs.push(
-							{
-								id        : encoding.ssrc,
-								attribute : 'msid',
-								value     : rtpSender.rtpParameters.userParameters.msid
-							});
+						// RTX stream (a=ssrc-group:FID).
+						if (encoding.rtx && encoding.rtx.ssrc)
+						{
+							ssrcs.push(encoding.rtx.ssrc);
+
+							objMedia.ssrcGroups.push(
+								{
+									semantics : 'FID',
+									ssrcs     : ssrcs.join(' ')
+								});
+						}
+
+						for (let ssrc of ssrcs)
+						{
+							objMedia.ssrcs.push(
+								{
+									id        : ssrc,
+									attribute : 'cname',
+									value     : rtpSender.rtpParameters.rtcp.cname
+								});
+
+							objMedia.ssrcs.push(
+								{
+									id        : ssrc,
+									attribute : 'msid',
+									value     : rtpSender.rtpParameters.userParameters.msid
+								});
+						}
 					}
 				}
 
@@ -470,7 +488,7 @@ class RTCPeerConnectionPlanB extends RTCPeerConnectionCommon
 
 	_createRtpReceiverForSsrc(parsedMedia, mediaSsrcs, trackInfo)
 	{
-		// TODO: We assume no RTX/FEC in client's SDP.
+		// NOTE: We assume no FEC in client's SDP.
 
 		if (!Array.isArray(mediaSsrcs))
 			mediaSsrcs = [ mediaSsrcs ];
@@ -539,14 +557,21 @@ class RTCPeerConnectionPlanB extends RTCPeerConnectionCommon
 		let encodings = [];
 		// NOTE: Here we assume that the first codec in the list is the media one.
 		let codecPayloadType = mapCodecs.values().next().value.payloadType;
+		// Map of RTX SSRCs indexed by media SSRC.
+		let rtxSsrcs = sdpUtils.getRtxSsrcs(parsedMedia);
 
 		for (let ssrc of mediaSsrcs)
 		{
-			encodings.push(
-				{
-					ssrc             : ssrc,
-					codecPayloadType : codecPayloadType
-				});
+			let encoding =
+			{
+				ssrc             : ssrc,
+				codecPayloadType : codecPayloadType
+			};
+
+			if (rtxSsrcs.has(ssrc))
+				encoding.rtx = { ssrc: rtxSsrcs.get(ssrc) };
+
+			encodings.push(encoding);
 		}
 
 		// Array of RtpHeaderExtensionParameters.
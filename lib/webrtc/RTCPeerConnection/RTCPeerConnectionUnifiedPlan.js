@@ -318,7 +318,7 @@ class RTCPeerConnectionUnifiedPlan extends RTCPeerConnectionCommon
 
 	_createRtpReceiver(parsedMedia)
 	{
-		// TODO: We assume no RTX/FEC in client's generated answer.
+		// NOTE: We assume no FEC in client's generated answer.
 
 		let transport = this._peer.transports[0];
 		let kind = parsedMedia.type;
@@ -397,6 +397,13 @@ class RTCPeerConnectionUnifiedPlan extends RTCPeerConnectionCommon
 			}
 		}
 
+		// Map of RTX SSRCs indexed by media SSRC.
+		let rtxSsrcs = sdpUtils.getRtxSsrcs(parsedMedia);
+
+		// The first SSRC in a FID group is the media one.
+		if (rtxSsrcs.size > 0)
+			mediaSsrc = rtxSsrcs.keys().next().value;
+
 		// Array of RtpEncodingParameters.
 		// NOTE: Just a single encoding will be created with the first media codec
 		// in the answer.
@@ -408,6 +415,9 @@ class RTCPeerConnectionUnifiedPlan extends RTCPeerConnectionCommon
 			}
 		];
 
+		if (rtxSsrcs.has(mediaSsrc))
+			encodings[0].rtx = { ssrc: rtxSsrcs.get(mediaSsrc) };
+
 		// Array of RtpHeaderExtensionParameters.
 		let headerExtensions = sdpUtils.descToRtpHeaderExtensionParameters(parsedMedia);
 
@@ -281,14 +281,33 @@ class RTCRtpTransceiver
 			if (this._sender.rtpParameters.userParameters.msid)
 				objMedia.msid = this._sender.rtpParameters.userParameters.msid;
 
+			objMedia.ssrcGroups = [];
+
 			for (let encoding of this._sender.rtpParameters.encodings)
 			{
-				objMedia.ssrcs.push(
-					{
-						id        : encoding.ssrc,
-						attribute : 'cname',
-						value     : this._sender.rtpParameters.rtcp.cname
-					});
+				let ssrcs = [ encoding.ssrc ];
+
+				// RTX stream (a=ssrc-group:FID).
+				if (encoding.rtx && encoding.rtx.ssrc)
+				{
+					ssrcs.push(encoding.rtx.ssrc);
+
+					objMedia.ssrcGroups.push(
+						{
+							semantics : 'FID',
+							ssrcs     : ssrcs.join(' ')
+						});
+				}
+
+				for (let ssrc of ssrcs)
+				{
+					objMedia.ssrcs.push(
+						{
+							id        : ssrc,
+							attribute : 'cname',
+							value     : this._sender.rtpParameters.rtcp.cname
+						});
+				}
 			}
 		}
 
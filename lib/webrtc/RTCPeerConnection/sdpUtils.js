@@ -19,10 +19,9 @@ module.exports =
 
 			for (let rtp of parsedMedia.rtp)
 			{
-				// Ignore feature codecs.
+				// Ignore feature codecs (but RTX).
 				switch (rtp.codec.toLowerCase())
 				{
-					case 'rtx':
 					case 'ulpfec':
 					case 'flexfec':
 					case 'red':
@@ -196,12 +195,37 @@ module.exports =
 	},
 
 	/**
-	 * This assumes no RTX/FEC.
+	 * Map of RTX SSRCs indexed by media SSRC (a=ssrc-group:FID).
+	 */
+	getRtxSsrcs(parsedMedia)
+	{
+		let rtxSsrcs = new Map();
+
+		if (!Array.isArray(parsedMedia.ssrcGroups))
+			return rtxSsrcs;
+
+		for (let group of parsedMedia.ssrcGroups)
+		{
+			if (group.semantics !== 'FID')
+				continue;
+
+			let ssrcs = group.ssrcs.split(' ').map(Number);
+
+			if (ssrcs.length === 2)
+				rtxSsrcs.set(ssrcs[0], ssrcs[1]);
+		}
+
+		return rtxSsrcs;
+	},
+
+	/**
+	 * This assumes no FEC. RTX SSRCs are not returned.
 	 */
 	getPlanBSsrcs(parsedMedia)
 	{
 		let singleSsrcs = new Set();
 		let simulcastSsrcs = new Set();
+		let rtxSsrcs = new Set(this.getRtxSsrcs(parsedMedia).values());
 		let ssrcs = [];
 
 		// Simulcast.
@@ -237,7 +261,7 @@ module.exports =
 			{
 				let ssrc = ssrcObj.id;
 
-				if (simulcastSsrcs.has(ssrc) || singleSsrcs.has(ssrc))
+				if (simulcastSsrcs.has(ssrc) || singleSsrcs.has(ssrc) || rtxSsrcs.has(ssrc))
 					continue;
 
 				singleSsrcs.add(ssrc);
@@ -4,6 +4,7 @@ const tap = require('tap');
 const mediasoup = require('../');
 const roomOptions = require('./data/options').roomOptions;
 const peerOptions = require('./data/options').peerOptions;
+const peerCapabilities = require('./data/options').peerCapabilities;
 
 tap.test('room.Peer() with peerName must succeed', { timeout: 2000 }, (t) =>
 {
@@ -169,3 +170,229 @@ tap.test('room.dump() must succeed', { timeout: 2000 }, (t) =>
 		})
 		.catch((error) => t.fail(`server.createRoom() failed: ${error}`));
 });
+
+tap.test('room.dump() with limit and cursor must paginate the peers', { timeout: 2000 }, (t) =>
+{
+	let server = mediasoup.Server();
+	let peerNames = [];
+
+	t.tearDown(() => server.close());
+
+	server.createRoom(roomOptions)
+		.then((room) =>
+		{
+			room.Peer('alice', peerOptions);
+			room.Peer('bob', peerOptions);
+			room.Peer('carol', peerOptions);
+
+			return room.dump({ limit: 2 })
+				.then((data) =>
+				{
+					t.equal(data.peers.length, 2, 'first page must retrieve two peers');
+					t.type(data.nextCursor, 'number', 'first page must have nextCursor');
+					t.ok(data.mapRtpReceiverRtpSenders, 'first page must have the maps');
+					t.ok(data.linkedRtpReceivers, 'first page must have the linked RtpReceivers');
+
+					peerNames = peerNames.concat(data.peers.map((peer) => peer.peerName));
+
+					return room.dump({ limit: 2, cursor: data.nextCursor });
+				})
+				.then((data) =>
+				{
+					t.equal(data.peers.length, 1, 'second page must retrieve one peer');
+					t.notOk('nextCursor' in data, 'second page must not have nextCursor');
+
+					peerNames = peerNames.concat(data.peers.map((peer) => peer.peerName));
+
+					t.same(peerNames.sort(), [ 'alice', 'bob', 'carol' ], 'pages must retrieve every peer once');
+					t.end();
+				});
+		})
+		.catch((error) => t.fail(`room.dump() failed: ${error}`));
+});
+
+// Creates two Rooms in the same worker with a video RtpReceiver in the first
+// one and a Peer ready to receive it in the second one.
+function initLinkTest(t)
+{
+	let server = mediasoup.Server({ numWorkers: 1 });
+	let sourceRoom;
+	let room;
+	let alice;
+	let bob;
+	let rtpReceiver;
+
+	t.tearDown(() => server.close());
+
+	return Promise.all([ server.createRoom(roomOptions), server.createRoom(roomOptions) ])
+		.then((rooms) =>
+		{
+			sourceRoom = rooms[0];
+			room = rooms[1];
+			alice = sourceRoom.Peer('alice');
+			bob = room.Peer('bob');
+
+			return Promise.all(
+				[
+					alice.setCapabilities(peerCapabilities),
+					bob.setCapabilities(peerCapabilities)
+				]);
+		})
+		.then(() =>
+		{
+			return alice.createTransport({ tcp: false });
+		})
+		.then((transport) =>
+		{
+			rtpReceiver = alice.RtpReceiver('video', transport);
+
+			return rtpReceiver.receive(
+				{
+					codecs :
+					[
+						{
+							name        : 'video/vp8',
+							payloadType : 110,
+							clockRate   : 90000
+						}
+					],
+					encodings :
+					[
+						{
+							ssrc : 1111
+						}
+					]
+				});
+		})
+		.then(() =>
+		{
+			return { sourceRoom: sourceRoom, room: room, bob: bob, rtpReceiver: rtpReceiver };
+		});
+}
+
+tap.test('room.linkRtpReceiver() must forward the RtpReceiver to the Peers of the Room', { timeout: 2000 }, (t) =>
+{
+	return initLinkTest(t)
+		.then((data) =>
+		{
+			let newRtpSender = new Promise((accept) => data.bob.on('newrtpsender', accept));
+
+			return data.room.linkRtpReceiver(data.rtpReceiver)
+				.then(() => newRtpSender)
+				.then((rtpSender) =>
+				{
+					t.equal(rtpSender.associatedPeer, data.rtpReceiver.associatedPeer, 'RtpSender must be associated to the Peer of the linked RtpReceiver');
+
+					return Promise.all(
+						[
+							data.room.dump(),
+							data.sourceRoom.dump(),
+							data.room.dump({ limit: 1 })
+						]);
+				})
+				.then((dumps) =>
+				{
+					let rtpReceiverId = String(data.rtpReceiver._internal.rtpReceiverId);
+
+					t.equal(dumps[0].linkedRtpReceivers[rtpReceiverId], String(data.sourceRoom._internal.roomId), 'Room must list the linked RtpReceiver');
+					// The REMB of the linked RtpSenders is aggregated by the source Room.
+					t.same(dumps[1].mapRtpReceiverLinkedRooms[rtpReceiverId], [ String(data.room._internal.roomId) ], 'source Room must list the Room for REMB propagation');
+					// A page includes the linked RtpReceivers forwarded to its Peers.
+					t.ok(dumps[2].linkedRtpReceivers[rtpReceiverId], 'paginated dump must list the linked RtpReceiver');
+					t.equal(dumps[2].mapRtpReceiverRtpSenders[rtpReceiverId].length, 1, 'paginated dump must list the RtpSender of the linked RtpReceiver');
+				});
+		});
+});
+
+tap.test('room.linkRtpReceiver() with the same RtpReceiver twice must fail', { timeout: 2000 }, (t) =>
+{
+	return initLinkTest(t)
+		.then((data) =>
+		{
+			let listenerCount = data.rtpReceiver.listenerCount('close');
+
+			return data.room.linkRtpReceiver(data.rtpReceiver)
+				.then(() => data.room.linkRtpReceiver(data.rtpReceiver))
+				.then(() => t.fail('second room.linkRtpReceiver() succeeded'))
+				.catch((error) =>
+				{
+					t.type(error, Error, 'second room.linkRtpReceiver() must fail');
+					t.equal(data.rtpReceiver.listenerCount('close'), listenerCount + 1, 'Room must listen just once to the RtpReceiver');
+
+					return data.room.dump();
+				})
+				.then((dump) =>
+				{
+					t.equal(Object.keys(dump.linkedRtpReceivers).length, 1, 'first link must be kept');
+				});
+		});
+});
+
+tap.test('room.linkRtpReceiver() with a RtpReceiver of the same Room must fail', { timeout: 2000 }, (t) =>
+{
+	return initLinkTest(t)
+		.then((data) =>
+		{
+			return data.sourceRoom.linkRtpReceiver(data.rtpReceiver)
+				.then(() => t.fail('room.linkRtpReceiver() succeeded'))
+				.catch((error) => t.type(error, Error, 'room.linkRtpReceiver() must fail'));
+		});
+});
+
+tap.test('closing the source Room must unlink its RtpReceivers', { timeout: 2000 }, (t) =>
+{
+	return initLinkTest(t)
+		.then((data) =>
+		{
+			let listenerCount = data.rtpReceiver.listenerCount('close');
+
+			return data.room.linkRtpReceiver(data.rtpReceiver)
+				.then(() =>
+				{
+					t.equal(data.rtpReceiver.listenerCount('close'), listenerCount + 1, 'Room must listen to the RtpReceiver');
+					t.equal(data.bob.rtpSenders.length, 1, 'bob must have 1 RtpSender');
+
+					let rtpSenderClosed = new Promise((accept) => data.bob.rtpSenders[0].on('close', accept));
+
+					data.sourceRoom.close();
+
+					return rtpSenderClosed;
+				})
+				.then(() =>
+				{
+					t.pass('linked RtpSender closed');
+					t.equal(data.rtpReceiver.listenerCount('close'), listenerCount, 'Room must stop listening to the RtpReceiver');
+
+					return data.room.dump();
+				})
+				.then((dump) =>
+				{
+					t.same(dump.linkedRtpReceivers, {}, 'Room must not list the RtpReceiver');
+				});
+		});
+});
+
+tap.test('closing the Room must stop listening to its linked RtpReceivers', { timeout: 2000 }, (t) =>
+{
+	return initLinkTest(t)
+		.then((data) =>
+		{
+			let listenerCount = data.rtpReceiver.listenerCount('close');
+
+			return data.room.linkRtpReceiver(data.rtpReceiver)
+				.then(() =>
+				{
+					data.room.close();
+
+					t.equal(data.rtpReceiver.listenerCount('close'), listenerCount, 'Room must stop listening to the RtpReceiver');
+
+					// Wait a bit so the worker closes the Room.
+					return new Promise((accept) => setTimeout(accept, 50));
+				})
+				.then(() => data.sourceRoom.dump())
+				.then((dump) =>
+				{
+					t.same(dump.mapRtpReceiverLinkedRooms, {}, 'source Room must not list the closed Room');
+				});
+		});
+});
@@ -0,0 +1,48 @@
+#ifndef MS_CHANNEL_MSG_PACK_HPP
+#define MS_CHANNEL_MSG_PACK_HPP
+
+#include "common.hpp"
+#include <string>
+#include <json/json.h>
+
+namespace Channel
+{
+	/**
+	 * Minimal MessagePack codec for Channel messages in binary format. It maps
+	 * to/from Json::Value so requests, responses and notifications are handled
+	 * the same way regardless of the Channel format.
+	 *
+	 * Supported types: nil, bool, int, uint, float, str, bin (decoded as str),
+	 * array and map (with string keys).
+	 */
+	class MsgPack
+	{
+	public:
+		static void Encode(const Json::Value& json, std::string& buffer);
+		static void EncodeArrayHeader(size_t size, std::string& buffer);
+		static void EncodeMapHeader(size_t size, std::string& buffer);
+		static void EncodeString(const char* str, size_t len, std::string& buffer);
+		static bool Decode(const uint8_t* data, size_t len, Json::Value& json);
+		static bool IsMsgPack(const uint8_t* data, size_t len);
+
+	private:
+		static bool DecodeValue(const uint8_t* data, size_t len, size_t& pos, Json::Value& json, size_t depth);
+	};
+
+	/* Inline static methods. */
+
+	/**
+	 * Whether the given Channel message looks like a MessagePack map (the only
+	 * valid top level type for Channel messages).
+	 */
+	inline
+	bool MsgPack::IsMsgPack(const uint8_t* data, size_t len)
+	{
+		if (len == 0)
+			return false;
+
+		return (data[0] & 0xF0) == 0x80 || data[0] == 0xDE || data[0] == 0xDF;
+	}
+}
+
+#endif
@@ -19,10 +19,12 @@ namespace Channel
 		{
 			worker_dump = 1,
 			worker_updateSettings,
+			worker_getStats,
 			worker_createRoom,
 			room_close,
 			room_dump,
 			room_createPeer,
+			room_linkRtpReceiver,
 			peer_close,
 			peer_dump,
 			peer_setCapabilities,
@@ -31,14 +33,20 @@ namespace Channel
 			transport_close,
 			transport_dump,
 			transport_setRemoteDtlsParameters,
+			transport_setPacer,
+			transport_dumpPacketTrace,
 			rtpReceiver_close,
 			rtpReceiver_dump,
 			rtpReceiver_receive,
 			rtpReceiver_setRtpRawEvent,
 			rtpReceiver_setRtpObjectEvent,
+			rtpReceiver_setRtpRawRing,
+			rtpReceiver_setRecording,
 			rtpSender_dump,
 			rtpSender_setTransport,
-			rtpSender_disable
+			rtpSender_disable,
+			rtpSender_setTargetEncoding,
+			rtpSender_setTargetLayers
 		};
 
 	private:
@@ -0,0 +1,78 @@
+#ifndef MS_CHANNEL_RESPONSE_WRITER_HPP
+#define MS_CHANNEL_RESPONSE_WRITER_HPP
+
+#include "common.hpp"
+#include "Channel/Request.hpp"
+#include "Channel/UnixStreamSocket.hpp"
+#include <string>
+#include <vector>
+#include <json/json.h>
+
+namespace Channel
+{
+	/**
+	 * Writes the data of the accepted response of a Request piece by piece, so
+	 * a big response (i.e. the dump of a big Room) is neither built as a single
+	 * Json::Value nor limited to the size of a netstring: the encoded data is
+	 * sent in chunks (see UnixStreamSocket::SendChunk()) every ChunkSize bytes.
+	 *
+	 * Objects and arrays are started with their number of entries (needed by
+	 * the binary format) and each entry of an object is a Key() followed by a
+	 * value (a Value() or another object or array).
+	 *
+	 * If a Listener is given, the data is handed to it instead of being sent
+	 * into the Channel.
+	 */
+	class ResponseWriter
+	{
+	public:
+		class Listener
+		{
+		public:
+			virtual void onResponseWriterPayload(Channel::ResponseWriter* responseWriter, const std::string& payload) = 0;
+			virtual void onResponseWriterChunk(Channel::ResponseWriter* responseWriter, const uint8_t* data, size_t len, bool last) = 0;
+		};
+
+	public:
+		static constexpr size_t ChunkSize = 65536;
+
+	private:
+		struct Container
+		{
+			bool isObject = false;
+			size_t size = 0;
+			size_t count = 0;
+		};
+
+	public:
+		explicit ResponseWriter(Channel::Request* request);
+		ResponseWriter(Listener* listener, uint32_t id, bool binary);
+
+		void StartObject(size_t size);
+		void StartArray(size_t size);
+		void End();
+		void Key(const char* key);
+		void Value(const Json::Value& json);
+		void Finish();
+
+	private:
+		void Start(uint32_t id);
+		void AddEntry();
+		void MayFlush();
+		void SendChunk(bool last);
+
+	private:
+		// Passed by argument.
+		Channel::UnixStreamSocket* channel = nullptr;
+		Listener* listener = nullptr;
+		// Allocated by this.
+		std::unique_ptr<Json::StreamWriter> jsonWriter;
+		// Others.
+		bool binary = false;
+		std::string buffer;
+		std::vector<Container> containers;
+		bool chunked = false;
+	};
+}
+
+#endif
@@ -3,13 +3,16 @@
 
 #include "common.hpp"
 #include "handles/UnixStreamSocket.hpp"
+#include "handles/Prepare.hpp"
 #include "Channel/Request.hpp"
+#include <string>
 #include <json/json.h>
 
 namespace Channel
 {
 	class UnixStreamSocket :
-		public ::UnixStreamSocket
+		public ::UnixStreamSocket,
+		public Prepare::Listener
 	{
 	public:
 		class Listener
@@ -19,8 +22,22 @@ namespace Channel
 			virtual void onChannelUnixStreamSocketRemotelyClosed(Channel::UnixStreamSocket* channel) = 0;
 		};
 
+	public:
+		/**
+		 * Format of the messages sent by this Channel. Received messages are
+		 * accepted in both formats.
+		 */
+		enum class Format
+		{
+			JSON = 1,
+			BINARY
+		};
+
 	private:
 		static uint8_t writeBuffer[];
+		// Max bytes of a batch before it is flushed in the middle of the loop
+		// iteration.
+		static constexpr size_t MaxBatchSize = 65536;
 
 	public:
 		explicit UnixStreamSocket(int fd);
@@ -30,24 +47,57 @@ namespace Channel
 
 	public:
 		void SetListener(Listener* listener);
+		void SetFormat(Format format);
+		Format GetFormat() const;
 		void Send(Json::Value &json);
-		void SendLog(char* ns_payload, size_t ns_payload_len);
+		void SendPayload(const std::string& ns_payload);
+		void SendChunk(const uint8_t* data, size_t len, bool last);
+		void SendLog(char* ns_payload, size_t ns_payload_len, bool immediate = true);
 		void SendBinary(const uint8_t* ns_payload, size_t ns_payload_len);
+		void Flush();
+		Json::Value toJson() const;
+
+	private:
+		void Enqueue(const uint8_t* data, size_t len);
+		void EnqueueChunk(const uint8_t* data, size_t len, bool more);
 
 	/* Pure virtual methods inherited from ::UnixStreamSocket. */
 	public:
 		virtual void userOnUnixStreamRead() override;
 		virtual void userOnUnixStreamSocketClosed(bool is_closed_by_peer) override;
 
+	/* Pure virtual methods inherited from Prepare::Listener. */
+	public:
+		virtual void onPrepare(Prepare* prepare) override;
+
 	private:
 		// Passed by argument.
 		Listener* listener = nullptr;
+		// Allocated by this.
+		Prepare* prepare = nullptr;
 		// Others.
 		Json::CharReader* jsonReader = nullptr;
 		Json::StreamWriter* jsonWriter = nullptr;
+		Format format = Format::JSON;
 		size_t msgStart = 0; // Where the latest message starts.
 		bool closed = false;
+		// Others (batching).
+		std::string batchBuffer;
+		size_t batchMessages = 0;
+		uint64_t totalBatches = 0;
+		uint64_t totalMessages = 0;
+		uint64_t totalBytes = 0;
+		uint64_t overflowBatches = 0;
+		size_t maxBatchMessages = 0;
 	};
+
+	/* Inline instance methods. */
+
+	inline
+	UnixStreamSocket::Format UnixStreamSocket::GetFormat() const
+	{
+		return this->format;
+	}
 }
 
 #endif
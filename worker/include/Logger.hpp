@@ -8,9 +8,22 @@
  * All the logging macros use the same format as printf(). The XXX_STD version
  * of a macro logs to stdoud/stderr instead of using the Channel instance.
  *
+ * MS_TRACE(), MS_XXX_TAG(), MS_XXX_2TAGS() and MS_XXX_DEV() do not format
+ * anything in place. They just store the format string pointer and a copy of
+ * the arguments into a ring, which is formatted and sent in batches by an idle
+ * handle. If the ring is full the entry is dropped (and counted). So the given
+ * format must be a string literal.
+ *
  * If the macro MS_LOG_FILE_LINE is defied, all the logging macros print more
  * verbose information, including current file and line.
  *
+ * If a source file defines the MS_LOG_HOT_PATH macro (before including any
+ * file) and the build defines MS_HOT_PATH_LOG_LEVEL ("debug", "warn" or
+ * "error", see the mediasoup_hot_path_log_level gyp variable), the trace,
+ * debug and warn macros below that level are compiled out of that file, so
+ * they do not even check the current log level and tags at runtime. Levels
+ * above the threshold keep working as usual. MS_LOG_DEV disables it.
+ *
  * MS_TRACE()
  *
  *   Logs the current method/function if MS_LOG_TRACE macro is defined and the
@@ -63,12 +76,17 @@
 #include "LogLevel.hpp"
 #include "Settings.hpp"
 #include "Channel/UnixStreamSocket.hpp"
+#include "handles/Idle.hpp"
 #include <string>
+#include <type_traits>
 #include <cstdio> // std::snprintf(), std::fprintf(), stdout, stderr
 #include <cstring>
 #include <cstdlib> // std::abort()
 
 #define MS_LOGGER_BUFFER_SIZE 10000
+// Max size of the packed arguments of a deferred entry (bigger ones are
+// formatted when logged).
+#define MS_LOGGER_ARGS_SIZE 1024
 #define _MS_TAG_ENABLED(tag) Settings::configuration.logTags.tag
 #define _MS_TAG_ENABLED_2(tag1, tag2) (Settings::configuration.logTags.tag1 || Settings::configuration.logTags.tag2)
 #ifdef MS_LOG_DEV
@@ -77,6 +95,18 @@
 	#define _MS_LOG_DEV_ENABLED false
 #endif
 
+#define _MS_LOG_LEVEL_debug 2
+#define _MS_LOG_LEVEL_warn 1
+#define _MS_LOG_LEVEL_error 0
+#define _MS_LOG_LEVEL_VALUE(level) _MS_LOG_LEVEL_VALUE_(level)
+#define _MS_LOG_LEVEL_VALUE_(level) _MS_LOG_LEVEL_##level
+#if defined(MS_LOG_HOT_PATH) && defined(MS_HOT_PATH_LOG_LEVEL) && !defined(MS_LOG_DEV)
+	#define _MS_LOG_MIN_LEVEL _MS_LOG_LEVEL_VALUE(MS_HOT_PATH_LOG_LEVEL)
+#else
+	#define _MS_LOG_MIN_LEVEL 2
+#endif
+#define _MS_LOG_COMPILED(level) (LogLevel::level <= ms_logger_min_level)
+
 // Usage:
 //   MS_DEBUG_DEV("Leading text "MS_UINT16_TO_BINARY_PATTERN, MS_UINT16_TO_BINARY(value));
 #define MS_UINT16_TO_BINARY_PATTERN "%c%c%c%c%c%c%c%c%c%c%c%c%c%c%c%c"
@@ -100,16 +130,211 @@
 
 class Logger
 {
+private:
+	class IdleListener :
+		public Idle::Listener
+	{
+	/* Pure virtual methods inherited from Idle::Listener. */
+	public:
+		virtual void onIdle(Idle* idle) override;
+	};
+
+	/* Header of each deferred entry in the ring. */
+	struct EntryHeader
+	{
+		// Size of the entry (header + args) padded to 8 bytes. 0 means wrap.
+		uint32_t size;
+		uint16_t argsLen;
+		// 'D', 'W' or 't' (trace).
+		char level;
+		int line;
+		const char* file;
+		const char* className;
+		const char* function;
+		const char* format;
+	};
+
 public:
 	static void Init(const std::string &id, Channel::UnixStreamSocket* channel);
 	static void Init(const std::string &id);
+	static void Flush();
+	static void FlushOnAbort();
+	static void Close();
+	static Json::Value toJson();
+	static void Defer(char level, const char* file, int line, const char* className, const char* function, const char* format);
+	template<typename... Args>
+	static void Defer(char level, const char* file, int line, const char* className, const char* function, const char* format, Args... args);
+	template<typename... Args>
+	static void Send(char level, const char* file, int line, const char* className, const char* function, const char* format, Args... args);
+	static int Format(char* buffer, size_t bufferSize, const char* format, const uint8_t* args, size_t argsLen);
+	static size_t PackString(uint8_t* args, size_t len, const char* value);
+	static size_t PackNumber(uint8_t* args, size_t len, char type, uint64_t value);
+
+private:
+	static void Commit(char level, const char* file, int line, const char* className, const char* function, const char* format, const uint8_t* args, size_t argsLen);
+	static void FlushEntries(size_t maxEntries);
+	static void SendEntry(const EntryHeader* header, const uint8_t* args);
+	static int WritePrefix(const EntryHeader* header);
+	// Argument packing.
+	template<typename T>
+	static typename std::enable_if<std::is_integral<T>::value && std::is_signed<T>::value, size_t>::type
+	PackArg(uint8_t* args, size_t len, T value);
+	template<typename T>
+	static typename std::enable_if<std::is_integral<T>::value && std::is_unsigned<T>::value, size_t>::type
+	PackArg(uint8_t* args, size_t len, T value);
+	template<typename T>
+	static typename std::enable_if<std::is_enum<T>::value, size_t>::type
+	PackArg(uint8_t* args, size_t len, T value);
+	static size_t PackArg(uint8_t* args, size_t len, double value);
+	static size_t PackArg(uint8_t* args, size_t len, const char* value);
+	static size_t PackArg(uint8_t* args, size_t len, char* value);
+	template<typename T>
+	static size_t PackArg(uint8_t* args, size_t len, T* value);
 
 public:
 	static std::string id;
+	// "id:<id>", used by the logging macros.
+	static std::string idTag;
 	static Channel::UnixStreamSocket* channel;
 	static char buffer[];
+
+private:
+	static uint8_t ring[];
+	static uint64_t ringWritePos;
+	static uint64_t ringReadPos;
+	static Idle* idle;
+	static IdleListener idleListener;
+	static uint64_t deferredEntries;
+	static uint64_t droppedEntries;
+	static uint64_t pendingDroppedEntries;
+	static bool aborting;
 };
 
+/* Inline static methods. */
+
+inline
+void Logger::Defer(char level, const char* file, int line, const char* className, const char* function, const char* format)
+{
+	Logger::Commit(level, file, line, className, function, format, nullptr, 0);
+}
+
+template<typename... Args>
+inline
+void Logger::Defer(char level, const char* file, int line, const char* className, const char* function, const char* format, Args... args)
+{
+	uint8_t packed[MS_LOGGER_ARGS_SIZE];
+	size_t len = 0;
+	// Pack the arguments in order.
+	int expand[] = { 0, (len = Logger::PackArg(packed, len, args), 0)... };
+
+	(void)expand;
+
+	// The arguments do not fit (i.e. a long SDP or JSON dump), so format the
+	// entry now.
+	if (len > MS_LOGGER_ARGS_SIZE)
+	{
+		Logger::Send(level, file, line, className, function, format, args...);
+
+		return;
+	}
+
+	Logger::Commit(level, file, line, className, function, format, packed, len);
+}
+
+/**
+ * Formats and sends an entry right now, after the pending deferred ones so the
+ * order is kept.
+ */
+template<typename... Args>
+inline
+void Logger::Send(char level, const char* file, int line, const char* className, const char* function, const char* format, Args... args)
+{
+	if (!Logger::channel)
+		return;
+
+	EntryHeader header;
+
+	header.level = level;
+	header.line = line;
+	header.file = file;
+	header.className = className;
+	header.function = function;
+
+	Logger::FlushEntries(SIZE_MAX);
+
+	int written = Logger::WritePrefix(&header);
+
+	if (written <= 0 || written >= MS_LOGGER_BUFFER_SIZE)
+		return;
+
+	written += std::snprintf(Logger::buffer + written, MS_LOGGER_BUFFER_SIZE - written, format, args...);
+
+	if (written >= MS_LOGGER_BUFFER_SIZE)
+		written = MS_LOGGER_BUFFER_SIZE - 1;
+
+	Logger::channel->SendLog(Logger::buffer, written, false);
+}
+
+template<typename T>
+inline
+typename std::enable_if<std::is_integral<T>::value && std::is_signed<T>::value, size_t>::type
+Logger::PackArg(uint8_t* args, size_t len, T value)
+{
+	return Logger::PackNumber(args, len, 'i', (uint64_t)(int64_t)value);
+}
+
+template<typename T>
+inline
+typename std::enable_if<std::is_integral<T>::value && std::is_unsigned<T>::value, size_t>::type
+Logger::PackArg(uint8_t* args, size_t len, T value)
+{
+	return Logger::PackNumber(args, len, 'u', (uint64_t)value);
+}
+
+template<typename T>
+inline
+typename std::enable_if<std::is_enum<T>::value, size_t>::type
+Logger::PackArg(uint8_t* args, size_t len, T value)
+{
+	return Logger::PackNumber(args, len, 'i', (uint64_t)(int64_t)value);
+}
+
+inline
+size_t Logger::PackArg(uint8_t* args, size_t len, double value)
+{
+	uint64_t bits;
+
+	std::memcpy(&bits, &value, sizeof(bits));
+
+	return Logger::PackNumber(args, len, 'f', bits);
+}
+
+inline
+size_t Logger::PackArg(uint8_t* args, size_t len, const char* value)
+{
+	return Logger::PackString(args, len, value);
+}
+
+inline
+size_t Logger::PackArg(uint8_t* args, size_t len, char* value)
+{
+	return Logger::PackString(args, len, value);
+}
+
+template<typename T>
+inline
+size_t Logger::PackArg(uint8_t* args, size_t len, T* value)
+{
+	return Logger::PackNumber(args, len, 'p', (uint64_t)(uintptr_t)value);
+}
+
+/* Lowest log level compiled into the current source file. */
+
+namespace
+{
+	constexpr LogLevel ms_logger_min_level = static_cast<LogLevel>(_MS_LOG_MIN_LEVEL);
+}
+
 /* Logging macros. */
 
 #define _MS_LOG_SEPARATOR_CHAR_STD "\n"
@@ -118,21 +343,22 @@ public:
 	#define _MS_LOG_STR "[%s] %s:%d | %s::%s()"
 	#define _MS_LOG_STR_DESC _MS_LOG_STR " | "
 	#define _MS_FILE (std::strchr(__FILE__, '/') ? std::strchr(__FILE__, '/') + 1 : __FILE__)
-	#define _MS_LOG_ARG ("id:" + Logger::id).c_str(), _MS_FILE, __LINE__, MS_CLASS, __FUNCTION__
+	#define _MS_LOG_ARG Logger::idTag.c_str(), _MS_FILE, __LINE__, MS_CLASS, __FUNCTION__
+	#define _MS_DEFER(level, desc, ...) Logger::Defer(level, _MS_FILE, __LINE__, MS_CLASS, __FUNCTION__, desc, ##__VA_ARGS__)
 #else
 	#define _MS_LOG_STR "[%s] %s::%s()"
 	#define _MS_LOG_STR_DESC _MS_LOG_STR " | "
-	#define _MS_LOG_ARG ("id:" + Logger::id).c_str(), MS_CLASS, __FUNCTION__
+	#define _MS_LOG_ARG Logger::idTag.c_str(), MS_CLASS, __FUNCTION__
+	#define _MS_DEFER(level, desc, ...) Logger::Defer(level, nullptr, 0, MS_CLASS, __FUNCTION__, desc, ##__VA_ARGS__)
 #endif
 
 #ifdef MS_LOG_TRACE
 	#define MS_TRACE() \
 		do \
 		{ \
-			if (LogLevel::LOG_DEBUG == Settings::configuration.logLevel) \
+			if (_MS_LOG_COMPILED(LOG_DEBUG) && LogLevel::LOG_DEBUG == Settings::configuration.logLevel) \
 			{ \
-				int ms_logger_written = std::snprintf(Logger::buffer, MS_LOGGER_BUFFER_SIZE, "D(trace) " _MS_LOG_STR, _MS_LOG_ARG); \
-				Logger::channel->SendLog(Logger::buffer, ms_logger_written); \
+				_MS_DEFER('t', ""); \
 			} \
 		} \
 		while (0)
@@ -140,7 +366,7 @@ public:
 	#define MS_TRACE_STD() \
 		do \
 		{ \
-			if (LogLevel::LOG_DEBUG == Settings::configuration.logLevel) \
+			if (_MS_LOG_COMPILED(LOG_DEBUG) && LogLevel::LOG_DEBUG == Settings::configuration.logLevel) \
 			{ \
 				std::fprintf(stdout, "(trace) " _MS_LOG_STR _MS_LOG_SEPARATOR_CHAR_STD, _MS_LOG_ARG); \
 				std::fflush(stdout); \
@@ -155,10 +381,9 @@ public:
 #define MS_DEBUG_TAG(tag, desc, ...) \
 	do \
 	{ \
-		if (LogLevel::LOG_DEBUG == Settings::configuration.logLevel && (_MS_TAG_ENABLED(tag) || _MS_LOG_DEV_ENABLED)) \
+		if (_MS_LOG_COMPILED(LOG_DEBUG) && LogLevel::LOG_DEBUG == Settings::configuration.logLevel && (_MS_TAG_ENABLED(tag) || _MS_LOG_DEV_ENABLED)) \
 		{ \
-			int ms_logger_written = std::snprintf(Logger::buffer, MS_LOGGER_BUFFER_SIZE, "D" _MS_LOG_STR_DESC desc, _MS_LOG_ARG, ##__VA_ARGS__); \
-			Logger::channel->SendLog(Logger::buffer, ms_logger_written); \
+			_MS_DEFER('D', desc, ##__VA_ARGS__); \
 		} \
 	} \
 	while (0)
@@ -166,7 +391,7 @@ public:
 #define MS_DEBUG_TAG_STD(tag, desc, ...) \
 	do \
 	{ \
-		if (LogLevel::LOG_DEBUG == Settings::configuration.logLevel && (_MS_TAG_ENABLED(tag) || _MS_LOG_DEV_ENABLED)) \
+		if (_MS_LOG_COMPILED(LOG_DEBUG) && LogLevel::LOG_DEBUG == Settings::configuration.logLevel && (_MS_TAG_ENABLED(tag) || _MS_LOG_DEV_ENABLED)) \
 		{ \
 			std::fprintf(stdout, _MS_LOG_STR_DESC desc _MS_LOG_SEPARATOR_CHAR_STD, _MS_LOG_ARG, ##__VA_ARGS__); \
 			std::fflush(stdout); \
@@ -177,10 +402,9 @@ public:
 #define MS_WARN_TAG(tag, desc, ...) \
 	do \
 	{ \
-		if (LogLevel::LOG_WARN <= Settings::configuration.logLevel && (_MS_TAG_ENABLED(tag) || _MS_LOG_DEV_ENABLED)) \
+		if (_MS_LOG_COMPILED(LOG_WARN) && LogLevel::LOG_WARN <= Settings::configuration.logLevel && (_MS_TAG_ENABLED(tag) || _MS_LOG_DEV_ENABLED)) \
 		{ \
-			int ms_logger_written = std::snprintf(Logger::buffer, MS_LOGGER_BUFFER_SIZE, "W" _MS_LOG_STR_DESC desc, _MS_LOG_ARG, ##__VA_ARGS__); \
-			Logger::channel->SendLog(Logger::buffer, ms_logger_written); \
+			_MS_DEFER('W', desc, ##__VA_ARGS__); \
 		} \
 	} \
 	while (0)
@@ -188,7 +412,7 @@ public:
 #define MS_WARN_TAG_STD(tag, desc, ...) \
 	do \
 	{ \
-		if (LogLevel::LOG_WARN <= Settings::configuration.logLevel && (_MS_TAG_ENABLED(tag) || _MS_LOG_DEV_ENABLED)) \
+		if (_MS_LOG_COMPILED(LOG_WARN) && LogLevel::LOG_WARN <= Settings::configuration.logLevel && (_MS_TAG_ENABLED(tag) || _MS_LOG_DEV_ENABLED)) \
 		{ \
 			std::fprintf(stderr, _MS_LOG_STR_DESC desc _MS_LOG_SEPARATOR_CHAR_STD, _MS_LOG_ARG, ##__VA_ARGS__); \
 			std::fflush(stderr); \
@@ -199,10 +423,9 @@ public:
 #define MS_DEBUG_2TAGS(tag1, tag2, desc, ...) \
 	do \
 	{ \
-		if (LogLevel::LOG_DEBUG == Settings::configuration.logLevel && (_MS_TAG_ENABLED_2(tag1, tag2) || _MS_LOG_DEV_ENABLED)) \
+		if (_MS_LOG_COMPILED(LOG_DEBUG) && LogLevel::LOG_DEBUG == Settings::configuration.logLevel && (_MS_TAG_ENABLED_2(tag1, tag2) || _MS_LOG_DEV_ENABLED)) \
 		{ \
-			int ms_logger_written = std::snprintf(Logger::buffer, MS_LOGGER_BUFFER_SIZE, "D" _MS_LOG_STR_DESC desc, _MS_LOG_ARG, ##__VA_ARGS__); \
-			Logger::channel->SendLog(Logger::buffer, ms_logger_written); \
+			_MS_DEFER('D', desc, ##__VA_ARGS__); \
 		} \
 	} \
 	while (0)
@@ -210,7 +433,7 @@ public:
 #define MS_DEBUG_2TAGS_STD(tag, desc, ...) \
 	do \
 	{ \
-		if (LogLevel::LOG_DEBUG == Settings::configuration.logLevel && (_MS_TAG_ENABLED_2(tag1, tag2) || _MS_LOG_DEV_ENABLED)) \
+		if (_MS_LOG_COMPILED(LOG_DEBUG) && LogLevel::LOG_DEBUG == Settings::configuration.logLevel && (_MS_TAG_ENABLED_2(tag1, tag2) || _MS_LOG_DEV_ENABLED)) \
 		{ \
 			std::fprintf(stdout, _MS_LOG_STR_DESC desc _MS_LOG_SEPARATOR_CHAR_STD, _MS_LOG_ARG, ##__VA_ARGS__); \
 			std::fflush(stdout); \
@@ -221,10 +444,9 @@ public:
 #define MS_WARN_2TAGS(tag1, tag2, desc, ...) \
 	do \
 	{ \
-		if (LogLevel::LOG_WARN <= Settings::configuration.logLevel && (_MS_TAG_ENABLED_2(tag1, tag2) || _MS_LOG_DEV_ENABLED)) \
+		if (_MS_LOG_COMPILED(LOG_WARN) && LogLevel::LOG_WARN <= Settings::configuration.logLevel && (_MS_TAG_ENABLED_2(tag1, tag2) || _MS_LOG_DEV_ENABLED)) \
 		{ \
-			int ms_logger_written = std::snprintf(Logger::buffer, MS_LOGGER_BUFFER_SIZE, "W" _MS_LOG_STR_DESC desc, _MS_LOG_ARG, ##__VA_ARGS__); \
-			Logger::channel->SendLog(Logger::buffer, ms_logger_written); \
+			_MS_DEFER('W', desc, ##__VA_ARGS__); \
 		} \
 	} \
 	while (0)
@@ -232,7 +454,7 @@ public:
 #define MS_WARN_2TAGS_STD(tag1, tag2, desc, ...) \
 	do \
 	{ \
-		if (LogLevel::LOG_WARN <= Settings::configuration.logLevel && (_MS_TAG_ENABLED_2(tag1, tag2) || _MS_LOG_DEV_ENABLED)) \
+		if (_MS_LOG_COMPILED(LOG_WARN) && LogLevel::LOG_WARN <= Settings::configuration.logLevel && (_MS_TAG_ENABLED_2(tag1, tag2) || _MS_LOG_DEV_ENABLED)) \
 		{ \
 			std::fprintf(stderr, _MS_LOG_STR_DESC desc _MS_LOG_SEPARATOR_CHAR_STD, _MS_LOG_ARG, ##__VA_ARGS__); \
 			std::fflush(stderr); \
@@ -244,10 +466,9 @@ public:
 	#define MS_DEBUG_DEV(desc, ...) \
 		do \
 		{ \
-			if (LogLevel::LOG_DEBUG == Settings::configuration.logLevel) \
+			if (_MS_LOG_COMPILED(LOG_DEBUG) && LogLevel::LOG_DEBUG == Settings::configuration.logLevel) \
 			{ \
-				int ms_logger_written = std::snprintf(Logger::buffer, MS_LOGGER_BUFFER_SIZE, "D" _MS_LOG_STR_DESC desc, _MS_LOG_ARG, ##__VA_ARGS__); \
-				Logger::channel->SendLog(Logger::buffer, ms_logger_written); \
+				_MS_DEFER('D', desc, ##__VA_ARGS__); \
 			} \
 		} \
 		while (0)
@@ -255,7 +476,7 @@ public:
 	#define MS_DEBUG_DEV_STD(desc, ...) \
 		do \
 		{ \
-			if (LogLevel::LOG_DEBUG == Settings::configuration.logLevel) \
+			if (_MS_LOG_COMPILED(LOG_DEBUG) && LogLevel::LOG_DEBUG == Settings::configuration.logLevel) \
 			{ \
 				std::fprintf(stdout, _MS_LOG_STR_DESC desc _MS_LOG_SEPARATOR_CHAR_STD, _MS_LOG_ARG, ##__VA_ARGS__); \
 				std::fflush(stdout); \
@@ -266,10 +487,9 @@ public:
 	#define MS_WARN_DEV(desc, ...) \
 		do \
 		{ \
-			if (LogLevel::LOG_WARN <= Settings::configuration.logLevel) \
+			if (_MS_LOG_COMPILED(LOG_WARN) && LogLevel::LOG_WARN <= Settings::configuration.logLevel) \
 			{ \
-				int ms_logger_written = std::snprintf(Logger::buffer, MS_LOGGER_BUFFER_SIZE, "W" _MS_LOG_STR_DESC desc, _MS_LOG_ARG, ##__VA_ARGS__); \
-				Logger::channel->SendLog(Logger::buffer, ms_logger_written); \
+				_MS_DEFER('W', desc, ##__VA_ARGS__); \
 			} \
 		} \
 		while (0)
@@ -277,7 +497,7 @@ public:
 	#define MS_WARN_DEV_STD(desc, ...) \
 		do \
 		{ \
-			if (LogLevel::LOG_WARN <= Settings::configuration.logLevel) \
+			if (_MS_LOG_COMPILED(LOG_WARN) && LogLevel::LOG_WARN <= Settings::configuration.logLevel) \
 			{ \
 				std::fprintf(stderr, _MS_LOG_STR_DESC desc _MS_LOG_SEPARATOR_CHAR_STD, _MS_LOG_ARG, ##__VA_ARGS__); \
 				std::fflush(stderr); \
@@ -294,6 +514,7 @@ public:
 #define MS_DUMP(desc, ...) \
 	do \
 	{ \
+		Logger::Flush(); \
 		int ms_logger_written = std::snprintf(Logger::buffer, MS_LOGGER_BUFFER_SIZE, "D" _MS_LOG_STR_DESC desc, _MS_LOG_ARG, ##__VA_ARGS__); \
 		Logger::channel->SendLog(Logger::buffer, ms_logger_written); \
 	} \
@@ -310,6 +531,7 @@ public:
 #define MS_ERROR(desc, ...) \
 	do \
 	{ \
+		Logger::Flush(); \
 		int ms_logger_written = std::snprintf(Logger::buffer, MS_LOGGER_BUFFER_SIZE, "E" _MS_LOG_STR_DESC desc, _MS_LOG_ARG, ##__VA_ARGS__); \
 		Logger::channel->SendLog(Logger::buffer, ms_logger_written); \
 	} \
@@ -328,6 +550,7 @@ public:
 	{ \
 		std::fprintf(stderr, "ABORT" _MS_LOG_STR_DESC desc _MS_LOG_SEPARATOR_CHAR_STD, _MS_LOG_ARG, ##__VA_ARGS__); \
 		std::fflush(stderr); \
+		Logger::FlushOnAbort(); \
 		std::abort(); \
 	} \
 	while (0)
@@ -0,0 +1,127 @@
+#ifndef MS_RTC_AUDIO_LEVEL_OBSERVER_HPP
+#define MS_RTC_AUDIO_LEVEL_OBSERVER_HPP
+
+#include "common.hpp"
+#include "RTC/RtpPacket.hpp"
+#include <unordered_map>
+#include <json/json.h>
+
+namespace RTC
+{
+	/**
+	 * Tracks the ssrc-audio-level of the audio streams of a room (identified by
+	 * their RtpReceiver id) to select the dominant speaker and, if lastN is not
+	 * 0, the N loudest streams that are forwarded to the RtpSenders.
+	 *
+	 * Levels are smoothed per packet and the selection is evaluated every
+	 * Interval ms. A stream replaces a selected one (or the dominant speaker)
+	 * just if it is louder by Hysteresis dB and the replaced one has been
+	 * selected for MinHoldTime ms at least. Streams without audio level are
+	 * always forwarded.
+	 *
+	 * If a silence threshold is set, packets at or below it are dropped once
+	 * the stream has been silent for SilenceGracePeriod ms, but one of them is
+	 * still forwarded every ComfortInterval ms so the remote peers keep
+	 * playing comfort noise.
+	 */
+	class AudioLevelObserver
+	{
+	public:
+		class Listener
+		{
+		public:
+			virtual void onAudioLevelObserverDominantSpeaker(RTC::AudioLevelObserver* audioLevelObserver, uint32_t streamId) = 0;
+		};
+
+	public:
+		// Time (ms) between evaluations.
+		static constexpr uint64_t Interval = 300;
+		// Min difference (dB) for a stream to replace a selected one.
+		static constexpr uint8_t Hysteresis = 6;
+		// Min time (ms) a stream is kept selected.
+		static constexpr uint64_t MinHoldTime = 1000;
+		// Time (ms) without packets after which a stream is considered silent.
+		static constexpr uint64_t MaxIdleTime = 1000;
+		// Weight of a new level sample in the smoothed level.
+		static constexpr double SmoothingFactor = 0.125;
+		// Time (ms) a stream must be silent before its packets are dropped.
+		static constexpr uint64_t SilenceGracePeriod = 500;
+		// Time (ms) between forwarded packets of a silent stream.
+		static constexpr uint64_t ComfortInterval = 400;
+
+	public:
+		AudioLevelObserver(Listener* listener, size_t lastN = 0);
+
+		Json::Value toJson() const;
+		void SetSilenceThreshold(int32_t dBov);
+		bool ReceivePacket(uint32_t streamId, RTC::RtpPacket* packet, uint64_t now, bool* resumed);
+		void RemoveStream(uint32_t streamId);
+		bool IsForwarded(uint32_t streamId) const;
+		bool HasDominantSpeaker() const;
+		uint32_t GetDominantSpeaker() const;
+		size_t GetLastN() const;
+
+	private:
+		struct Stream
+		{
+			bool hasLevel = false;
+			// Smoothed level in dB over silence (0 is silence, 127 the loudest).
+			double level = 0;
+			uint64_t lastPacketAt = 0;
+			bool selected = false;
+			uint64_t selectedAt = 0;
+			// Whether packets were dropped since the last forwarded one.
+			bool paused = false;
+			bool silent = false;
+			uint64_t silentSince = 0;
+			uint64_t lastForwardedAt = 0;
+		};
+
+	private:
+		void Evaluate(uint64_t now);
+		void UpdateSelection(uint64_t now);
+		void UpdateDominantSpeaker(uint64_t now);
+
+	private:
+		// Passed by argument.
+		Listener* listener = nullptr;
+		size_t lastN = 0;
+		// Others.
+		// Audio level (-dBov) from which packets are silent (0 means disabled).
+		uint8_t silenceVolume = 0;
+		std::unordered_map<uint32_t, Stream> streams;
+		size_t numSelected = 0;
+		uint64_t lastEvaluationAt = 0;
+		bool hasDominantSpeaker = false;
+		uint32_t dominantSpeaker = 0;
+		uint64_t dominantSpeakerAt = 0;
+		// Stats.
+		size_t forwardedPackets = 0;
+		size_t droppedPackets = 0;
+		size_t suppressedPackets = 0;
+		size_t selectionChanges = 0;
+		size_t dominantSpeakerChanges = 0;
+	};
+
+	/* Inline instance methods. */
+
+	inline
+	bool AudioLevelObserver::HasDominantSpeaker() const
+	{
+		return this->hasDominantSpeaker;
+	}
+
+	inline
+	uint32_t AudioLevelObserver::GetDominantSpeaker() const
+	{
+		return this->dominantSpeaker;
+	}
+
+	inline
+	size_t AudioLevelObserver::GetLastN() const
+	{
+		return this->lastN;
+	}
+}
+
+#endif
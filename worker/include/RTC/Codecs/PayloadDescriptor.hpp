@@ -0,0 +1,40 @@
+#ifndef MS_RTC_CODECS_PAYLOAD_DESCRIPTOR_HPP
+#define MS_RTC_CODECS_PAYLOAD_DESCRIPTOR_HPP
+
+#include "common.hpp"
+
+namespace RTC { namespace Codecs
+{
+	/**
+	 * Codec independent view of the RTP payload descriptor (VP8, VP9) or NAL
+	 * unit header (H264, H265). The offsets allow rewriting the picture id and
+	 * TL0PICIDX in place.
+	 */
+	struct PayloadDescriptor
+	{
+		// Whether the packet starts a frame (VP8), a layer frame (VP9) or a NAL
+		// unit (H264, H265).
+		bool startOfFrame = false;
+		// Whether the packet ends a layer frame (VP9) or a NAL unit (H264, H265).
+		bool endOfFrame = false;
+		bool isKeyFrame = false;
+		bool hasPictureId = false;
+		bool hasLongPictureId = false;
+		uint16_t pictureId = 0;
+		size_t pictureIdOffset = 0;
+		bool hasTl0PicIdx = false;
+		uint8_t tl0PicIdx = 0;
+		size_t tl0PicIdxOffset = 0;
+		uint8_t temporalLayer = 0;
+		// Whether the packet carries a spatial layer index (just VP9).
+		bool hasSpatialLayers = false;
+		uint8_t spatialLayer = 0;
+		// Whether it is safe to switch up to this temporal layer.
+		bool layerSync = false;
+		// Length of the payload descriptor (just VP8 and VP9), this is, offset of
+		// the codec bitstream.
+		size_t payloadOffset = 0;
+	};
+}}
+
+#endif
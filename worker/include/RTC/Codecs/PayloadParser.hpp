@@ -0,0 +1,39 @@
+#ifndef MS_RTC_CODECS_PAYLOAD_PARSER_HPP
+#define MS_RTC_CODECS_PAYLOAD_PARSER_HPP
+
+#include "common.hpp"
+#include "RTC/RtpDictionaries.hpp"
+#include "RTC/Codecs/PayloadDescriptor.hpp"
+
+namespace RTC { namespace Codecs
+{
+	/**
+	 * Payload parser for the given codec. Just the specializations below are
+	 * defined. Parse() returns false if the payload is malformed.
+	 */
+	template<RTC::RtpCodecMime::Subtype subtype> class PayloadParser
+	{
+	public:
+		static bool Parse(const uint8_t* data, size_t len, PayloadDescriptor& descriptor);
+	};
+
+	/* Specializations. */
+
+	// DOC: https://tools.ietf.org/html/rfc7741#section-4.2
+	template<>
+	bool PayloadParser<RTC::RtpCodecMime::Subtype::VP8>::Parse(const uint8_t* data, size_t len, PayloadDescriptor& descriptor);
+
+	// DOC: https://tools.ietf.org/html/draft-ietf-payload-vp9
+	template<>
+	bool PayloadParser<RTC::RtpCodecMime::Subtype::VP9>::Parse(const uint8_t* data, size_t len, PayloadDescriptor& descriptor);
+
+	// DOC: https://tools.ietf.org/html/rfc6184
+	template<>
+	bool PayloadParser<RTC::RtpCodecMime::Subtype::H264>::Parse(const uint8_t* data, size_t len, PayloadDescriptor& descriptor);
+
+	// DOC: https://tools.ietf.org/html/rfc7798
+	template<>
+	bool PayloadParser<RTC::RtpCodecMime::Subtype::H265>::Parse(const uint8_t* data, size_t len, PayloadDescriptor& descriptor);
+}}
+
+#endif
@@ -0,0 +1,60 @@
+#ifndef MS_RTC_CODECS_TOOLS_HPP
+#define MS_RTC_CODECS_TOOLS_HPP
+
+#include "common.hpp"
+#include "RTC/RtpDictionaries.hpp"
+#include "RTC/Codecs/PayloadDescriptor.hpp"
+
+namespace RTC { namespace Codecs
+{
+	/**
+	 * Codec specific helpers for RTP payloads.
+	 */
+	class Tools
+	{
+	public:
+		/**
+		 * Parse the payload of VP8, VP9, H264 and H265 packets. It returns false
+		 * for other codecs or if the payload is malformed.
+		 */
+		static bool ParsePayloadDescriptor(const RTC::RtpCodecMime& mime, const uint8_t* data, size_t len, PayloadDescriptor& descriptor);
+		/**
+		 * Whether the given RTP payload starts (or contains) a key frame. It
+		 * always returns true for non video codecs, so any packet is a valid
+		 * switching point for them.
+		 */
+		static bool IsKeyFrame(const RTC::RtpCodecMime& mime, const uint8_t* data, size_t len);
+		static void SetPictureId(uint8_t* data, const PayloadDescriptor& descriptor, uint16_t pictureId);
+		static void SetTl0PicIdx(uint8_t* data, const PayloadDescriptor& descriptor, uint8_t tl0PicIdx);
+	};
+
+	/* Inline static methods. */
+
+	inline
+	void Tools::SetPictureId(uint8_t* data, const PayloadDescriptor& descriptor, uint16_t pictureId)
+	{
+		if (!descriptor.hasPictureId)
+			return;
+
+		if (descriptor.hasLongPictureId)
+		{
+			data[descriptor.pictureIdOffset] = 0x80 | ((pictureId >> 8) & 0x7F);
+			data[descriptor.pictureIdOffset + 1] = pictureId & 0xFF;
+		}
+		else
+		{
+			data[descriptor.pictureIdOffset] = pictureId & 0x7F;
+		}
+	}
+
+	inline
+	void Tools::SetTl0PicIdx(uint8_t* data, const PayloadDescriptor& descriptor, uint8_t tl0PicIdx)
+	{
+		if (!descriptor.hasTl0PicIdx)
+			return;
+
+		data[descriptor.tl0PicIdxOffset] = tl0PicIdx;
+	}
+}}
+
+#endif
@@ -0,0 +1,100 @@
+#ifndef MS_RTC_FEC_GENERATOR_HPP
+#define MS_RTC_FEC_GENERATOR_HPP
+
+#include "common.hpp"
+#include "RTC/RtpPacket.hpp"
+#include <json/json.h>
+
+namespace RTC
+{
+	/**
+	 * Generates FlexFEC (draft-ietf-payload-flexible-fec-scheme-03) packets for
+	 * a media stream. Each FEC packet is the XOR of a group of consecutive media
+	 * packets so the remote peer can recover one lost packet of the group
+	 * without waiting for a retransmission.
+	 *
+	 * The group size follows the fraction lost reported by the remote peer (the
+	 * more loss, the smaller the groups) and no FEC is generated without loss.
+	 * A group is closed once it has groupSize packets, or at the end of a frame
+	 * if it has half of them at least.
+	 *
+	 * The transport-wide sequence number (if any) is stamped by the Transport
+	 * once the packet leaves, so its value is not protected (it is XORed as
+	 * zero) and FEC packets carry the extension too so they are also reported
+	 * in transport-cc feedback.
+	 */
+	class FecGenerator
+	{
+	public:
+		// Max number of media packets protected by a FEC packet (so the mask fits
+		// in its shortest form).
+		static constexpr size_t MaxGroupSize = 15;
+		static constexpr size_t MinGroupSize = 2;
+		// Media packets bigger than this are not protected.
+		static constexpr size_t MaxMediaPacketSize = 1500;
+
+	private:
+		static constexpr size_t RtpHeaderSize = 12;
+		static constexpr size_t FecHeaderSize = 20;
+		// One-byte header extension with just the transport-wide sequence number.
+		static constexpr size_t ExtensionSize = 8;
+
+	private:
+		// Buffer to build the FEC packets.
+		static uint8_t buffer[];
+
+	public:
+		static void Xor(uint8_t* dst, const uint8_t* src, size_t len);
+
+	public:
+		FecGenerator(uint32_t ssrc, uint8_t payloadType, uint8_t transportWideCcId = 0);
+
+		Json::Value toJson() const;
+		void SetFractionLost(uint8_t fractionLost);
+		size_t GetGroupSize() const;
+		RTC::RtpPacket* AddPacket(RTC::RtpPacket* packet);
+
+	private:
+		RTC::RtpPacket* CreateFecPacket();
+
+	public:
+		// Passed by argument.
+		uint32_t ssrc = 0;
+		uint8_t payloadType = 0;
+		uint8_t transportWideCcId = 0;
+
+	private:
+		// Others.
+		uint16_t seq = 0;
+		// Number of media packets per FEC packet (0 means disabled).
+		size_t groupSize = 0;
+		// Current group.
+		size_t numPackets = 0;
+		uint32_t mediaSsrc = 0;
+		uint16_t baseSeq = 0;
+		uint16_t mask = 0;
+		uint32_t lastTimestamp = 0;
+		// XOR of the first two bytes, lengths (minus the RTP header), timestamps
+		// and the rest of the protected packets.
+		uint8_t byte0Recovery = 0;
+		uint8_t byte1Recovery = 0;
+		uint16_t lengthRecovery = 0;
+		uint32_t timestampRecovery = 0;
+		uint8_t recovery[MaxMediaPacketSize - RtpHeaderSize];
+		size_t recoveryLength = 0;
+		// Stats.
+		size_t protectedPackets = 0;
+		size_t fecPackets = 0;
+		size_t fecBytes = 0;
+	};
+
+	/* Inline instance methods. */
+
+	inline
+	size_t FecGenerator::GetGroupSize() const
+	{
+		return this->groupSize;
+	}
+}
+
+#endif
@@ -0,0 +1,97 @@
+#ifndef MS_RTC_KEY_FRAME_CACHE_HPP
+#define MS_RTC_KEY_FRAME_CACHE_HPP
+
+#include "common.hpp"
+#include "RTC/RtpPacket.hpp"
+#include <vector>
+#include <json/json.h>
+
+namespace RTC
+{
+	/**
+	 * Keeps the packets of the most recent key frame of a video stream and the
+	 * following ones (the GOP) so new RtpSenders can be primed with them
+	 * instead of waiting for the next key frame.
+	 *
+	 * If the GOP does not fit into maxPackets just the key frame is kept.
+	 *
+	 * Packets are cloned into fixed size buffers taken from a pool shared by
+	 * all the caches so no memory is allocated per packet once warmed up.
+	 */
+	class KeyFrameCache
+	{
+	public:
+		static constexpr size_t BufferSize = 1500;
+		static constexpr size_t MaxPoolSize = 4096;
+		static constexpr size_t DefaultMaxPackets = 256;
+
+	public:
+		static void ClassDestroy();
+
+	private:
+		static uint8_t* GetBuffer();
+		static void ReleaseBuffer(uint8_t* buffer);
+
+	private:
+		static std::vector<uint8_t*> bufferPool;
+
+	public:
+		explicit KeyFrameCache(size_t maxPackets);
+		~KeyFrameCache();
+
+		void ReceivePacket(RTC::RtpPacket* packet);
+		bool HasKeyFrame() const;
+		bool IsGopComplete() const;
+		const std::vector<RTC::RtpPacket*>& GetPackets() const;
+		size_t GetKeyFramePackets() const;
+		Json::Value toJson() const;
+
+	private:
+		void Clear();
+
+	private:
+		// Passed by argument.
+		size_t maxPackets;
+		// Allocated by this.
+		std::vector<RTC::RtpPacket*> packets;
+		// Taken from the pool (one per cached packet).
+		std::vector<uint8_t*> buffers;
+		// Others.
+		bool hasKeyFrame = false;
+		// Whether every packet since the key frame is cached.
+		bool gopComplete = false;
+		uint32_t keyFrameTimestamp = 0;
+		// Number of cached packets belonging to the key frame itself.
+		size_t keyFramePackets = 0;
+		size_t numKeyFrames = 0;
+		size_t numOverflows = 0;
+	};
+
+	/* Inline methods. */
+
+	inline
+	bool KeyFrameCache::HasKeyFrame() const
+	{
+		return this->hasKeyFrame;
+	}
+
+	inline
+	bool KeyFrameCache::IsGopComplete() const
+	{
+		return this->gopComplete;
+	}
+
+	inline
+	const std::vector<RTC::RtpPacket*>& KeyFrameCache::GetPackets() const
+	{
+		return this->packets;
+	}
+
+	inline
+	size_t KeyFrameCache::GetKeyFramePackets() const
+	{
+		return this->keyFramePackets;
+	}
+}
+
+#endif
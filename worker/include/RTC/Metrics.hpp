@@ -0,0 +1,191 @@
+#ifndef MS_RTC_METRICS_HPP
+#define MS_RTC_METRICS_HPP
+
+#include "common.hpp"
+#include "RTC/RtpDictionaries.hpp"
+#include "RTC/RtpDataCounter.hpp"
+#include <string>
+#include <vector>
+#include <unordered_set>
+#include <uv.h>
+#include <json/json.h>
+
+namespace RTC
+{
+	/**
+	 * Worker metrics, exported by the worker.getStats request.
+	 *
+	 * Transports, RtpReceivers and RtpSenders register their counters here
+	 * once created, and the histograms are fed as packets are handled, so
+	 * getting the stats just reads a flat set of counters instead of building
+	 * the JSON dump of every Room.
+	 */
+	class Metrics
+	{
+	public:
+		/**
+		 * Log-linear histogram of unsigned values: each power of two is split
+		 * into SubBuckets linear buckets (so the error is below 25%). Values
+		 * above 2^32 - 1 are counted in the last bucket.
+		 */
+		class Histogram
+		{
+		public:
+			static constexpr size_t SubBuckets = 4;
+			static constexpr size_t NumBuckets = SubBuckets + (32 - 2) * SubBuckets;
+
+		public:
+			static uint64_t GetBucketUpperBound(size_t idx);
+
+		private:
+			static size_t GetBucket(uint64_t value);
+
+		public:
+			explicit Histogram(const char* name);
+
+			void Add(uint64_t value);
+			void Reset();
+			Json::Value toJson() const;
+			void WritePrometheus(std::string& out, const std::string& labels) const;
+
+		public:
+			// Passed by argument.
+			const char* name = nullptr;
+
+		private:
+			// Others.
+			uint64_t buckets[NumBuckets] = { 0 };
+			uint64_t count = 0;
+			uint64_t sum = 0;
+		};
+
+	public:
+		struct TransportCounters
+		{
+			uint32_t transportId = 0;
+			uint64_t rtpPacketsReceived = 0;
+			uint64_t rtpBytesReceived = 0;
+			uint64_t rtpPacketsSent = 0;
+			uint64_t rtpBytesSent = 0;
+			uint64_t rtcpPacketsReceived = 0;
+			uint64_t rtcpBytesReceived = 0;
+			uint64_t rtcpPacketsSent = 0;
+			uint64_t rtcpBytesSent = 0;
+		};
+
+		// Counters of a RtpReceiver (received and RTX) or a RtpSender
+		// (transmitted and retransmitted).
+		struct StreamCounters
+		{
+			uint32_t id = 0;
+			RTC::Media::Kind kind = RTC::Media::Kind::ALL;
+			const RTC::RtpDataCounter* counter = nullptr;
+			const RTC::RtpDataCounter* rtxCounter = nullptr;
+		};
+
+	public:
+		static void AddTransport(const TransportCounters* counters);
+		static void RemoveTransport(const TransportCounters* counters);
+		static void AddRtpReceiver(const StreamCounters* counters);
+		static void RemoveRtpReceiver(const StreamCounters* counters);
+		static void AddRtpSender(const StreamCounters* counters);
+		static void RemoveRtpSender(const StreamCounters* counters);
+		static void BeginForwarding();
+		static void EndForwarding();
+		static uint64_t GetForwardingStartTime();
+		static void SetForwardingStartTime(uint64_t time);
+		static void PacketForwarded();
+		static Json::Value toJson();
+		static std::string GetPrometheusText();
+
+	private:
+		static uint64_t GetTimeUs();
+
+	public:
+		static size_t numRooms;
+		static size_t numPeers;
+		// Jitter of the received streams (ms), once per Receiver Report.
+		static Histogram jitter;
+		// RTT with the remote peers (ms), once per Receiver Report.
+		static Histogram rtt;
+		// Size of the received RTP packets (bytes).
+		static Histogram packetSize;
+		// Time from the reception of a RTP packet to the sending of the packets
+		// forwarded out of it, including the pacer queue (us).
+		static Histogram forwardingLatency;
+
+	private:
+		static std::unordered_set<const TransportCounters*> transports;
+		static std::unordered_set<const StreamCounters*> rtpReceivers;
+		static std::unordered_set<const StreamCounters*> rtpSenders;
+		// Reception time (us) of the RTP packet being forwarded (0 if none).
+		static uint64_t forwardingStartTime;
+	};
+
+	/* Inline static methods. */
+
+	inline
+	uint64_t Metrics::GetTimeUs()
+	{
+		return uv_hrtime() / 1000;
+	}
+
+	inline
+	void Metrics::BeginForwarding()
+	{
+		Metrics::forwardingStartTime = GetTimeUs();
+	}
+
+	inline
+	void Metrics::EndForwarding()
+	{
+		Metrics::forwardingStartTime = 0;
+	}
+
+	inline
+	uint64_t Metrics::GetForwardingStartTime()
+	{
+		return Metrics::forwardingStartTime;
+	}
+
+	inline
+	void Metrics::SetForwardingStartTime(uint64_t time)
+	{
+		Metrics::forwardingStartTime = time;
+	}
+
+	inline
+	void Metrics::PacketForwarded()
+	{
+		if (Metrics::forwardingStartTime)
+			Metrics::forwardingLatency.Add(GetTimeUs() - Metrics::forwardingStartTime);
+	}
+
+	inline
+	size_t Metrics::Histogram::GetBucket(uint64_t value)
+	{
+		if (value < SubBuckets)
+			return value;
+
+		if (value > 0xFFFFFFFF)
+			return NumBuckets - 1;
+
+		// Position of the most significant bit (2 at least).
+		size_t exponent = 63 - __builtin_clzll(value);
+		size_t subBucket = (value >> (exponent - 2)) & (SubBuckets - 1);
+
+		return SubBuckets + (exponent - 2) * SubBuckets + subBucket;
+	}
+
+	/* Inline instance methods. */
+
+	inline
+	void Metrics::Histogram::Add(uint64_t value)
+	{
+		this->buckets[GetBucket(value)]++;
+		this->count++;
+		this->sum += value;
+	}
+}
+
+#endif
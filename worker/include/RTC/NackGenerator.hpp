@@ -0,0 +1,128 @@
+#ifndef MS_RTC_NACK_GENERATOR_HPP
+#define MS_RTC_NACK_GENERATOR_HPP
+
+#include "common.hpp"
+#include "RTC/RtpPacket.hpp"
+#include "handles/Timer.hpp"
+#include <map>
+#include <set>
+#include <vector>
+#include <unordered_set>
+#include <json/json.h>
+
+namespace RTC
+{
+	/**
+	 * Keeps the list of missing packets of a receive stream and asks the sender
+	 * for them until they arrive, they are too old or they were requested too
+	 * many times.
+	 *
+	 * A missing packet is NACKed as soon as the gap is noticed and then once per
+	 * RTT. All the generators are driven by a single timer so the retries of
+	 * every stream are batched in a tick. If the list overflows (or a packet is
+	 * given up) a key frame is required instead.
+	 */
+	class NackGenerator
+	{
+	public:
+		class Listener
+		{
+		public:
+			virtual void onNackGeneratorNackRequired(RTC::NackGenerator* nackGenerator, const std::vector<uint16_t>& seqNumbers) = 0;
+			virtual void onNackGeneratorKeyFrameRequired(RTC::NackGenerator* nackGenerator) = 0;
+		};
+
+	private:
+		class Ticker :
+			public Timer::Listener
+		{
+		/* Pure virtual methods inherited from Timer::Listener. */
+		public:
+			virtual void onTimer(Timer* timer) override;
+		};
+
+	public:
+		static constexpr size_t MaxNackPackets = 500;
+		static constexpr size_t MaxKeyFramePackets = 100;
+		static constexpr uint8_t MaxRetries = 10;
+		// Max time (ms) a missing packet is requested.
+		static constexpr uint64_t MaxAge = 1000;
+		// RTT (ms) used until one is known.
+		static constexpr uint32_t DefaultRtt = 100;
+		// Min time (ms) between two requests of the same packet.
+		static constexpr uint32_t MinRetryInterval = 20;
+		// Timer interval (ms).
+		static constexpr uint64_t Interval = 20;
+
+	private:
+		static Ticker ticker;
+		static Timer* timer;
+		static bool timerActive;
+		static size_t numGenerators;
+		// Generators with missing packets.
+		static std::unordered_set<NackGenerator*> pendingGenerators;
+
+	public:
+		explicit NackGenerator(Listener* listener);
+		~NackGenerator();
+
+		Json::Value toJson() const;
+		bool ReceivePacket(RTC::RtpPacket* packet, uint64_t now);
+		void ProcessRetries(uint64_t now);
+		void UpdateRtt(uint32_t rtt);
+		uint32_t GetRtt() const;
+		size_t GetNackListSize() const;
+		void Reset();
+
+	private:
+		struct NackInfo
+		{
+			uint64_t createdAt = 0;
+			uint64_t sentAt = 0;
+			uint8_t retries = 0;
+		};
+
+	private:
+		void AddPacketsToNackList(uint32_t seqStart, uint32_t seqEnd, uint64_t now);
+		bool RemoveNackItemsUntilKeyFrame();
+		void SendNacks(uint64_t now, bool onlyNew);
+		void UpdatePending();
+
+	private:
+		// Passed by argument.
+		Listener* listener = nullptr;
+		// Others.
+		bool started = false;
+		// Extended seq number of the highest packet received.
+		uint32_t lastSeq32 = 0;
+		// Missing packets by extended seq number.
+		std::map<uint32_t, NackInfo> nackList;
+		// Extended seq numbers of the recent key frame packets.
+		std::set<uint32_t> keyFrameList;
+		// Smoothed RTT (ms), 0 if unknown.
+		uint32_t rtt = 0;
+		// Stats.
+		size_t missingPackets = 0;
+		size_t requestedPackets = 0;
+		size_t recoveredPackets = 0;
+		size_t expiredPackets = 0;
+		size_t latePackets = 0;
+		size_t keyFramesRequired = 0;
+	};
+
+	/* Inline instance methods. */
+
+	inline
+	uint32_t NackGenerator::GetRtt() const
+	{
+		return this->rtt ? this->rtt : NackGenerator::DefaultRtt;
+	}
+
+	inline
+	size_t NackGenerator::GetNackListSize() const
+	{
+		return this->nackList.size();
+	}
+}
+
+#endif
@@ -0,0 +1,132 @@
+#ifndef MS_RTC_PACER_HPP
+#define MS_RTC_PACER_HPP
+
+#include "common.hpp"
+#include "RTC/RtpPacket.hpp"
+#include "handles/Timer.hpp"
+#include <deque>
+#include <vector>
+#include <unordered_set>
+#include <json/json.h>
+
+namespace RTC
+{
+	/**
+	 * Spreads the RTP packets sent by a Transport over time with a token bucket
+	 * so bursts (i.e. key frames of several streams) do not hit the remote
+	 * bottleneck at once.
+	 *
+	 * Queued packets are sent in priority order (audio, retransmissions, video,
+	 * padding). All the pacers are driven by a single timer and refill their
+	 * bucket with the high resolution clock. When the queue is full the oldest
+	 * non key frame video packet is dropped.
+	 */
+	class Pacer
+	{
+	public:
+		class Listener
+		{
+		public:
+			virtual void onPacerRtpPacket(RTC::Pacer* pacer, RTC::RtpPacket* packet, uint8_t transportWideCcId) = 0;
+		};
+
+	public:
+		// Sorted by priority (highest first).
+		enum class Priority : uint8_t
+		{
+			AUDIO = 0,
+			RETRANSMISSION,
+			VIDEO,
+			PADDING
+		};
+
+	private:
+		class Ticker :
+			public Timer::Listener
+		{
+		/* Pure virtual methods inherited from Timer::Listener. */
+		public:
+			virtual void onTimer(Timer* timer) override;
+		};
+
+	public:
+		static constexpr size_t NumPriorities = 4;
+		static constexpr size_t BufferSize = 1500;
+		static constexpr size_t MaxPoolSize = 1024;
+		static constexpr size_t MaxQueuedPackets = 512;
+		// Timer interval (ms).
+		static constexpr uint64_t Interval = 5;
+		// Max burst (ms worth of the bitrate).
+		static constexpr uint64_t MaxBurst = 10;
+
+	public:
+		static void ClassDestroy();
+
+	private:
+		static uint8_t* GetBuffer();
+		static void ReleaseBuffer(uint8_t* buffer);
+		static uint64_t GetTimeUs();
+
+	private:
+		static std::vector<uint8_t*> bufferPool;
+		static Ticker ticker;
+		static Timer* timer;
+		static bool timerActive;
+		static size_t numPacers;
+		// Pacers with queued packets.
+		static std::unordered_set<Pacer*> pendingPacers;
+
+	public:
+		explicit Pacer(Listener* listener);
+		~Pacer();
+
+		Json::Value toJson() const;
+		void SetBitrate(uint32_t bitrate);
+		uint32_t GetBitrate() const;
+		void SendRtpPacket(RTC::RtpPacket* packet, uint8_t transportWideCcId, Priority priority);
+		void Flush();
+
+	private:
+		struct QueuedPacket
+		{
+			RTC::RtpPacket* packet = nullptr;
+			uint8_t* buffer = nullptr;
+			uint8_t transportWideCcId = 0;
+			bool isKeyFrame = false;
+			// Reception time of the packet it was forwarded out of (see Metrics).
+			uint64_t forwardingStartTime = 0;
+		};
+
+	private:
+		void Process(uint64_t nowUs);
+		void Refill(uint64_t nowUs);
+		bool MakeRoom(Priority priority);
+		void Send(QueuedPacket& queuedPacket);
+		void Release(QueuedPacket& queuedPacket);
+
+	private:
+		// Passed by argument.
+		Listener* listener = nullptr;
+		// Allocated by this.
+		std::deque<QueuedPacket> queues[NumPriorities];
+		// Others.
+		uint32_t bitrate = 0;
+		// Available bytes (may be negative after sending a big packet).
+		double budget = 0;
+		uint64_t lastRefillTimeUs = 0;
+		size_t queuedPackets = 0;
+		size_t queuedBytes = 0;
+		size_t sentPackets = 0;
+		size_t droppedPackets = 0;
+	};
+
+	/* Inline instance methods. */
+
+	inline
+	uint32_t Pacer::GetBitrate() const
+	{
+		return this->bitrate;
+	}
+}
+
+#endif
@@ -0,0 +1,104 @@
+#ifndef MS_RTC_PACKET_TRACE_HPP
+#define MS_RTC_PACKET_TRACE_HPP
+
+#include "common.hpp"
+#include <string>
+#include <vector>
+#include <cstring> // std::memcpy()
+#include <uv.h>
+#include <json/json.h>
+
+namespace RTC
+{
+	/**
+	 * Always-on ring with the latest RTP and RTCP packets received and sent by
+	 * a Transport. Just the headers are kept (the RTP fixed header and the
+	 * first RTCP header with its SSRC) along with the direction, reception or
+	 * sending time and size.
+	 *
+	 * Dump() writes it into a JSON or pcap file. The pcap file has raw IPv4
+	 * packets (local address 10.0.0.1, remote address 10.0.0.2) truncated after
+	 * the kept headers, so "Decode As RTP" works in Wireshark.
+	 */
+	class PacketTrace
+	{
+	public:
+		static constexpr size_t Size = 1024;
+		static constexpr size_t MaxHeaderLength = 12;
+
+	public:
+		enum class Direction : uint8_t
+		{
+			IN = 0,
+			OUT
+		};
+
+		enum class Type : uint8_t
+		{
+			RTP = 0,
+			RTCP
+		};
+
+		enum class Format
+		{
+			JSON = 1,
+			PCAP
+		};
+
+	private:
+		struct Record
+		{
+			// Monotonic time (us).
+			uint64_t time;
+			uint16_t size;
+			Direction direction;
+			Type type;
+			uint8_t headerLength;
+			uint8_t header[MaxHeaderLength];
+		};
+
+	public:
+		static bool GetFormat(const std::string& name, Format& format);
+
+	public:
+		Json::Value toJson() const;
+		void Add(Direction direction, Type type, const uint8_t* data, size_t len);
+		size_t Dump(const std::string& path, Format format) const;
+
+	private:
+		Json::Value GetRecordsJson(uint64_t timeOffset) const;
+		void WritePcap(std::vector<uint8_t>& out, uint64_t timeOffset) const;
+
+	private:
+		// Others.
+		Record records[Size];
+		// Index of the next record.
+		size_t head = 0;
+		// Stats.
+		uint64_t numRecords = 0;
+	};
+
+	/* Inline instance methods. */
+
+	inline
+	void PacketTrace::Add(Direction direction, Type type, const uint8_t* data, size_t len)
+	{
+		Record& record = this->records[this->head];
+		size_t headerLength = type == Type::RTP ? 12 : 8;
+
+		if (headerLength > len)
+			headerLength = len;
+
+		record.time = uv_hrtime() / 1000;
+		record.size = len > 0xFFFF ? 0xFFFF : static_cast<uint16_t>(len);
+		record.direction = direction;
+		record.type = type;
+		record.headerLength = static_cast<uint8_t>(headerLength);
+		std::memcpy(record.header, data, headerLength);
+
+		this->head = (this->head + 1) % Size;
+		this->numRecords++;
+	}
+}
+
+#endif
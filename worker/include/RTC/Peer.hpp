@@ -10,6 +10,7 @@
 #include "RTC/RTCP/ReceiverReport.hpp"
 #include "RTC/RTCP/SenderReport.hpp"
 #include "RTC/RTCP/Feedback.hpp"
+#include "RTC/RTCP/FeedbackPsRemb.hpp"
 #include "Channel/Request.hpp"
 #include "Channel/Notifier.hpp"
 #include "handles/Timer.hpp"
@@ -35,6 +36,8 @@ namespace RTC
 			virtual void onPeerRtpReceiverParameters(RTC::Peer* peer, RTC::RtpReceiver* rtpReceiver) = 0;
 			virtual void onPeerRtpReceiverClosed(RTC::Peer* peer, RTC::RtpReceiver* rtpReceiver) = 0;
 			virtual void onPeerRtpSenderClosed(RTC::Peer* peer, RTC::RtpSender* rtpSender) = 0;
+			virtual void onPeerRtpSenderKeyFrameRequired(RTC::Peer* peer, RTC::RtpSender* rtpSender, size_t encodingIndex) = 0;
+			virtual void onPeerRtpSenderRemb(RTC::Peer* peer, RTC::RtpSender* rtpSender, uint32_t bitrate) = 0;
 			virtual void onPeerRtpPacket(RTC::Peer* peer, RTC::RtpReceiver* rtpReceiver, RTC::RtpPacket* packet) = 0;
 			virtual void onPeerRtcpReceiverReport(RTC::Peer* peer, RTC::RtpSender* rtpSender, RTC::RTCP::ReceiverReport* report) = 0;
 			virtual void onPeerRtcpFeedback(RTC::Peer* peer, RTC::RtpSender* rtpSender, RTC::RTCP::FeedbackPsPacket* packet) = 0;
@@ -72,6 +75,7 @@ namespace RTC
 		RTC::Transport* GetTransportFromRequest(Channel::Request* request, uint32_t* transportId = nullptr) const;
 		RTC::RtpReceiver* GetRtpReceiverFromRequest(Channel::Request* request, uint32_t* rtpReceiverId = nullptr) const;
 		RTC::RtpSender* GetRtpSenderFromRequest(Channel::Request* request, uint32_t* rtpSenderId = nullptr) const;
+		void ReceiveRemb(RTC::RTCP::FeedbackPsRembPacket* remb);
 
 	/* Pure virtual methods inherited from RTC::Transport::Listener. */
 	public:
@@ -88,6 +92,7 @@ namespace RTC
 	/* Pure virtual methods inherited from RTC::RtpSender::Listener. */
 	public:
 		virtual void onRtpSenderClosed(RTC::RtpSender* rtpSender) override;
+		virtual void onRtpSenderKeyFrameRequired(RTC::RtpSender* rtpSender, size_t encodingIndex) override;
 
 	/* Pure virtual methods inherited from Timer::Listener. */
 	public:
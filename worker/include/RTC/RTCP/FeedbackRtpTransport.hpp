@@ -0,0 +1,140 @@
+#ifndef MS_RTC_RTCP_FEEDBACK_RTP_TRANSPORT_HPP
+#define MS_RTC_RTCP_FEEDBACK_RTP_TRANSPORT_HPP
+
+#include "common.hpp"
+#include "RTC/RTCP/Feedback.hpp"
+#include <vector>
+
+/* draft-holmer-rmcat-transport-wide-cc-extensions-01
+ * RTCP message for transport-wide congestion control feedback
+
+    0 1 2 3 4 5 6 7 8 9 0 1 2 3 4 5 6 7 8 9 0 1 2 3 4 5 6 7 8 9 0 1
+   +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+   |V=2|P| FMT=15  |   PT=205      |             length            |
+   +=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+=+
+0  |                  SSRC of packet sender                        |
+   +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+4  |                  SSRC of media source                         |
+   +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+8  |      base sequence number     |      packet status count      |
+   +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+12 |                 reference time                | fb pkt. count |
+   +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+16 |          packet chunk         |         packet chunk          |
+   +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+   .                                                               .
+   +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+   |         packet chunk          |  recv delta   |  recv delta   |
+   +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+   .                                                               .
+   +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+   |           recv delta          |  recv delta   | zero padding  |
+   +-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+-+
+   */
+
+namespace RTC { namespace RTCP
+{
+	class FeedbackRtpTransportPacket
+		: public FeedbackRtpPacket
+	{
+	public:
+		struct PacketResult
+		{
+			uint16_t sequenceNumber = 0;
+			bool received = false;
+			// Arrival time (in ms) in the clock of the remote receiver.
+			int64_t receivedAtMs = 0;
+		};
+
+	private:
+		enum Status : uint8_t
+		{
+			NOT_RECEIVED = 0,
+			SMALL_DELTA  = 1,
+			LARGE_DELTA  = 2
+		};
+
+	public:
+		static FeedbackRtpTransportPacket* Parse(const uint8_t* data, size_t len);
+
+	public:
+		// Parsed Report. Points to an external data.
+		explicit FeedbackRtpTransportPacket(CommonHeader* commonHeader);
+		// Locally generated Report. Results must be consecutive starting at the
+		// base sequence number and at least one of them must be received.
+		FeedbackRtpTransportPacket(uint32_t senderSsrc, uint32_t mediaSsrc, uint8_t feedbackPacketCount, const std::vector<PacketResult>& packetResults);
+		virtual ~FeedbackRtpTransportPacket() {};
+
+		bool IsCorrect() const;
+		uint16_t GetBaseSequenceNumber() const;
+		uint16_t GetPacketStatusCount() const;
+		int32_t GetReferenceTime() const;
+		uint8_t GetFeedbackPacketCount() const;
+		const std::vector<PacketResult>& GetPacketResults() const;
+
+	/* Pure virtual methods inherited from Packet. */
+	public:
+		virtual void Dump() const override;
+		virtual size_t Serialize(uint8_t* buffer) override;
+		virtual size_t GetSize() const override;
+
+	private:
+		uint16_t baseSequenceNumber = 0;
+		uint16_t packetStatusCount = 0;
+		// Reference time in multiples of 64ms.
+		int32_t referenceTime = 0;
+		uint8_t feedbackPacketCount = 0;
+		std::vector<PacketResult> packetResults;
+		// Content of locally generated Reports.
+		std::vector<uint8_t> buffer;
+		uint8_t* data = nullptr;
+		size_t size = 0;
+		bool isCorrect = true;
+	};
+
+	/* Inline instance methods. */
+
+	inline
+	bool FeedbackRtpTransportPacket::IsCorrect() const
+	{
+		return this->isCorrect;
+	}
+
+	inline
+	uint16_t FeedbackRtpTransportPacket::GetBaseSequenceNumber() const
+	{
+		return this->baseSequenceNumber;
+	}
+
+	inline
+	uint16_t FeedbackRtpTransportPacket::GetPacketStatusCount() const
+	{
+		return this->packetStatusCount;
+	}
+
+	inline
+	int32_t FeedbackRtpTransportPacket::GetReferenceTime() const
+	{
+		return this->referenceTime;
+	}
+
+	inline
+	uint8_t FeedbackRtpTransportPacket::GetFeedbackPacketCount() const
+	{
+		return this->feedbackPacketCount;
+	}
+
+	inline
+	const std::vector<FeedbackRtpTransportPacket::PacketResult>& FeedbackRtpTransportPacket::GetPacketResults() const
+	{
+		return this->packetResults;
+	}
+
+	inline
+	size_t FeedbackRtpTransportPacket::GetSize() const
+	{
+		return FeedbackRtpPacket::GetSize() + this->size;
+	}
+}}
+
+#endif
@@ -0,0 +1,157 @@
+#ifndef MS_RTC_RECORDER_HPP
+#define MS_RTC_RECORDER_HPP
+
+#include "common.hpp"
+#include "RTC/RtpDictionaries.hpp"
+#include "RTC/RtpPacket.hpp"
+#include "handles/FileWriter.hpp"
+#include "handles/Timer.hpp"
+#include <string>
+#include <vector>
+#include <deque>
+#include <map>
+#include <json/json.h>
+
+namespace RTC
+{
+	/**
+	 * Writes the RTP packets of a RtpReceiver into a file:
+	 *
+	 * - "ivf": VP8 or VP9 frames (just the base spatial layer of VP9).
+	 * - "ogg": Opus packets (RFC 7845), one per page.
+	 * - "h264": H264 Annex B byte stream.
+	 * - "rtpdump": raw RTP packets (rtptools format) of any codec.
+	 *
+	 * Container formats record a single stream (the SSRC of the first packet)
+	 * and video ones start (and restart after a packet loss) at a key frame.
+	 *
+	 * Data is appended to a memory buffer that is written by a FileWriter once
+	 * full (or every FlushInterval ms), so the loop never waits for the disk.
+	 * If the disk does not keep up, records are dropped once MaxQueuedBuffers
+	 * are waiting to be written.
+	 *
+	 * Close() flushes the remaining data, closes the file and deletes the
+	 * instance once done.
+	 */
+	class Recorder :
+		public Timer::Listener,
+		public FileWriter::Listener
+	{
+	public:
+		class Listener
+		{
+		public:
+			virtual void onRecorderKeyFrameRequired(RTC::Recorder* recorder, uint32_t ssrc) = 0;
+		};
+
+	public:
+		enum class Format
+		{
+			RTPDUMP = 1,
+			IVF,
+			OGG,
+			H264
+		};
+
+	public:
+		static constexpr size_t BufferSize = 256 * 1024;
+		static constexpr size_t MaxQueuedBuffers = 8;
+		static constexpr uint64_t FlushInterval = 1000;
+
+	public:
+		static bool GetFormat(const std::string& name, Format& format);
+		static Format GetDefaultFormat(const RTC::RtpCodecMime& mime);
+		static bool IsSupported(Format format, const RTC::RtpCodecMime& mime);
+		static const std::string& GetFormatString(Format format);
+
+	private:
+		static std::map<std::string, Format> string2Format;
+		static std::map<Format, std::string> format2String;
+		static uint32_t oggCrcTable[];
+
+	public:
+		Recorder(Listener* listener, const std::string& path, Format format, const RTC::RtpCodecParameters& codec);
+
+	private:
+		virtual ~Recorder();
+
+	public:
+		void Close();
+		Json::Value toJson() const;
+		void ReceivePacket(const RTC::RtpPacket* packet);
+
+	private:
+		uint8_t* Append(size_t len);
+		bool Flush();
+		void WriteNext();
+		void Finish();
+		uint64_t UnwrapTimestamp(uint32_t timestamp);
+		bool CheckStream(const RTC::RtpPacket* packet);
+		void WaitKeyFrame();
+		void WriteRtpDumpHeader();
+		void WriteRtpDumpPacket(const RTC::RtpPacket* packet);
+		void WriteIvfHeader(uint8_t* data) const;
+		void ReceiveVideoFramePacket(const RTC::RtpPacket* packet);
+		void WriteIvfFrame();
+		void WriteOggHeaders();
+		void WriteOggPage(uint8_t headerType, uint64_t granule, const uint8_t* data, size_t len);
+		void WriteOggPacket(const RTC::RtpPacket* packet);
+		void WriteH264Packet(const RTC::RtpPacket* packet);
+
+	/* Pure virtual methods inherited from Timer::Listener. */
+	public:
+		virtual void onTimer(Timer* timer) override;
+
+	/* Pure virtual methods inherited from FileWriter::Listener. */
+	public:
+		virtual void onFileWriterWrite(FileWriter* fileWriter, size_t written, int err) override;
+		virtual void onFileWriterClosed(FileWriter* fileWriter) override;
+
+	private:
+		// Passed by argument.
+		Listener* listener = nullptr;
+		std::string path;
+		Format format;
+		RTC::RtpCodecParameters codec;
+		// Allocated by this.
+		FileWriter* fileWriter = nullptr;
+		Timer* flushTimer = nullptr;
+		// Others.
+		bool closing = false;
+		bool failed = false;
+		// Buffer being filled and the full ones.
+		std::vector<uint8_t> buffer;
+		std::deque<std::vector<uint8_t>> queuedBuffers;
+		// Size of the buffer being written.
+		size_t writeSize = 0;
+		// File offset of the next buffer.
+		int64_t fileOffset = 0;
+		// Stream being recorded (container formats).
+		bool hasSsrc = false;
+		uint32_t ssrc = 0;
+		uint16_t lastSeq = 0;
+		bool waitingKeyFrame = false;
+		// Timestamps relative to the first packet.
+		bool hasTimestamp = false;
+		uint32_t lastTimestamp = 0;
+		uint64_t unwrappedTimestamp = 0;
+		uint64_t startTime = 0;
+		// Frame being assembled (IVF).
+		std::vector<uint8_t> frame;
+		uint32_t frameTimestamp = 0;
+		uint16_t width = 0;
+		uint16_t height = 0;
+		bool ivfHeaderUpdated = false;
+		// Ogg stream.
+		uint32_t oggSerial = 0;
+		uint32_t oggPageSeq = 0;
+		uint64_t oggGranule = 0;
+		// Stats.
+		size_t packets = 0;
+		size_t frames = 0;
+		size_t writtenBytes = 0;
+		size_t droppedBytes = 0;
+	};
+}
+
+#endif
@@ -0,0 +1,79 @@
+#ifndef MS_RTC_RED_ENCODER_HPP
+#define MS_RTC_RED_ENCODER_HPP
+
+#include "common.hpp"
+#include "RTC/RtpPacket.hpp"
+#include <json/json.h>
+
+namespace RTC
+{
+	/**
+	 * Adds RFC 2198 redundancy to an audio stream: each packet carries the
+	 * payloads of the previous `distance` packets too, so the remote peer can
+	 * fill single losses (or bursts up to `distance` packets) right away.
+	 *
+	 * The distance follows the fraction lost reported by the remote peer. With
+	 * distance 0 packets are sent as they are (without RED encapsulation).
+	 */
+	class RedEncoder
+	{
+	public:
+		// Max number of redundant payloads per packet.
+		static constexpr size_t MaxDistance = 3;
+		// Max size of a redundant payload (the block length has 10 bits).
+		static constexpr size_t MaxBlockLength = 1023;
+		// Max size of the RED packets (redundant payloads that don't fit are not
+		// included).
+		static constexpr size_t MaxPacketSize = 1200;
+
+	private:
+		// Buffer to build the RED packets.
+		static uint8_t buffer[];
+
+	public:
+		explicit RedEncoder(uint8_t payloadType);
+
+		Json::Value toJson() const;
+		void SetFractionLost(uint8_t fractionLost);
+		size_t GetDistance() const;
+		RTC::RtpPacket* Encode(const RTC::RtpPacket* packet);
+
+	private:
+		void StorePayload(const RTC::RtpPacket* packet);
+
+	public:
+		// Passed by argument.
+		uint8_t payloadType = 0;
+
+	private:
+		struct Block
+		{
+			uint8_t payloadType = 0;
+			uint32_t timestamp = 0;
+			size_t length = 0;
+			uint8_t data[MaxBlockLength];
+		};
+
+	private:
+		// Others.
+		size_t distance = 1;
+		// Payloads of the latest consecutive packets (ring).
+		Block history[MaxDistance];
+		size_t historyIdx = 0;
+		size_t historySize = 0;
+		uint16_t lastSeq = 0;
+		// Stats.
+		size_t redPackets = 0;
+		size_t redundantBytes = 0;
+	};
+
+	/* Inline instance methods. */
+
+	inline
+	size_t RedEncoder::GetDistance() const
+	{
+		return this->distance;
+	}
+}
+
+#endif
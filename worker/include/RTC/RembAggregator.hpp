@@ -0,0 +1,51 @@
+#ifndef MS_RTC_REMB_AGGREGATOR_HPP
+#define MS_RTC_REMB_AGGREGATOR_HPP
+
+#include "common.hpp"
+#include <string>
+#include <vector>
+#include <map>
+#include <unordered_map>
+#include <json/json.h>
+
+namespace RTC
+{
+	/**
+	 * Combines the bitrates announced via REMB by the remote receivers of a
+	 * stream into the one announced to its source.
+	 */
+	class RembAggregator
+	{
+	public:
+		enum class Policy : uint8_t
+		{
+			// The lowest bitrate.
+			MIN = 1,
+			// The given percentile (so the lowest ones are sacrificed).
+			PERCENTILE,
+			// The lowest bitrate above the lower outlier fence (Q1 - 1.5 * IQR).
+			MIN_NON_OUTLIERS
+		};
+
+	public:
+		static Policy GetPolicy(std::string& str);
+		static Json::StaticString& GetJsonString(Policy policy);
+
+	private:
+		static std::unordered_map<std::string, Policy> string2Policy;
+		static std::map<Policy, Json::StaticString> policy2Json;
+
+	public:
+		explicit RembAggregator(Policy policy = Policy::MIN, uint8_t percentile = 20);
+
+		Json::Value toJson() const;
+		uint32_t Aggregate(std::vector<uint32_t>& bitrates) const;
+
+	private:
+		// Passed by argument.
+		Policy policy;
+		uint8_t percentile;
+	};
+}
+
+#endif
@@ -7,12 +7,17 @@
 #include "RTC/RtpReceiver.hpp"
 #include "RTC/RtpSender.hpp"
 #include "RTC/RtpPacket.hpp"
+#include "RTC/RembAggregator.hpp"
+#include "RTC/AudioLevelObserver.hpp"
+#include "RTC/VideoLastN.hpp"
 #include "RTC/RTCP/ReceiverReport.hpp"
 #include "RTC/RTCP/SenderReport.hpp"
 #include "RTC/RTCP/Feedback.hpp"
 #include "RTC/RTCP/Sdes.hpp"
 #include "Channel/Request.hpp"
 #include "Channel/Notifier.hpp"
+#include "Channel/ResponseWriter.hpp"
+#include <string>
 #include <unordered_map>
 #include <unordered_set>
 #include <vector>
@@ -21,7 +26,8 @@
 namespace RTC
 {
 	class Room :
-		public RTC::Peer::Listener
+		public RTC::Peer::Listener,
+		public RTC::AudioLevelObserver::Listener
 	{
 	public:
 		class Listener
@@ -46,12 +52,26 @@ namespace RTC
 	public:
 		void Destroy();
 		Json::Value toJson() const;
+		void Dump(Channel::Request* request) const;
 		void HandleRequest(Channel::Request* request);
+		void LinkRtpReceiver(Channel::Request* request, RTC::Room* sourceRoom);
 		const RTC::RtpCapabilities& GetCapabilities() const;
 
 	private:
+		void WriteMap(Channel::ResponseWriter& writer, const std::string& field,
+			const std::unordered_set<const RTC::RtpReceiver*>* rtpReceivers = nullptr,
+			const std::unordered_set<const RTC::RtpSender*>* rtpSenders = nullptr) const;
 		RTC::Peer* GetPeerFromRequest(Channel::Request* request, uint32_t* peerId = nullptr) const;
 		void SetCapabilities(std::vector<RTC::RtpCodecParameters>& mediaCodecs);
+		void UpdateVideoLastN();
+		RTC::RtpReceiver* GetRtpReceiver(uint32_t rtpReceiverId, RTC::Peer** peer) const;
+		void ForwardRtpPacket(RTC::RtpReceiver* rtpReceiver, RTC::RtpPacket* packet);
+		void CloseRtpSenders(RTC::RtpReceiver* rtpReceiver);
+		void UpdateRemb(RTC::RtpReceiver* rtpReceiver);
+		void GetRembBitrates(RTC::RtpReceiver* rtpReceiver, uint64_t now, std::vector<uint32_t>& bitrates);
+		void AddLinkedRtpSender(RTC::Peer* peer, RTC::RtpReceiver* rtpReceiver, RTC::Peer* sourcePeer);
+		void UpdateLinkedRtpReceiver(RTC::RtpReceiver* rtpReceiver);
+		void UnlinkRtpReceiver(RTC::RtpReceiver* rtpReceiver);
 
 	/* Pure virtual methods inherited from RTC::Peer::Listener. */
 	public:
@@ -60,12 +80,25 @@ namespace RTC
 		virtual void onPeerRtpReceiverParameters(RTC::Peer* peer, RTC::RtpReceiver* rtpReceiver) override;
 		virtual void onPeerRtpReceiverClosed(RTC::Peer* peer, RTC::RtpReceiver* rtpReceiver) override;
 		virtual void onPeerRtpSenderClosed(RTC::Peer* peer, RTC::RtpSender* rtpSender) override;
+		virtual void onPeerRtpSenderKeyFrameRequired(RTC::Peer* peer, RTC::RtpSender* rtpSender, size_t encodingIndex) override;
+		virtual void onPeerRtpSenderRemb(RTC::Peer* peer, RTC::RtpSender* rtpSender, uint32_t bitrate) override;
 		virtual void onPeerRtpPacket(RTC::Peer* peer, RTC::RtpReceiver* rtpReceiver, RTC::RtpPacket* packet) override;
 		virtual void onPeerRtcpReceiverReport(RTC::Peer* peer, RTC::RtpSender* rtpSender, RTC::RTCP::ReceiverReport* report) override;
 		virtual void onPeerRtcpFeedback(RTC::Peer* peer, RTC::RtpSender* rtpSender, RTC::RTCP::FeedbackPsPacket* packet) override;
 		virtual void onPeerRtcpFeedback(RTC::Peer* peer, RTC::RtpSender* rtpSender, RTC::RTCP::FeedbackRtpPacket* packet) override;
 		virtual void onPeerRtcpSenderReport(RTC::Peer* peer, RTC::RtpReceiver* rtpReceiver, RTC::RTCP::SenderReport* report) override;
 
+	/* Pure virtual methods inherited from RTC::AudioLevelObserver::Listener. */
+	public:
+		virtual void onAudioLevelObserverDominantSpeaker(RTC::AudioLevelObserver* audioLevelObserver, uint32_t streamId) override;
+
+	private:
+		struct LinkedRtpReceiver
+		{
+			RTC::Room* sourceRoom = nullptr;
+			RTC::Peer* sourcePeer = nullptr;
+		};
+
 	public:
 		// Passed by argument.
 		uint32_t roomId;
@@ -76,9 +109,23 @@ namespace RTC
 		Channel::Notifier* notifier = nullptr;
 		// Others.
 		RTC::RtpCapabilities capabilities;
+		// Max number of packets in the key frame cache of each video stream.
+		size_t keyFrameCacheSize = RTC::KeyFrameCache::DefaultMaxPackets;
+		// Window (ms) in which key frame requests to a publisher are merged.
+		uint16_t keyFrameRequestWindow = 1000;
+		// Combines the REMB bitrates of the RtpSenders of each RtpReceiver.
+		RTC::RembAggregator rembAggregator;
+		// Selects the dominant speaker and the forwarded audio streams.
+		RTC::AudioLevelObserver audioLevelObserver;
+		// Selects the Peers whose video is forwarded to each Peer.
+		RTC::VideoLastN videoLastN;
 		std::unordered_map<uint32_t, RTC::Peer*> peers;
 		std::unordered_map<RTC::RtpReceiver*, std::unordered_set<RTC::RtpSender*>> mapRtpReceiverRtpSenders;
 		std::unordered_map<RTC::RtpSender*, RTC::RtpReceiver*> mapRtpSenderRtpReceiver;
+		// RtpReceivers of other Rooms forwarded to the Peers of this Room.
+		std::unordered_map<RTC::RtpReceiver*, LinkedRtpReceiver> linkedRtpReceivers;
+		// Other Rooms the RtpReceivers of this Room are forwarded to.
+		std::unordered_map<RTC::RtpReceiver*, std::unordered_set<RTC::Room*>> mapRtpReceiverLinkedRooms;
 	};
 
 	/* Inline static methods. */
@@ -4,6 +4,7 @@
 #include "common.hpp"
 #include "DepLibUV.hpp"
 #include "RTC/RtpPacket.hpp"
+#include <json/json.h>
 
 namespace RTC
 {
@@ -50,6 +51,7 @@ namespace RTC
 	class RtpDataCounter
 	{
 	public:
+		Json::Value toJson() const;
 		void Update(RTC::RtpPacket* packet);
 		uint32_t GetRate(uint64_t now);
 		size_t GetPacketCount() const;
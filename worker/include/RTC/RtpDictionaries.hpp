@@ -127,12 +127,14 @@ namespace RTC
 	public:
 		enum class Type : uint8_t
 		{
-			UNKNOWN           = 0,
-			SSRC_AUDIO_LEVEL  = 1,
-			TO_OFFSET         = 2,
-			ABS_SEND_TIME     = 3,
-			VIDEO_ORIENTATION = 4,
-			RTP_STREAM_ID     = 5
+			UNKNOWN              = 0,
+			SSRC_AUDIO_LEVEL     = 1,
+			TO_OFFSET            = 2,
+			ABS_SEND_TIME        = 3,
+			VIDEO_ORIENTATION    = 4,
+			RTP_STREAM_ID        = 5,
+			TRANSPORT_WIDE_CC_01 = 6,
+			MID                  = 7
 		};
 
 		private:
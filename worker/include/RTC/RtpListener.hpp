@@ -17,13 +17,18 @@ namespace RTC
 		bool HasSsrc(uint32_t ssrc, RTC::RtpReceiver* rtpReceiver) const;
 		bool HasMuxId(std::string& muxId, RTC::RtpReceiver* rtpReceiver) const;
 		bool HasPayloadType(uint8_t payloadType, RTC::RtpReceiver* rtpReceiver) const;
+		bool HasRid(std::string& ridKey, RTC::RtpReceiver* rtpReceiver) const;
 		void AddRtpReceiver(RTC::RtpReceiver* rtpReceiver);
 		void RemoveRtpReceiver(RTC::RtpReceiver* rtpReceiver);
 		RTC::RtpReceiver* GetRtpReceiver(RTC::RtpPacket* packet);
 		RTC::RtpReceiver* GetRtpReceiver(uint32_t ssrc);
 
 	private:
-		void RollbackRtpReceiver(RTC::RtpReceiver* rtpReceiver, std::vector<uint32_t>& previousSsrcs, std::string& previousMuxId, std::vector<uint8_t>& previousPayloadTypes);
+		static std::string GetRidKey(const std::string& mid, const std::string& rid);
+		static bool HasMidKey(const RTC::RtpParameters* rtpParameters);
+
+	private:
+		void RollbackRtpReceiver(RTC::RtpReceiver* rtpReceiver, std::vector<uint32_t>& previousSsrcs, std::string& previousMuxId, std::vector<uint8_t>& previousPayloadTypes, std::vector<std::string>& previousRids);
 
 	public:
 		// Table of SSRC / RtpReceiver pairs.
@@ -32,8 +37,24 @@ namespace RTC
 		std::unordered_map<std::string, RTC::RtpReceiver*> muxIdTable;
 		// Table of RTP payload type / RtpReceiver pairs.
 		std::unordered_map<uint8_t, RTC::RtpReceiver*> ptTable;
+		// Table of MID + RID (encodings without SSRC) / RtpReceiver pairs. The
+		// MID is just included if the RtpReceiver has muxId and the MID RTP
+		// header extension, so RtpReceivers with the same RIDs (i.e. "low", "mid"
+		// and "high") do not collide.
+		std::unordered_map<std::string, RTC::RtpReceiver*> ridTable;
 	};
 
+	/* Inline static methods. */
+
+	inline
+	std::string RtpListener::GetRidKey(const std::string& mid, const std::string& rid)
+	{
+		if (mid.empty())
+			return rid;
+		else
+			return mid + ":" + rid;
+	}
+
 	/* Inline instance methods. */
 
 	inline
@@ -80,6 +101,21 @@ namespace RTC
 			return (it->second != rtpReceiver);
 		}
 	}
+
+	inline
+	bool RtpListener::HasRid(std::string& ridKey, RTC::RtpReceiver* rtpReceiver) const
+	{
+		auto it = this->ridTable.find(ridKey);
+
+		if (it == this->ridTable.end())
+		{
+			return false;
+		}
+		else
+		{
+			return (it->second != rtpReceiver);
+		}
+	}
 }
 
 #endif
@@ -3,7 +3,9 @@
 
 #include "common.hpp"
 #include "RTC/RtpDictionaries.hpp"
+#include "RTC/Codecs/PayloadDescriptor.hpp"
 #include "Utils.hpp"
+#include <string>
 #include <map>
 
 namespace RTC
@@ -102,13 +104,23 @@ namespace RTC
 		uint8_t* GetExtension(RtpHeaderExtensionUri::Type uri, uint8_t* len) const;
 		bool ReadAudioLevel(uint8_t* volume, bool* voice) const;
 		bool ReadAbsSendTime(uint32_t* time) const;
+		bool ReadRid(std::string& rid) const;
+		bool ReadMid(std::string& mid) const;
+		bool ReadTransportWideCc01(uint16_t* wideSeqNumber) const;
+		bool UpdateTransportWideCc01(uint16_t wideSeqNumber);
 		uint8_t* GetPayload() const;
 		size_t GetPayloadLength() const;
+		bool ParsePayloadDescriptor(const RTC::RtpCodecMime& mime);
+		const RTC::Codecs::PayloadDescriptor* GetPayloadDescriptor() const;
 		void Serialize(uint8_t* buffer);
 		RtpPacket* Clone(uint8_t* buffer) const;
+		void RtxEncode(uint8_t payloadType, uint32_t ssrc, uint16_t seq);
+		bool RtxDecode(uint8_t payloadType, uint32_t ssrc);
+		bool RedDecode();
 
 	private:
 		void ParseExtensions();
+		bool ReadSdesExtension(RtpHeaderExtensionUri::Type uri, std::string& value) const;
 
 	private:
 		// Passed by argument.
@@ -122,6 +134,10 @@ namespace RTC
 		size_t payloadLength = 0;
 		uint8_t payloadPadding = 0;
 		size_t size = 0; // Full size of the packet in bytes.
+		// Others.
+		// Codec specific payload info, filled once by the RtpReceiver.
+		RTC::Codecs::PayloadDescriptor payloadDescriptor;
+		bool hasPayloadDescriptor = false;
 	};
 
 	/* Inline static methods. */
@@ -290,7 +306,7 @@ namespace RTC
 			if (this->twoBytesExtensions.find(id) == this->twoBytesExtensions.end())
 				return nullptr;
 
-			*len = this->oneByteExtensions.at(id)->len;
+			*len = this->twoBytesExtensions.at(id)->len;
 			return this->twoBytesExtensions.at(id)->value;
 		}
 		else
@@ -333,6 +349,79 @@ namespace RTC
 		return true;
 	}
 
+	inline
+	bool RtpPacket::ReadRid(std::string& rid) const
+	{
+		return ReadSdesExtension(RtpHeaderExtensionUri::Type::RTP_STREAM_ID, rid);
+	}
+
+	inline
+	bool RtpPacket::ReadMid(std::string& mid) const
+	{
+		return ReadSdesExtension(RtpHeaderExtensionUri::Type::MID, mid);
+	}
+
+	inline
+	bool RtpPacket::ReadSdesExtension(RtpHeaderExtensionUri::Type uri, std::string& value) const
+	{
+		uint8_t exten_len;
+		uint8_t* exten_value;
+
+		exten_value = GetExtension(uri, &exten_len);
+
+		if (!exten_value || exten_len == 0)
+			return false;
+
+		// Ignore trailing zero bytes (padding).
+		while (exten_len > 0 && exten_value[exten_len - 1] == 0)
+		{
+			--exten_len;
+		}
+
+		if (exten_len == 0)
+			return false;
+
+		value.assign((const char*)exten_value, (size_t)exten_len);
+
+		return true;
+	}
+
+	inline
+	bool RtpPacket::ReadTransportWideCc01(uint16_t* wideSeqNumber) const
+	{
+		uint8_t exten_len;
+		uint8_t* exten_value;
+
+		exten_value = GetExtension(RtpHeaderExtensionUri::Type::TRANSPORT_WIDE_CC_01, &exten_len);
+
+		if (!exten_value || exten_len != 2)
+			return false;
+
+		*wideSeqNumber = Utils::Byte::Get2Bytes(exten_value, 0);
+
+		return true;
+	}
+
+	/**
+	 * Overwrites the transport-wide sequence number in place. Returns false if
+	 * the packet does not carry the extension (it cannot be added here).
+	 */
+	inline
+	bool RtpPacket::UpdateTransportWideCc01(uint16_t wideSeqNumber)
+	{
+		uint8_t exten_len;
+		uint8_t* exten_value;
+
+		exten_value = GetExtension(RtpHeaderExtensionUri::Type::TRANSPORT_WIDE_CC_01, &exten_len);
+
+		if (!exten_value || exten_len != 2)
+			return false;
+
+		Utils::Byte::Set2Bytes(exten_value, 0, wideSeqNumber);
+
+		return true;
+	}
+
 	inline
 	uint8_t* RtpPacket::GetPayload() const
 	{
@@ -344,6 +433,12 @@ namespace RTC
 	{
 		return this->payloadLength;
 	}
+
+	inline
+	const RTC::Codecs::PayloadDescriptor* RtpPacket::GetPayloadDescriptor() const
+	{
+		return this->hasPayloadDescriptor ? &this->payloadDescriptor : nullptr;
+	}
 }
 
 #endif
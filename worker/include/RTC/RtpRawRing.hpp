@@ -0,0 +1,92 @@
+#ifndef MS_RTC_RTP_RAW_RING_HPP
+#define MS_RTC_RTP_RAW_RING_HPP
+
+#include "common.hpp"
+#include "RTC/RtpPacket.hpp"
+#include <string>
+#include <json/json.h>
+
+namespace RTC
+{
+	/**
+	 * Single producer / single consumer ring buffer living in a POSIX shared
+	 * memory object. The worker writes raw RTP packets into it and a consumer
+	 * process (that knows the object name) mmaps it and reads them, so raw RTP
+	 * taps do not go through the Channel.
+	 *
+	 * Memory layout (host byte order):
+	 *
+	 *   [0]    Header (magic, version, dataSize, writePos, readPos, dropped)
+	 *   [256]  Data area of dataSize bytes.
+	 *
+	 * writePos and readPos are monotonic byte counters (offset in the data area
+	 * is pos % dataSize). The producer only writes writePos and dropped, the
+	 * consumer only writes readPos.
+	 *
+	 * Each record starts with a RecordHeader and is padded to 8 bytes. A record
+	 * with size 0 means "wrap to the beginning of the data area".
+	 */
+	class RtpRawRing
+	{
+	public:
+		static constexpr uint32_t Magic = 0x4D535252; // "MSRR".
+		static constexpr uint32_t Version = 1;
+		static constexpr size_t HeaderSize = 256;
+		static constexpr size_t DefaultSize = 4 * 1024 * 1024;
+		static constexpr size_t MinSize = 64 * 1024;
+		static constexpr size_t MaxSize = 256 * 1024 * 1024;
+
+	public:
+		struct Header
+		{
+			uint32_t magic;
+			uint32_t version;
+			uint32_t dataSize;
+			uint32_t reserved;
+			// Each position in its own cache line.
+			alignas(64) uint64_t writePos;
+			alignas(64) uint64_t readPos;
+			alignas(64) uint64_t dropped;
+		};
+
+		struct RecordHeader
+		{
+			// Size of the RTP packet (0 means wrap).
+			uint32_t size;
+			uint32_t ssrc;
+			// Reception time (ms).
+			uint64_t time;
+		};
+
+	public:
+		RtpRawRing(const std::string& name, size_t size);
+		~RtpRawRing();
+
+		bool Write(const RTC::RtpPacket* packet, uint64_t now);
+		const std::string& GetName() const;
+		Json::Value toJson() const;
+
+	private:
+		// Passed by argument.
+		std::string name;
+		// Allocated by this.
+		int fd = -1;
+		uint8_t* mem = nullptr;
+		// Others.
+		size_t memSize = 0;
+		Header* header = nullptr;
+		uint8_t* data = nullptr;
+		uint32_t dataSize = 0;
+		uint64_t writtenPackets = 0;
+	};
+
+	/* Inline instance methods. */
+
+	inline
+	const std::string& RtpRawRing::GetName() const
+	{
+		return this->name;
+	}
+}
+
+#endif
@@ -5,6 +5,11 @@
 #include "RTC/RtpDictionaries.hpp"
 #include "RTC/RtpPacket.hpp"
 #include "RTC/RtpStreamRecv.hpp"
+#include "RTC/RtpRawRing.hpp"
+#include "RTC/KeyFrameCache.hpp"
+#include "RTC/Recorder.hpp"
+#include "RTC/RtpDataCounter.hpp"
+#include "RTC/Metrics.hpp"
 #include "RTC/RTCP/ReceiverReport.hpp"
 #include "RTC/RTCP/Feedback.hpp"
 #include "RTC/RTCP/CompoundPacket.hpp"
@@ -12,6 +17,7 @@
 #include "Channel/Notifier.hpp"
 #include <string>
 #include <map>
+#include <set>
 #include <json/json.h>
 
 namespace RTC
@@ -21,7 +27,8 @@ namespace RTC
 	class Transport;
 
 	class RtpReceiver :
-		public RtpStreamRecv::Listener
+		public RtpStreamRecv::Listener,
+		public RTC::Recorder::Listener
 	{
 	public:
 		/**
@@ -36,6 +43,20 @@ namespace RTC
 			virtual void onRtpReceiverClosed(RtpReceiver* rtpReceiver) = 0;
 		};
 
+	private:
+		// Key frame requests sent to the source of a video stream.
+		struct KeyFrameRequestState
+		{
+			// Whether the codec just supports FIR (not PLI).
+			bool useFir = false;
+			uint8_t firSeqNumber = 0;
+			// Whether a request was merged and must be sent once the window ends.
+			bool pending = false;
+			uint64_t lastSentTime = 0;
+			size_t requested = 0;
+			size_t forwarded = 0;
+		};
+
 	private:
 		static uint8_t rtcpBuffer[];
 
@@ -53,21 +74,38 @@ namespace RTC
 		RTC::Transport* GetTransport() const;
 		void RemoveTransport(RTC::Transport* transport);
 		RTC::RtpParameters* GetParameters() const;
+		uint8_t GetRidExtensionId() const;
+		uint8_t GetMidExtensionId() const;
+		uint8_t GetTransportWideCc01ExtensionId() const;
+		size_t GetEncodingIndex(uint32_t ssrc) const;
+		void SetKeyFrameCacheSize(size_t size);
+		void SetKeyFrameRequestWindow(uint16_t window);
+		const RTC::KeyFrameCache* GetKeyFrameCache(uint32_t ssrc) const;
 		void ReceiveRtpPacket(RTC::RtpPacket* packet);
 		void ReceiveRtcpSenderReport(RTC::RTCP::SenderReport* report);
 		void GetRtcp(RTC::RTCP::CompoundPacket *packet, uint64_t now);
 		void ReceiveRtcpFeedback(RTC::RTCP::FeedbackPsPacket* packet);
 		void ReceiveRtcpFeedback(RTC::RTCP::FeedbackRtpPacket* packet);
+		void RequestKeyFrame(size_t encodingIndex);
 
 	private:
+		RTC::RtpStreamRecv* CreateRtpStreamForRid(RTC::RtpPacket* packet);
 		void CreateRtpStream(RTC::RtpEncodingParameters& encoding);
 		void ClearRtpStreams();
+		void CacheKeyFramePacket(RTC::RtpPacket* packet);
+		void HandleKeyFrameRequest(uint32_t ssrc);
+		void CheckKeyFrameRequest(RTC::RtpPacket* packet);
+		void SendKeyFrameRequest(uint32_t ssrc, KeyFrameRequestState& state, uint64_t now);
 
 	/* Pure virtual methods inherited from RTC::RtpStreamRecv::Listener. */
 	public:
-		virtual void onNackRequired(RTC::RtpStreamRecv* rtpStream, uint16_t seq, uint16_t bitmask) override;
+		virtual void onNackRequired(RTC::RtpStreamRecv* rtpStream, const std::vector<uint16_t>& seqNumbers) override;
 		virtual void onPliRequired(RTC::RtpStreamRecv* rtpStream) override;
 
+	/* Pure virtual methods inherited from RTC::Recorder::Listener. */
+	public:
+		virtual void onRecorderKeyFrameRequired(RTC::Recorder* recorder, uint32_t ssrc) override;
+
 	public:
 		// Passed by argument.
 		uint32_t rtpReceiverId;
@@ -81,12 +119,35 @@ namespace RTC
 		// Allocated by this.
 		RTC::RtpParameters* rtpParameters = nullptr;
 		std::map<uint32_t, RTC::RtpStreamRecv*> rtpStreams;
+		RTC::RtpRawRing* rtpRawRing = nullptr;
+		RTC::Recorder* recorder = nullptr;
+		std::map<uint32_t, RTC::KeyFrameCache*> keyFrameCaches;
 		// Others.
+		std::map<uint32_t, KeyFrameRequestState> keyFrameRequests;
+		// RTX SSRCs and payload types mapped to the media ones.
+		std::map<uint32_t, uint32_t> rtxSsrcs;
+		std::map<uint8_t, uint8_t> rtxPayloadTypes;
+		// RED payload types (just the primary encoding is forwarded).
+		std::set<uint8_t> redPayloadTypes;
+		// Ids of the RID and MID RTP header extensions (0 means none).
+		uint8_t ridExtensionId = 0;
+		uint8_t midExtensionId = 0;
+		uint8_t transportWideCc01ExtensionId = 0;
 		bool rtpRawEventEnabled = false;
 		bool rtpObjectEventEnabled = false;
+		// Max number of packets in the key frame cache of each stream (0 means
+		// disabled).
+		size_t keyFrameCacheSize = 0;
+		// Key frame requests within this window (ms) since the last one sent are
+		// merged (0 means sending all of them).
+		uint16_t keyFrameRequestWindow = 0;
 		// Timestamp when last RTCP was sent.
 		uint64_t lastRtcpSentTime = 0;
 		uint16_t maxRtcpInterval;
+		// RTP counters.
+		RTC::RtpDataCounter receivedCounter;
+		RTC::RtpDataCounter rtxReceivedCounter;
+		RTC::Metrics::StreamCounters counters;
 	};
 
 	/* Inline methods. */
@@ -116,6 +177,65 @@ namespace RTC
 		return this->rtpParameters;
 	}
 
+	inline
+	uint8_t RtpReceiver::GetRidExtensionId() const
+	{
+		return this->ridExtensionId;
+	}
+
+	inline
+	uint8_t RtpReceiver::GetMidExtensionId() const
+	{
+		return this->midExtensionId;
+	}
+
+	inline
+	uint8_t RtpReceiver::GetTransportWideCc01ExtensionId() const
+	{
+		return this->transportWideCc01ExtensionId;
+	}
+
+	/**
+	 * Index of the encoding (simulcast layer) with the given SSRC. Encodings
+	 * announced with RID get their SSRC once their first packet is received.
+	 */
+	inline
+	size_t RtpReceiver::GetEncodingIndex(uint32_t ssrc) const
+	{
+		auto& encodings = this->rtpParameters->encodings;
+
+		for (size_t idx = 0; idx < encodings.size(); ++idx)
+		{
+			if (encodings[idx].ssrc == ssrc)
+				return idx;
+		}
+
+		return 0;
+	}
+
+	inline
+	void RtpReceiver::SetKeyFrameCacheSize(size_t size)
+	{
+		this->keyFrameCacheSize = size;
+	}
+
+	inline
+	void RtpReceiver::SetKeyFrameRequestWindow(uint16_t window)
+	{
+		this->keyFrameRequestWindow = window;
+	}
+
+	inline
+	const RTC::KeyFrameCache* RtpReceiver::GetKeyFrameCache(uint32_t ssrc) const
+	{
+		auto it = this->keyFrameCaches.find(ssrc);
+
+		if (it == this->keyFrameCaches.end())
+			return nullptr;
+
+		return it->second;
+	}
+
 	inline
 	void RtpReceiver::ReceiveRtcpSenderReport(RTC::RTCP::SenderReport* report)
 	{
@@ -2,17 +2,24 @@
 #define MS_RTC_RTP_SENDER_HPP
 
 #include "common.hpp"
+#include "RTC/Codecs/PayloadDescriptor.hpp"
 #include "RTC/Transport.hpp"
 #include "RTC/RtpStreamSend.hpp"
+#include "RTC/KeyFrameCache.hpp"
+#include "RTC/SeqTracker.hpp"
+#include "RTC/FecGenerator.hpp"
+#include "RTC/RedEncoder.hpp"
 #include "RTC/RtpDictionaries.hpp"
 #include "RTC/RtpPacket.hpp"
 #include "RTC/RtpDataCounter.hpp"
+#include "RTC/Metrics.hpp"
 #include "RTC/RTCP/Sdes.hpp"
 #include "RTC/RTCP/ReceiverReport.hpp"
 #include "RTC/RTCP/FeedbackRtpNack.hpp"
 #include "RTC/RTCP/CompoundPacket.hpp"
 #include "Channel/Request.hpp"
 #include "Channel/Notifier.hpp"
+#include "DepLibUV.hpp"
 #include <unordered_set>
 #include <vector>
 #include <json/json.h>
@@ -29,11 +36,14 @@ namespace RTC
 		{
 		public:
 			virtual void onRtpSenderClosed(RtpSender* rtpSender) = 0;
+			virtual void onRtpSenderKeyFrameRequired(RtpSender* rtpSender, size_t encodingIndex) = 0;
 		};
 
 	private:
 		// Container of RTP packets to retransmit.
 		static std::vector<RTC::RtpPacket*> rtpRetransmissionContainer;
+		// Buffer to encapsulate retransmitted packets into RTX.
+		static uint8_t rtxBuffer[];
 
 	public:
 		RtpSender(Listener* listener, Channel::Notifier* notifier, uint32_t rtpSenderId, RTC::Media::Kind kind);
@@ -52,14 +62,29 @@ namespace RTC
 		void RemoveTransport(RTC::Transport* transport);
 		RTC::RtpParameters* GetParameters() const;
 		bool GetActive() const;
-		void SendRtpPacket(RTC::RtpPacket* packet);
+		void SetPaused(bool paused);
+		size_t GetCurrentEncoding() const;
+		uint32_t GetSourceSsrc() const;
+		bool NeedsPriming(size_t encodingIndex) const;
+		void Prime(const RTC::KeyFrameCache* keyFrameCache, const RTC::RtpPacket* packet, size_t encodingIndex);
+		void SendRtpPacket(RTC::RtpPacket* packet, size_t encodingIndex = 0);
+		void Resync();
 		void GetRtcp(RTC::RTCP::CompoundPacket *packet, uint64_t now);
 		void ReceiveNack(RTC::RTCP::FeedbackRtpNackPacket* nackPacket);
 		void ReceiveRtcpReceiverReport(RTC::RTCP::ReceiverReport* report);
+		void ReceiveRemb(uint32_t bitrate);
+		uint32_t GetRembBitrate(uint64_t now) const;
+		uint32_t GetAvailableBitrate(uint64_t now) const;
 		uint32_t GetTransmissionRate(uint64_t now);
 
 	private:
+		void SetRtx(RTC::RtpEncodingParameters& encoding);
+		void SetFec(RTC::RtpEncodingParameters& encoding);
+		void SetRed(RTC::RtpEncodingParameters& encoding);
 		void CreateRtpStream(RTC::RtpEncodingParameters& encoding);
+		bool SwitchEncoding(RTC::RtpPacket* packet, size_t encodingIndex);
+		bool CheckLayers(const RTC::Codecs::PayloadDescriptor& descriptor);
+		void DropPacket(uint16_t seq, bool isNewest);
 		void RetransmitRtpPacket(RTC::RtpPacket* packet);
 		void EmitActiveChange() const;
 
@@ -77,19 +102,70 @@ namespace RTC
 		// Allocated by this.
 		RTC::RtpParameters* rtpParameters = nullptr;
 		RTC::RtpStreamSend* rtpStream = nullptr;
+		RTC::FecGenerator* fecGenerator = nullptr;
+		RTC::RedEncoder* redEncoder = nullptr;
 		// Others.
 		std::unordered_set<uint8_t> supportedPayloadTypes;
 		// Whether this RtpSender is valid according to Peer capabilities.
 		bool available = false;
 		// Whether this RtpSender has been disabled by the app.
 		bool disabled = false;
+		// Whether this RtpSender has been paused by the Room (last-N).
+		bool paused = false;
 		// Timestamp when last RTCP was sent.
 		uint64_t lastRtcpSentTime = 0;
 		uint16_t maxRtcpInterval;
+		// Simulcast: number of encodings in the source RtpReceiver, the one
+		// requested by the app and the one being forwarded.
+		size_t sourceEncodings = 1;
+		size_t targetEncoding = 0;
+		size_t currentEncoding = 0;
+		// Whether the first packet has been forwarded.
+		bool started = false;
+		// Whether the source packets were skipped on purpose so the output stream
+		// must continue with the next one (without a gap).
+		bool resync = false;
+		// Whether it was primed with just a cached key frame so packets must be
+		// dropped until the next one.
+		bool waitingKeyFrame = false;
+		// Header rewriting so the remote peer sees a single continuous stream.
+		uint32_t sourceSsrc = 0;
+		uint32_t clockRate = 0;
+		uint16_t seqOffset = 0;
+		uint32_t tsOffset = 0;
+		uint16_t lastSeq = 0;
+		uint32_t lastTimestamp = 0;
+		uint64_t lastPacketTime = 0;
+		// Source sequence numbers since the switching point (and the dropped ones
+		// so the output ones have no gaps).
+		RTC::SeqTracker sourceSeqTracker;
+		// VP8/VP9 layers requested by the app and the ones being forwarded
+		// (255 means all).
+		uint8_t targetSpatialLayer = 255;
+		uint8_t targetTemporalLayer = 255;
+		uint8_t currentSpatialLayer = 255;
+		uint8_t currentTemporalLayer = 255;
+		// VP8/VP9 picture id and TL0PICIDX rewriting.
+		bool resyncPictureId = false;
+		bool pictureDropped = false;
+		uint16_t pictureIdOffset = 0;
+		uint16_t lastPictureId = 0;
+		uint16_t lastDroppedPictureId = 0;
+		uint8_t tl0PicIdxOffset = 0;
+		uint8_t lastTl0PicIdx = 0;
+		// Bitrate announced by the remote peer via REMB and when.
+		uint32_t rembBitrate = 0;
+		uint64_t rembTime = 0;
+		// Transport-wide sequence number header extension id (0 if not used).
+		uint8_t transportWideCcId = 0;
+		// RTX stream (0 SSRC if the peer does not support it).
+		uint32_t rtxSsrc = 0;
+		uint8_t rtxPayloadType = 0;
+		uint16_t rtxSeq = 0;
 		// RTP counters.
 		RTC::RtpDataCounter transmittedCounter;
-		// TODO: keep track of retransmitted data too.
-		// RTC::RtpDataCounter retransmitted;
+		RTC::RtpDataCounter retransmittedCounter;
+		RTC::Metrics::StreamCounters counters;
 	};
 
 	/* Inline methods. */
@@ -132,7 +208,78 @@ namespace RTC
 	inline
 	bool RtpSender::GetActive() const
 	{
-		return (this->available && this->transport && !this->disabled);
+		return (this->available && this->transport && !this->disabled && !this->paused);
+	}
+
+	inline
+	size_t RtpSender::GetCurrentEncoding() const
+	{
+		return this->currentEncoding;
+	}
+
+	inline
+	uint32_t RtpSender::GetSourceSsrc() const
+	{
+		return this->sourceSsrc;
+	}
+
+	/**
+	 * Whether nothing has been forwarded yet so the RtpSender can be primed
+	 * with the key frame cache of the given encoding.
+	 */
+	inline
+	bool RtpSender::NeedsPriming(size_t encodingIndex) const
+	{
+		return (
+			!this->started &&
+			this->kind == RTC::Media::Kind::VIDEO &&
+			encodingIndex == this->targetEncoding &&
+			this->GetActive()
+		);
+	}
+
+	/**
+	 * Called when source packets were not given to this RtpSender on purpose.
+	 */
+	inline
+	void RtpSender::Resync()
+	{
+		if (this->started)
+			this->resync = true;
+	}
+
+	inline
+	void RtpSender::ReceiveRemb(uint32_t bitrate)
+	{
+		this->rembBitrate = bitrate;
+		this->rembTime = DepLibUV::GetTime();
+	}
+
+	/**
+	 * Latest REMB bitrate (0 if none was received in the last 10 seconds).
+	 */
+	inline
+	uint32_t RtpSender::GetRembBitrate(uint64_t now) const
+	{
+		if (!this->rembTime || now - this->rembTime > 10000)
+			return 0;
+
+		return this->rembBitrate;
+	}
+
+	/**
+	 * Bitrate that can be sent to the remote peer as estimated by the Transport
+	 * out of transport-cc feedback, or the REMB one otherwise (0 if unknown).
+	 */
+	inline
+	uint32_t RtpSender::GetAvailableBitrate(uint64_t now) const
+	{
+		uint32_t availableBitrate = this->transport ? this->transport->GetAvailableBitrate() : 0;
+
+		if (availableBitrate)
+			return availableBitrate;
+
+		return GetRembBitrate(now);
 	}
 
 	inline
@@ -24,6 +24,7 @@ namespace RTC
 			bool              useNack = false;
 			bool              usePli = false;
 			uint8_t           absSendTimeId = 0; // 0 means no abs-send-time id.
+			uint8_t           ssrcAudioLevelId = 0; // 0 means no ssrc-audio-level id.
 		};
 
 	public:
@@ -2,19 +2,21 @@
 #define MS_RTC_RTP_STREAM_RECV_HPP
 
 #include "RTC/RtpStream.hpp"
+#include "RTC/NackGenerator.hpp"
 #include "RTC/RTCP/ReceiverReport.hpp"
 #include "RTC/RTCP/SenderReport.hpp"
 
 namespace RTC
 {
 	class RtpStreamRecv :
-		public RtpStream
+		public RtpStream,
+		public RTC::NackGenerator::Listener
 	{
 	public:
 		class Listener
 		{
 		public:
-			virtual void onNackRequired(RTC::RtpStreamRecv* rtpStream, uint16_t seq, uint16_t bitmask) = 0;
+			virtual void onNackRequired(RTC::RtpStreamRecv* rtpStream, const std::vector<uint16_t>& seqNumbers) = 0;
 			virtual void onPliRequired(RTC::RtpStreamRecv* rtpStream) = 0;
 		};
 
@@ -26,25 +28,30 @@ namespace RTC
 		virtual bool ReceivePacket(RTC::RtpPacket* packet) override;
 		RTC::RTCP::ReceiverReport* GetRtcpReceiverReport();
 		void ReceiveRtcpSenderReport(RTC::RTCP::SenderReport* report);
+		void UpdateRtt(uint32_t rtt);
 
 	private:
 		void CalculateJitter(uint32_t rtpTimestamp);
-		void MayTriggerNack(RTC::RtpPacket* packet);
-		void ResetNack();
 
 	/* Pure virtual methods inherited from RtpStream. */
 	protected:
 		virtual void onInitSeq() override;
 
+	/* Pure virtual methods inherited from RTC::NackGenerator::Listener. */
+	public:
+		virtual void onNackGeneratorNackRequired(RTC::NackGenerator* nackGenerator, const std::vector<uint16_t>& seqNumbers) override;
+		virtual void onNackGeneratorKeyFrameRequired(RTC::NackGenerator* nackGenerator) override;
+
 	private:
 		// Passed by argument.
 		Listener* listener = nullptr;
+		// Allocated by this.
+		RTC::NackGenerator* nackGenerator = nullptr;
 		// Others.
 		uint32_t last_sr_timestamp = 0; // The middle 32 bits out of 64 in the NTP timestamp received in the most recent sender report.
 		uint64_t last_sr_received = 0; // Wallclock time representing the most recent sender report arrival.
 		uint32_t transit = 0; // Relative trans time for prev pkt.
 		uint32_t jitter = 0; // Estimated jitter.
-		uint32_t last_seq32 = 0; // Extended seq number of last valid packet.
 	};
 }
 
@@ -0,0 +1,85 @@
+#ifndef MS_RTC_SEND_SIDE_BANDWIDTH_ESTIMATOR_HPP
+#define MS_RTC_SEND_SIDE_BANDWIDTH_ESTIMATOR_HPP
+
+#include "common.hpp"
+#include "RTC/RtpDataCounter.hpp"
+#include "RTC/RTCP/FeedbackRtpTransport.hpp"
+#include "RTC/RemoteBitrateEstimator/InterArrival.hpp"
+#include "RTC/RemoteBitrateEstimator/OveruseEstimator.hpp"
+#include "RTC/RemoteBitrateEstimator/OveruseDetector.hpp"
+#include "RTC/RemoteBitrateEstimator/AimdRateControl.hpp"
+#include <vector>
+#include <json/json.h>
+
+namespace RTC
+{
+	/**
+	 * Estimates the bitrate that can be sent over a Transport out of the
+	 * transport-cc feedback of the remote peer. The delay based estimation
+	 * reuses the receive side machinery (InterArrival, OveruseEstimator,
+	 * OveruseDetector and AimdRateControl) with local send times, and the
+	 * loss based one follows the usual 2% / 10% thresholds. The lowest one wins.
+	 */
+	class SendSideBandwidthEstimator
+	{
+	public:
+		// Sent packets remembered until their feedback arrives (power of 2).
+		static constexpr size_t HistorySize = 1024;
+		static constexpr uint32_t StartBitrate = 300000;
+		static constexpr uint32_t MinBitrate = 30000;
+		// Min number of reported packets to compute the loss fraction.
+		static constexpr size_t LossWindowPackets = 20;
+		static constexpr uint64_t LossIncreaseInterval = 1000;
+		static constexpr uint64_t LossDecreaseInterval = 300;
+
+	public:
+		SendSideBandwidthEstimator();
+
+		Json::Value toJson() const;
+		uint16_t PacketSent(size_t size, uint64_t now);
+		void ReceiveFeedback(const RTC::RTCP::FeedbackRtpTransportPacket* feedback, uint64_t now);
+		uint32_t GetAvailableBitrate() const;
+
+	private:
+		void UpdateLossBased(uint64_t now);
+
+	private:
+		struct SentPacket
+		{
+			uint64_t sendTime = 0;
+			uint32_t size = 0;
+			uint16_t sequenceNumber = 0;
+			bool valid = false;
+		};
+
+	private:
+		// Allocated by this.
+		std::vector<SentPacket> history;
+		std::unique_ptr<InterArrival> interArrival;
+		std::unique_ptr<OveruseEstimator> estimator;
+		// Others.
+		uint16_t wideSeqNumber = 0;
+		OveruseDetector detector;
+		AimdRateControl rateControl;
+		RateCalculator ackedBitrate;
+		uint32_t delayBasedBitrate = StartBitrate;
+		uint32_t lossBasedBitrate = StartBitrate;
+		uint32_t availableBitrate = StartBitrate;
+		size_t lossWindowPackets = 0;
+		size_t lossWindowLost = 0;
+		uint8_t fractionLost = 0;
+		uint64_t lastLossIncreaseTime = 0;
+		uint64_t lastLossDecreaseTime = 0;
+		size_t feedbacks = 0;
+	};
+
+	/* Inline instance methods. */
+
+	inline
+	uint32_t SendSideBandwidthEstimator::GetAvailableBitrate() const
+	{
+		return this->availableBitrate;
+	}
+}
+
+#endif
@@ -0,0 +1,110 @@
+#ifndef MS_RTC_SEQ_TRACKER_HPP
+#define MS_RTC_SEQ_TRACKER_HPP
+
+#include "common.hpp"
+#include <deque>
+
+namespace RTC
+{
+	/**
+	 * Tracks the sequence numbers of the source packets of a RtpSender since
+	 * its last switching point, so packets sent before it (by the previous
+	 * encoding) are ignored no matter how many times the sequence number
+	 * wraps afterwards.
+	 *
+	 * It also keeps the source packets dropped on purpose (i.e. layers above
+	 * the target ones) so the output sequence numbers have no gaps: a packet is
+	 * sent with the offset that applied at its position, which is the current
+	 * one plus the number of dropped packets newer than it.
+	 */
+	class SeqTracker
+	{
+	public:
+		// Max distance behind the highest sequence number for an older packet
+		// to be accepted.
+		static constexpr uint16_t MaxReorder = 0x4000;
+		// Max number of dropped packets remembered. Packets older than a
+		// forgotten one are ignored.
+		static constexpr size_t MaxDropped = 512;
+
+	public:
+		void Sync(uint16_t seq);
+		bool Receive(uint16_t seq, bool* isNewest);
+		void Drop(uint16_t seq);
+		bool GetDroppedAfter(uint16_t seq, uint16_t* count) const;
+		uint16_t GetMaxSeq() const;
+
+	private:
+		// Others.
+		uint16_t syncSeq = 0;
+		uint16_t maxSeq = 0;
+		// Dropped sequence numbers (oldest first).
+		std::deque<uint16_t> dropped;
+	};
+
+	/* Inline instance methods. */
+
+	/**
+	 * Returns false if the packet was sent before the switching point (or it
+	 * is too old). isNewest is set if it is the highest sequence number so far.
+	 */
+	inline
+	bool SeqTracker::Receive(uint16_t seq, bool* isNewest)
+	{
+		*isNewest = static_cast<uint16_t>(seq - this->maxSeq - 1) < 0x8000;
+
+		if (*isNewest)
+		{
+			this->maxSeq = seq;
+
+			// Drag the switching point so it stays within MaxReorder behind the
+			// newest packet, otherwise every packet would look older than it once
+			// the sequence number moves 32768 past it.
+			if (static_cast<uint16_t>(seq - this->syncSeq) > MaxReorder)
+			{
+				this->syncSeq = seq - MaxReorder;
+
+				while (!this->dropped.empty() && static_cast<uint16_t>(this->dropped.front() - this->syncSeq) >= 0x8000)
+				{
+					this->dropped.pop_front();
+				}
+			}
+
+			return true;
+		}
+
+		return static_cast<uint16_t>(seq - this->syncSeq) < 0x8000;
+	}
+
+	/**
+	 * Returns false if the packet was dropped. Otherwise count is set to the
+	 * number of dropped packets newer than it.
+	 */
+	inline
+	bool SeqTracker::GetDroppedAfter(uint16_t seq, uint16_t* count) const
+	{
+		*count = 0;
+
+		for (auto it = this->dropped.rbegin(); it != this->dropped.rend(); ++it)
+		{
+			uint16_t delta = *it - seq;
+
+			if (delta == 0)
+				return false;
+			else if (delta >= 0x8000)
+				break;
+
+			(*count)++;
+		}
+
+		return true;
+	}
+
+	inline
+	uint16_t SeqTracker::GetMaxSeq() const
+	{
+		return this->maxSeq;
+	}
+}
+
+#endif
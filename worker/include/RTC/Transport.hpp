@@ -16,11 +16,20 @@
 #include "RTC/RtpPacket.hpp"
 #include "RTC/RTCP/Packet.hpp"
 #include "RTC/RTCP/CompoundPacket.hpp"
+#include "RTC/RTCP/FeedbackRtpTransport.hpp"
+#include "RTC/RTCP/FeedbackPsRemb.hpp"
 #include "RTC/RemoteBitrateEstimator/RemoteBitrateEstimatorAbsSendTime.hpp"
+#include "RTC/SendSideBandwidthEstimator.hpp"
+#include "RTC/TransportFeedbackGenerator.hpp"
+#include "RTC/Pacer.hpp"
+#include "RTC/PacketTrace.hpp"
+#include "RTC/Metrics.hpp"
 #include "Channel/Request.hpp"
 #include "Channel/Notifier.hpp"
 #include <string>
 #include <vector>
+#include <unordered_map>
+#include <unordered_set>
 #include <json/json.h>
 
 namespace RTC
@@ -31,7 +40,9 @@ namespace RTC
 		public RTC::TcpConnection::Listener,
 		public RTC::IceServer::Listener,
 		public RTC::DtlsTransport::Listener,
-		public RTC::RemoteBitrateEstimator::Listener
+		public RTC::RemoteBitrateEstimator::Listener,
+		public RTC::TransportFeedbackGenerator::Listener,
+		public RTC::Pacer::Listener
 	{
 	public:
 		class Listener
@@ -56,14 +67,23 @@ namespace RTC
 		void HandleRequest(Channel::Request* request);
 		void AddRtpReceiver(RTC::RtpReceiver* rtpReceiver);
 		void RemoveRtpReceiver(RTC::RtpReceiver* rtpReceiver);
-		void SendRtpPacket(RTC::RtpPacket* packet);
+		void SendRtpPacket(RTC::RtpPacket* packet, uint8_t transportWideCcId = 0, RTC::Pacer::Priority priority = RTC::Pacer::Priority::VIDEO);
 		void SendRtcpPacket(RTC::RTCP::Packet* packet);
 		void SendRtcpCompoundPacket(RTC::RTCP::CompoundPacket* packet);
 		RTC::RtpReceiver* GetRtpReceiver(uint32_t ssrc);
 		void EnableRemb();
+		void SetRtpReceiverRemb(RTC::RtpReceiver* rtpReceiver, uint32_t bitrate);
+		void ReceiveTransportFeedback(RTC::RTCP::FeedbackRtpTransportPacket* feedback);
+		void ReceiveRemb(RTC::RTCP::FeedbackPsRembPacket* remb);
+		uint32_t GetAvailableBitrate() const;
+		void SetRtt(uint32_t rtt);
+		uint32_t GetRtt() const;
 
 	private:
 		void MayRunDtlsTransport();
+		void SendRemb(uint64_t now);
+		void TransmitRtpPacket(RTC::RtpPacket* packet, uint8_t transportWideCcId);
+		uint32_t GetPacingBitrate(uint64_t now) const;
 
 	/* Private methods to unify UDP and TCP behavior. */
 	private:
@@ -106,6 +126,14 @@ namespace RTC
 	public:
 		virtual void onReceiveBitrateChanged(const std::vector<uint32_t>& ssrcs, uint32_t bitrate) override;
 
+	/* Pure virtual methods inherited from RTC::TransportFeedbackGenerator::Listener. */
+	public:
+		virtual void onTransportFeedbackGeneratorFeedback(RTC::TransportFeedbackGenerator* transportFeedbackGenerator, RTC::RTCP::FeedbackRtpTransportPacket* packet) override;
+
+	/* Pure virtual methods inherited from RTC::Pacer::Listener. */
+	public:
+		virtual void onPacerRtpPacket(RTC::Pacer* pacer, RTC::RtpPacket* packet, uint8_t transportWideCcId) override;
+
 	public:
 		// Passed by argument.
 		uint32_t transportId;
@@ -131,8 +159,37 @@ namespace RTC
 		RTC::DtlsTransport::Role dtlsLocalRole = RTC::DtlsTransport::Role::AUTO;
 		// Others (RtpListener).
 		RtpListener rtpListener;
+		// All the RtpReceivers of this Transport (some may not be in every table
+		// of the RtpListener, i.e. those without payload types).
+		std::unordered_set<RTC::RtpReceiver*> rtpReceivers;
 		// REMB.
 		std::unique_ptr<RemoteBitrateEstimatorAbsSendTime> remoteBitrateEstimator;
+		uint32_t estimatedBitrate = 0;
+		std::vector<uint32_t> estimatedSsrcs;
+		// Bitrate the remote receivers of each RtpReceiver can take (announced
+		// via REMB to the source along with the estimated one).
+		std::unordered_map<RTC::RtpReceiver*, uint32_t> rtpReceiversRemb;
+		uint32_t lastRembBitrate = 0;
+		uint64_t lastRembSentTime = 0;
+		// Send side bandwidth estimation (created once transport-cc is used).
+		std::unique_ptr<RTC::SendSideBandwidthEstimator> sendSideBandwidthEstimator;
+		// Receive side transport-cc feedback (created once a packet with
+		// transport-wide sequence number is received).
+		std::unique_ptr<RTC::TransportFeedbackGenerator> transportFeedbackGenerator;
+		// Bitrate announced via REMB by the remote peer.
+		uint32_t remoteRembBitrate = 0;
+		uint64_t remoteRembTime = 0;
+		// Pacer (enabled by the app). A bitrate of 0 means derived from the
+		// remote estimations.
+		std::unique_ptr<RTC::Pacer> pacer;
+		uint32_t pacerBitrate = 0;
+		// RTT (ms) with the remote peer as computed by the RtpSenders out of the
+		// Receiver Reports (0 means unknown).
+		uint32_t rtt = 0;
+		// Headers of the latest RTP and RTCP packets.
+		RTC::PacketTrace packetTrace;
+		// Stats.
+		RTC::Metrics::TransportCounters counters;
 	};
 
 	/* Inline instance methods. */
@@ -141,12 +198,15 @@ namespace RTC
 	void Transport::AddRtpReceiver(RTC::RtpReceiver* rtpReceiver)
 	{
 		this->rtpListener.AddRtpReceiver(rtpReceiver);
+		this->rtpReceivers.insert(rtpReceiver);
 	}
 
 	inline
 	void Transport::RemoveRtpReceiver(RTC::RtpReceiver* rtpReceiver)
 	{
 		this->rtpListener.RemoveRtpReceiver(rtpReceiver);
+		this->rtpReceivers.erase(rtpReceiver);
+		this->rtpReceiversRemb.erase(rtpReceiver);
 	}
 
 	inline
@@ -155,6 +215,30 @@ namespace RTC
 		return this->rtpListener.GetRtpReceiver(ssrc);
 	}
 
+	/**
+	 * Returns 0 if the remote peer does not send transport-cc feedback.
+	 */
+	inline
+	uint32_t Transport::GetAvailableBitrate() const
+	{
+		if (!this->sendSideBandwidthEstimator)
+			return 0;
+
+		return this->sendSideBandwidthEstimator->GetAvailableBitrate();
+	}
+
+	inline
+	void Transport::SetRtt(uint32_t rtt)
+	{
+		this->rtt = rtt;
+	}
+
+	inline
+	uint32_t Transport::GetRtt() const
+	{
+		return this->rtt;
+	}
+
 	inline
 	void Transport::EnableRemb()
 	{
@@ -0,0 +1,63 @@
+#ifndef MS_RTC_TRANSPORT_FEEDBACK_GENERATOR_HPP
+#define MS_RTC_TRANSPORT_FEEDBACK_GENERATOR_HPP
+
+#include "common.hpp"
+#include "RTC/RTCP/FeedbackRtpTransport.hpp"
+#include <map>
+#include <json/json.h>
+
+namespace RTC
+{
+	/**
+	 * Records the arrival time of the packets received over a Transport with a
+	 * transport-wide sequence number and reports them to the remote sender in
+	 * transport-cc feedback packets (RTPFB FMT 15).
+	 *
+	 * There is no timer: the feedback is generated when a packet arrives once
+	 * the interval has elapsed or too many packets are pending.
+	 */
+	class TransportFeedbackGenerator
+	{
+	public:
+		class Listener
+		{
+		public:
+			virtual void onTransportFeedbackGeneratorFeedback(RTC::TransportFeedbackGenerator* transportFeedbackGenerator, RTC::RTCP::FeedbackRtpTransportPacket* packet) = 0;
+		};
+
+	public:
+		// Min time (ms) between two feedback packets.
+		static constexpr uint64_t Interval = 100;
+		// Max number of packet statuses in a feedback packet (so it fits in a
+		// single datagram even with large deltas).
+		static constexpr size_t MaxStatusCount = 250;
+
+	public:
+		explicit TransportFeedbackGenerator(Listener* listener);
+
+		Json::Value toJson() const;
+		void ReceivePacket(uint16_t wideSeqNumber, uint32_t mediaSsrc, uint64_t now);
+
+	private:
+		void SendFeedback(uint64_t now);
+
+	private:
+		// Passed by argument.
+		Listener* listener = nullptr;
+		// Others.
+		bool started = false;
+		// Unwrapped seq number of the latest received packet.
+		int64_t lastSeq = 0;
+		// Unwrapped seq number of the first packet not reported yet.
+		int64_t baseSeq = 0;
+		// Arrival time (ms) of the pending packets by unwrapped seq number.
+		std::map<int64_t, uint64_t> arrivals;
+		uint32_t mediaSsrc = 0;
+		uint8_t feedbackPacketCount = 0;
+		uint64_t lastFeedbackTime = 0;
+		// Stats.
+		size_t feedbackPacketsSent = 0;
+	};
+}
+
+#endif
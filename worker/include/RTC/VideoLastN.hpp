@@ -0,0 +1,52 @@
+#ifndef MS_RTC_VIDEO_LAST_N_HPP
+#define MS_RTC_VIDEO_LAST_N_HPP
+
+#include "common.hpp"
+#include <vector>
+
+namespace RTC
+{
+	/**
+	 * Selects the Peers (identified by their id) whose video is forwarded to
+	 * each Peer of a room: the N most recent dominant speakers and then the
+	 * Peers by arrival. A Peer does not take a place in its own last-N, so
+	 * every Peer receives the video of N other Peers. If N is 0 the video of
+	 * all the Peers is forwarded.
+	 */
+	class VideoLastN
+	{
+	public:
+		explicit VideoLastN(size_t lastN = 0);
+
+		void AddPeer(uint32_t peerId);
+		void RemovePeer(uint32_t peerId);
+		bool SetDominantSpeaker(uint32_t peerId);
+		bool IsForwarded(uint32_t receiverPeerId, uint32_t senderPeerId) const;
+		size_t GetLastN() const;
+		const std::vector<uint32_t>& GetSpeakers() const;
+
+	private:
+		// Passed by argument.
+		size_t lastN = 0;
+		// Others.
+		// Peers by their last time as dominant speaker (most recent first) and
+		// then by arrival.
+		std::vector<uint32_t> speakers;
+	};
+
+	/* Inline instance methods. */
+
+	inline
+	size_t VideoLastN::GetLastN() const
+	{
+		return this->lastN;
+	}
+
+	inline
+	const std::vector<uint32_t>& VideoLastN::GetSpeakers() const
+	{
+		return this->speakers;
+	}
+}
+
+#endif
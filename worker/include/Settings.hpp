@@ -37,6 +37,7 @@ public:
 		uint16_t       rtcMaxPort           { 59999 };
 		std::string    dtlsCertificateFile;
 		std::string    dtlsPrivateKeyFile;
+		std::string    channelFormat        { "json" };
 		// Private fields.
 		bool           hasIPv4              { false };
 		bool           hasIPv6              { false };
@@ -56,6 +57,7 @@ private:
 	static void SetRtcIPv6(const std::string &ip);
 	static void SetRtcPorts();
 	static void SetDtlsCertificateAndPrivateKeyFiles();
+	static void SetChannelFormat(std::string &format);
 	static void SetLogTags(std::vector<std::string>& tags);
 	static void SetLogTags(Json::Value& json);
 
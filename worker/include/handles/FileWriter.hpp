@@ -0,0 +1,77 @@
+#ifndef MS_FILE_WRITER_HPP
+#define	MS_FILE_WRITER_HPP
+
+#include "common.hpp"
+#include <string>
+#include <vector>
+#include <uv.h>
+
+/**
+ * File written with asynchronous libuv fs requests (one at a time) so the
+ * loop never waits for the disk. The file is opened synchronously so the
+ * caller gets the error (if any).
+ *
+ * Close() closes the file once the pending write (if any) is done and
+ * deletes the instance.
+ */
+class FileWriter
+{
+public:
+	class Listener
+	{
+	public:
+		virtual ~Listener() {};
+
+	public:
+		// err is 0 if all the data was written.
+		virtual void onFileWriterWrite(FileWriter* fileWriter, size_t written, int err) = 0;
+		virtual void onFileWriterClosed(FileWriter* fileWriter) = 0;
+	};
+
+public:
+	// listener may be nullptr.
+	FileWriter(Listener* listener, const std::string& path);
+	FileWriter& operator=(const FileWriter&) = delete;
+	FileWriter(const FileWriter&) = delete;
+
+private:
+	~FileWriter() {};
+
+public:
+	void Close();
+	void Write(std::vector<uint8_t>&& data, int64_t offset);
+	bool IsWriting() const;
+
+private:
+	void WriteRest();
+
+/* Callbacks fired by UV events. */
+public:
+	void onUvWrite(ssize_t result);
+	void onUvClose();
+
+private:
+	// Passed by argument.
+	Listener* listener = nullptr;
+	// Others.
+	uv_file fd = -1;
+	uv_fs_t writeReq;
+	uv_fs_t closeReq;
+	bool writing = false;
+	bool closing = false;
+	// Data being written, bytes of it already written and file offset of the
+	// rest.
+	std::vector<uint8_t> data;
+	size_t pos = 0;
+	int64_t offset = 0;
+};
+
+/* Inline methods. */
+
+inline
+bool FileWriter::IsWriting() const
+{
+	return this->writing;
+}
+
+#endif
@@ -0,0 +1,48 @@
+#ifndef MS_IDLE_HPP
+#define	MS_IDLE_HPP
+
+#include "common.hpp"
+#include <uv.h>
+
+/**
+ * Runs the listener once per loop iteration while started. An active idle
+ * handle makes the loop poll for I/O without blocking, so it must be stopped
+ * when there is nothing left to do. The handle does not keep the loop alive.
+ */
+class Idle
+{
+public:
+	class Listener
+	{
+	public:
+		virtual ~Listener() {};
+
+	public:
+		virtual void onIdle(Idle* idle) = 0;
+	};
+
+public:
+	explicit Idle(Listener* listener);
+	Idle& operator=(const Idle&) = delete;
+	Idle(const Idle&) = delete;
+
+private:
+	~Idle() {};
+
+public:
+	void Destroy();
+	void Start();
+	void Stop();
+
+/* Callbacks fired by UV events. */
+public:
+	void onUvIdle();
+
+private:
+	// Passed by argument.
+	Listener* listener = nullptr;
+	// Allocated by this.
+	uv_idle_t* uvHandle = nullptr;
+};
+
+#endif
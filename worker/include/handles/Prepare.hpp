@@ -0,0 +1,47 @@
+#ifndef MS_PREPARE_HPP
+#define	MS_PREPARE_HPP
+
+#include "common.hpp"
+#include <uv.h>
+
+/**
+ * Runs the listener once per loop iteration, right before the loop blocks
+ * for I/O. The handle does not keep the loop alive.
+ */
+class Prepare
+{
+public:
+	class Listener
+	{
+	public:
+		virtual ~Listener() {};
+
+	public:
+		virtual void onPrepare(Prepare* prepare) = 0;
+	};
+
+public:
+	explicit Prepare(Listener* listener);
+	Prepare& operator=(const Prepare&) = delete;
+	Prepare(const Prepare&) = delete;
+
+private:
+	~Prepare() {};
+
+public:
+	void Destroy();
+	void Start();
+	void Stop();
+
+/* Callbacks fired by UV events. */
+public:
+	void onUvPrepare();
+
+private:
+	// Passed by argument.
+	Listener* listener = nullptr;
+	// Allocated by this.
+	uv_prepare_t* uvHandle = nullptr;
+};
+
+#endif
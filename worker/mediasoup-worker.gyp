@@ -18,29 +18,46 @@
       'src/Logger.cpp',
       'src/Loop.cpp',
       'src/Settings.cpp',
+      'src/Channel/MsgPack.cpp',
       'src/Channel/Notifier.cpp',
       'src/Channel/Request.cpp',
+      'src/Channel/ResponseWriter.cpp',
       'src/Channel/UnixStreamSocket.cpp',
+      'src/RTC/AudioLevelObserver.cpp',
       'src/RTC/DtlsTransport.cpp',
+      'src/RTC/FecGenerator.cpp',
       'src/RTC/IceCandidate.cpp',
       'src/RTC/IceServer.cpp',
+      'src/RTC/KeyFrameCache.cpp',
+      'src/RTC/Metrics.cpp',
+      'src/RTC/NackGenerator.cpp',
+      'src/RTC/Pacer.cpp',
+      'src/RTC/PacketTrace.cpp',
       'src/RTC/Peer.cpp',
+      'src/RTC/Recorder.cpp',
+      'src/RTC/RedEncoder.cpp',
+      'src/RTC/RembAggregator.cpp',
       'src/RTC/Room.cpp',
       'src/RTC/RtpListener.cpp',
       'src/RTC/RtpPacket.cpp',
+      'src/RTC/RtpRawRing.cpp',
       'src/RTC/RtpReceiver.cpp',
       'src/RTC/RtpSender.cpp',
+      'src/RTC/SeqTracker.cpp',
       'src/RTC/RtpStream.cpp',
       'src/RTC/RtpStreamRecv.cpp',
       'src/RTC/RtpStreamSend.cpp',
       'src/RTC/RtpDataCounter.cpp',
+      'src/RTC/SendSideBandwidthEstimator.cpp',
       'src/RTC/SrtpSession.cpp',
       'src/RTC/StunMessage.cpp',
       'src/RTC/TcpConnection.cpp',
       'src/RTC/TcpServer.cpp',
       'src/RTC/Transport.cpp',
+      'src/RTC/TransportFeedbackGenerator.cpp',
       'src/RTC/TransportTuple.cpp',
       'src/RTC/UdpSocket.cpp',
+      'src/RTC/VideoLastN.cpp',
       'src/RTC/RtpDictionaries/Media.cpp',
       'src/RTC/RtpDictionaries/Parameters.cpp',
       'src/RTC/RtpDictionaries/RtcpFeedback.cpp',
@@ -55,6 +72,8 @@
       'src/RTC/RtpDictionaries/RtpHeaderExtensionUri.cpp',
       'src/RTC/RtpDictionaries/RtpParameters.cpp',
       'src/RTC/RtpDictionaries/RtpRtxParameters.cpp',
+      'src/RTC/Codecs/PayloadParser.cpp',
+      'src/RTC/Codecs/Tools.cpp',
       'src/RTC/RTCP/Packet.cpp',
       'src/RTC/RTCP/CompoundPacket.cpp',
       'src/RTC/RTCP/SenderReport.cpp',
@@ -69,6 +88,7 @@
       'src/RTC/RTCP/FeedbackRtpSrReq.cpp',
       'src/RTC/RTCP/FeedbackRtpTllei.cpp',
       'src/RTC/RTCP/FeedbackRtpEcn.cpp',
+      'src/RTC/RTCP/FeedbackRtpTransport.cpp',
       'src/RTC/RTCP/FeedbackPsPli.cpp',
       'src/RTC/RTCP/FeedbackPsSli.cpp',
       'src/RTC/RTCP/FeedbackPsRpsi.cpp',
@@ -87,6 +107,9 @@
       'src/Utils/Crypto.cpp',
       'src/Utils/File.cpp',
       'src/Utils/IP.cpp',
+      'src/handles/FileWriter.cpp',
+      'src/handles/Idle.cpp',
+      'src/handles/Prepare.cpp',
       'src/handles/SignalsHandler.cpp',
       'src/handles/TcpConnection.cpp',
       'src/handles/TcpServer.cpp',
@@ -104,31 +127,51 @@
       'include/Settings.hpp',
       'include/Utils.hpp',
       'include/common.hpp',
+      'include/Channel/MsgPack.hpp',
       'include/Channel/Notifier.hpp',
       'include/Channel/Request.hpp',
+      'include/Channel/ResponseWriter.hpp',
       'include/Channel/UnixStreamSocket.hpp',
+      'include/RTC/AudioLevelObserver.hpp',
       'include/RTC/DtlsTransport.hpp',
+      'include/RTC/FecGenerator.hpp',
       'include/RTC/IceCandidate.hpp',
       'include/RTC/IceServer.hpp',
+      'include/RTC/KeyFrameCache.hpp',
+      'include/RTC/Metrics.hpp',
+      'include/RTC/NackGenerator.hpp',
+      'include/RTC/Pacer.hpp',
+      'include/RTC/PacketTrace.hpp',
       'include/RTC/Parameters.hpp',
       'include/RTC/Peer.hpp',
+      'include/RTC/Recorder.hpp',
+      'include/RTC/RedEncoder.hpp',
+      'include/RTC/RembAggregator.hpp',
       'include/RTC/Room.hpp',
       'include/RTC/RtpDictionaries.hpp',
       'include/RTC/RtpListener.hpp',
       'include/RTC/RtpPacket.hpp',
+      'include/RTC/RtpRawRing.hpp',
       'include/RTC/RtpReceiver.hpp',
       'include/RTC/RtpSender.hpp',
+      'include/RTC/SeqTracker.hpp',
       'include/RTC/RtpStream.hpp',
       'include/RTC/RtpStreamRecv.hpp',
       'include/RTC/RtpStreamSend.hpp',
       'include/RTC/RtpDataCounter.hpp',
+      'include/RTC/SendSideBandwidthEstimator.hpp',
       'include/RTC/SrtpSession.hpp',
       'include/RTC/StunMessage.hpp',
       'include/RTC/TcpConnection.hpp',
       'include/RTC/TcpServer.hpp',
       'include/RTC/Transport.hpp',
+      'include/RTC/TransportFeedbackGenerator.hpp',
       'include/RTC/TransportTuple.hpp',
       'include/RTC/UdpSocket.hpp',
+      'include/RTC/VideoLastN.hpp',
+      'include/RTC/Codecs/PayloadDescriptor.hpp',
+      'include/RTC/Codecs/PayloadParser.hpp',
+      'include/RTC/Codecs/Tools.hpp',
       'include/RTC/RTCP/Packet.hpp',
       'include/RTC/RTCP/CompoundPacket.hpp',
       'include/RTC/RTCP/SenderReport.hpp',
@@ -144,6 +187,7 @@
       'include/RTC/RTCP/FeedbackRtpSrReq.hpp',
       'include/RTC/RTCP/FeedbackRtpTllei.hpp',
       'include/RTC/RTCP/FeedbackRtpEcn.hpp',
+      'include/RTC/RTCP/FeedbackRtpTransport.hpp',
       'include/RTC/RTCP/FeedbackPsPli.hpp',
       'include/RTC/RTCP/FeedbackPsSli.hpp',
       'include/RTC/RTCP/FeedbackPsRpsi.hpp',
@@ -160,6 +204,9 @@
       'include/RTC/RemoteBitrateEstimator/RemoteBitrateEstimator.hpp',
       'include/RTC/RemoteBitrateEstimator/RemoteBitrateEstimatorAbsSendTime.hpp',
       'include/RTC/RemoteBitrateEstimator/RemoteBitrateEstimatorSingleStream.hpp',
+      'include/handles/FileWriter.hpp',
+      'include/handles/Idle.hpp',
+      'include/handles/Prepare.hpp',
       'include/handles/SignalsHandler.hpp',
       'include/handles/TcpConnection.hpp',
       'include/handles/TcpServer.hpp',
@@ -256,6 +303,23 @@
         'test/test-rtcp.cpp',
         'test/test-bitrate.cpp',
         'test/test-rtpstreamrecv.cpp',
+        'test/test-rtprawring.cpp',
+        'test/test-msgpack.cpp',
+        'test/test-logger.cpp',
+        'test/test-codecs.cpp',
+        'test/test-keyframecache.cpp',
+        'test/test-rembaggregator.cpp',
+        'test/test-pacer.cpp',
+        'test/test-nackgenerator.cpp',
+        'test/test-audiolevelobserver.cpp',
+        'test/test-fecgenerator.cpp',
+        'test/test-redencoder.cpp',
+        'test/test-recorder.cpp',
+        'test/test-packettrace.cpp',
+        'test/test-metrics.cpp',
+        'test/test-seqtracker.cpp',
+        'test/test-videolastn.cpp',
+        'test/test-responsewriter.cpp',
         # C++ include files
         'test/catch.hpp',
         'test/helpers.hpp'
@@ -0,0 +1,116 @@
+# This file is generated by gyp; do not edit.
+
+TOOLSET := target
+TARGET := jsoncpp
+DEFS_Debug := \
+	'-DDEBUG' \
+	'-DMS_LOG_FILE_LINE'
+
+# Flags passed to all source files.
+CFLAGS_Debug := \
+	-m64 \
+	-std=c++11 \
+	-Wall \
+	-Wextra \
+	-Wno-unused-parameter \
+	-g \
+	-O0 \
+	-fwrapv \
+	-Wno-parentheses-equality
+
+# Flags passed to only C files.
+CFLAGS_C_Debug :=
+
+# Flags passed to only C++ files.
+CFLAGS_CC_Debug :=
+
+INCS_Debug :=
+
+DEFS_Release := \
+	'-DMS_HOT_PATH_LOG_LEVEL=warn'
+
+# Flags passed to all source files.
+CFLAGS_Release := \
+	-m64 \
+	-std=c++11 \
+	-Wall \
+	-Wextra \
+	-Wno-unused-parameter \
+	-g
+
+# Flags passed to only C files.
+CFLAGS_C_Release :=
+
+# Flags passed to only C++ files.
+CFLAGS_CC_Release :=
+
+INCS_Release :=
+
+OBJS := \
+	$(obj).target/$(TARGET)/deps/jsoncpp/jsoncpp/bundled/jsoncpp.o
+
+# Add to the list of files we specially track dependencies for.
+all_deps += $(OBJS)
+
+# CFLAGS et al overrides must be target-local.
+# See "Target-specific Variable Values" in the GNU Make manual.
+$(OBJS): TOOLSET := $(TOOLSET)
+$(OBJS): GYP_CFLAGS := $(DEFS_$(BUILDTYPE)) $(INCS_$(BUILDTYPE))  $(CFLAGS_$(BUILDTYPE)) $(CFLAGS_C_$(BUILDTYPE))
+$(OBJS): GYP_CXXFLAGS := $(DEFS_$(BUILDTYPE)) $(INCS_$(BUILDTYPE))  $(CFLAGS_$(BUILDTYPE)) $(CFLAGS_CC_$(BUILDTYPE))
+
+# Suffix rules, putting all outputs into $(obj).
+
+$(obj).$(TOOLSET)/$(TARGET)/%.o: $(srcdir)/%.cpp FORCE_DO_CMD
+	@$(call do_cmd,cxx,1)
+
+# Try building from generated source, too.
+
+$(obj).$(TOOLSET)/$(TARGET)/%.o: $(obj).$(TOOLSET)/%.cpp FORCE_DO_CMD
+	@$(call do_cmd,cxx,1)
+
+$(obj).$(TOOLSET)/$(TARGET)/%.o: $(obj)/%.cpp FORCE_DO_CMD
+	@$(call do_cmd,cxx,1)
+
+# End of this set of suffix rules
+### Rules for final target.
+LDFLAGS_Debug := \
+	-m64
+
+LDFLAGS_Release := \
+	-m64
+
+LIBS :=
+
+$(obj).target/deps/jsoncpp/libjsoncpp.a: GYP_LDFLAGS := $(LDFLAGS_$(BUILDTYPE))
+$(obj).target/deps/jsoncpp/libjsoncpp.a: LIBS := $(LIBS)
+$(obj).target/deps/jsoncpp/libjsoncpp.a: TOOLSET := $(TOOLSET)
+$(obj).target/deps/jsoncpp/libjsoncpp.a: $(OBJS) FORCE_DO_CMD
+	$(call do_cmd,alink)
+
+all_deps += $(obj).target/deps/jsoncpp/libjsoncpp.a
+# Add target alias
+.PHONY: jsoncpp
+jsoncpp: $(obj).target/deps/jsoncpp/libjsoncpp.a
+
+# Add target alias to "all" target.
+.PHONY: all
+all: jsoncpp
+
+# Add target alias
+.PHONY: jsoncpp
+jsoncpp: $(builddir)/libjsoncpp.a
+
+# Copy this to the static library output path.
+$(builddir)/libjsoncpp.a: TOOLSET := $(TOOLSET)
+$(builddir)/libjsoncpp.a: $(obj).target/deps/jsoncpp/libjsoncpp.a FORCE_DO_CMD
+	$(call do_cmd,copy)
+
+all_deps += $(builddir)/libjsoncpp.a
+# Short alias for building this static library.
+.PHONY: libjsoncpp.a
+libjsoncpp.a: $(obj).target/deps/jsoncpp/libjsoncpp.a $(builddir)/libjsoncpp.a
+
+# Add static library to "all" target.
+.PHONY: all
+all: $(builddir)/libjsoncpp.a
+
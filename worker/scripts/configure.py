@@ -99,6 +99,9 @@ if __name__ == '__main__':
   else:
     args.append('-Dmediasoup_asan=false')
 
+  if os.environ.get('MEDIASOUP_HOT_PATH_LOG_LEVEL'):
+    args.append('-Dmediasoup_hot_path_log_level=' + os.environ['MEDIASOUP_HOT_PATH_LOG_LEVEL'])
+
   args.append('-Dnode_byteorder=' + sys.byteorder)
 
   gyp_args = list(args)
@@ -0,0 +1,502 @@
+#define MS_CLASS "Channel::MsgPack"
+// #define MS_LOG_DEV
+
+#include "Channel/MsgPack.hpp"
+#include "Utils.hpp"
+#include "Logger.hpp"
+#include <cstring> // std::memcpy()
+
+#define MAX_DEPTH 64
+
+/* Helpers declaration. */
+
+static void appendUInt8(std::string& buffer, uint8_t type, uint8_t value);
+static void appendUInt16(std::string& buffer, uint8_t type, uint16_t value);
+static void appendUInt32(std::string& buffer, uint8_t type, uint32_t value);
+static void appendUInt64(std::string& buffer, uint8_t type, uint64_t value);
+static void appendString(std::string& buffer, const char* str, size_t len);
+
+namespace Channel
+{
+	/* Class methods. */
+
+	void MsgPack::Encode(const Json::Value& json, std::string& buffer)
+	{
+		MS_TRACE();
+
+		switch (json.type())
+		{
+			case Json::nullValue:
+			{
+				buffer.push_back((char)0xC0);
+
+				break;
+			}
+
+			case Json::booleanValue:
+			{
+				buffer.push_back(json.asBool() ? (char)0xC3 : (char)0xC2);
+
+				break;
+			}
+
+			case Json::intValue:
+			{
+				int64_t value = json.asInt64();
+
+				if (value >= 0)
+				{
+					Encode(Json::Value((Json::UInt64)value), buffer);
+				}
+				else if (value >= -32)
+				{
+					buffer.push_back((char)(int8_t)value);
+				}
+				else if (value >= INT8_MIN)
+				{
+					appendUInt8(buffer, 0xD0, (uint8_t)(int8_t)value);
+				}
+				else if (value >= INT16_MIN)
+				{
+					appendUInt16(buffer, 0xD1, (uint16_t)(int16_t)value);
+				}
+				else if (value >= INT32_MIN)
+				{
+					appendUInt32(buffer, 0xD2, (uint32_t)(int32_t)value);
+				}
+				else
+				{
+					appendUInt64(buffer, 0xD3, (uint64_t)value);
+				}
+
+				break;
+			}
+
+			case Json::uintValue:
+			{
+				uint64_t value = json.asUInt64();
+
+				if (value <= 0x7F)
+					buffer.push_back((char)value);
+				else if (value <= UINT8_MAX)
+					appendUInt8(buffer, 0xCC, (uint8_t)value);
+				else if (value <= UINT16_MAX)
+					appendUInt16(buffer, 0xCD, (uint16_t)value);
+				else if (value <= UINT32_MAX)
+					appendUInt32(buffer, 0xCE, (uint32_t)value);
+				else
+					appendUInt64(buffer, 0xCF, value);
+
+				break;
+			}
+
+			case Json::realValue:
+			{
+				double value = json.asDouble();
+				uint64_t bits;
+
+				std::memcpy(&bits, &value, sizeof(bits));
+				appendUInt64(buffer, 0xCB, bits);
+
+				break;
+			}
+
+			case Json::stringValue:
+			{
+				const char* begin;
+				const char* end;
+
+				json.getString(&begin, &end);
+				appendString(buffer, begin, end - begin);
+
+				break;
+			}
+
+			case Json::arrayValue:
+			{
+				Json::ArrayIndex size = json.size();
+
+				EncodeArrayHeader(size, buffer);
+
+				for (Json::ArrayIndex i = 0; i < size; ++i)
+				{
+					Encode(json[i], buffer);
+				}
+
+				break;
+			}
+
+			case Json::objectValue:
+			{
+				Json::ArrayIndex size = json.size();
+
+				EncodeMapHeader(size, buffer);
+
+				for (auto it = json.begin(); it != json.end(); ++it)
+				{
+					const char* begin;
+					const char* end;
+
+					begin = it.memberName(&end);
+					appendString(buffer, begin, end - begin);
+					Encode(*it, buffer);
+				}
+
+				break;
+			}
+		}
+	}
+
+	/**
+	 * Array and map headers let a message be encoded piece by piece (see
+	 * Channel::ResponseWriter).
+	 */
+	void MsgPack::EncodeArrayHeader(size_t size, std::string& buffer)
+	{
+		MS_TRACE();
+
+		if (size <= 15)
+			buffer.push_back((char)(0x90 | size));
+		else if (size <= UINT16_MAX)
+			appendUInt16(buffer, 0xDC, (uint16_t)size);
+		else
+			appendUInt32(buffer, 0xDD, (uint32_t)size);
+	}
+
+	void MsgPack::EncodeMapHeader(size_t size, std::string& buffer)
+	{
+		MS_TRACE();
+
+		if (size <= 15)
+			buffer.push_back((char)(0x80 | size));
+		else if (size <= UINT16_MAX)
+			appendUInt16(buffer, 0xDE, (uint16_t)size);
+		else
+			appendUInt32(buffer, 0xDF, (uint32_t)size);
+	}
+
+	void MsgPack::EncodeString(const char* str, size_t len, std::string& buffer)
+	{
+		MS_TRACE();
+
+		appendString(buffer, str, len);
+	}
+
+	bool MsgPack::Decode(const uint8_t* data, size_t len, Json::Value& json)
+	{
+		MS_TRACE();
+
+		size_t pos = 0;
+
+		if (!DecodeValue(data, len, pos, json, 0))
+			return false;
+
+		// Trailing garbage is an error.
+		return pos == len;
+	}
+
+	bool MsgPack::DecodeValue(const uint8_t* data, size_t len, size_t& pos, Json::Value& json, size_t depth)
+	{
+		MS_TRACE();
+
+		#define NEED(n) if (len - pos < (size_t)(n)) return false
+
+		if (depth > MAX_DEPTH)
+			return false;
+
+		NEED(1);
+
+		uint8_t type = data[pos++];
+		size_t strLen = 0;
+		size_t count = 0;
+		bool isMap = false;
+
+		// positive fixint.
+		if (type <= 0x7F)
+		{
+			json = Json::Value((Json::UInt)type);
+
+			return true;
+		}
+		// fixmap.
+		else if ((type & 0xF0) == 0x80)
+		{
+			count = type & 0x0F;
+			isMap = true;
+		}
+		// fixarray.
+		else if ((type & 0xF0) == 0x90)
+		{
+			count = type & 0x0F;
+		}
+		// fixstr.
+		else if ((type & 0xE0) == 0xA0)
+		{
+			strLen = type & 0x1F;
+		}
+		// negative fixint.
+		else if (type >= 0xE0)
+		{
+			json = Json::Value((Json::Int)(int8_t)type);
+
+			return true;
+		}
+		else
+		{
+			switch (type)
+			{
+				case 0xC0:
+					json = Json::Value(Json::nullValue);
+					return true;
+
+				case 0xC2:
+					json = Json::Value(false);
+					return true;
+
+				case 0xC3:
+					json = Json::Value(true);
+					return true;
+
+				// str 8 / bin 8.
+				case 0xD9:
+				case 0xC4:
+					NEED(1);
+					strLen = Utils::Byte::Get1Byte(data, pos);
+					pos += 1;
+					break;
+
+				// str 16 / bin 16.
+				case 0xDA:
+				case 0xC5:
+					NEED(2);
+					strLen = Utils::Byte::Get2Bytes(data, pos);
+					pos += 2;
+					break;
+
+				// str 32 / bin 32.
+				case 0xDB:
+				case 0xC6:
+					NEED(4);
+					strLen = Utils::Byte::Get4Bytes(data, pos);
+					pos += 4;
+					break;
+
+				// float 32.
+				case 0xCA:
+				{
+					NEED(4);
+
+					uint32_t bits = Utils::Byte::Get4Bytes(data, pos);
+					float value;
+
+					std::memcpy(&value, &bits, sizeof(value));
+					pos += 4;
+					json = Json::Value((double)value);
+
+					return true;
+				}
+
+				// float 64.
+				case 0xCB:
+				{
+					NEED(8);
+
+					uint64_t bits = Utils::Byte::Get8Bytes(data, pos);
+					double value;
+
+					std::memcpy(&value, &bits, sizeof(value));
+					pos += 8;
+					json = Json::Value(value);
+
+					return true;
+				}
+
+				// uint 8/16/32/64.
+				case 0xCC:
+					NEED(1);
+					json = Json::Value((Json::UInt)Utils::Byte::Get1Byte(data, pos));
+					pos += 1;
+					return true;
+
+				case 0xCD:
+					NEED(2);
+					json = Json::Value((Json::UInt)Utils::Byte::Get2Bytes(data, pos));
+					pos += 2;
+					return true;
+
+				case 0xCE:
+					NEED(4);
+					json = Json::Value((Json::UInt)Utils::Byte::Get4Bytes(data, pos));
+					pos += 4;
+					return true;
+
+				case 0xCF:
+					NEED(8);
+					json = Json::Value((Json::UInt64)Utils::Byte::Get8Bytes(data, pos));
+					pos += 8;
+					return true;
+
+				// int 8/16/32/64.
+				case 0xD0:
+					NEED(1);
+					json = Json::Value((Json::Int)(int8_t)Utils::Byte::Get1Byte(data, pos));
+					pos += 1;
+					return true;
+
+				case 0xD1:
+					NEED(2);
+					json = Json::Value((Json::Int)(int16_t)Utils::Byte::Get2Bytes(data, pos));
+					pos += 2;
+					return true;
+
+				case 0xD2:
+					NEED(4);
+					json = Json::Value((Json::Int)(int32_t)Utils::Byte::Get4Bytes(data, pos));
+					pos += 4;
+					return true;
+
+				case 0xD3:
+					NEED(8);
+					json = Json::Value((Json::Int64)Utils::Byte::Get8Bytes(data, pos));
+					pos += 8;
+					return true;
+
+				// array 16/32.
+				case 0xDC:
+					NEED(2);
+					count = Utils::Byte::Get2Bytes(data, pos);
+					pos += 2;
+					break;
+
+				case 0xDD:
+					NEED(4);
+					count = Utils::Byte::Get4Bytes(data, pos);
+					pos += 4;
+					break;
+
+				// map 16/32.
+				case 0xDE:
+					NEED(2);
+					count = Utils::Byte::Get2Bytes(data, pos);
+					pos += 2;
+					isMap = true;
+					break;
+
+				case 0xDF:
+					NEED(4);
+					count = Utils::Byte::Get4Bytes(data, pos);
+					pos += 4;
+					isMap = true;
+					break;
+
+				// ext and reserved types are not supported.
+				default:
+					return false;
+			}
+		}
+
+		// String or binary.
+		if ((type & 0xE0) == 0xA0 || type == 0xD9 || type == 0xDA || type == 0xDB ||
+			type == 0xC4 || type == 0xC5 || type == 0xC6)
+		{
+			NEED(strLen);
+
+			json = Json::Value((const char*)data + pos, (const char*)data + pos + strLen);
+			pos += strLen;
+
+			return true;
+		}
+
+		// Map.
+		if (isMap)
+		{
+			json = Json::Value(Json::objectValue);
+
+			for (size_t i = 0; i < count; ++i)
+			{
+				Json::Value key;
+				Json::Value value;
+
+				if (!DecodeValue(data, len, pos, key, depth + 1) || !key.isString())
+					return false;
+
+				if (!DecodeValue(data, len, pos, value, depth + 1))
+					return false;
+
+				json[key.asString()] = value;
+			}
+
+			return true;
+		}
+
+		// Array.
+		json = Json::Value(Json::arrayValue);
+
+		// Each item takes at least one byte.
+		NEED(count);
+
+		for (size_t i = 0; i < count; ++i)
+		{
+			if (!DecodeValue(data, len, pos, json[(Json::ArrayIndex)i], depth + 1))
+				return false;
+		}
+
+		return true;
+
+		#undef NEED
+	}
+}
+
+/* Helpers. */
+
+inline
+static void appendUInt8(std::string& buffer, uint8_t type, uint8_t value)
+{
+	buffer.push_back((char)type);
+	buffer.push_back((char)value);
+}
+
+inline
+static void appendUInt16(std::string& buffer, uint8_t type, uint16_t value)
+{
+	uint8_t bytes[2];
+
+	Utils::Byte::Set2Bytes(bytes, 0, value);
+	buffer.push_back((char)type);
+	buffer.append((const char*)bytes, sizeof(bytes));
+}
+
+inline
+static void appendUInt32(std::string& buffer, uint8_t type, uint32_t value)
+{
+	uint8_t bytes[4];
+
+	Utils::Byte::Set4Bytes(bytes, 0, value);
+	buffer.push_back((char)type);
+	buffer.append((const char*)bytes, sizeof(bytes));
+}
+
+inline
+static void appendUInt64(std::string& buffer, uint8_t type, uint64_t value)
+{
+	uint8_t bytes[8];
+
+	Utils::Byte::Set8Bytes(bytes, 0, value);
+	buffer.push_back((char)type);
+	buffer.append((const char*)bytes, sizeof(bytes));
+}
+
+inline
+static void appendString(std::string& buffer, const char* str, size_t len)
+{
+	if (len <= 31)
+		buffer.push_back((char)(0xA0 | len));
+	else if (len <= UINT8_MAX)
+		appendUInt8(buffer, 0xD9, (uint8_t)len);
+	else if (len <= UINT16_MAX)
+		appendUInt16(buffer, 0xDA, (uint16_t)len);
+	else
+		appendUInt32(buffer, 0xDB, (uint32_t)len);
+
+	buffer.append(str, len);
+}
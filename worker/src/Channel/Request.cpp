@@ -13,10 +13,12 @@ namespace Channel
 	{
 		{ "worker.dump",                       Request::MethodId::worker_dump                       },
 		{ "worker.updateSettings",             Request::MethodId::worker_updateSettings             },
+		{ "worker.getStats",                   Request::MethodId::worker_getStats                   },
 		{ "worker.createRoom",                 Request::MethodId::worker_createRoom                 },
 		{ "room.close",                        Request::MethodId::room_close                        },
 		{ "room.dump",                         Request::MethodId::room_dump                         },
 		{ "room.createPeer",                   Request::MethodId::room_createPeer                   },
+		{ "room.linkRtpReceiver",              Request::MethodId::room_linkRtpReceiver              },
 		{ "peer.close",                        Request::MethodId::peer_close                        },
 		{ "peer.dump",                         Request::MethodId::peer_dump                         },
 		{ "peer.setCapabilities",              Request::MethodId::peer_setCapabilities              },
@@ -25,14 +27,20 @@ namespace Channel
 		{ "transport.close",                   Request::MethodId::transport_close                   },
 		{ "transport.dump",                    Request::MethodId::transport_dump                    },
 		{ "transport.setRemoteDtlsParameters", Request::MethodId::transport_setRemoteDtlsParameters },
+		{ "transport.setPacer",                Request::MethodId::transport_setPacer                },
+		{ "transport.dumpPacketTrace",         Request::MethodId::transport_dumpPacketTrace         },
 		{ "rtpReceiver.close",                 Request::MethodId::rtpReceiver_close                 },
 		{ "rtpReceiver.dump",                  Request::MethodId::rtpReceiver_dump                  },
 		{ "rtpReceiver.receive",               Request::MethodId::rtpReceiver_receive               },
 		{ "rtpReceiver.setRtpRawEvent",        Request::MethodId::rtpReceiver_setRtpRawEvent        },
 		{ "rtpReceiver.setRtpObjectEvent",     Request::MethodId::rtpReceiver_setRtpObjectEvent     },
+		{ "rtpReceiver.setRtpRawRing",         Request::MethodId::rtpReceiver_setRtpRawRing         },
+		{ "rtpReceiver.setRecording",          Request::MethodId::rtpReceiver_setRecording          },
 		{ "rtpSender.dump",                    Request::MethodId::rtpSender_dump                    },
 		{ "rtpSender.setTransport",            Request::MethodId::rtpSender_setTransport            },
-		{ "rtpSender.disable",                 Request::MethodId::rtpSender_disable                 }
+		{ "rtpSender.disable",                 Request::MethodId::rtpSender_disable                 },
+		{ "rtpSender.setTargetEncoding",       Request::MethodId::rtpSender_setTargetEncoding       },
+		{ "rtpSender.setTargetLayers",         Request::MethodId::rtpSender_setTargetLayers         }
 	};
 
 	/* Instance methods. */
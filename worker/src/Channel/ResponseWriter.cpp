@@ -0,0 +1,238 @@
+#define MS_CLASS "Channel::ResponseWriter"
+// #define MS_LOG_DEV
+
+#include "Channel/ResponseWriter.hpp"
+#include "Channel/MsgPack.hpp"
+#include "Logger.hpp"
+#include <sstream> // std::ostringstream
+#include <cstring> // std::strlen()
+
+namespace Channel
+{
+	/* Class variables. */
+
+	constexpr size_t ResponseWriter::ChunkSize;
+
+	/* Instance methods. */
+
+	ResponseWriter::ResponseWriter(Channel::Request* request) :
+		channel(request->channel)
+	{
+		MS_TRACE();
+
+		MS_ASSERT(request->replied == false, "Request already replied");
+		request->replied = true;
+
+		this->binary = this->channel->GetFormat() == Channel::UnixStreamSocket::Format::BINARY;
+
+		Start(request->id);
+	}
+
+	ResponseWriter::ResponseWriter(Listener* listener, uint32_t id, bool binary) :
+		listener(listener),
+		binary(binary)
+	{
+		MS_TRACE();
+
+		Start(id);
+	}
+
+	void ResponseWriter::StartObject(size_t size)
+	{
+		MS_TRACE();
+
+		AddEntry();
+
+		Container container;
+
+		container.isObject = true;
+		container.size = size;
+		this->containers.push_back(container);
+
+		if (this->binary)
+			MsgPack::EncodeMapHeader(size, this->buffer);
+		else
+			this->buffer.push_back('{');
+	}
+
+	void ResponseWriter::StartArray(size_t size)
+	{
+		MS_TRACE();
+
+		AddEntry();
+
+		Container container;
+
+		container.isObject = false;
+		container.size = size;
+		this->containers.push_back(container);
+
+		if (this->binary)
+			MsgPack::EncodeArrayHeader(size, this->buffer);
+		else
+			this->buffer.push_back('[');
+	}
+
+	void ResponseWriter::End()
+	{
+		MS_TRACE();
+
+		MS_ASSERT(!this->containers.empty(), "no object or array to end");
+
+		Container& container = this->containers.back();
+
+		MS_ASSERT(container.count == container.size, "wrong number of entries");
+
+		if (!this->binary)
+			this->buffer.push_back(container.isObject ? '}' : ']');
+
+		this->containers.pop_back();
+	}
+
+	void ResponseWriter::Key(const char* key)
+	{
+		MS_TRACE();
+
+		MS_ASSERT(!this->containers.empty() && this->containers.back().isObject, "key out of an object");
+
+		Container& container = this->containers.back();
+
+		if (this->binary)
+		{
+			MsgPack::EncodeString(key, std::strlen(key), this->buffer);
+		}
+		else
+		{
+			if (container.count > 0)
+				this->buffer.push_back(',');
+
+			this->buffer.append(Json::valueToQuotedString(key));
+			this->buffer.push_back(':');
+		}
+
+		container.count++;
+	}
+
+	void ResponseWriter::Value(const Json::Value& json)
+	{
+		MS_TRACE();
+
+		AddEntry();
+
+		if (this->binary)
+		{
+			MsgPack::Encode(json, this->buffer);
+		}
+		else
+		{
+			std::ostringstream stream;
+
+			this->jsonWriter->write(json, &stream);
+			this->buffer.append(stream.str());
+		}
+
+		MayFlush();
+	}
+
+	/**
+	 * Ends the response and sends the remaining data.
+	 */
+	void ResponseWriter::Finish()
+	{
+		MS_TRACE();
+
+		MS_ASSERT(this->containers.empty(), "objects or arrays not ended");
+
+		if (!this->binary)
+			this->buffer.push_back('}');
+
+		// Send it as a single message if it was not chunked yet.
+		if (!this->chunked)
+		{
+			if (this->listener)
+				this->listener->onResponseWriterPayload(this, this->buffer);
+			else
+				this->channel->SendPayload(this->buffer);
+
+			this->buffer.clear();
+		}
+		else
+		{
+			SendChunk(true);
+		}
+	}
+
+	/**
+	 * Starts the response (the data is written next).
+	 */
+	void ResponseWriter::Start(uint32_t id)
+	{
+		MS_TRACE();
+
+		this->buffer.reserve(ChunkSize * 2);
+
+		if (this->binary)
+		{
+			MsgPack::EncodeMapHeader(3, this->buffer);
+			MsgPack::EncodeString("id", 2, this->buffer);
+			MsgPack::Encode(Json::Value((Json::UInt)id), this->buffer);
+			MsgPack::EncodeString("accepted", 8, this->buffer);
+			MsgPack::Encode(Json::Value(true), this->buffer);
+			MsgPack::EncodeString("data", 4, this->buffer);
+		}
+		else
+		{
+			Json::StreamWriterBuilder builder;
+
+			builder["commentStyle"] = "None";
+			builder["indentation"] = "";
+			builder["enableYAMLCompatibility"] = false;
+			builder["dropNullPlaceholders"] = false;
+
+			this->jsonWriter.reset(builder.newStreamWriter());
+
+			this->buffer.append("{\"id\":");
+			this->buffer.append(std::to_string(id));
+			this->buffer.append(",\"accepted\":true,\"data\":");
+		}
+	}
+
+	/**
+	 * Called before writing a value into an array (the entries of an object are
+	 * counted by Key()).
+	 */
+	inline
+	void ResponseWriter::AddEntry()
+	{
+		if (this->containers.empty() || this->containers.back().isObject)
+			return;
+
+		Container& container = this->containers.back();
+
+		if (!this->binary && container.count > 0)
+			this->buffer.push_back(',');
+
+		container.count++;
+	}
+
+	inline
+	void ResponseWriter::MayFlush()
+	{
+		if (this->buffer.size() < ChunkSize)
+			return;
+
+		SendChunk(false);
+		this->chunked = true;
+	}
+
+	inline
+	void ResponseWriter::SendChunk(bool last)
+	{
+		if (this->listener)
+			this->listener->onResponseWriterChunk(this, (const uint8_t*)this->buffer.data(), this->buffer.size(), last);
+		else
+			this->channel->SendChunk((const uint8_t*)this->buffer.data(), this->buffer.size(), last);
+
+		this->buffer.clear();
+	}
+}
@@ -2,6 +2,7 @@
 // #define MS_LOG_DEV
 
 #include "Channel/UnixStreamSocket.hpp"
+#include "Channel/MsgPack.hpp"
 #include "Logger.hpp"
 #include "MediaSoupError.hpp"
 #include <sstream> // std::ostringstream
@@ -16,12 +17,15 @@ extern "C"
 // netstring length for a 65536 bytes payload
 #define NS_MAX_SIZE      65543
 #define MESSAGE_MAX_SIZE 65536
+// Data of a chunk (see SendChunk()).
+#define CHUNK_MAX_SIZE   (MESSAGE_MAX_SIZE - 2)
 
 namespace Channel
 {
 	/* Class variables. */
 
 	uint8_t UnixStreamSocket::writeBuffer[NS_MAX_SIZE];
+	constexpr size_t UnixStreamSocket::MaxBatchSize;
 
 	/* Instance methods. */
 
@@ -57,6 +61,11 @@ namespace Channel
 
 			this->jsonWriter = builder.newStreamWriter();
 		}
+
+		// Messages are batched and written once per loop iteration.
+		this->batchBuffer.reserve(MaxBatchSize + NS_MAX_SIZE);
+		this->prepare = new Prepare(this);
+		this->prepare->Start();
 	}
 
 	UnixStreamSocket::~UnixStreamSocket()
@@ -65,6 +74,13 @@ namespace Channel
 
 		delete this->jsonReader;
 		delete this->jsonWriter;
+
+		if (this->prepare)
+			this->prepare->Destroy();
+
+		// Don't let the Logger use a deleted Channel.
+		if (Logger::channel == this)
+			Logger::channel = nullptr;
 	}
 
 	void UnixStreamSocket::SetListener(Listener* listener)
@@ -74,6 +90,13 @@ namespace Channel
 		this->listener = listener;
 	}
 
+	void UnixStreamSocket::SetFormat(Format format)
+	{
+		MS_TRACE_STD();
+
+		this->format = format;
+	}
+
 	void UnixStreamSocket::Send(Json::Value &msg)
 	{
 		if (this->closed)
@@ -83,17 +106,38 @@ namespace Channel
 
 		std::ostringstream stream;
 		std::string ns_payload;
-		size_t ns_payload_len;
+
+		if (this->format == Format::BINARY)
+		{
+			MsgPack::Encode(msg, ns_payload);
+		}
+		else
+		{
+			this->jsonWriter->write(msg, &stream);
+			ns_payload = stream.str();
+		}
+
+		SendPayload(ns_payload);
+	}
+
+	/**
+	 * Sends an already encoded message. If it does not fit into a single
+	 * netstring it is split into chunks.
+	 */
+	void UnixStreamSocket::SendPayload(const std::string& ns_payload)
+	{
+		if (this->closed)
+			return;
+
+		// MS_TRACE_STD();
+
+		size_t ns_payload_len = ns_payload.length();
 		size_t ns_num_len;
 		size_t ns_len;
 
-		this->jsonWriter->write(msg, &stream);
-		ns_payload = stream.str();
-		ns_payload_len = ns_payload.length();
-
 		if (ns_payload_len > MESSAGE_MAX_SIZE)
 		{
-			MS_ERROR_STD("mesage too big");
+			SendChunk((const uint8_t*)ns_payload.data(), ns_payload_len, true);
 
 			return;
 		}
@@ -115,10 +159,37 @@ namespace Channel
 
 		ns_len = ns_num_len + ns_payload_len + 2;
 
-		Write(UnixStreamSocket::writeBuffer, ns_len);
+		Enqueue(UnixStreamSocket::writeBuffer, ns_len);
 	}
 
-	void UnixStreamSocket::SendLog(char* ns_payload, size_t ns_payload_len)
+	/**
+	 * Sends a piece of a message too big for a single netstring. Each chunk is
+	 * sent as a netstring with the 'C' byte, a byte telling whether more chunks
+	 * follow (1) or not (0) and the data. The receiver concatenates the data of
+	 * the chunks up to the last one and handles it as a single message.
+	 *
+	 * Data bigger than a netstring is split into several chunks.
+	 */
+	void UnixStreamSocket::SendChunk(const uint8_t* data, size_t len, bool last)
+	{
+		if (this->closed)
+			return;
+
+		// MS_TRACE_STD();
+
+		do
+		{
+			size_t chunk_len = len < CHUNK_MAX_SIZE ? len : CHUNK_MAX_SIZE;
+
+			EnqueueChunk(data, chunk_len, len > chunk_len || !last);
+
+			data += chunk_len;
+			len -= chunk_len;
+		}
+		while (len > 0);
+	}
+
+	void UnixStreamSocket::SendLog(char* ns_payload, size_t ns_payload_len, bool immediate)
 	{
 		if (this->closed)
 			return;
@@ -152,6 +223,16 @@ namespace Channel
 
 		ns_len = ns_num_len + ns_payload_len + 2;
 
+		// Deferred logs (see Logger) are batched like any other message.
+		if (!immediate)
+		{
+			Enqueue(UnixStreamSocket::writeBuffer, ns_len);
+
+			return;
+		}
+
+		// Immediate logs are not batched, but must not overtake previous messages.
+		Flush();
 		Write(UnixStreamSocket::writeBuffer, ns_len);
 	}
 
@@ -187,7 +268,86 @@ namespace Channel
 
 		ns_len = ns_num_len + ns_payload_len + 2;
 
-		Write(UnixStreamSocket::writeBuffer, ns_len);
+		Enqueue(UnixStreamSocket::writeBuffer, ns_len);
+	}
+
+	void UnixStreamSocket::Flush()
+	{
+		if (this->batchBuffer.empty())
+			return;
+
+		// MS_TRACE_STD();
+
+		this->totalBatches++;
+		this->totalMessages += this->batchMessages;
+		this->totalBytes += this->batchBuffer.size();
+
+		if (this->batchMessages > this->maxBatchMessages)
+			this->maxBatchMessages = this->batchMessages;
+
+		// Write() copies what it can not write right now, so the buffer can be
+		// reused.
+		if (!this->closed)
+			Write((const uint8_t*)this->batchBuffer.data(), this->batchBuffer.size());
+
+		this->batchBuffer.clear();
+		this->batchMessages = 0;
+	}
+
+	Json::Value UnixStreamSocket::toJson() const
+	{
+		MS_TRACE_STD();
+
+		static const Json::StaticString k_format("format");
+		static const Json::StaticString k_batches("batches");
+		static const Json::StaticString k_messages("messages");
+		static const Json::StaticString k_bytes("bytes");
+		static const Json::StaticString k_overflowBatches("overflowBatches");
+		static const Json::StaticString k_maxBatchMessages("maxBatchMessages");
+
+		Json::Value json(Json::objectValue);
+
+		json[k_format] = this->format == Format::BINARY ? "binary" : "json";
+		json[k_batches] = (Json::UInt64)this->totalBatches;
+		json[k_messages] = (Json::UInt64)this->totalMessages;
+		json[k_bytes] = (Json::UInt64)this->totalBytes;
+		json[k_overflowBatches] = (Json::UInt64)this->overflowBatches;
+		json[k_maxBatchMessages] = (Json::UInt64)this->maxBatchMessages;
+
+		return json;
+	}
+
+	inline
+	void UnixStreamSocket::Enqueue(const uint8_t* data, size_t len)
+	{
+		// Bound the batch size (and hence the latency added to its first message)
+		// when lots of messages are produced within the same loop iteration.
+		if (this->batchBuffer.size() + len > MaxBatchSize)
+		{
+			if (!this->batchBuffer.empty())
+				this->overflowBatches++;
+
+			Flush();
+		}
+
+		this->batchBuffer.append((const char*)data, len);
+		this->batchMessages++;
+	}
+
+	inline
+	void UnixStreamSocket::EnqueueChunk(const uint8_t* data, size_t len, bool more)
+	{
+		size_t ns_payload_len = len + 2;
+		size_t ns_num_len = (size_t)std::ceil(std::log10((double)ns_payload_len + 1));
+		size_t ns_len = ns_num_len + ns_payload_len + 2;
+
+		std::sprintf((char*)UnixStreamSocket::writeBuffer, "%zu:", ns_payload_len);
+		UnixStreamSocket::writeBuffer[ns_num_len + 1] = 'C';
+		UnixStreamSocket::writeBuffer[ns_num_len + 2] = more ? 1 : 0;
+		std::memcpy(UnixStreamSocket::writeBuffer + ns_num_len + 3, data, len);
+		UnixStreamSocket::writeBuffer[ns_len - 1] = ',';
+
+		Enqueue(UnixStreamSocket::writeBuffer, ns_len);
 	}
 
 	void UnixStreamSocket::userOnUnixStreamRead()
@@ -271,8 +431,23 @@ namespace Channel
 
 			Json::Value json;
 			std::string json_parse_error;
+			bool parsed;
 
-			if (this->jsonReader->parse((const char*)json_start, (const char*)json_start + json_len, &json, &json_parse_error))
+			// Binary (MessagePack) message.
+			if (MsgPack::IsMsgPack((const uint8_t*)json_start, json_len))
+			{
+				parsed = MsgPack::Decode((const uint8_t*)json_start, json_len, json);
+
+				if (!parsed)
+					json_parse_error = "invalid binary message";
+			}
+			// JSON message.
+			else
+			{
+				parsed = this->jsonReader->parse((const char*)json_start, (const char*)json_start + json_len, &json, &json_parse_error);
+			}
+
+			if (parsed)
 			{
 				Channel::Request* request = nullptr;
 
@@ -296,7 +471,7 @@ namespace Channel
 			}
 			else
 			{
-				MS_ERROR_STD("JSON parsing error: %s", json_parse_error.c_str());
+				MS_ERROR_STD("message parsing error: %s", json_parse_error.c_str());
 			}
 
 			// If there is no more space available in the buffer and that is because
@@ -326,6 +501,15 @@ namespace Channel
 		}
 	}
 
+	void UnixStreamSocket::onPrepare(Prepare* prepare)
+	{
+		// MS_TRACE_STD();
+
+		// The loop is about to block, so write everything produced during this
+		// iteration.
+		Flush();
+	}
+
 	void UnixStreamSocket::userOnUnixStreamSocketClosed(bool is_closed_by_peer)
 	{
 		MS_TRACE_STD();
@@ -3,25 +3,508 @@
 
 #include "Logger.hpp"
 
+// Size of the deferred entries ring.
+#define RING_SIZE (512 * 1024)
+// Max number of deferred entries sent per idle callback.
+#define MAX_BATCH_ENTRIES 256
+#define ENTRY_ALIGN(x) (((x) + 7) & ~((size_t)7))
+
 /* Class variables. */
 
 std::string Logger::id = "unset";
+std::string Logger::idTag = "id:unset";
 Channel::UnixStreamSocket* Logger::channel = nullptr;
 char Logger::buffer[MS_LOGGER_BUFFER_SIZE];
+alignas(8) uint8_t Logger::ring[RING_SIZE];
+uint64_t Logger::ringWritePos = 0;
+uint64_t Logger::ringReadPos = 0;
+Idle* Logger::idle = nullptr;
+Logger::IdleListener Logger::idleListener;
+uint64_t Logger::deferredEntries = 0;
+uint64_t Logger::droppedEntries = 0;
+uint64_t Logger::pendingDroppedEntries = 0;
+bool Logger::aborting = false;
 
 /* Class methods. */
 
 void Logger::Init(const std::string &id, Channel::UnixStreamSocket* channel)
 {
 	Logger::id = id;
+	Logger::idTag = "id:" + id;
 	Logger::channel = channel;
 
+	// Deferred entries are sent from an idle handle.
+	Logger::idle = new Idle(&Logger::idleListener);
+
 	MS_TRACE();
 }
 
 void Logger::Init(const std::string &id)
 {
 	Logger::id = id;
+	Logger::idTag = "id:" + id;
 
 	MS_TRACE();
 }
+
+/**
+ * Send all the deferred entries now.
+ */
+void Logger::Flush()
+{
+	if (Logger::ringReadPos == Logger::ringWritePos && !Logger::pendingDroppedEntries)
+		return;
+
+	Logger::FlushEntries(SIZE_MAX);
+}
+
+/**
+ * Best effort to send the deferred entries before aborting (so the ones that
+ * lead to the failure are not lost). An abort while flushing does not flush
+ * again.
+ */
+void Logger::FlushOnAbort()
+{
+	if (Logger::aborting)
+		return;
+
+	Logger::aborting = true;
+	Logger::Flush();
+}
+
+/**
+ * Send the deferred entries and close the idle handle. Later entries are sent
+ * synchronously.
+ */
+void Logger::Close()
+{
+	Logger::Flush();
+
+	if (Logger::idle)
+	{
+		Logger::idle->Destroy();
+		Logger::idle = nullptr;
+	}
+}
+
+Json::Value Logger::toJson()
+{
+	static const Json::StaticString k_deferredEntries("deferredEntries");
+	static const Json::StaticString k_droppedEntries("droppedEntries");
+	static const Json::StaticString k_pendingBytes("pendingBytes");
+
+	Json::Value json(Json::objectValue);
+
+	json[k_deferredEntries] = (Json::UInt64)Logger::deferredEntries;
+	json[k_droppedEntries] = (Json::UInt64)Logger::droppedEntries;
+	json[k_pendingBytes] = (Json::UInt64)(Logger::ringWritePos - Logger::ringReadPos);
+
+	return json;
+}
+
+/**
+ * Format a deferred entry. Integer conversions are rewritten to use the "ll"
+ * length modifier (arguments are packed as 64 bits values), so PRIu32 and
+ * friends work as usual.
+ */
+int Logger::Format(char* buffer, size_t bufferSize, const char* format, const uint8_t* args, size_t argsLen)
+{
+	size_t written = 0;
+	size_t argsPos = 0;
+	const char* p = format;
+
+	if (bufferSize == 0)
+		return 0;
+
+	// Get the next packed argument.
+	auto nextArg = [&](char* type, uint64_t* number, const char** str, size_t* strLen) -> bool
+	{
+		if (argsPos >= argsLen)
+			return false;
+
+		*type = (char)args[argsPos++];
+
+		if (*type == 's')
+		{
+			uint16_t len;
+
+			std::memcpy(&len, args + argsPos, sizeof(len));
+			argsPos += sizeof(len);
+			*str = (const char*)args + argsPos;
+			*strLen = len;
+			argsPos += len;
+		}
+		else
+		{
+			std::memcpy(number, args + argsPos, sizeof(uint64_t));
+			argsPos += sizeof(uint64_t);
+		}
+
+		return true;
+	};
+
+	auto append = [&](const char* data, size_t len)
+	{
+		if (written + len >= bufferSize)
+			len = bufferSize - written - 1;
+
+		std::memcpy(buffer + written, data, len);
+		written += len;
+	};
+
+	while (*p && written < bufferSize - 1)
+	{
+		if (*p != '%')
+		{
+			const char* next = std::strchr(p, '%');
+			size_t len = next ? (size_t)(next - p) : std::strlen(p);
+
+			append(p, len);
+			p += len;
+
+			continue;
+		}
+
+		if (*(p + 1) == '%')
+		{
+			append("%", 1);
+			p += 2;
+
+			continue;
+		}
+
+		// Build the conversion spec without length modifiers.
+		char spec[32];
+		size_t specLen = 0;
+		char type;
+		uint64_t number = 0;
+		const char* str = nullptr;
+		size_t strLen = 0;
+
+		spec[specLen++] = *p++;
+
+		// Flags, width and precision.
+		while (*p && std::strchr("-+ #0123456789.*", *p) && specLen < sizeof(spec) - 8)
+		{
+			if (*p == '*')
+			{
+				int value = 0;
+
+				if (nextArg(&type, &number, &str, &strLen) && type != 's')
+					value = (int)(int64_t)number;
+
+				specLen += std::snprintf(spec + specLen, sizeof(spec) - specLen, "%d", value);
+				p++;
+			}
+			else
+			{
+				spec[specLen++] = *p++;
+			}
+		}
+
+		// Length modifiers.
+		while (*p && std::strchr("hljztLq", *p))
+		{
+			p++;
+		}
+
+		char conversion = *p;
+
+		if (!conversion)
+			break;
+
+		p++;
+
+		char out[512];
+		int len = 0;
+
+		if (!nextArg(&type, &number, &str, &strLen))
+		{
+			append("(?)", 3);
+
+			continue;
+		}
+
+		switch (conversion)
+		{
+			case 'd':
+			case 'i':
+			case 'u':
+			case 'o':
+			case 'x':
+			case 'X':
+			{
+				spec[specLen++] = 'l';
+				spec[specLen++] = 'l';
+				spec[specLen++] = conversion;
+				spec[specLen] = '\0';
+
+				if (conversion == 'd' || conversion == 'i')
+					len = std::snprintf(out, sizeof(out), spec, (long long)(int64_t)number);
+				else
+					len = std::snprintf(out, sizeof(out), spec, (unsigned long long)number);
+
+				break;
+			}
+
+			case 'c':
+			{
+				spec[specLen++] = conversion;
+				spec[specLen] = '\0';
+				len = std::snprintf(out, sizeof(out), spec, (int)number);
+
+				break;
+			}
+
+			case 'f':
+			case 'F':
+			case 'e':
+			case 'E':
+			case 'g':
+			case 'G':
+			case 'a':
+			case 'A':
+			{
+				double value;
+
+				std::memcpy(&value, &number, sizeof(value));
+				spec[specLen++] = conversion;
+				spec[specLen] = '\0';
+				len = std::snprintf(out, sizeof(out), spec, value);
+
+				break;
+			}
+
+			case 's':
+			{
+				std::string value = type == 's' ? std::string(str, strLen) : std::string("(null)");
+
+				spec[specLen++] = conversion;
+				spec[specLen] = '\0';
+				len = std::snprintf(out, sizeof(out), spec, value.c_str());
+
+				// Long strings do not fit into out.
+				if (len >= (int)sizeof(out))
+				{
+					std::string longOut((size_t)len + 1, '\0');
+
+					std::snprintf(&longOut[0], longOut.size(), spec, value.c_str());
+					append(longOut.data(), (size_t)len);
+					len = 0;
+				}
+
+				break;
+			}
+
+			case 'p':
+			{
+				spec[specLen++] = conversion;
+				spec[specLen] = '\0';
+				len = std::snprintf(out, sizeof(out), spec, (void*)(uintptr_t)number);
+
+				break;
+			}
+
+			default:
+			{
+				len = 0;
+			}
+		}
+
+		if (len > 0)
+			append(out, std::min((size_t)len, sizeof(out) - 1));
+	}
+
+	buffer[written] = '\0';
+
+	return (int)written;
+}
+
+size_t Logger::PackString(uint8_t* args, size_t len, const char* value)
+{
+	if (!value)
+		return Logger::PackNumber(args, len, 'p', 0);
+
+	size_t strLen = std::strlen(value);
+
+	// Does not fit (it must not be truncated).
+	if (len + 1 + sizeof(uint16_t) + strLen > MS_LOGGER_ARGS_SIZE)
+		return MS_LOGGER_ARGS_SIZE + 1;
+
+	uint16_t strLen16 = (uint16_t)strLen;
+
+	args[len] = 's';
+	std::memcpy(args + len + 1, &strLen16, sizeof(strLen16));
+	std::memcpy(args + len + 1 + sizeof(strLen16), value, strLen);
+
+	return len + 1 + sizeof(strLen16) + strLen;
+}
+
+size_t Logger::PackNumber(uint8_t* args, size_t len, char type, uint64_t value)
+{
+	if (len + 1 + sizeof(value) > MS_LOGGER_ARGS_SIZE)
+		return MS_LOGGER_ARGS_SIZE + 1;
+
+	args[len] = (uint8_t)type;
+	std::memcpy(args + len + 1, &value, sizeof(value));
+
+	return len + 1 + sizeof(value);
+}
+
+void Logger::Commit(char level, const char* file, int line, const char* className, const char* function, const char* format, const uint8_t* args, size_t argsLen)
+{
+	EntryHeader header;
+
+	header.argsLen = (uint16_t)argsLen;
+	header.level = level;
+	header.line = line;
+	header.file = file;
+	header.className = className;
+	header.function = function;
+	header.format = format;
+
+	// No idle handle (yet), so send it now.
+	if (!Logger::idle)
+	{
+		Logger::SendEntry(&header, args);
+
+		return;
+	}
+
+	size_t entrySize = ENTRY_ALIGN(sizeof(EntryHeader) + argsLen);
+	size_t offset = (size_t)(Logger::ringWritePos % RING_SIZE);
+	size_t tail = RING_SIZE - offset;
+	size_t needed = tail < entrySize ? entrySize + tail : entrySize;
+
+	if (needed > RING_SIZE - (size_t)(Logger::ringWritePos - Logger::ringReadPos))
+	{
+		Logger::droppedEntries++;
+		Logger::pendingDroppedEntries++;
+
+		return;
+	}
+
+	bool wasEmpty = Logger::ringWritePos == Logger::ringReadPos;
+
+	if (tail < entrySize)
+	{
+		reinterpret_cast<EntryHeader*>(Logger::ring + offset)->size = 0;
+		Logger::ringWritePos += tail;
+		offset = 0;
+	}
+
+	header.size = (uint32_t)entrySize;
+	std::memcpy(Logger::ring + offset, &header, sizeof(header));
+	if (argsLen)
+		std::memcpy(Logger::ring + offset + sizeof(header), args, argsLen);
+	Logger::ringWritePos += entrySize;
+	Logger::deferredEntries++;
+
+	if (wasEmpty)
+		Logger::idle->Start();
+}
+
+void Logger::FlushEntries(size_t maxEntries)
+{
+	size_t count = 0;
+
+	while (Logger::ringReadPos != Logger::ringWritePos && count < maxEntries)
+	{
+		size_t offset = (size_t)(Logger::ringReadPos % RING_SIZE);
+		EntryHeader* header = reinterpret_cast<EntryHeader*>(Logger::ring + offset);
+
+		// Wrap.
+		if (RING_SIZE - offset < sizeof(EntryHeader) || header->size == 0)
+		{
+			Logger::ringReadPos += RING_SIZE - offset;
+
+			continue;
+		}
+
+		// Copy the header since the entry may be overwritten while sending it.
+		EntryHeader entry = *header;
+
+		Logger::ringReadPos += entry.size;
+		Logger::SendEntry(&entry, Logger::ring + offset + sizeof(EntryHeader));
+		count++;
+	}
+
+	if (Logger::pendingDroppedEntries)
+	{
+		int written = std::snprintf(Logger::buffer, MS_LOGGER_BUFFER_SIZE,
+			"W[%s] Logger::FlushEntries() | %" PRIu64 " log entries dropped (ring full)",
+			Logger::idTag.c_str(), Logger::pendingDroppedEntries);
+
+		Logger::pendingDroppedEntries = 0;
+
+		if (Logger::channel)
+			Logger::channel->SendLog(Logger::buffer, written, false);
+	}
+}
+
+void Logger::SendEntry(const EntryHeader* header, const uint8_t* args)
+{
+	if (!Logger::channel)
+		return;
+
+	int written = Logger::WritePrefix(header);
+
+	if (header->level != 't' && written > 0 && written < MS_LOGGER_BUFFER_SIZE)
+	{
+		written += Logger::Format(Logger::buffer + written, MS_LOGGER_BUFFER_SIZE - written,
+			header->format, args, header->argsLen);
+	}
+
+	if (written <= 0)
+		return;
+
+	if (written >= MS_LOGGER_BUFFER_SIZE)
+		written = MS_LOGGER_BUFFER_SIZE - 1;
+
+	// Deferred entries go into the Channel batch.
+	Logger::channel->SendLog(Logger::buffer, written, false);
+}
+
+/**
+ * Writes the level, id, class and function of the entry into the buffer.
+ */
+int Logger::WritePrefix(const EntryHeader* header)
+{
+	if (header->level == 't')
+	{
+		if (header->file)
+		{
+			return std::snprintf(Logger::buffer, MS_LOGGER_BUFFER_SIZE, "D(trace) [%s] %s:%d | %s::%s()",
+				Logger::idTag.c_str(), header->file, header->line, header->className, header->function);
+		}
+		else
+		{
+			return std::snprintf(Logger::buffer, MS_LOGGER_BUFFER_SIZE, "D(trace) [%s] %s::%s()",
+				Logger::idTag.c_str(), header->className, header->function);
+		}
+	}
+	else
+	{
+		if (header->file)
+		{
+			return std::snprintf(Logger::buffer, MS_LOGGER_BUFFER_SIZE, "%c[%s] %s:%d | %s::%s() | ",
+				header->level, Logger::idTag.c_str(), header->file, header->line, header->className, header->function);
+		}
+		else
+		{
+			return std::snprintf(Logger::buffer, MS_LOGGER_BUFFER_SIZE, "%c[%s] %s::%s() | ",
+				header->level, Logger::idTag.c_str(), header->className, header->function);
+		}
+	}
+}
+
+/* Instance methods. */
+
+void Logger::IdleListener::onIdle(Idle* idle)
+{
+	Logger::FlushEntries(MAX_BATCH_ENTRIES);
+
+	// Nothing else to do, so let the loop block again.
+	if (Logger::ringReadPos == Logger::ringWritePos)
+		idle->Stop();
+}
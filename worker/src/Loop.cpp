@@ -4,6 +4,7 @@
 #include "Loop.hpp"
 #include "DepLibUV.hpp"
 #include "Settings.hpp"
+#include "RTC/Metrics.hpp"
 #include "MediaSoupError.hpp"
 #include "Logger.hpp"
 #include <string>
@@ -73,9 +74,15 @@ void Loop::Close()
 	// Delete the Notifier.
 	delete this->notifier;
 
-	// Close the Channel socket.
+	// Send the deferred log entries.
+	Logger::Close();
+
+	// Close the Channel socket (write pending messages first).
 	if (this->channel)
+	{
+		this->channel->Flush();
 		this->channel->Destroy();
+	}
 }
 
 RTC::Room* Loop::GetRoomFromRequest(Channel::Request* request, uint32_t* roomId)
@@ -139,11 +146,15 @@ void Loop::onChannelRequest(Channel::UnixStreamSocket* channel, Channel::Request
 		{
 			static const Json::StaticString k_workerId("workerId");
 			static const Json::StaticString k_rooms("rooms");
+			static const Json::StaticString k_channel("channel");
+			static const Json::StaticString k_logger("logger");
 
 			Json::Value json(Json::objectValue);
 			Json::Value json_rooms(Json::arrayValue);
 
 			json[k_workerId] = Logger::id;
+			json[k_channel] = this->channel->toJson();
+			json[k_logger] = Logger::toJson();
 
 			for (auto& kv : this->rooms)
 			{
@@ -165,6 +176,46 @@ void Loop::onChannelRequest(Channel::UnixStreamSocket* channel, Channel::Request
 			break;
 		}
 
+		case Channel::Request::MethodId::worker_getStats:
+		{
+			static const Json::StaticString k_format("format");
+			static const Json::StaticString k_text("text");
+
+			auto json_format = request->data[k_format];
+			std::string format = "prometheus";
+
+			if (json_format.isString())
+			{
+				format = json_format.asString();
+			}
+			else if (!json_format.isNull())
+			{
+				request->Reject("invalid data.format");
+				return;
+			}
+
+			if (format == "prometheus")
+			{
+				Json::Value data(Json::objectValue);
+
+				data[k_text] = RTC::Metrics::GetPrometheusText();
+
+				request->Accept(data);
+			}
+			else if (format == "json")
+			{
+				Json::Value data = RTC::Metrics::toJson();
+
+				request->Accept(data);
+			}
+			else
+			{
+				request->Reject("invalid data.format");
+			}
+
+			break;
+		}
+
 		case Channel::Request::MethodId::worker_createRoom:
 		{
 			static const Json::StaticString k_capabilities("capabilities");
@@ -212,6 +263,57 @@ void Loop::onChannelRequest(Channel::UnixStreamSocket* channel, Channel::Request
 			break;
 		}
 
+		case Channel::Request::MethodId::room_linkRtpReceiver:
+		{
+			static const Json::StaticString k_sourceRoomId("sourceRoomId");
+
+			RTC::Room* room;
+
+			try
+			{
+				room = GetRoomFromRequest(request);
+			}
+			catch (const MediaSoupError &error)
+			{
+				request->Reject(error.what());
+				return;
+			}
+
+			if (!room)
+			{
+				request->Reject("Room does not exist");
+				return;
+			}
+
+			auto json_sourceRoomId = request->internal[k_sourceRoomId];
+
+			if (!json_sourceRoomId.isUInt())
+			{
+				request->Reject("Request has not numeric internal.sourceRoomId");
+				return;
+			}
+
+			auto it = this->rooms.find(json_sourceRoomId.asUInt());
+
+			if (it == this->rooms.end())
+			{
+				request->Reject("source Room does not exist");
+				return;
+			}
+
+			RTC::Room* sourceRoom = it->second;
+
+			if (sourceRoom == room)
+			{
+				request->Reject("source Room is the same Room");
+				return;
+			}
+
+			room->LinkRtpReceiver(request, sourceRoom);
+
+			break;
+		}
+
 		case Channel::Request::MethodId::room_close:
 		case Channel::Request::MethodId::room_dump:
 		case Channel::Request::MethodId::room_createPeer:
@@ -223,14 +325,20 @@ void Loop::onChannelRequest(Channel::UnixStreamSocket* channel, Channel::Request
 		case Channel::Request::MethodId::transport_close:
 		case Channel::Request::MethodId::transport_dump:
 		case Channel::Request::MethodId::transport_setRemoteDtlsParameters:
+		case Channel::Request::MethodId::transport_setPacer:
+		case Channel::Request::MethodId::transport_dumpPacketTrace:
 		case Channel::Request::MethodId::rtpReceiver_close:
 		case Channel::Request::MethodId::rtpReceiver_dump:
 		case Channel::Request::MethodId::rtpReceiver_receive:
 		case Channel::Request::MethodId::rtpReceiver_setRtpRawEvent:
 		case Channel::Request::MethodId::rtpReceiver_setRtpObjectEvent:
+		case Channel::Request::MethodId::rtpReceiver_setRtpRawRing:
+		case Channel::Request::MethodId::rtpReceiver_setRecording:
 		case Channel::Request::MethodId::rtpSender_dump:
 		case Channel::Request::MethodId::rtpSender_setTransport:
 		case Channel::Request::MethodId::rtpSender_disable:
+		case Channel::Request::MethodId::rtpSender_setTargetEncoding:
+		case Channel::Request::MethodId::rtpSender_setTargetLayers:
 		{
 			RTC::Room* room;
 
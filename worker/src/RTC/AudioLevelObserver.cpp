@@ -0,0 +1,366 @@
+#define MS_CLASS "RTC::AudioLevelObserver"
+// #define MS_LOG_DEV
+#define MS_LOG_HOT_PATH
+
+#include "RTC/AudioLevelObserver.hpp"
+#include "Logger.hpp"
+#include "MediaSoupError.hpp"
+#include <string>
+#include <vector>
+#include <algorithm> // std::sort()
+
+namespace RTC
+{
+	/* Class variables. */
+
+	constexpr uint64_t AudioLevelObserver::Interval;
+	constexpr uint8_t AudioLevelObserver::Hysteresis;
+	constexpr uint64_t AudioLevelObserver::MinHoldTime;
+	constexpr uint64_t AudioLevelObserver::MaxIdleTime;
+	constexpr double AudioLevelObserver::SmoothingFactor;
+	constexpr uint64_t AudioLevelObserver::SilenceGracePeriod;
+	constexpr uint64_t AudioLevelObserver::ComfortInterval;
+
+	/* Instance methods. */
+
+	AudioLevelObserver::AudioLevelObserver(Listener* listener, size_t lastN) :
+		listener(listener),
+		lastN(lastN)
+	{
+		MS_TRACE();
+	}
+
+	Json::Value AudioLevelObserver::toJson() const
+	{
+		MS_TRACE();
+
+		static const Json::StaticString k_lastN("lastN");
+		static const Json::StaticString k_silenceThreshold("silenceThreshold");
+		static const Json::StaticString k_dominantSpeaker("dominantSpeaker");
+		static const Json::StaticString k_streams("streams");
+		static const Json::StaticString k_level("level");
+		static const Json::StaticString k_selected("selected");
+		static const Json::StaticString k_forwardedPackets("forwardedPackets");
+		static const Json::StaticString k_droppedPackets("droppedPackets");
+		static const Json::StaticString k_suppressedPackets("suppressedPackets");
+		static const Json::StaticString k_selectionChanges("selectionChanges");
+		static const Json::StaticString k_dominantSpeakerChanges("dominantSpeakerChanges");
+
+		Json::Value json(Json::objectValue);
+		Json::Value json_streams(Json::objectValue);
+
+		json[k_lastN] = (Json::UInt)this->lastN;
+
+		if (this->silenceVolume)
+			json[k_silenceThreshold] = -(Json::Int)this->silenceVolume;
+		else
+			json[k_silenceThreshold] = Json::nullValue;
+
+		if (this->hasDominantSpeaker)
+			json[k_dominantSpeaker] = std::to_string(this->dominantSpeaker);
+		else
+			json[k_dominantSpeaker] = Json::nullValue;
+
+		for (auto& kv : this->streams)
+		{
+			auto& stream = kv.second;
+			Json::Value json_stream(Json::objectValue);
+
+			if (stream.hasLevel)
+				json_stream[k_level] = (Json::UInt)stream.level;
+			else
+				json_stream[k_level] = Json::nullValue;
+
+			json_stream[k_selected] = stream.selected;
+
+			json_streams[std::to_string(kv.first)] = json_stream;
+		}
+		json[k_streams] = json_streams;
+
+		json[k_forwardedPackets] = (Json::UInt)this->forwardedPackets;
+		json[k_droppedPackets] = (Json::UInt)this->droppedPackets;
+		json[k_suppressedPackets] = (Json::UInt)this->suppressedPackets;
+		json[k_selectionChanges] = (Json::UInt)this->selectionChanges;
+		json[k_dominantSpeakerChanges] = (Json::UInt)this->dominantSpeakerChanges;
+
+		return json;
+	}
+
+	/**
+	 * Packets with an audio level at or below the given one (in dBov, from -127
+	 * to -1) are silent. 0 disables silence suppression.
+	 */
+	void AudioLevelObserver::SetSilenceThreshold(int32_t dBov)
+	{
+		MS_TRACE();
+
+		if (dBov > 0 || dBov < -127)
+			MS_THROW_ERROR("invalid silence threshold [dBov:%" PRIi32 "]", dBov);
+
+		this->silenceVolume = static_cast<uint8_t>(-dBov);
+	}
+
+	/**
+	 * Returns true if the packet must be forwarded. If so, resumed is set to
+	 * true when the previous packets of the stream were dropped.
+	 */
+	bool AudioLevelObserver::ReceivePacket(uint32_t streamId, RTC::RtpPacket* packet, uint64_t now, bool* resumed)
+	{
+		MS_TRACE();
+
+		auto& stream = this->streams[streamId];
+		uint8_t volume;
+		bool voice;
+		bool hasVolume = packet->ReadAudioLevel(&volume, &voice);
+
+		stream.lastPacketAt = now;
+
+		if (hasVolume)
+		{
+			// The extension carries -dBov (127 is silence).
+			double level = 127 - volume;
+
+			if (!stream.hasLevel)
+			{
+				stream.hasLevel = true;
+				stream.level = level;
+
+				// Take a free slot right away.
+				if (this->lastN && this->numSelected < this->lastN)
+				{
+					stream.selected = true;
+					stream.selectedAt = now;
+					this->numSelected++;
+				}
+			}
+			else
+			{
+				stream.level += (level - stream.level) * AudioLevelObserver::SmoothingFactor;
+			}
+		}
+
+		if (now - this->lastEvaluationAt >= AudioLevelObserver::Interval)
+			Evaluate(now);
+
+		*resumed = false;
+
+		if (!IsForwarded(streamId))
+		{
+			stream.paused = true;
+			this->droppedPackets++;
+
+			return false;
+		}
+
+		// Silence suppression.
+		if (this->silenceVolume && hasVolume && volume >= this->silenceVolume)
+		{
+			if (!stream.silent)
+			{
+				stream.silent = true;
+				stream.silentSince = now;
+			}
+
+			if (
+				now - stream.silentSince >= AudioLevelObserver::SilenceGracePeriod &&
+				now - stream.lastForwardedAt < AudioLevelObserver::ComfortInterval
+			)
+			{
+				stream.paused = true;
+				this->suppressedPackets++;
+
+				return false;
+			}
+		}
+		else
+		{
+			stream.silent = false;
+		}
+
+		if (stream.paused)
+		{
+			stream.paused = false;
+			*resumed = true;
+		}
+
+		stream.lastForwardedAt = now;
+		this->forwardedPackets++;
+
+		return true;
+	}
+
+	void AudioLevelObserver::RemoveStream(uint32_t streamId)
+	{
+		MS_TRACE();
+
+		auto it = this->streams.find(streamId);
+
+		if (it == this->streams.end())
+			return;
+
+		// The free slot is taken in the next evaluation.
+		if (it->second.selected)
+			this->numSelected--;
+
+		this->streams.erase(it);
+
+		if (this->hasDominantSpeaker && this->dominantSpeaker == streamId)
+			this->hasDominantSpeaker = false;
+	}
+
+	bool AudioLevelObserver::IsForwarded(uint32_t streamId) const
+	{
+		MS_TRACE();
+
+		if (!this->lastN)
+			return true;
+
+		auto it = this->streams.find(streamId);
+
+		if (it == this->streams.end())
+			return true;
+
+		auto& stream = it->second;
+
+		return !stream.hasLevel || stream.selected;
+	}
+
+	void AudioLevelObserver::Evaluate(uint64_t now)
+	{
+		MS_TRACE();
+
+		this->lastEvaluationAt = now;
+
+		// Streams that stopped sending (muted or DTX) are silent.
+		for (auto& kv : this->streams)
+		{
+			auto& stream = kv.second;
+
+			if (stream.hasLevel && now - stream.lastPacketAt > AudioLevelObserver::MaxIdleTime)
+				stream.level = 0;
+		}
+
+		if (this->lastN)
+			UpdateSelection(now);
+
+		UpdateDominantSpeaker(now);
+	}
+
+	void AudioLevelObserver::UpdateSelection(uint64_t now)
+	{
+		MS_TRACE();
+
+		std::vector<Stream*> selected;
+		std::vector<Stream*> unselected;
+
+		for (auto& kv : this->streams)
+		{
+			auto& stream = kv.second;
+
+			if (!stream.hasLevel)
+				continue;
+
+			if (stream.selected)
+				selected.push_back(&stream);
+			else
+				unselected.push_back(&stream);
+		}
+
+		if (unselected.empty())
+			return;
+
+		// Weakest selected streams first.
+		std::sort(selected.begin(), selected.end(), [](const Stream* a, const Stream* b)
+		{
+			return a->level < b->level;
+		});
+
+		// Loudest candidates first.
+		std::sort(unselected.begin(), unselected.end(), [](const Stream* a, const Stream* b)
+		{
+			return a->level > b->level;
+		});
+
+		auto candidateIt = unselected.begin();
+
+		// Fill the free slots.
+		for (; candidateIt != unselected.end() && this->numSelected < this->lastN; ++candidateIt)
+		{
+			(*candidateIt)->selected = true;
+			(*candidateIt)->selectedAt = now;
+			this->numSelected++;
+			this->selectionChanges++;
+		}
+
+		// Replace the weakest selected streams with louder candidates.
+		auto selectedIt = selected.begin();
+
+		while (candidateIt != unselected.end() && selectedIt != selected.end())
+		{
+			auto candidate = *candidateIt;
+			auto current = *selectedIt;
+
+			if (candidate->level < current->level + AudioLevelObserver::Hysteresis)
+				break;
+
+			// Too recently selected, try with the next weakest one.
+			if (now - current->selectedAt < AudioLevelObserver::MinHoldTime)
+			{
+				++selectedIt;
+
+				continue;
+			}
+
+			current->selected = false;
+			candidate->selected = true;
+			candidate->selectedAt = now;
+			this->selectionChanges++;
+
+			++candidateIt;
+			++selectedIt;
+		}
+	}
+
+	void AudioLevelObserver::UpdateDominantSpeaker(uint64_t now)
+	{
+		MS_TRACE();
+
+		uint32_t loudestId = 0;
+		const Stream* loudest = nullptr;
+
+		for (auto& kv : this->streams)
+		{
+			auto& stream = kv.second;
+
+			if (stream.hasLevel && stream.level > 0 && (!loudest || stream.level > loudest->level))
+			{
+				loudestId = kv.first;
+				loudest = &stream;
+			}
+		}
+
+		if (!loudest || (this->hasDominantSpeaker && loudestId == this->dominantSpeaker))
+			return;
+
+		if (this->hasDominantSpeaker)
+		{
+			auto& dominant = this->streams.at(this->dominantSpeaker);
+
+			if (loudest->level < dominant.level + AudioLevelObserver::Hysteresis)
+				return;
+
+			if (now - this->dominantSpeakerAt < AudioLevelObserver::MinHoldTime)
+				return;
+		}
+
+		MS_DEBUG_DEV("dominant speaker changed [streamId:%" PRIu32 ", level:%f]",
+			loudestId, loudest->level);
+
+		this->hasDominantSpeaker = true;
+		this->dominantSpeaker = loudestId;
+		this->dominantSpeakerAt = now;
+		this->dominantSpeakerChanges++;
+
+		this->listener->onAudioLevelObserverDominantSpeaker(this, loudestId);
+	}
+}
@@ -0,0 +1,396 @@
+#define MS_CLASS "RTC::Codecs::PayloadParser"
+// #define MS_LOG_DEV
+#define MS_LOG_HOT_PATH
+
+#include "RTC/Codecs/PayloadParser.hpp"
+#include "Utils.hpp"
+#include "Logger.hpp"
+
+namespace RTC { namespace Codecs
+{
+	/* Helpers. */
+
+	static bool isH264KeyFrameNal(uint8_t nal)
+	{
+		// IDR slice or SPS.
+		return nal == 5 || nal == 7;
+	}
+
+	static bool isH265KeyFrameNal(uint8_t nal)
+	{
+		// IRAP pictures (BLA, IDR, CRA) or VPS/SPS.
+		return (nal >= 16 && nal <= 21) || nal == 32 || nal == 33;
+	}
+
+	/* Specialization for VP8. */
+
+	template<>
+	bool PayloadParser<RTC::RtpCodecMime::Subtype::VP8>::Parse(const uint8_t* data, size_t len, PayloadDescriptor& descriptor)
+	{
+		MS_TRACE();
+
+		size_t offset = 1;
+
+		// Just the first partition of a frame carries the VP8 payload header.
+		bool startOfPartition = (data[0] & 0x10) ? true : false;
+		uint8_t partitionIndex = data[0] & 0x07;
+
+		descriptor.startOfFrame = startOfPartition && partitionIndex == 0;
+
+		// Extended control bits.
+		if (data[0] & 0x80)
+		{
+			if (len <= offset)
+				return false;
+
+			uint8_t ext = data[offset++];
+
+			// PictureID (7 or 15 bits).
+			if (ext & 0x80)
+			{
+				if (len <= offset)
+					return false;
+
+				descriptor.hasPictureId = true;
+				descriptor.pictureIdOffset = offset;
+
+				if (data[offset] & 0x80)
+				{
+					if (len <= offset + 1)
+						return false;
+
+					descriptor.hasLongPictureId = true;
+					descriptor.pictureId = Utils::Byte::Get2Bytes(data, offset) & 0x7FFF;
+					offset += 2;
+				}
+				else
+				{
+					descriptor.pictureId = data[offset] & 0x7F;
+					offset += 1;
+				}
+			}
+
+			// TL0PICIDX.
+			if (ext & 0x40)
+			{
+				if (len <= offset)
+					return false;
+
+				descriptor.hasTl0PicIdx = true;
+				descriptor.tl0PicIdxOffset = offset;
+				descriptor.tl0PicIdx = data[offset];
+				offset++;
+			}
+
+			// TID/Y/KEYIDX.
+			if (ext & 0x30)
+			{
+				if (len <= offset)
+					return false;
+
+				// TID is just valid if the T bit is set.
+				if (ext & 0x20)
+				{
+					descriptor.temporalLayer = (data[offset] >> 6) & 0x03;
+					descriptor.layerSync = (data[offset] & 0x20) ? true : false;
+				}
+
+				offset++;
+			}
+		}
+
+		if (len <= offset)
+			return false;
+
+		descriptor.payloadOffset = offset;
+
+		// Inverse key frame flag (P) of the VP8 payload header.
+		descriptor.isKeyFrame = descriptor.startOfFrame && (data[offset] & 0x01) == 0;
+
+		return true;
+	}
+
+	/* Specialization for VP9. */
+
+	template<>
+	bool PayloadParser<RTC::RtpCodecMime::Subtype::VP9>::Parse(const uint8_t* data, size_t len, PayloadDescriptor& descriptor)
+	{
+		MS_TRACE();
+
+		size_t offset = 1;
+		bool interPicturePredicted = (data[0] & 0x40) ? true : false;
+		bool hasLayerIndices = (data[0] & 0x20) ? true : false;
+		bool flexibleMode = (data[0] & 0x10) ? true : false;
+
+		descriptor.startOfFrame = (data[0] & 0x08) ? true : false;
+		descriptor.endOfFrame = (data[0] & 0x04) ? true : false;
+
+		// PictureID (7 or 15 bits).
+		if (data[0] & 0x80)
+		{
+			if (len <= offset)
+				return false;
+
+			descriptor.hasPictureId = true;
+			descriptor.pictureIdOffset = offset;
+
+			if (data[offset] & 0x80)
+			{
+				if (len <= offset + 1)
+					return false;
+
+				descriptor.hasLongPictureId = true;
+				descriptor.pictureId = Utils::Byte::Get2Bytes(data, offset) & 0x7FFF;
+				offset += 2;
+			}
+			else
+			{
+				descriptor.pictureId = data[offset] & 0x7F;
+				offset += 1;
+			}
+		}
+
+		// Layer indices.
+		if (hasLayerIndices)
+		{
+			if (len <= offset)
+				return false;
+
+			descriptor.temporalLayer = (data[offset] >> 5) & 0x07;
+			descriptor.layerSync = (data[offset] & 0x10) ? true : false;
+			descriptor.hasSpatialLayers = true;
+			descriptor.spatialLayer = (data[offset] >> 1) & 0x07;
+			offset++;
+
+			// TL0PICIDX is just present in non flexible mode.
+			if (!flexibleMode)
+			{
+				if (len <= offset)
+					return false;
+
+				descriptor.hasTl0PicIdx = true;
+				descriptor.tl0PicIdxOffset = offset;
+				descriptor.tl0PicIdx = data[offset];
+				offset++;
+			}
+		}
+
+		// Reference indices (up to 3 P_DIFF, N bit set if another one follows)
+		// are just present in flexible mode.
+		if (flexibleMode && interPicturePredicted)
+		{
+			for (size_t i = 0; i < 3; ++i)
+			{
+				if (len <= offset)
+					return false;
+
+				if (!(data[offset++] & 0x01))
+					break;
+			}
+		}
+
+		// Scalability structure.
+		if (data[0] & 0x02)
+		{
+			if (len <= offset)
+				return false;
+
+			size_t numSpatialLayers = (data[offset] >> 5) + 1;
+			bool hasResolutions = (data[offset] & 0x10) ? true : false;
+			bool hasPictureGroup = (data[offset] & 0x08) ? true : false;
+
+			offset++;
+
+			// Width and height of each spatial layer.
+			if (hasResolutions)
+				offset += numSpatialLayers * 4;
+
+			if (hasPictureGroup)
+			{
+				if (len <= offset)
+					return false;
+
+				size_t numPictures = data[offset++];
+
+				for (size_t i = 0; i < numPictures; ++i)
+				{
+					if (len <= offset)
+						return false;
+
+					// T, U and R (number of P_DIFF that follow).
+					offset += 1 + ((data[offset] >> 2) & 0x03);
+				}
+			}
+		}
+
+		if (len <= offset)
+			return false;
+
+		descriptor.payloadOffset = offset;
+
+		descriptor.isKeyFrame = !interPicturePredicted && descriptor.startOfFrame && descriptor.spatialLayer == 0;
+
+		return true;
+	}
+
+	/* Specialization for H264. */
+
+	template<>
+	bool PayloadParser<RTC::RtpCodecMime::Subtype::H264>::Parse(const uint8_t* data, size_t len, PayloadDescriptor& descriptor)
+	{
+		MS_TRACE();
+
+		// Forbidden zero bit.
+		if (data[0] & 0x80)
+			return false;
+
+		uint8_t nal = data[0] & 0x1F;
+
+		switch (nal)
+		{
+			// STAP-A.
+			case 24:
+			{
+				size_t offset = 1;
+
+				if (len < offset + 3)
+					return false;
+
+				while (offset < len)
+				{
+					if (offset + 2 >= len)
+						return false;
+
+					size_t naluSize = Utils::Byte::Get2Bytes(data, offset);
+
+					offset += 2;
+
+					if (naluSize == 0 || offset + naluSize > len)
+						return false;
+
+					if (isH264KeyFrameNal(data[offset] & 0x1F))
+						descriptor.isKeyFrame = true;
+
+					offset += naluSize;
+				}
+
+				descriptor.startOfFrame = true;
+				descriptor.endOfFrame = true;
+
+				return true;
+			}
+
+			// FU-A.
+			case 28:
+			{
+				if (len < 3)
+					return false;
+
+				descriptor.startOfFrame = (data[1] & 0x80) ? true : false;
+				descriptor.endOfFrame = (data[1] & 0x40) ? true : false;
+				descriptor.isKeyFrame = descriptor.startOfFrame && isH264KeyFrameNal(data[1] & 0x1F);
+
+				return true;
+			}
+
+			// Reserved types and those not used in WebRTC (STAP-B, MTAP, FU-B).
+			case 0:
+			case 25:
+			case 26:
+			case 27:
+			case 29:
+			case 30:
+			case 31:
+				return false;
+
+			// Single NAL unit.
+			default:
+			{
+				descriptor.startOfFrame = true;
+				descriptor.endOfFrame = true;
+				descriptor.isKeyFrame = isH264KeyFrameNal(nal);
+
+				return true;
+			}
+		}
+	}
+
+	/* Specialization for H265. */
+
+	template<>
+	bool PayloadParser<RTC::RtpCodecMime::Subtype::H265>::Parse(const uint8_t* data, size_t len, PayloadDescriptor& descriptor)
+	{
+		MS_TRACE();
+
+		// Two bytes NAL unit header with forbidden zero bit and a non zero
+		// nuh_temporal_id_plus1.
+		if (len < 3 || (data[0] & 0x80) || (data[1] & 0x07) == 0)
+			return false;
+
+		uint8_t nal = (data[0] >> 1) & 0x3F;
+
+		descriptor.temporalLayer = (data[1] & 0x07) - 1;
+
+		switch (nal)
+		{
+			// AP.
+			case 48:
+			{
+				size_t offset = 2;
+
+				while (offset < len)
+				{
+					if (offset + 3 >= len)
+						return false;
+
+					size_t naluSize = Utils::Byte::Get2Bytes(data, offset);
+
+					offset += 2;
+
+					if (naluSize < 2 || offset + naluSize > len)
+						return false;
+
+					if (isH265KeyFrameNal((data[offset] >> 1) & 0x3F))
+						descriptor.isKeyFrame = true;
+
+					offset += naluSize;
+				}
+
+				descriptor.startOfFrame = true;
+				descriptor.endOfFrame = true;
+
+				return true;
+			}
+
+			// FU.
+			case 49:
+			{
+				nal = data[2] & 0x3F;
+
+				descriptor.startOfFrame = (data[2] & 0x80) ? true : false;
+				descriptor.endOfFrame = (data[2] & 0x40) ? true : false;
+				descriptor.isKeyFrame = descriptor.startOfFrame && isH265KeyFrameNal(nal);
+				// TSA and STSA pictures.
+				descriptor.layerSync = nal >= 2 && nal <= 5;
+
+				return true;
+			}
+
+			// PACI.
+			case 50:
+				return false;
+
+			// Single NAL unit.
+			default:
+			{
+				descriptor.startOfFrame = true;
+				descriptor.endOfFrame = true;
+				descriptor.isKeyFrame = isH265KeyFrameNal(nal);
+				// TSA and STSA pictures.
+				descriptor.layerSync = nal >= 2 && nal <= 5;
+
+				return true;
+			}
+		}
+	}
+}}
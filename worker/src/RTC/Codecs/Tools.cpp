@@ -0,0 +1,53 @@
+#define MS_CLASS "RTC::Codecs::Tools"
+// #define MS_LOG_DEV
+#define MS_LOG_HOT_PATH
+
+#include "RTC/Codecs/Tools.hpp"
+#include "RTC/Codecs/PayloadParser.hpp"
+#include "Logger.hpp"
+
+namespace RTC { namespace Codecs
+{
+	/* Class methods. */
+
+	bool Tools::ParsePayloadDescriptor(const RTC::RtpCodecMime& mime, const uint8_t* data, size_t len, PayloadDescriptor& descriptor)
+	{
+		MS_TRACE();
+
+		if (!data || len == 0)
+			return false;
+
+		switch (mime.subtype)
+		{
+			case RTC::RtpCodecMime::Subtype::VP8:
+				return PayloadParser<RTC::RtpCodecMime::Subtype::VP8>::Parse(data, len, descriptor);
+
+			case RTC::RtpCodecMime::Subtype::VP9:
+				return PayloadParser<RTC::RtpCodecMime::Subtype::VP9>::Parse(data, len, descriptor);
+
+			case RTC::RtpCodecMime::Subtype::H264:
+				return PayloadParser<RTC::RtpCodecMime::Subtype::H264>::Parse(data, len, descriptor);
+
+			case RTC::RtpCodecMime::Subtype::H265:
+				return PayloadParser<RTC::RtpCodecMime::Subtype::H265>::Parse(data, len, descriptor);
+
+			default:
+				return false;
+		}
+	}
+
+	bool Tools::IsKeyFrame(const RTC::RtpCodecMime& mime, const uint8_t* data, size_t len)
+	{
+		MS_TRACE();
+
+		if (mime.type != RTC::RtpCodecMime::Type::VIDEO)
+			return true;
+
+		PayloadDescriptor descriptor;
+
+		if (!ParsePayloadDescriptor(mime, data, len, descriptor))
+			return false;
+
+		return descriptor.isKeyFrame;
+	}
+}}
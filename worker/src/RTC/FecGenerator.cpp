@@ -0,0 +1,273 @@
+#define MS_CLASS "RTC::FecGenerator"
+// #define MS_LOG_DEV
+#define MS_LOG_HOT_PATH
+
+#include "RTC/FecGenerator.hpp"
+#include "Utils.hpp"
+#include "Logger.hpp"
+#include <cstring> // std::memcpy(), std::memset()
+#include <algorithm> // std::max(), std::min()
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace RTC
+{
+	/* Class variables. */
+
+	constexpr size_t FecGenerator::MaxGroupSize;
+	constexpr size_t FecGenerator::MinGroupSize;
+	constexpr size_t FecGenerator::MaxMediaPacketSize;
+	constexpr size_t FecGenerator::RtpHeaderSize;
+	constexpr size_t FecGenerator::FecHeaderSize;
+	constexpr size_t FecGenerator::ExtensionSize;
+
+	uint8_t FecGenerator::buffer[FecGenerator::MaxMediaPacketSize + FecGenerator::ExtensionSize + FecGenerator::FecHeaderSize];
+
+	/* Class methods. */
+
+	/**
+	 * dst ^= src. Done in 16 bytes blocks with SSE2 (if available) and in 8
+	 * bytes words otherwise.
+	 */
+	void FecGenerator::Xor(uint8_t* dst, const uint8_t* src, size_t len)
+	{
+		size_t i = 0;
+
+#if defined(__SSE2__)
+		for (; i + 16 <= len; i += 16)
+		{
+			__m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(dst + i));
+			__m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), _mm_xor_si128(a, b));
+		}
+#endif
+
+		for (; i + 8 <= len; i += 8)
+		{
+			uint64_t a;
+			uint64_t b;
+
+			std::memcpy(&a, dst + i, 8);
+			std::memcpy(&b, src + i, 8);
+			a ^= b;
+			std::memcpy(dst + i, &a, 8);
+		}
+
+		for (; i < len; ++i)
+		{
+			dst[i] ^= src[i];
+		}
+	}
+
+	/* Instance methods. */
+
+	FecGenerator::FecGenerator(uint32_t ssrc, uint8_t payloadType, uint8_t transportWideCcId) :
+		ssrc(ssrc),
+		payloadType(payloadType),
+		transportWideCcId(transportWideCcId)
+	{
+		MS_TRACE();
+
+		this->seq = static_cast<uint16_t>(Utils::Crypto::GetRandomUInt(0, 0xFFFF));
+
+		std::memset(this->recovery, 0, sizeof(this->recovery));
+	}
+
+	Json::Value FecGenerator::toJson() const
+	{
+		MS_TRACE();
+
+		static const Json::StaticString k_ssrc("ssrc");
+		static const Json::StaticString k_groupSize("groupSize");
+		static const Json::StaticString k_protectedPackets("protectedPackets");
+		static const Json::StaticString k_fecPackets("fecPackets");
+		static const Json::StaticString k_fecBytes("fecBytes");
+
+		Json::Value json(Json::objectValue);
+
+		json[k_ssrc] = (Json::UInt)this->ssrc;
+		json[k_groupSize] = (Json::UInt)this->groupSize;
+		json[k_protectedPackets] = (Json::UInt)this->protectedPackets;
+		json[k_fecPackets] = (Json::UInt)this->fecPackets;
+		json[k_fecBytes] = (Json::UInt)this->fecBytes;
+
+		return json;
+	}
+
+	/**
+	 * Fraction lost as reported in RTCP (loss / 256). Each FEC packet protects
+	 * about 1 / (2 * loss) packets.
+	 */
+	void FecGenerator::SetFractionLost(uint8_t fractionLost)
+	{
+		MS_TRACE();
+
+		size_t groupSize = 0;
+
+		if (fractionLost)
+		{
+			groupSize = 128 / fractionLost;
+			groupSize = std::max(groupSize, FecGenerator::MinGroupSize);
+			groupSize = std::min(groupSize, FecGenerator::MaxGroupSize);
+		}
+
+		if (groupSize != this->groupSize)
+		{
+			MS_DEBUG_TAG(rtp, "FEC group size changed [ssrc:%" PRIu32 ", fractionLost:%" PRIu8 ", groupSize:%zu]",
+				this->ssrc, fractionLost, groupSize);
+		}
+
+		this->groupSize = groupSize;
+	}
+
+	/**
+	 * Protects the given (already sent) media packet. Returns a FEC packet if
+	 * the group is complete (the caller must delete it and it is just valid
+	 * until the next call).
+	 */
+	RTC::RtpPacket* FecGenerator::AddPacket(RTC::RtpPacket* packet)
+	{
+		MS_TRACE();
+
+		if (!this->groupSize)
+		{
+			this->numPackets = 0;
+
+			return nullptr;
+		}
+
+		const uint8_t* data = packet->GetData();
+		size_t size = packet->GetSize();
+		uint16_t seq = packet->GetSequenceNumber();
+
+		if (size > FecGenerator::MaxMediaPacketSize)
+			return nullptr;
+
+		if (this->numPackets)
+		{
+			uint16_t delta = seq - this->baseSeq;
+
+			// Older (or repeated) packet.
+			if (delta >= 0x8000 || (delta < FecGenerator::MaxGroupSize && (this->mask & (0x4000 >> delta))))
+				return nullptr;
+
+			// It does not fit in the mask, so start a new group.
+			if (delta >= FecGenerator::MaxGroupSize || packet->GetSsrc() != this->mediaSsrc)
+				this->numPackets = 0;
+		}
+
+		if (!this->numPackets)
+		{
+			std::memset(this->recovery, 0, this->recoveryLength);
+
+			this->mediaSsrc = packet->GetSsrc();
+			this->baseSeq = seq;
+			this->mask = 0;
+			this->byte0Recovery = 0;
+			this->byte1Recovery = 0;
+			this->lengthRecovery = 0;
+			this->timestampRecovery = 0;
+			this->recoveryLength = 0;
+		}
+
+		size_t length = size - FecGenerator::RtpHeaderSize;
+		uint16_t wideSeqNumber;
+		bool hasWideSeqNumber = false;
+
+		// Do not protect the transport-wide sequence number (restored below).
+		if (this->transportWideCcId)
+		{
+			packet->AddExtensionMapping(RTC::RtpHeaderExtensionUri::Type::TRANSPORT_WIDE_CC_01, this->transportWideCcId);
+
+			if (packet->ReadTransportWideCc01(&wideSeqNumber))
+			{
+				packet->UpdateTransportWideCc01(0);
+				hasWideSeqNumber = true;
+			}
+		}
+
+		this->byte0Recovery ^= data[0];
+		this->byte1Recovery ^= data[1];
+		this->lengthRecovery ^= static_cast<uint16_t>(length);
+		this->timestampRecovery ^= packet->GetTimestamp();
+		FecGenerator::Xor(this->recovery, data + FecGenerator::RtpHeaderSize, length);
+
+		if (hasWideSeqNumber)
+			packet->UpdateTransportWideCc01(wideSeqNumber);
+
+		this->recoveryLength = std::max(this->recoveryLength, length);
+		this->mask |= 0x4000 >> static_cast<uint16_t>(seq - this->baseSeq);
+		this->lastTimestamp = packet->GetTimestamp();
+		this->numPackets++;
+		this->protectedPackets++;
+
+		if (
+			this->numPackets >= this->groupSize ||
+			(packet->HasMarker() && this->numPackets * 2 >= this->groupSize)
+		)
+		{
+			return CreateFecPacket();
+		}
+
+		return nullptr;
+	}
+
+	RTC::RtpPacket* FecGenerator::CreateFecPacket()
+	{
+		MS_TRACE();
+
+		uint8_t* rtp = FecGenerator::buffer;
+		size_t headerSize = FecGenerator::RtpHeaderSize;
+
+		// RTP header (V=2).
+		rtp[0] = 0x80;
+		rtp[1] = this->payloadType;
+		Utils::Byte::Set2Bytes(rtp, 2, this->seq++);
+		Utils::Byte::Set4Bytes(rtp, 4, this->lastTimestamp);
+		Utils::Byte::Set4Bytes(rtp, 8, this->ssrc);
+
+		// Header extension with an empty transport-wide sequence number to be
+		// stamped by the Transport (X=1).
+		if (this->transportWideCcId)
+		{
+			uint8_t* extension = rtp + FecGenerator::RtpHeaderSize;
+
+			rtp[0] |= 0x10;
+			Utils::Byte::Set2Bytes(extension, 0, 0xBEDE);
+			Utils::Byte::Set2Bytes(extension, 2, 1);
+			extension[4] = (this->transportWideCcId << 4) | 1;
+			extension[5] = 0;
+			extension[6] = 0;
+			extension[7] = 0;
+			headerSize += FecGenerator::ExtensionSize;
+		}
+
+		uint8_t* fec = rtp + headerSize;
+
+		// FlexFEC header with R=0, F=0 (flexible mask), a single SSRC and the
+		// shortest mask (k=1).
+		fec[0] = this->byte0Recovery & 0x3F;
+		fec[1] = this->byte1Recovery;
+		Utils::Byte::Set2Bytes(fec, 2, this->lengthRecovery);
+		Utils::Byte::Set4Bytes(fec, 4, this->timestampRecovery);
+		fec[8] = 1;
+		fec[9] = 0;
+		fec[10] = 0;
+		fec[11] = 0;
+		Utils::Byte::Set4Bytes(fec, 12, this->mediaSsrc);
+		Utils::Byte::Set2Bytes(fec, 16, this->baseSeq);
+		Utils::Byte::Set2Bytes(fec, 18, 0x8000 | this->mask);
+
+		std::memcpy(fec + FecGenerator::FecHeaderSize, this->recovery, this->recoveryLength);
+
+		size_t size = headerSize + FecGenerator::FecHeaderSize + this->recoveryLength;
+
+		this->numPackets = 0;
+		this->fecPackets++;
+		this->fecBytes += size;
+
+		return RTC::RtpPacket::Parse(FecGenerator::buffer, size);
+	}
+}
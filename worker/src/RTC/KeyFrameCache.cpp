@@ -0,0 +1,189 @@
+#define MS_CLASS "RTC::KeyFrameCache"
+// #define MS_LOG_DEV
+#define MS_LOG_HOT_PATH
+
+#include "RTC/KeyFrameCache.hpp"
+#include "Logger.hpp"
+
+namespace RTC
+{
+	/* Class variables. */
+
+	constexpr size_t KeyFrameCache::BufferSize;
+	constexpr size_t KeyFrameCache::MaxPoolSize;
+	constexpr size_t KeyFrameCache::DefaultMaxPackets;
+	std::vector<uint8_t*> KeyFrameCache::bufferPool;
+
+	/* Class methods. */
+
+	void KeyFrameCache::ClassDestroy()
+	{
+		MS_TRACE();
+
+		for (auto buffer : KeyFrameCache::bufferPool)
+		{
+			delete[] buffer;
+		}
+
+		KeyFrameCache::bufferPool.clear();
+	}
+
+	uint8_t* KeyFrameCache::GetBuffer()
+	{
+		MS_TRACE();
+
+		if (KeyFrameCache::bufferPool.empty())
+			return new uint8_t[KeyFrameCache::BufferSize];
+
+		uint8_t* buffer = KeyFrameCache::bufferPool.back();
+
+		KeyFrameCache::bufferPool.pop_back();
+
+		return buffer;
+	}
+
+	void KeyFrameCache::ReleaseBuffer(uint8_t* buffer)
+	{
+		MS_TRACE();
+
+		if (KeyFrameCache::bufferPool.size() < KeyFrameCache::MaxPoolSize)
+			KeyFrameCache::bufferPool.push_back(buffer);
+		else
+			delete[] buffer;
+	}
+
+	/* Instance methods. */
+
+	KeyFrameCache::KeyFrameCache(size_t maxPackets) :
+		maxPackets(maxPackets)
+	{
+		MS_TRACE();
+	}
+
+	KeyFrameCache::~KeyFrameCache()
+	{
+		MS_TRACE();
+
+		Clear();
+	}
+
+	void KeyFrameCache::ReceivePacket(RTC::RtpPacket* packet)
+	{
+		MS_TRACE();
+
+		const RTC::Codecs::PayloadDescriptor* descriptor = packet->GetPayloadDescriptor();
+		uint32_t timestamp = packet->GetTimestamp();
+
+		// A new key frame starts a new GOP. Packets of the same picture may be
+		// flagged as key frame too (i.e. H264 SPS and IDR slice in different
+		// packets).
+		if (
+			descriptor && descriptor->isKeyFrame &&
+			!(this->hasKeyFrame && timestamp == this->keyFrameTimestamp)
+		)
+		{
+			Clear();
+
+			this->hasKeyFrame = true;
+			this->gopComplete = true;
+			this->keyFrameTimestamp = timestamp;
+			this->numKeyFrames++;
+		}
+
+		if (!this->hasKeyFrame || !this->gopComplete)
+			return;
+
+		// Ignore packets older than the key frame (retransmissions, reordering).
+		if (
+			!this->packets.empty() &&
+			static_cast<uint16_t>(packet->GetSequenceNumber() - this->packets[0]->GetSequenceNumber()) >= 0x8000
+		)
+		{
+			return;
+		}
+
+		bool isKeyFramePacket = (timestamp == this->keyFrameTimestamp);
+
+		if (this->packets.size() >= this->maxPackets || packet->GetSize() > KeyFrameCache::BufferSize)
+		{
+			// The key frame itself does not fit so it is useless.
+			if (isKeyFramePacket)
+			{
+				MS_DEBUG_TAG(rtp, "key frame does not fit into the cache [ssrc:%" PRIu32 "]", packet->GetSsrc());
+
+				Clear();
+
+				return;
+			}
+
+			// Keep just the key frame.
+			while (this->packets.size() > this->keyFramePackets)
+			{
+				delete this->packets.back();
+				KeyFrameCache::ReleaseBuffer(this->buffers.back());
+
+				this->packets.pop_back();
+				this->buffers.pop_back();
+			}
+
+			this->gopComplete = false;
+			this->numOverflows++;
+
+			return;
+		}
+
+		uint8_t* buffer = KeyFrameCache::GetBuffer();
+
+		this->packets.push_back(packet->Clone(buffer));
+		this->buffers.push_back(buffer);
+
+		if (isKeyFramePacket)
+			this->keyFramePackets++;
+	}
+
+	Json::Value KeyFrameCache::toJson() const
+	{
+		MS_TRACE();
+
+		static const Json::StaticString k_maxPackets("maxPackets");
+		static const Json::StaticString k_hasKeyFrame("hasKeyFrame");
+		static const Json::StaticString k_gopComplete("gopComplete");
+		static const Json::StaticString k_packets("packets");
+		static const Json::StaticString k_keyFramePackets("keyFramePackets");
+		static const Json::StaticString k_keyFrames("keyFrames");
+		static const Json::StaticString k_overflows("overflows");
+
+		Json::Value json(Json::objectValue);
+
+		json[k_maxPackets] = (Json::UInt)this->maxPackets;
+		json[k_hasKeyFrame] = this->hasKeyFrame;
+		json[k_gopComplete] = this->gopComplete;
+		json[k_packets] = (Json::UInt)this->packets.size();
+		json[k_keyFramePackets] = (Json::UInt)this->keyFramePackets;
+		json[k_keyFrames] = (Json::UInt)this->numKeyFrames;
+		json[k_overflows] = (Json::UInt)this->numOverflows;
+
+		return json;
+	}
+
+	void KeyFrameCache::Clear()
+	{
+		MS_TRACE();
+
+		for (auto packet : this->packets)
+		{
+			delete packet;
+		}
+
+		for (auto buffer : this->buffers)
+		{
+			KeyFrameCache::ReleaseBuffer(buffer);
+		}
+
+		this->packets.clear();
+		this->buffers.clear();
+		this->hasKeyFrame = false;
+		this->gopComplete = false;
+		this->keyFramePackets = 0;
+	}
+}
@@ -0,0 +1,421 @@
+#define MS_CLASS "RTC::Metrics"
+// #define MS_LOG_DEV
+
+#include "RTC/Metrics.hpp"
+#include "Logger.hpp"
+#include <cstring> // std::memset()
+#include <cstdio> // std::snprintf()
+#include <cinttypes> // PRIu64
+
+/* Static helpers. */
+
+static inline
+void writeHeader(std::string& out, const char* name, const char* type, const char* help)
+{
+	out.append("# HELP ").append(name).append(" ").append(help).append("\n");
+	out.append("# TYPE ").append(name).append(" ").append(type).append("\n");
+}
+
+static inline
+void writeSample(std::string& out, const char* name, const char* suffix, const std::string& labels, uint64_t value)
+{
+	char buffer[32];
+
+	std::snprintf(buffer, sizeof(buffer), "%" PRIu64, value);
+
+	out.append(name).append(suffix).append("{").append(labels).append("} ").append(buffer).append("\n");
+}
+
+namespace RTC
+{
+	/* Class variables. */
+
+	constexpr size_t Metrics::Histogram::SubBuckets;
+	constexpr size_t Metrics::Histogram::NumBuckets;
+
+	size_t Metrics::numRooms = 0;
+	size_t Metrics::numPeers = 0;
+	Metrics::Histogram Metrics::jitter("mediasoup_jitter_ms");
+	Metrics::Histogram Metrics::rtt("mediasoup_rtt_ms");
+	Metrics::Histogram Metrics::packetSize("mediasoup_rtp_packet_size_bytes");
+	Metrics::Histogram Metrics::forwardingLatency("mediasoup_forwarding_latency_us");
+	std::unordered_set<const Metrics::TransportCounters*> Metrics::transports;
+	std::unordered_set<const Metrics::StreamCounters*> Metrics::rtpReceivers;
+	std::unordered_set<const Metrics::StreamCounters*> Metrics::rtpSenders;
+	uint64_t Metrics::forwardingStartTime = 0;
+
+	/* Class methods. */
+
+	void Metrics::AddTransport(const TransportCounters* counters)
+	{
+		MS_TRACE();
+
+		Metrics::transports.insert(counters);
+	}
+
+	void Metrics::RemoveTransport(const TransportCounters* counters)
+	{
+		MS_TRACE();
+
+		Metrics::transports.erase(counters);
+	}
+
+	void Metrics::AddRtpReceiver(const StreamCounters* counters)
+	{
+		MS_TRACE();
+
+		Metrics::rtpReceivers.insert(counters);
+	}
+
+	void Metrics::RemoveRtpReceiver(const StreamCounters* counters)
+	{
+		MS_TRACE();
+
+		Metrics::rtpReceivers.erase(counters);
+	}
+
+	void Metrics::AddRtpSender(const StreamCounters* counters)
+	{
+		MS_TRACE();
+
+		Metrics::rtpSenders.insert(counters);
+	}
+
+	void Metrics::RemoveRtpSender(const StreamCounters* counters)
+	{
+		MS_TRACE();
+
+		Metrics::rtpSenders.erase(counters);
+	}
+
+	Json::Value Metrics::toJson()
+	{
+		MS_TRACE();
+
+		static const Json::StaticString k_rooms("rooms");
+		static const Json::StaticString k_peers("peers");
+		static const Json::StaticString k_transports("transports");
+		static const Json::StaticString k_rtpReceivers("rtpReceivers");
+		static const Json::StaticString k_rtpSenders("rtpSenders");
+		static const Json::StaticString k_histograms("histograms");
+		static const Json::StaticString k_transportId("transportId");
+		static const Json::StaticString k_rtpPacketsReceived("rtpPacketsReceived");
+		static const Json::StaticString k_rtpBytesReceived("rtpBytesReceived");
+		static const Json::StaticString k_rtpPacketsSent("rtpPacketsSent");
+		static const Json::StaticString k_rtpBytesSent("rtpBytesSent");
+		static const Json::StaticString k_rtcpPacketsReceived("rtcpPacketsReceived");
+		static const Json::StaticString k_rtcpBytesReceived("rtcpBytesReceived");
+		static const Json::StaticString k_rtcpPacketsSent("rtcpPacketsSent");
+		static const Json::StaticString k_rtcpBytesSent("rtcpBytesSent");
+		static const Json::StaticString k_rtpReceiverId("rtpReceiverId");
+		static const Json::StaticString k_rtpSenderId("rtpSenderId");
+		static const Json::StaticString k_kind("kind");
+		static const Json::StaticString k_packets("packets");
+		static const Json::StaticString k_bytes("bytes");
+		static const Json::StaticString k_rtxPackets("rtxPackets");
+		static const Json::StaticString k_rtxBytes("rtxBytes");
+		static const Json::StaticString k_retransmittedPackets("retransmittedPackets");
+		static const Json::StaticString k_retransmittedBytes("retransmittedBytes");
+		static const Json::StaticString k_jitter("jitter");
+		static const Json::StaticString k_rtt("rtt");
+		static const Json::StaticString k_packetSize("packetSize");
+		static const Json::StaticString k_forwardingLatency("forwardingLatency");
+
+		Json::Value json(Json::objectValue);
+		Json::Value json_transports(Json::arrayValue);
+		Json::Value json_rtpReceivers(Json::arrayValue);
+		Json::Value json_rtpSenders(Json::arrayValue);
+		Json::Value json_histograms(Json::objectValue);
+
+		json[k_rooms] = (Json::UInt)Metrics::numRooms;
+		json[k_peers] = (Json::UInt)Metrics::numPeers;
+
+		for (auto counters : Metrics::transports)
+		{
+			Json::Value json_transport(Json::objectValue);
+
+			json_transport[k_transportId] = (Json::UInt)counters->transportId;
+			json_transport[k_rtpPacketsReceived] = (Json::UInt64)counters->rtpPacketsReceived;
+			json_transport[k_rtpBytesReceived] = (Json::UInt64)counters->rtpBytesReceived;
+			json_transport[k_rtpPacketsSent] = (Json::UInt64)counters->rtpPacketsSent;
+			json_transport[k_rtpBytesSent] = (Json::UInt64)counters->rtpBytesSent;
+			json_transport[k_rtcpPacketsReceived] = (Json::UInt64)counters->rtcpPacketsReceived;
+			json_transport[k_rtcpBytesReceived] = (Json::UInt64)counters->rtcpBytesReceived;
+			json_transport[k_rtcpPacketsSent] = (Json::UInt64)counters->rtcpPacketsSent;
+			json_transport[k_rtcpBytesSent] = (Json::UInt64)counters->rtcpBytesSent;
+
+			json_transports.append(json_transport);
+		}
+		json[k_transports] = json_transports;
+
+		for (auto counters : Metrics::rtpReceivers)
+		{
+			Json::Value json_rtpReceiver(Json::objectValue);
+
+			json_rtpReceiver[k_rtpReceiverId] = (Json::UInt)counters->id;
+			json_rtpReceiver[k_kind] = RTC::Media::GetJsonString(counters->kind);
+			json_rtpReceiver[k_packets] = (Json::UInt64)counters->counter->GetPacketCount();
+			json_rtpReceiver[k_bytes] = (Json::UInt64)counters->counter->GetBytes();
+			json_rtpReceiver[k_rtxPackets] = (Json::UInt64)counters->rtxCounter->GetPacketCount();
+			json_rtpReceiver[k_rtxBytes] = (Json::UInt64)counters->rtxCounter->GetBytes();
+
+			json_rtpReceivers.append(json_rtpReceiver);
+		}
+		json[k_rtpReceivers] = json_rtpReceivers;
+
+		for (auto counters : Metrics::rtpSenders)
+		{
+			Json::Value json_rtpSender(Json::objectValue);
+
+			json_rtpSender[k_rtpSenderId] = (Json::UInt)counters->id;
+			json_rtpSender[k_kind] = RTC::Media::GetJsonString(counters->kind);
+			json_rtpSender[k_packets] = (Json::UInt64)counters->counter->GetPacketCount();
+			json_rtpSender[k_bytes] = (Json::UInt64)counters->counter->GetBytes();
+			json_rtpSender[k_retransmittedPackets] = (Json::UInt64)counters->rtxCounter->GetPacketCount();
+			json_rtpSender[k_retransmittedBytes] = (Json::UInt64)counters->rtxCounter->GetBytes();
+
+			json_rtpSenders.append(json_rtpSender);
+		}
+		json[k_rtpSenders] = json_rtpSenders;
+
+		json_histograms[k_jitter] = Metrics::jitter.toJson();
+		json_histograms[k_rtt] = Metrics::rtt.toJson();
+		json_histograms[k_packetSize] = Metrics::packetSize.toJson();
+		json_histograms[k_forwardingLatency] = Metrics::forwardingLatency.toJson();
+		json[k_histograms] = json_histograms;
+
+		return json;
+	}
+
+	/**
+	 * Prometheus text exposition format. Every sample has a "worker" label with
+	 * the id of the worker.
+	 */
+	std::string Metrics::GetPrometheusText()
+	{
+		MS_TRACE();
+
+		std::string out;
+		std::string workerLabel = "worker=\"" + Logger::id + "\"";
+
+		out.reserve(1024 + (Metrics::transports.size() * 8 + (Metrics::rtpReceivers.size() + Metrics::rtpSenders.size()) * 4) * 96);
+
+		writeHeader(out, "mediasoup_rooms", "gauge", "Number of Rooms.");
+		writeSample(out, "mediasoup_rooms", "", workerLabel, Metrics::numRooms);
+		writeHeader(out, "mediasoup_peers", "gauge", "Number of Peers.");
+		writeSample(out, "mediasoup_peers", "", workerLabel, Metrics::numPeers);
+		writeHeader(out, "mediasoup_transports", "gauge", "Number of Transports.");
+		writeSample(out, "mediasoup_transports", "", workerLabel, Metrics::transports.size());
+		writeHeader(out, "mediasoup_rtp_receivers", "gauge", "Number of RtpReceivers.");
+		writeSample(out, "mediasoup_rtp_receivers", "", workerLabel, Metrics::rtpReceivers.size());
+		writeHeader(out, "mediasoup_rtp_senders", "gauge", "Number of RtpSenders.");
+		writeSample(out, "mediasoup_rtp_senders", "", workerLabel, Metrics::rtpSenders.size());
+
+		// Transports.
+		{
+			struct Family
+			{
+				const char* name;
+				const char* help;
+				uint64_t Metrics::TransportCounters::* field;
+			};
+
+			static const Family families[] =
+			{
+				{ "mediasoup_transport_rtp_packets_received_total",  "RTP packets received.",  &TransportCounters::rtpPacketsReceived  },
+				{ "mediasoup_transport_rtp_bytes_received_total",    "RTP bytes received.",    &TransportCounters::rtpBytesReceived    },
+				{ "mediasoup_transport_rtp_packets_sent_total",      "RTP packets sent.",      &TransportCounters::rtpPacketsSent      },
+				{ "mediasoup_transport_rtp_bytes_sent_total",        "RTP bytes sent.",        &TransportCounters::rtpBytesSent        },
+				{ "mediasoup_transport_rtcp_packets_received_total", "RTCP packets received.", &TransportCounters::rtcpPacketsReceived },
+				{ "mediasoup_transport_rtcp_bytes_received_total",   "RTCP bytes received.",   &TransportCounters::rtcpBytesReceived   },
+				{ "mediasoup_transport_rtcp_packets_sent_total",     "RTCP packets sent.",     &TransportCounters::rtcpPacketsSent     },
+				{ "mediasoup_transport_rtcp_bytes_sent_total",       "RTCP bytes sent.",       &TransportCounters::rtcpBytesSent       }
+			};
+
+			std::vector<std::string> labels;
+
+			labels.reserve(Metrics::transports.size());
+
+			for (auto counters : Metrics::transports)
+			{
+				labels.push_back(workerLabel + ",transport=\"" + std::to_string(counters->transportId) + "\"");
+			}
+
+			for (auto& family : families)
+			{
+				size_t idx = 0;
+
+				writeHeader(out, family.name, "counter", family.help);
+
+				for (auto counters : Metrics::transports)
+				{
+					writeSample(out, family.name, "", labels[idx++], counters->*family.field);
+				}
+			}
+		}
+
+		// RtpReceivers and RtpSenders.
+		{
+			struct Family
+			{
+				const char* name;
+				const char* help;
+				bool rtx;
+				bool bytes;
+			};
+
+			static const Family rtpReceiverFamilies[] =
+			{
+				{ "mediasoup_rtp_receiver_packets_total",     "RTP packets received.",     false, false },
+				{ "mediasoup_rtp_receiver_bytes_total",       "RTP bytes received.",       false, true  },
+				{ "mediasoup_rtp_receiver_rtx_packets_total", "RTX packets received.",     true,  false },
+				{ "mediasoup_rtp_receiver_rtx_bytes_total",   "RTX bytes received.",       true,  true  }
+			};
+
+			static const Family rtpSenderFamilies[] =
+			{
+				{ "mediasoup_rtp_sender_packets_total",               "RTP packets transmitted.",   false, false },
+				{ "mediasoup_rtp_sender_bytes_total",                 "RTP bytes transmitted.",     false, true  },
+				{ "mediasoup_rtp_sender_retransmitted_packets_total", "RTP packets retransmitted.", true,  false },
+				{ "mediasoup_rtp_sender_retransmitted_bytes_total",   "RTP bytes retransmitted.",   true,  true  }
+			};
+
+			struct Set
+			{
+				const Family* families;
+				const std::unordered_set<const StreamCounters*>& streams;
+				const char* idLabel;
+			};
+
+			const Set sets[] =
+			{
+				{ rtpReceiverFamilies, Metrics::rtpReceivers, ",rtp_receiver=\"" },
+				{ rtpSenderFamilies,   Metrics::rtpSenders,   ",rtp_sender=\""   }
+			};
+
+			for (auto& set : sets)
+			{
+				std::vector<std::string> labels;
+
+				labels.reserve(set.streams.size());
+
+				for (auto counters : set.streams)
+				{
+					labels.push_back(
+						workerLabel + set.idLabel + std::to_string(counters->id) +
+						"\",kind=\"" + RTC::Media::GetJsonString(counters->kind).c_str() + "\"");
+				}
+
+				for (size_t i = 0; i < 4; ++i)
+				{
+					const Family& family = set.families[i];
+					size_t idx = 0;
+
+					writeHeader(out, family.name, "counter", family.help);
+
+					for (auto counters : set.streams)
+					{
+						const RTC::RtpDataCounter* counter = family.rtx ? counters->rtxCounter : counters->counter;
+
+						writeSample(out, family.name, "", labels[idx++], family.bytes ? counter->GetBytes() : counter->GetPacketCount());
+					}
+				}
+			}
+		}
+
+		// Histograms.
+		writeHeader(out, Metrics::jitter.name, "histogram", "Jitter of the received streams.");
+		Metrics::jitter.WritePrometheus(out, workerLabel);
+		writeHeader(out, Metrics::rtt.name, "histogram", "Round trip time with the remote peers.");
+		Metrics::rtt.WritePrometheus(out, workerLabel);
+		writeHeader(out, Metrics::packetSize.name, "histogram", "Size of the received RTP packets.");
+		Metrics::packetSize.WritePrometheus(out, workerLabel);
+		writeHeader(out, Metrics::forwardingLatency.name, "histogram", "Time from the reception of a RTP packet to the sending of the forwarded ones.");
+		Metrics::forwardingLatency.WritePrometheus(out, workerLabel);
+
+		return out;
+	}
+
+	/* Histogram class methods. */
+
+	uint64_t Metrics::Histogram::GetBucketUpperBound(size_t idx)
+	{
+		if (idx < SubBuckets)
+			return idx;
+
+		size_t exponent = 2 + (idx - SubBuckets) / SubBuckets;
+		size_t subBucket = (idx - SubBuckets) % SubBuckets;
+
+		return ((SubBuckets + subBucket + 1) << (exponent - 2)) - 1;
+	}
+
+	/* Histogram instance methods. */
+
+	Metrics::Histogram::Histogram(const char* name) :
+		name(name)
+	{}
+
+	void Metrics::Histogram::Reset()
+	{
+		MS_TRACE();
+
+		std::memset(this->buckets, 0, sizeof(this->buckets));
+		this->count = 0;
+		this->sum = 0;
+	}
+
+	Json::Value Metrics::Histogram::toJson() const
+	{
+		MS_TRACE();
+
+		static const Json::StaticString k_count("count");
+		static const Json::StaticString k_sum("sum");
+		static const Json::StaticString k_buckets("buckets");
+
+		Json::Value json(Json::objectValue);
+		Json::Value json_buckets(Json::arrayValue);
+
+		json[k_count] = (Json::UInt64)this->count;
+		json[k_sum] = (Json::UInt64)this->sum;
+
+		// Just the non empty buckets, as [ upper bound, count ] pairs.
+		for (size_t idx = 0; idx < NumBuckets; ++idx)
+		{
+			if (!this->buckets[idx])
+				continue;
+
+			Json::Value json_bucket(Json::arrayValue);
+
+			json_bucket.append((Json::UInt64)GetBucketUpperBound(idx));
+			json_bucket.append((Json::UInt64)this->buckets[idx]);
+			json_buckets.append(json_bucket);
+		}
+		json[k_buckets] = json_buckets;
+
+		return json;
+	}
+
+	/**
+	 * Writes the cumulative buckets, followed by the "+Inf" one, the sum and the
+	 * count. All the buckets are written (even if empty) so every scrape has the
+	 * same series, but for the last one, which also counts the values out of
+	 * range and so is left to "+Inf".
+	 */
+	void Metrics::Histogram::WritePrometheus(std::string& out, const std::string& labels) const
+	{
+		MS_TRACE();
+
+		uint64_t cumulative = 0;
+
+		for (size_t idx = 0; idx < NumBuckets - 1; ++idx)
+		{
+			cumulative += this->buckets[idx];
+
+			writeSample(out, this->name, "_bucket", labels + ",le=\"" + std::to_string(GetBucketUpperBound(idx)) + "\"", cumulative);
+		}
+
+		writeSample(out, this->name, "_bucket", labels + ",le=\"+Inf\"", this->count);
+		writeSample(out, this->name, "_sum", labels, this->sum);
+		writeSample(out, this->name, "_count", labels, this->count);
+	}
+}
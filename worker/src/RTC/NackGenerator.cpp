@@ -0,0 +1,345 @@
+#define MS_CLASS "RTC::NackGenerator"
+// #define MS_LOG_DEV
+#define MS_LOG_HOT_PATH
+
+#include "RTC/NackGenerator.hpp"
+#include "DepLibUV.hpp"
+#include "Logger.hpp"
+#include <algorithm> // std::max()
+#include <iterator> // std::distance()
+
+namespace RTC
+{
+	/* Class variables. */
+
+	constexpr size_t NackGenerator::MaxNackPackets;
+	constexpr size_t NackGenerator::MaxKeyFramePackets;
+	constexpr uint8_t NackGenerator::MaxRetries;
+	constexpr uint64_t NackGenerator::MaxAge;
+	constexpr uint32_t NackGenerator::DefaultRtt;
+	constexpr uint32_t NackGenerator::MinRetryInterval;
+	constexpr uint64_t NackGenerator::Interval;
+	NackGenerator::Ticker NackGenerator::ticker;
+	Timer* NackGenerator::timer = nullptr;
+	bool NackGenerator::timerActive = false;
+	size_t NackGenerator::numGenerators = 0;
+	std::unordered_set<NackGenerator*> NackGenerator::pendingGenerators;
+
+	/* Instance methods. */
+
+	NackGenerator::NackGenerator(Listener* listener) :
+		listener(listener)
+	{
+		MS_TRACE();
+
+		// The timer is shared by all the generators of the worker.
+		if (NackGenerator::numGenerators++ == 0)
+			NackGenerator::timer = new Timer(&NackGenerator::ticker);
+	}
+
+	NackGenerator::~NackGenerator()
+	{
+		MS_TRACE();
+
+		NackGenerator::pendingGenerators.erase(this);
+
+		if (--NackGenerator::numGenerators == 0)
+		{
+			NackGenerator::timer->Destroy();
+			NackGenerator::timer = nullptr;
+			NackGenerator::timerActive = false;
+		}
+	}
+
+	Json::Value NackGenerator::toJson() const
+	{
+		MS_TRACE();
+
+		static const Json::StaticString k_rtt("rtt");
+		static const Json::StaticString k_nackListSize("nackListSize");
+		static const Json::StaticString k_missingPackets("missingPackets");
+		static const Json::StaticString k_requestedPackets("requestedPackets");
+		static const Json::StaticString k_recoveredPackets("recoveredPackets");
+		static const Json::StaticString k_expiredPackets("expiredPackets");
+		static const Json::StaticString k_latePackets("latePackets");
+		static const Json::StaticString k_keyFramesRequired("keyFramesRequired");
+
+		Json::Value json(Json::objectValue);
+
+		json[k_rtt] = (Json::UInt)this->rtt;
+		json[k_nackListSize] = (Json::UInt)this->nackList.size();
+		json[k_missingPackets] = (Json::UInt)this->missingPackets;
+		json[k_requestedPackets] = (Json::UInt)this->requestedPackets;
+		json[k_recoveredPackets] = (Json::UInt)this->recoveredPackets;
+		json[k_expiredPackets] = (Json::UInt)this->expiredPackets;
+		json[k_latePackets] = (Json::UInt)this->latePackets;
+		json[k_keyFramesRequired] = (Json::UInt)this->keyFramesRequired;
+
+		return json;
+	}
+
+	/**
+	 * Returns true if the packet was in the NACK list.
+	 */
+	bool NackGenerator::ReceivePacket(RTC::RtpPacket* packet, uint64_t now)
+	{
+		MS_TRACE();
+
+		uint16_t seq = packet->GetSequenceNumber();
+		const RTC::Codecs::PayloadDescriptor* descriptor = packet->GetPayloadDescriptor();
+		bool isKeyFrame = descriptor && descriptor->isKeyFrame;
+
+		if (!this->started)
+		{
+			this->started = true;
+			// Leave room for the packets older than the first one.
+			this->lastSeq32 = (1 << 16) + seq;
+
+			if (isKeyFrame)
+				this->keyFrameList.insert(this->lastSeq32);
+
+			return false;
+		}
+
+		int16_t diff = static_cast<int16_t>(seq - static_cast<uint16_t>(this->lastSeq32));
+		uint32_t seq32 = this->lastSeq32 + diff;
+
+		// Duplicated packet.
+		if (diff == 0)
+			return false;
+
+		if (isKeyFrame)
+		{
+			this->keyFrameList.insert(seq32);
+
+			if (this->keyFrameList.size() > NackGenerator::MaxKeyFramePackets)
+				this->keyFrameList.erase(this->keyFrameList.begin());
+		}
+
+		// Out of order packet.
+		if (diff < 0)
+		{
+			auto it = this->nackList.find(seq32);
+
+			// Already received or given up.
+			if (it == this->nackList.end())
+			{
+				this->latePackets++;
+
+				return false;
+			}
+
+			MS_DEBUG_DEV("missing packet received [seq:%" PRIu16 ", retries:%" PRIu8 "]",
+				seq, it->second.retries);
+
+			this->nackList.erase(it);
+			this->recoveredPackets++;
+
+			UpdatePending();
+
+			return true;
+		}
+
+		uint32_t lastSeq32 = this->lastSeq32;
+
+		this->lastSeq32 = seq32;
+
+		// Just received the next expected packet.
+		if (diff == 1)
+			return false;
+
+		AddPacketsToNackList(lastSeq32 + 1, seq32, now);
+
+		// Request the new missing packets right away.
+		SendNacks(now, true);
+
+		return false;
+	}
+
+	/**
+	 * Called by the shared timer. Requests again the missing packets whose last
+	 * request is older than the RTT and gives up the too old ones.
+	 */
+	void NackGenerator::ProcessRetries(uint64_t now)
+	{
+		MS_TRACE();
+
+		SendNacks(now, false);
+	}
+
+	void NackGenerator::UpdateRtt(uint32_t rtt)
+	{
+		MS_TRACE();
+
+		if (!this->rtt)
+			this->rtt = rtt;
+		else
+			this->rtt = (this->rtt * 7 + rtt) / 8;
+	}
+
+	void NackGenerator::Reset()
+	{
+		MS_TRACE();
+
+		this->nackList.clear();
+		this->keyFrameList.clear();
+		this->started = false;
+		this->lastSeq32 = 0;
+
+		UpdatePending();
+	}
+
+	void NackGenerator::AddPacketsToNackList(uint32_t seqStart, uint32_t seqEnd, uint64_t now)
+	{
+		MS_TRACE();
+
+		size_t numNew = seqEnd - seqStart;
+
+		this->missingPackets += numNew;
+
+		// Packets older than a received key frame are not needed anymore.
+		while (this->nackList.size() + numNew > NackGenerator::MaxNackPackets && RemoveNackItemsUntilKeyFrame())
+		{}
+
+		if (this->nackList.size() + numNew > NackGenerator::MaxNackPackets)
+		{
+			MS_DEBUG_TAG(rtcp, "NACK list full, key frame required [missing:%zu]",
+				this->nackList.size() + numNew);
+
+			this->expiredPackets += this->nackList.size() + numNew;
+			this->nackList.clear();
+			this->keyFramesRequired++;
+
+			UpdatePending();
+
+			this->listener->onNackGeneratorKeyFrameRequired(this);
+
+			return;
+		}
+
+		for (uint32_t seq32 = seqStart; seq32 != seqEnd; ++seq32)
+		{
+			this->nackList[seq32].createdAt = now;
+		}
+	}
+
+	bool NackGenerator::RemoveNackItemsUntilKeyFrame()
+	{
+		MS_TRACE();
+
+		while (!this->keyFrameList.empty())
+		{
+			auto it = this->nackList.lower_bound(*this->keyFrameList.begin());
+
+			if (it != this->nackList.begin())
+			{
+				this->expiredPackets += std::distance(this->nackList.begin(), it);
+				this->nackList.erase(this->nackList.begin(), it);
+
+				return true;
+			}
+
+			// Nothing older than this key frame, try with the next one.
+			this->keyFrameList.erase(this->keyFrameList.begin());
+		}
+
+		return false;
+	}
+
+	/**
+	 * If onlyNew is true just the packets never requested are NACKed.
+	 */
+	void NackGenerator::SendNacks(uint64_t now, bool onlyNew)
+	{
+		MS_TRACE();
+
+		std::vector<uint16_t> seqNumbers;
+		uint32_t retryInterval = std::max(GetRtt(), NackGenerator::MinRetryInterval);
+		bool keyFrameRequired = false;
+
+		for (auto it = this->nackList.begin(); it != this->nackList.end();)
+		{
+			auto& nackInfo = it->second;
+
+			if (onlyNew && nackInfo.retries != 0)
+			{
+				++it;
+
+				continue;
+			}
+
+			// Give up.
+			if (nackInfo.retries >= NackGenerator::MaxRetries || now - nackInfo.createdAt > NackGenerator::MaxAge)
+			{
+				MS_DEBUG_DEV("missing packet given up [seq:%" PRIu16 ", retries:%" PRIu8 "]",
+					static_cast<uint16_t>(it->first), nackInfo.retries);
+
+				it = this->nackList.erase(it);
+				this->expiredPackets++;
+				keyFrameRequired = true;
+
+				continue;
+			}
+
+			if (nackInfo.retries == 0 || now - nackInfo.sentAt >= retryInterval)
+			{
+				seqNumbers.push_back(static_cast<uint16_t>(it->first));
+				nackInfo.retries++;
+				nackInfo.sentAt = now;
+				this->requestedPackets++;
+			}
+
+			++it;
+		}
+
+		UpdatePending();
+
+		if (!seqNumbers.empty())
+			this->listener->onNackGeneratorNackRequired(this, seqNumbers);
+
+		if (keyFrameRequired)
+		{
+			this->keyFramesRequired++;
+			this->listener->onNackGeneratorKeyFrameRequired(this);
+		}
+	}
+
+	void NackGenerator::UpdatePending()
+	{
+		MS_TRACE();
+
+		if (this->nackList.empty())
+		{
+			NackGenerator::pendingGenerators.erase(this);
+
+			return;
+		}
+
+		NackGenerator::pendingGenerators.insert(this);
+
+		if (!NackGenerator::timerActive)
+		{
+			NackGenerator::timer->Start(NackGenerator::Interval);
+			NackGenerator::timerActive = true;
+		}
+	}
+
+	/* Instance methods of the Ticker. */
+
+	void NackGenerator::Ticker::onTimer(Timer* timer)
+	{
+		MS_TRACE();
+
+		NackGenerator::timerActive = false;
+
+		uint64_t now = DepLibUV::GetTime();
+		// Copy it since ProcessRetries() updates the set.
+		std::vector<NackGenerator*> generators(
+			NackGenerator::pendingGenerators.begin(), NackGenerator::pendingGenerators.end());
+
+		for (auto generator : generators)
+		{
+			generator->ProcessRetries(now);
+		}
+	}
+}
@@ -0,0 +1,391 @@
+#define MS_CLASS "RTC::Pacer"
+// #define MS_LOG_DEV
+#define MS_LOG_HOT_PATH
+
+#include "RTC/Pacer.hpp"
+#include "RTC/Metrics.hpp"
+#include "Logger.hpp"
+#include <uv.h>
+#include <algorithm> // std::max()
+
+namespace RTC
+{
+	/* Class variables. */
+
+	constexpr size_t Pacer::NumPriorities;
+	constexpr size_t Pacer::BufferSize;
+	constexpr size_t Pacer::MaxPoolSize;
+	constexpr size_t Pacer::MaxQueuedPackets;
+	constexpr uint64_t Pacer::Interval;
+	constexpr uint64_t Pacer::MaxBurst;
+	std::vector<uint8_t*> Pacer::bufferPool;
+	Pacer::Ticker Pacer::ticker;
+	Timer* Pacer::timer = nullptr;
+	bool Pacer::timerActive = false;
+	size_t Pacer::numPacers = 0;
+	std::unordered_set<Pacer*> Pacer::pendingPacers;
+
+	/* Class methods. */
+
+	void Pacer::ClassDestroy()
+	{
+		MS_TRACE();
+
+		for (auto buffer : Pacer::bufferPool)
+		{
+			delete[] buffer;
+		}
+
+		Pacer::bufferPool.clear();
+	}
+
+	uint8_t* Pacer::GetBuffer()
+	{
+		MS_TRACE();
+
+		if (Pacer::bufferPool.empty())
+			return new uint8_t[Pacer::BufferSize];
+
+		uint8_t* buffer = Pacer::bufferPool.back();
+
+		Pacer::bufferPool.pop_back();
+
+		return buffer;
+	}
+
+	void Pacer::ReleaseBuffer(uint8_t* buffer)
+	{
+		MS_TRACE();
+
+		if (Pacer::bufferPool.size() < Pacer::MaxPoolSize)
+			Pacer::bufferPool.push_back(buffer);
+		else
+			delete[] buffer;
+	}
+
+	inline
+	uint64_t Pacer::GetTimeUs()
+	{
+		return uv_hrtime() / 1000;
+	}
+
+	/* Instance methods. */
+
+	Pacer::Pacer(Listener* listener) :
+		listener(listener)
+	{
+		MS_TRACE();
+
+		// The timer is shared by all the pacers of the worker.
+		if (Pacer::numPacers++ == 0)
+			Pacer::timer = new Timer(&Pacer::ticker);
+	}
+
+	Pacer::~Pacer()
+	{
+		MS_TRACE();
+
+		for (auto& queue : this->queues)
+		{
+			for (auto& queuedPacket : queue)
+			{
+				Release(queuedPacket);
+			}
+
+			queue.clear();
+		}
+
+		Pacer::pendingPacers.erase(this);
+
+		if (--Pacer::numPacers == 0)
+		{
+			Pacer::timer->Destroy();
+			Pacer::timer = nullptr;
+			Pacer::timerActive = false;
+		}
+	}
+
+	Json::Value Pacer::toJson() const
+	{
+		MS_TRACE();
+
+		static const Json::StaticString k_bitrate("bitrate");
+		static const Json::StaticString k_queuedPackets("queuedPackets");
+		static const Json::StaticString k_queuedBytes("queuedBytes");
+		static const Json::StaticString k_sentPackets("sentPackets");
+		static const Json::StaticString k_droppedPackets("droppedPackets");
+		static const Json::StaticString k_queues("queues");
+		static const Json::StaticString k_audio("audio");
+		static const Json::StaticString k_retransmission("retransmission");
+		static const Json::StaticString k_video("video");
+		static const Json::StaticString k_padding("padding");
+
+		Json::Value json(Json::objectValue);
+
+		json[k_bitrate] = (Json::UInt)this->bitrate;
+		json[k_queuedPackets] = (Json::UInt)this->queuedPackets;
+		json[k_queuedBytes] = (Json::UInt)this->queuedBytes;
+		json[k_sentPackets] = (Json::UInt)this->sentPackets;
+		json[k_droppedPackets] = (Json::UInt)this->droppedPackets;
+		json[k_queues][k_audio] = (Json::UInt)this->queues[(size_t)Priority::AUDIO].size();
+		json[k_queues][k_retransmission] = (Json::UInt)this->queues[(size_t)Priority::RETRANSMISSION].size();
+		json[k_queues][k_video] = (Json::UInt)this->queues[(size_t)Priority::VIDEO].size();
+		json[k_queues][k_padding] = (Json::UInt)this->queues[(size_t)Priority::PADDING].size();
+
+		return json;
+	}
+
+	/**
+	 * 0 means no pacing at all.
+	 */
+	void Pacer::SetBitrate(uint32_t bitrate)
+	{
+		MS_TRACE();
+
+		this->bitrate = bitrate;
+
+		if (!this->bitrate)
+			Flush();
+	}
+
+	/**
+	 * The packet is cloned if it must wait so the caller can modify it once
+	 * this method returns.
+	 */
+	void Pacer::SendRtpPacket(RTC::RtpPacket* packet, uint8_t transportWideCcId, Priority priority)
+	{
+		MS_TRACE();
+
+		size_t size = packet->GetSize();
+
+		if (!this->bitrate)
+		{
+			this->sentPackets++;
+			this->listener->onPacerRtpPacket(this, packet, transportWideCcId);
+
+			return;
+		}
+
+		uint64_t nowUs = Pacer::GetTimeUs();
+
+		Refill(nowUs);
+
+		// Nothing waiting and enough budget (or too big to be queued).
+		if ((this->queuedPackets == 0 && this->budget > 0) || size > Pacer::BufferSize)
+		{
+			this->budget -= size;
+			this->sentPackets++;
+			this->listener->onPacerRtpPacket(this, packet, transportWideCcId);
+
+			return;
+		}
+
+		if (this->queuedPackets >= Pacer::MaxQueuedPackets && !MakeRoom(priority))
+		{
+			MS_DEBUG_DEV("pacer queue full, packet dropped [ssrc:%" PRIu32 ", seq:%" PRIu16 "]",
+				packet->GetSsrc(), packet->GetSequenceNumber());
+
+			this->droppedPackets++;
+
+			return;
+		}
+
+		const RTC::Codecs::PayloadDescriptor* descriptor = packet->GetPayloadDescriptor();
+		QueuedPacket queuedPacket;
+
+		queuedPacket.buffer = Pacer::GetBuffer();
+		queuedPacket.packet = packet->Clone(queuedPacket.buffer);
+		queuedPacket.transportWideCcId = transportWideCcId;
+		queuedPacket.isKeyFrame = descriptor && descriptor->isKeyFrame;
+		queuedPacket.forwardingStartTime = RTC::Metrics::GetForwardingStartTime();
+
+		this->queues[(size_t)priority].push_back(queuedPacket);
+		this->queuedPackets++;
+		this->queuedBytes += size;
+
+		Process(nowUs);
+	}
+
+	/**
+	 * Sends all the queued packets regardless the budget.
+	 */
+	void Pacer::Flush()
+	{
+		MS_TRACE();
+
+		for (auto& queue : this->queues)
+		{
+			for (auto& queuedPacket : queue)
+			{
+				Send(queuedPacket);
+				Release(queuedPacket);
+			}
+
+			queue.clear();
+		}
+
+		Pacer::pendingPacers.erase(this);
+	}
+
+	void Pacer::Process(uint64_t nowUs)
+	{
+		MS_TRACE();
+
+		Refill(nowUs);
+
+		while (this->queuedPackets > 0 && this->budget > 0)
+		{
+			for (auto& queue : this->queues)
+			{
+				if (queue.empty())
+					continue;
+
+				Send(queue.front());
+				Release(queue.front());
+				queue.pop_front();
+
+				break;
+			}
+		}
+
+		if (this->queuedPackets == 0)
+		{
+			Pacer::pendingPacers.erase(this);
+
+			return;
+		}
+
+		Pacer::pendingPacers.insert(this);
+
+		if (!Pacer::timerActive)
+		{
+			Pacer::timer->Start(Pacer::Interval);
+			Pacer::timerActive = true;
+		}
+	}
+
+	void Pacer::Refill(uint64_t nowUs)
+	{
+		MS_TRACE();
+
+		double maxBudget = std::max(
+			static_cast<double>(this->bitrate) / 8 * Pacer::MaxBurst / 1000,
+			static_cast<double>(Pacer::BufferSize));
+
+		// Start with a full bucket.
+		if (!this->lastRefillTimeUs)
+		{
+			this->budget = maxBudget;
+			this->lastRefillTimeUs = nowUs;
+
+			return;
+		}
+
+		this->budget += static_cast<double>(this->bitrate) / 8 * (nowUs - this->lastRefillTimeUs) / 1000000;
+		this->lastRefillTimeUs = nowUs;
+
+		if (this->budget > maxBudget)
+			this->budget = maxBudget;
+	}
+
+	/**
+	 * Drops a queued packet to make room for a new one with the given priority.
+	 * Returns false if the new packet must be dropped instead.
+	 */
+	bool Pacer::MakeRoom(Priority priority)
+	{
+		MS_TRACE();
+
+		auto& padding = this->queues[(size_t)Priority::PADDING];
+		auto& video = this->queues[(size_t)Priority::VIDEO];
+		auto& retransmission = this->queues[(size_t)Priority::RETRANSMISSION];
+
+		if (!padding.empty())
+		{
+			Release(padding.front());
+			padding.pop_front();
+			this->droppedPackets++;
+
+			return true;
+		}
+
+		// The oldest non key frame video packet.
+		for (auto it = video.begin(); it != video.end(); ++it)
+		{
+			if (it->isKeyFrame)
+				continue;
+
+			MS_DEBUG_DEV("pacer queue full, queued packet dropped [ssrc:%" PRIu32 ", seq:%" PRIu16 "]",
+				it->packet->GetSsrc(), it->packet->GetSequenceNumber());
+
+			Release(*it);
+			video.erase(it);
+			this->droppedPackets++;
+
+			return true;
+		}
+
+		// Audio goes first anyway.
+		if (priority == Priority::AUDIO)
+		{
+			auto& queue = !video.empty() ? video : retransmission;
+
+			if (!queue.empty())
+			{
+				Release(queue.front());
+				queue.pop_front();
+				this->droppedPackets++;
+
+				return true;
+			}
+		}
+
+		return false;
+	}
+
+	inline
+	void Pacer::Send(QueuedPacket& queuedPacket)
+	{
+		MS_TRACE();
+
+		uint64_t forwardingStartTime = RTC::Metrics::GetForwardingStartTime();
+
+		this->budget -= queuedPacket.packet->GetSize();
+		this->sentPackets++;
+
+		// Account the time in the queue in the forwarding latency.
+		RTC::Metrics::SetForwardingStartTime(queuedPacket.forwardingStartTime);
+		this->listener->onPacerRtpPacket(this, queuedPacket.packet, queuedPacket.transportWideCcId);
+		RTC::Metrics::SetForwardingStartTime(forwardingStartTime);
+	}
+
+	inline
+	void Pacer::Release(QueuedPacket& queuedPacket)
+	{
+		MS_TRACE();
+
+		this->queuedPackets--;
+		this->queuedBytes -= queuedPacket.packet->GetSize();
+
+		delete queuedPacket.packet;
+		Pacer::ReleaseBuffer(queuedPacket.buffer);
+	}
+
+	/* Instance methods of the Ticker. */
+
+	void Pacer::Ticker::onTimer(Timer* timer)
+	{
+		MS_TRACE();
+
+		Pacer::timerActive = false;
+
+		uint64_t nowUs = Pacer::GetTimeUs();
+		// Copy it since Process() updates the set.
+		std::vector<Pacer*> pacers(Pacer::pendingPacers.begin(), Pacer::pendingPacers.end());
+
+		for (auto pacer : pacers)
+		{
+			pacer->Process(nowUs);
+		}
+	}
+}
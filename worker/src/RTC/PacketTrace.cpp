@@ -0,0 +1,252 @@
+#define MS_CLASS "RTC::PacketTrace"
+// #define MS_LOG_DEV
+
+#include "RTC/PacketTrace.hpp"
+#include "handles/FileWriter.hpp"
+#include "Utils.hpp"
+#include "Logger.hpp"
+#include <sys/time.h> // gettimeofday()
+
+// Fake IPv4 addresses and UDP ports of the pcap packets.
+#define PCAP_LOCAL_ADDRESS  0x0A000001
+#define PCAP_REMOTE_ADDRESS 0x0A000002
+#define PCAP_LOCAL_PORT     40000
+#define PCAP_REMOTE_PORT    40002
+
+/* Static helpers. */
+
+static inline
+void append(std::vector<uint8_t>& out, const void* data, size_t len)
+{
+	out.insert(out.end(), static_cast<const uint8_t*>(data), static_cast<const uint8_t*>(data) + len);
+}
+
+namespace RTC
+{
+	/* Class variables. */
+
+	constexpr size_t PacketTrace::Size;
+	constexpr size_t PacketTrace::MaxHeaderLength;
+
+	/* Class methods. */
+
+	bool PacketTrace::GetFormat(const std::string& name, Format& format)
+	{
+		MS_TRACE();
+
+		if (name == "json")
+			format = Format::JSON;
+		else if (name == "pcap")
+			format = Format::PCAP;
+		else
+			return false;
+
+		return true;
+	}
+
+	/* Instance methods. */
+
+	Json::Value PacketTrace::toJson() const
+	{
+		MS_TRACE();
+
+		static const Json::StaticString k_size("size");
+		static const Json::StaticString k_numRecords("numRecords");
+
+		Json::Value json(Json::objectValue);
+
+		json[k_size] = (Json::UInt)PacketTrace::Size;
+		json[k_numRecords] = (Json::UInt64)this->numRecords;
+
+		return json;
+	}
+
+	/**
+	 * Writes the records into the given file (the file is opened synchronously
+	 * so the caller gets the error, and written asynchronously). Returns the
+	 * number of records.
+	 */
+	size_t PacketTrace::Dump(const std::string& path, Format format) const
+	{
+		MS_TRACE();
+
+		struct timeval tv;
+
+		gettimeofday(&tv, nullptr);
+
+		// Offset from the monotonic time of the records to the wall clock one.
+		uint64_t timeOffset = static_cast<uint64_t>(tv.tv_sec) * 1000000 + tv.tv_usec - uv_hrtime() / 1000;
+		// It deletes itself once written.
+		FileWriter* fileWriter = new FileWriter(nullptr, path);
+		std::vector<uint8_t> data;
+
+		switch (format)
+		{
+			case Format::JSON:
+			{
+				Json::StreamWriterBuilder builder;
+
+				builder["indentation"] = "";
+				std::string json = Json::writeString(builder, GetRecordsJson(timeOffset));
+
+				data.assign(json.begin(), json.end());
+
+				break;
+			}
+
+			case Format::PCAP:
+			{
+				WritePcap(data, timeOffset);
+
+				break;
+			}
+		}
+
+		fileWriter->Write(std::move(data), 0);
+		fileWriter->Close();
+
+		return this->numRecords < PacketTrace::Size ? this->numRecords : PacketTrace::Size;
+	}
+
+	Json::Value PacketTrace::GetRecordsJson(uint64_t timeOffset) const
+	{
+		MS_TRACE();
+
+		static const Json::StaticString k_records("records");
+		static const Json::StaticString k_time("time");
+		static const Json::StaticString k_direction("direction");
+		static const Json::StaticString k_type("type");
+		static const Json::StaticString k_size("size");
+		static const Json::StaticString k_ssrc("ssrc");
+		static const Json::StaticString k_payloadType("payloadType");
+		static const Json::StaticString k_marker("marker");
+		static const Json::StaticString k_sequenceNumber("sequenceNumber");
+		static const Json::StaticString k_timestamp("timestamp");
+		static const Json::StaticString k_rtcpType("rtcpType");
+		static const Json::StaticString k_count("count");
+		static const Json::StaticString v_in("in");
+		static const Json::StaticString v_out("out");
+		static const Json::StaticString v_rtp("rtp");
+		static const Json::StaticString v_rtcp("rtcp");
+
+		Json::Value json(Json::objectValue);
+		Json::Value json_records(Json::arrayValue);
+		size_t count = this->numRecords < PacketTrace::Size ? this->numRecords : PacketTrace::Size;
+
+		for (size_t i = 0; i < count; ++i)
+		{
+			const Record& record = this->records[(this->head + PacketTrace::Size - count + i) % PacketTrace::Size];
+			const uint8_t* header = record.header;
+			Json::Value json_record(Json::objectValue);
+
+			json_record[k_time] = (Json::UInt64)(record.time + timeOffset);
+			json_record[k_direction] = record.direction == Direction::IN ? v_in : v_out;
+			json_record[k_size] = (Json::UInt)record.size;
+
+			if (record.type == Type::RTP)
+			{
+				json_record[k_type] = v_rtp;
+
+				if (record.headerLength == 12)
+				{
+					json_record[k_payloadType] = (Json::UInt)(header[1] & 0x7F);
+					json_record[k_marker] = (header[1] & 0x80) ? true : false;
+					json_record[k_sequenceNumber] = (Json::UInt)Utils::Byte::Get2Bytes(header, 2);
+					json_record[k_timestamp] = (Json::UInt)Utils::Byte::Get4Bytes(header, 4);
+					json_record[k_ssrc] = (Json::UInt)Utils::Byte::Get4Bytes(header, 8);
+				}
+			}
+			else
+			{
+				json_record[k_type] = v_rtcp;
+
+				if (record.headerLength == 8)
+				{
+					json_record[k_rtcpType] = (Json::UInt)header[1];
+					json_record[k_count] = (Json::UInt)(header[0] & 0x1F);
+					json_record[k_ssrc] = (Json::UInt)Utils::Byte::Get4Bytes(header, 4);
+				}
+			}
+
+			json_records.append(json_record);
+		}
+		json[k_records] = json_records;
+
+		return json;
+	}
+
+	void PacketTrace::WritePcap(std::vector<uint8_t>& out, uint64_t timeOffset) const
+	{
+		MS_TRACE();
+
+		size_t count = this->numRecords < PacketTrace::Size ? this->numRecords : PacketTrace::Size;
+
+		out.reserve(24 + count * (16 + 28 + PacketTrace::MaxHeaderLength));
+
+		// Global header (host byte order, us resolution, LINKTYPE_RAW).
+		uint32_t magic = 0xA1B2C3D4;
+		uint16_t versionMajor = 2;
+		uint16_t versionMinor = 4;
+		uint32_t zero = 0;
+		uint32_t snapLength = 65535;
+		uint32_t linkType = 101;
+
+		append(out, &magic, 4);
+		append(out, &versionMajor, 2);
+		append(out, &versionMinor, 2);
+		append(out, &zero, 4);
+		append(out, &zero, 4);
+		append(out, &snapLength, 4);
+		append(out, &linkType, 4);
+
+		for (size_t i = 0; i < count; ++i)
+		{
+			const Record& record = this->records[(this->head + PacketTrace::Size - count + i) % PacketTrace::Size];
+			uint64_t time = record.time + timeOffset;
+			uint32_t seconds = time / 1000000;
+			uint32_t microseconds = time % 1000000;
+			uint32_t includedLength = 28 + record.headerLength;
+			uint32_t originalLength = 28 + record.size;
+			bool in = record.direction == Direction::IN;
+			uint8_t ip[28];
+
+			append(out, &seconds, 4);
+			append(out, &microseconds, 4);
+			append(out, &includedLength, 4);
+			append(out, &originalLength, 4);
+
+			// IPv4 header (don't fragment, TTL 64, UDP).
+			ip[0] = 0x45;
+			ip[1] = 0;
+			Utils::Byte::Set2Bytes(ip, 2, originalLength > 0xFFFF ? 0xFFFF : originalLength);
+			Utils::Byte::Set2Bytes(ip, 4, 0);
+			Utils::Byte::Set2Bytes(ip, 6, 0x4000);
+			ip[8] = 64;
+			ip[9] = 17;
+			Utils::Byte::Set2Bytes(ip, 10, 0);
+			Utils::Byte::Set4Bytes(ip, 12, in ? PCAP_REMOTE_ADDRESS : PCAP_LOCAL_ADDRESS);
+			Utils::Byte::Set4Bytes(ip, 16, in ? PCAP_LOCAL_ADDRESS : PCAP_REMOTE_ADDRESS);
+
+			uint32_t checksum = 0;
+
+			for (size_t j = 0; j < 20; j += 2)
+			{
+				checksum += Utils::Byte::Get2Bytes(ip, j);
+			}
+			while (checksum >> 16)
+			{
+				checksum = (checksum & 0xFFFF) + (checksum >> 16);
+			}
+			Utils::Byte::Set2Bytes(ip, 10, ~checksum & 0xFFFF);
+
+			// UDP header (no checksum).
+			Utils::Byte::Set2Bytes(ip, 20, in ? PCAP_REMOTE_PORT : PCAP_LOCAL_PORT);
+			Utils::Byte::Set2Bytes(ip, 22, in ? PCAP_LOCAL_PORT : PCAP_REMOTE_PORT);
+			Utils::Byte::Set2Bytes(ip, 24, static_cast<uint16_t>(8 + record.size));
+			Utils::Byte::Set2Bytes(ip, 26, 0);
+
+			append(out, ip, sizeof(ip));
+			append(out, record.header, record.headerLength);
+		}
+	}
+}
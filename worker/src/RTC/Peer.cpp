@@ -2,6 +2,7 @@
 // #define MS_LOG_DEV
 
 #include "RTC/Peer.hpp"
+#include "RTC/Metrics.hpp"
 #include "RTC/RtpDictionaries.hpp"
 #include "RTC/RTCP/CompoundPacket.hpp"
 #include "RTC/RTCP/FeedbackRtpNack.hpp"
@@ -31,12 +32,16 @@ namespace RTC
 
 		// Start the RTCP timer.
 		this->timer->Start(uint64_t(RTC::RTCP::MAX_VIDEO_INTERVAL_MS / 2));
+
+		RTC::Metrics::numPeers++;
 	}
 
 	Peer::~Peer()
 	{
 		MS_TRACE();
 
+		RTC::Metrics::numPeers--;
+
 		// Destroy the RTCP timer.
 		this->timer->Destroy();
 	}
@@ -333,6 +338,8 @@ namespace RTC
 			case Channel::Request::MethodId::transport_close:
 			case Channel::Request::MethodId::transport_dump:
 			case Channel::Request::MethodId::transport_setRemoteDtlsParameters:
+			case Channel::Request::MethodId::transport_setPacer:
+			case Channel::Request::MethodId::transport_dumpPacketTrace:
 			{
 				RTC::Transport* transport;
 
@@ -362,6 +369,8 @@ namespace RTC
 			case Channel::Request::MethodId::rtpReceiver_receive:
 			case Channel::Request::MethodId::rtpReceiver_setRtpRawEvent:
 			case Channel::Request::MethodId::rtpReceiver_setRtpObjectEvent:
+			case Channel::Request::MethodId::rtpReceiver_setRtpRawRing:
+			case Channel::Request::MethodId::rtpReceiver_setRecording:
 			{
 				RTC::RtpReceiver* rtpReceiver;
 
@@ -457,6 +466,8 @@ namespace RTC
 			}
 
 			case Channel::Request::MethodId::rtpSender_disable:
+			case Channel::Request::MethodId::rtpSender_setTargetEncoding:
+			case Channel::Request::MethodId::rtpSender_setTargetLayers:
 			{
 				RTC::RtpSender* rtpSender;
 
@@ -694,6 +705,39 @@ namespace RTC
 		}
 	}
 
+	void Peer::ReceiveRemb(RTC::RTCP::FeedbackPsRembPacket* remb)
+	{
+		MS_TRACE();
+
+		std::vector<RTC::RtpSender*> rtpSenders;
+
+		for (auto ssrc : remb->GetSsrcs())
+		{
+			RTC::RtpSender* rtpSender = GetRtpSender(ssrc);
+
+			if (rtpSender)
+				rtpSenders.push_back(rtpSender);
+		}
+
+		if (rtpSenders.empty())
+		{
+			MS_DEBUG_TAG(rbe, "no RtpSender found while processing a REMB packet");
+
+			return;
+		}
+
+		// The bitrate is announced for all the given streams, so split it.
+		uint64_t bitrate = remb->GetBitrate() / rtpSenders.size();
+
+		if (bitrate > UINT32_MAX)
+			bitrate = UINT32_MAX;
+
+		for (auto rtpSender : rtpSenders)
+		{
+			this->listener->onPeerRtpSenderRemb(this, rtpSender, static_cast<uint32_t>(bitrate));
+		}
+	}
+
 	void Peer::onTransportClosed(RTC::Transport* transport)
 	{
 		MS_TRACE();
@@ -796,7 +840,14 @@ namespace RTC
 							RTCP::FeedbackPsAfbPacket* afb = static_cast<RTCP::FeedbackPsAfbPacket*>(feedback);
 							if (afb->GetApplication() == RTCP::FeedbackPsAfbPacket::REMB)
 							{
-								// afb->Dump();
+								RTCP::FeedbackPsRembPacket* remb = static_cast<RTCP::FeedbackPsRembPacket*>(afb);
+
+								if (remb->IsCorrect())
+								{
+									transport->ReceiveRemb(remb);
+									ReceiveRemb(remb);
+								}
+
 								break;
 							}
 						}
@@ -865,6 +916,15 @@ namespace RTC
 							break;
 						}
 
+						case RTCP::FeedbackRtp::MessageType::TCC:
+						{
+							RTC::RTCP::FeedbackRtpTransportPacket* tccPacket = static_cast<RTC::RTCP::FeedbackRtpTransportPacket*>(packet);
+
+							transport->ReceiveTransportFeedback(tccPacket);
+
+							break;
+						}
+
 						case RTCP::FeedbackRtp::MessageType::TMMBR:
 						case RTCP::FeedbackRtp::MessageType::TMMBN:
 						case RTCP::FeedbackRtp::MessageType::SR_REQ:
@@ -982,6 +1042,13 @@ namespace RTC
 		this->listener->onPeerRtpSenderClosed(this, rtpSender);
 	}
 
+	void Peer::onRtpSenderKeyFrameRequired(RTC::RtpSender* rtpSender, size_t encodingIndex)
+	{
+		MS_TRACE();
+
+		this->listener->onPeerRtpSenderKeyFrameRequired(this, rtpSender, encodingIndex);
+	}
+
 	void Peer::onTimer(Timer* timer)
 	{
 		uint64_t interval = RTC::RTCP::MAX_VIDEO_INTERVAL_MS;
@@ -8,6 +8,7 @@
 #include "RTC/RTCP/FeedbackRtpSrReq.hpp"
 #include "RTC/RTCP/FeedbackRtpTllei.hpp"
 #include "RTC/RTCP/FeedbackRtpEcn.hpp"
+#include "RTC/RTCP/FeedbackRtpTransport.hpp"
 // Feedback PS.
 #include "RTC/RTCP/FeedbackPsPli.hpp"
 #include "RTC/RTCP/FeedbackPsSli.hpp"
@@ -194,6 +195,7 @@ namespace RTC { namespace RTCP
 		{ FeedbackRtp::MessageType::TLLEI,  "TLLEI"  },
 		{ FeedbackRtp::MessageType::ECN,    "ECN"    },
 		{ FeedbackRtp::MessageType::PS,     "PS"     },
+		{ FeedbackRtp::MessageType::TCC,    "TCC"    },
 		{ FeedbackRtp::MessageType::EXT,    "EXT"    }
 	};
 
@@ -246,6 +248,10 @@ namespace RTC { namespace RTCP
 			case FeedbackRtp::MessageType::PS:
 				break;
 
+			case FeedbackRtp::MessageType::TCC:
+				packet = FeedbackRtpTransportPacket::Parse(data, len);
+				break;
+
 			case FeedbackRtp::MessageType::EXT:
 				break;
 
@@ -0,0 +1,337 @@
+#define MS_CLASS "RTC::RTCP::FeedbackRtpTransportPacket"
+// #define MS_LOG_DEV
+
+#include "RTC/RTCP/FeedbackRtpTransport.hpp"
+#include "Utils.hpp"
+#include "Logger.hpp"
+#include <cstring>
+
+namespace RTC { namespace RTCP
+{
+	/* Class methods. */
+
+	FeedbackRtpTransportPacket* FeedbackRtpTransportPacket::Parse(const uint8_t* data, size_t len)
+	{
+		MS_TRACE();
+
+		if (sizeof(CommonHeader) + sizeof(FeedbackPacket::Header) > len)
+		{
+			MS_WARN_TAG(rtcp, "not enough space for Feedback packet, discarded");
+
+			return nullptr;
+		}
+
+		CommonHeader* commonHeader = const_cast<CommonHeader*>(reinterpret_cast<const CommonHeader*>(data));
+
+		if ((size_t)(ntohs(commonHeader->length) + 1) * 4 > len)
+		{
+			MS_WARN_TAG(rtcp, "not enough space for transport-cc Feedback packet, discarded");
+
+			return nullptr;
+		}
+
+		std::unique_ptr<FeedbackRtpTransportPacket> packet(new FeedbackRtpTransportPacket(commonHeader));
+
+		if (!packet->IsCorrect())
+			return nullptr;
+
+		return packet.release();
+	}
+
+	/* Instance methods. */
+
+	FeedbackRtpTransportPacket::FeedbackRtpTransportPacket(CommonHeader* commonHeader):
+		FeedbackRtpPacket(commonHeader)
+	{
+		MS_TRACE();
+
+		this->size = ((ntohs(commonHeader->length) + 1) * 4) - (sizeof(CommonHeader) + sizeof(FeedbackPacket::Header));
+		this->data = (uint8_t*)commonHeader + sizeof(CommonHeader) + sizeof(FeedbackPacket::Header);
+
+		if (this->size < 8)
+		{
+			MS_WARN_TAG(rtcp, "transport-cc Feedback packet too short");
+
+			this->isCorrect = false;
+			return;
+		}
+
+		this->baseSequenceNumber = Utils::Byte::Get2Bytes(this->data, 0);
+		this->packetStatusCount = Utils::Byte::Get2Bytes(this->data, 2);
+		this->referenceTime = static_cast<int32_t>(Utils::Byte::Get3Bytes(this->data, 4));
+		this->feedbackPacketCount = Utils::Byte::Get1Byte(this->data, 7);
+
+		// Reference time is a signed 24 bits value.
+		if (this->referenceTime & 0x800000)
+			this->referenceTime -= 0x1000000;
+
+		std::vector<uint8_t> statuses;
+		size_t offset = 8;
+
+		statuses.reserve(this->packetStatusCount);
+
+		// Packet chunks.
+		while (statuses.size() < this->packetStatusCount)
+		{
+			if (offset + 2 > this->size)
+			{
+				MS_WARN_TAG(rtcp, "not enough space for transport-cc packet chunks");
+
+				this->isCorrect = false;
+				return;
+			}
+
+			uint16_t chunk = Utils::Byte::Get2Bytes(this->data, offset);
+			size_t remaining = this->packetStatusCount - statuses.size();
+
+			offset += 2;
+
+			// Run length chunk.
+			if (!(chunk & 0x8000))
+			{
+				uint8_t status = (chunk >> 13) & 0x03;
+				size_t runLength = chunk & 0x1FFF;
+
+				for (size_t i = 0; i < runLength && i < remaining; ++i)
+				{
+					statuses.push_back(status);
+				}
+			}
+			// Status vector chunk with 14 one bit symbols.
+			else if (!(chunk & 0x4000))
+			{
+				for (size_t i = 0; i < 14 && i < remaining; ++i)
+				{
+					statuses.push_back((chunk >> (13 - i)) & 0x01);
+				}
+			}
+			// Status vector chunk with 7 two bits symbols.
+			else
+			{
+				for (size_t i = 0; i < 7 && i < remaining; ++i)
+				{
+					statuses.push_back((chunk >> (2 * (6 - i))) & 0x03);
+				}
+			}
+		}
+
+		// Receive deltas (in multiples of 250us) relative to the previous received
+		// packet (or to the reference time for the first one).
+		int64_t receivedAtUs = static_cast<int64_t>(this->referenceTime) * 64000;
+		uint16_t seq = this->baseSequenceNumber;
+
+		this->packetResults.reserve(statuses.size());
+
+		for (auto status : statuses)
+		{
+			PacketResult result;
+
+			result.sequenceNumber = seq++;
+
+			switch (status)
+			{
+				case Status::NOT_RECEIVED:
+				{
+					break;
+				}
+
+				case Status::SMALL_DELTA:
+				{
+					if (offset + 1 > this->size)
+					{
+						MS_WARN_TAG(rtcp, "not enough space for transport-cc receive deltas");
+
+						this->isCorrect = false;
+						return;
+					}
+
+					receivedAtUs += 250 * static_cast<int64_t>(Utils::Byte::Get1Byte(this->data, offset));
+					offset += 1;
+					result.received = true;
+					result.receivedAtMs = receivedAtUs / 1000;
+
+					break;
+				}
+
+				case Status::LARGE_DELTA:
+				{
+					if (offset + 2 > this->size)
+					{
+						MS_WARN_TAG(rtcp, "not enough space for transport-cc receive deltas");
+
+						this->isCorrect = false;
+						return;
+					}
+
+					receivedAtUs += 250 * static_cast<int64_t>(static_cast<int16_t>(Utils::Byte::Get2Bytes(this->data, offset)));
+					offset += 2;
+					result.received = true;
+					result.receivedAtMs = receivedAtUs / 1000;
+
+					break;
+				}
+
+				default:
+				{
+					MS_WARN_TAG(rtcp, "invalid transport-cc packet status symbol");
+
+					this->isCorrect = false;
+					return;
+				}
+			}
+
+			this->packetResults.push_back(result);
+		}
+	}
+
+	FeedbackRtpTransportPacket::FeedbackRtpTransportPacket(uint32_t senderSsrc, uint32_t mediaSsrc, uint8_t feedbackPacketCount, const std::vector<PacketResult>& packetResults):
+		FeedbackRtpPacket(RTCP::FeedbackRtp::MessageType::TCC, senderSsrc, mediaSsrc),
+		feedbackPacketCount(feedbackPacketCount),
+		packetResults(packetResults)
+	{
+		MS_TRACE();
+
+		MS_ASSERT(!packetResults.empty(), "no packet results given");
+
+		this->baseSequenceNumber = packetResults.front().sequenceNumber;
+		this->packetStatusCount = static_cast<uint16_t>(packetResults.size());
+
+		// Reference time (multiple of 64ms) taken from the first received packet.
+		// Just its lower bits are sent since the remote uses the deltas.
+		int64_t receivedAtMs = 0;
+
+		for (auto& result : packetResults)
+		{
+			if (result.received)
+			{
+				receivedAtMs = (result.receivedAtMs / 64) * 64;
+				this->referenceTime = static_cast<int32_t>((result.receivedAtMs / 64) & 0x7FFFFF);
+
+				break;
+			}
+		}
+
+		// Statuses and receive deltas (in multiples of 250us). A delta that does
+		// not fit in 16 bits is reported as not received.
+		std::vector<uint8_t> statuses;
+		std::vector<int16_t> deltas;
+
+		statuses.reserve(packetResults.size());
+		deltas.reserve(packetResults.size());
+
+		for (auto& result : packetResults)
+		{
+			int64_t delta = (result.receivedAtMs - receivedAtMs) * 4;
+
+			if (!result.received || delta < INT16_MIN || delta > INT16_MAX)
+			{
+				statuses.push_back(Status::NOT_RECEIVED);
+
+				continue;
+			}
+
+			statuses.push_back(delta >= 0 && delta <= 0xFF ? Status::SMALL_DELTA : Status::LARGE_DELTA);
+			deltas.push_back(static_cast<int16_t>(delta));
+			receivedAtMs = result.receivedAtMs;
+		}
+
+		this->buffer.resize(8);
+
+		Utils::Byte::Set2Bytes(this->buffer.data(), 0, this->baseSequenceNumber);
+		Utils::Byte::Set2Bytes(this->buffer.data(), 2, this->packetStatusCount);
+		Utils::Byte::Set3Bytes(this->buffer.data(), 4, static_cast<uint32_t>(this->referenceTime));
+		Utils::Byte::Set1Byte(this->buffer.data(), 7, this->feedbackPacketCount);
+
+		// Packet chunks. Runs of the same status take a run length chunk, the
+		// rest go in status vector chunks with 7 two bits symbols.
+		size_t idx = 0;
+
+		while (idx < statuses.size())
+		{
+			size_t runLength = 1;
+			uint16_t chunk;
+
+			while (idx + runLength < statuses.size() && statuses[idx + runLength] == statuses[idx] && runLength < 0x1FFF)
+			{
+				++runLength;
+			}
+
+			if (runLength >= 7)
+			{
+				chunk = static_cast<uint16_t>((statuses[idx] << 13) | runLength);
+				idx += runLength;
+			}
+			else
+			{
+				chunk = 0xC000;
+
+				for (size_t i = 0; i < 7 && idx < statuses.size(); ++i, ++idx)
+				{
+					chunk |= statuses[idx] << (2 * (6 - i));
+				}
+			}
+
+			this->buffer.push_back(static_cast<uint8_t>(chunk >> 8));
+			this->buffer.push_back(static_cast<uint8_t>(chunk));
+		}
+
+		// Receive deltas.
+		size_t deltaIdx = 0;
+
+		for (auto status : statuses)
+		{
+			if (status == Status::SMALL_DELTA)
+			{
+				this->buffer.push_back(static_cast<uint8_t>(deltas[deltaIdx++]));
+			}
+			else if (status == Status::LARGE_DELTA)
+			{
+				uint16_t delta = static_cast<uint16_t>(deltas[deltaIdx++]);
+
+				this->buffer.push_back(static_cast<uint8_t>(delta >> 8));
+				this->buffer.push_back(static_cast<uint8_t>(delta));
+			}
+		}
+
+		// Zero padding up to a multiple of 4 bytes.
+		while (this->buffer.size() % 4)
+		{
+			this->buffer.push_back(0);
+		}
+
+		this->data = this->buffer.data();
+		this->size = this->buffer.size();
+	}
+
+	size_t FeedbackRtpTransportPacket::Serialize(uint8_t* buffer)
+	{
+		MS_TRACE();
+
+		size_t offset = FeedbackRtpPacket::Serialize(buffer);
+
+		// Copy the content.
+		std::memcpy(buffer+offset, this->data, this->size);
+
+		return offset + this->size;
+	}
+
+	void FeedbackRtpTransportPacket::Dump() const
+	{
+		MS_TRACE();
+
+		MS_DUMP("<FeedbackRtpTransportPacket>");
+		FeedbackRtpPacket::Dump();
+		MS_DUMP("  base sequence number  : %" PRIu16, this->baseSequenceNumber);
+		MS_DUMP("  packet status count   : %" PRIu16, this->packetStatusCount);
+		MS_DUMP("  reference time        : %" PRIi32, this->referenceTime);
+		MS_DUMP("  feedback packet count : %" PRIu8, this->feedbackPacketCount);
+		for (auto& result : this->packetResults)
+		{
+			if (result.received)
+				MS_DUMP("  seq:%" PRIu16 ", received at:%" PRIi64 "ms", result.sequenceNumber, result.receivedAtMs);
+			else
+				MS_DUMP("  seq:%" PRIu16 ", not received", result.sequenceNumber);
+		}
+		MS_DUMP("</FeedbackRtpTransportPacket>");
+	}
+}}
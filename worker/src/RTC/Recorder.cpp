@@ -0,0 +1,846 @@
+#define MS_CLASS "RTC::Recorder"
+// #define MS_LOG_DEV
+#define MS_LOG_HOT_PATH
+
+#include "RTC/Recorder.hpp"
+#include "DepLibUV.hpp"
+#include "Utils.hpp"
+#include "MediaSoupError.hpp"
+#include "Logger.hpp"
+#include <cstring> // std::memcpy()
+#include <sys/time.h> // gettimeofday()
+
+/* Static helpers (little endian, as used by IVF and Ogg). */
+
+static inline
+void setLE16(uint8_t* data, uint16_t value)
+{
+	data[0] = value & 0xFF;
+	data[1] = value >> 8;
+}
+
+static inline
+void setLE32(uint8_t* data, uint32_t value)
+{
+	for (size_t i = 0; i < 4; ++i)
+	{
+		data[i] = (value >> (i * 8)) & 0xFF;
+	}
+}
+
+static inline
+void setLE64(uint8_t* data, uint64_t value)
+{
+	for (size_t i = 0; i < 8; ++i)
+	{
+		data[i] = (value >> (i * 8)) & 0xFF;
+	}
+}
+
+/**
+ * Number of 48 kHz samples of an Opus packet (RFC 6716, section 3.1).
+ */
+static size_t getOpusSamples(const uint8_t* data, size_t len)
+{
+	static const size_t frameSamples[32] =
+	{
+		// SILK (10, 20, 40 and 60 ms).
+		480, 960, 1920, 2880, 480, 960, 1920, 2880, 480, 960, 1920, 2880,
+		// Hybrid (10 and 20 ms).
+		480, 960, 480, 960,
+		// CELT (2.5, 5, 10 and 20 ms).
+		120, 240, 480, 960, 120, 240, 480, 960, 120, 240, 480, 960, 120, 240, 480, 960
+	};
+
+	size_t numFrames;
+
+	switch (data[0] & 0x03)
+	{
+		case 0:
+			numFrames = 1;
+			break;
+		case 1:
+		case 2:
+			numFrames = 2;
+			break;
+		default:
+			numFrames = len > 1 ? data[1] & 0x3F : 0;
+	}
+
+	return numFrames * frameSamples[data[0] >> 3];
+}
+
+namespace RTC
+{
+	/* Class variables. */
+
+	constexpr size_t Recorder::BufferSize;
+	constexpr size_t Recorder::MaxQueuedBuffers;
+	constexpr uint64_t Recorder::FlushInterval;
+
+	std::map<std::string, Recorder::Format> Recorder::string2Format =
+	{
+		{ "rtpdump", Recorder::Format::RTPDUMP },
+		{ "ivf",     Recorder::Format::IVF     },
+		{ "ogg",     Recorder::Format::OGG     },
+		{ "h264",    Recorder::Format::H264    }
+	};
+
+	std::map<Recorder::Format, std::string> Recorder::format2String =
+	{
+		{ Recorder::Format::RTPDUMP, "rtpdump" },
+		{ Recorder::Format::IVF,     "ivf"     },
+		{ Recorder::Format::OGG,     "ogg"     },
+		{ Recorder::Format::H264,    "h264"    }
+	};
+
+	uint32_t Recorder::oggCrcTable[256];
+
+	/* Class methods. */
+
+	bool Recorder::GetFormat(const std::string& name, Format& format)
+	{
+		MS_TRACE();
+
+		auto it = Recorder::string2Format.find(name);
+
+		if (it == Recorder::string2Format.end())
+			return false;
+
+		format = it->second;
+
+		return true;
+	}
+
+	Recorder::Format Recorder::GetDefaultFormat(const RTC::RtpCodecMime& mime)
+	{
+		MS_TRACE();
+
+		switch (mime.subtype)
+		{
+			case RTC::RtpCodecMime::Subtype::VP8:
+			case RTC::RtpCodecMime::Subtype::VP9:
+				return Format::IVF;
+			case RTC::RtpCodecMime::Subtype::OPUS:
+				return Format::OGG;
+			case RTC::RtpCodecMime::Subtype::H264:
+				return Format::H264;
+			default:
+				return Format::RTPDUMP;
+		}
+	}
+
+	bool Recorder::IsSupported(Format format, const RTC::RtpCodecMime& mime)
+	{
+		MS_TRACE();
+
+		switch (format)
+		{
+			case Format::RTPDUMP:
+				return true;
+			case Format::IVF:
+				return mime.subtype == RTC::RtpCodecMime::Subtype::VP8 ||
+					mime.subtype == RTC::RtpCodecMime::Subtype::VP9;
+			case Format::OGG:
+				return mime.subtype == RTC::RtpCodecMime::Subtype::OPUS;
+			case Format::H264:
+				return mime.subtype == RTC::RtpCodecMime::Subtype::H264;
+		}
+
+		return false;
+	}
+
+	const std::string& Recorder::GetFormatString(Format format)
+	{
+		MS_TRACE();
+
+		return Recorder::format2String.at(format);
+	}
+
+	/* Instance methods. */
+
+	/**
+	 * NOTE: The file is opened synchronously so the request gets the error (if
+	 * any). Writes and close are asynchronous.
+	 */
+	Recorder::Recorder(Listener* listener, const std::string& path, Format format, const RTC::RtpCodecParameters& codec) :
+		listener(listener),
+		path(path),
+		format(format),
+		codec(codec)
+	{
+		MS_TRACE();
+
+		this->fileWriter = new FileWriter(this, path);
+		this->buffer.reserve(Recorder::BufferSize);
+		this->startTime = DepLibUV::GetTime();
+
+		// Ogg CRC (polynomial 0x04C11DB7, not reflected).
+		if (!Recorder::oggCrcTable[1])
+		{
+			for (uint32_t i = 0; i < 256; ++i)
+			{
+				uint32_t crc = i << 24;
+
+				for (size_t j = 0; j < 8; ++j)
+				{
+					crc = (crc & 0x80000000) ? (crc << 1) ^ 0x04C11DB7 : crc << 1;
+				}
+
+				Recorder::oggCrcTable[i] = crc;
+			}
+		}
+
+		switch (this->format)
+		{
+			case Format::RTPDUMP:
+				WriteRtpDumpHeader();
+				break;
+			case Format::IVF:
+				WriteIvfHeader(Append(32));
+				break;
+			case Format::OGG:
+				WriteOggHeaders();
+				break;
+			case Format::H264:
+				break;
+		}
+
+		this->flushTimer = new Timer(this);
+		this->flushTimer->Start(Recorder::FlushInterval);
+	}
+
+	Recorder::~Recorder()
+	{
+		MS_TRACE();
+	}
+
+	void Recorder::Close()
+	{
+		MS_TRACE();
+
+		this->closing = true;
+
+		this->flushTimer->Destroy();
+		this->flushTimer = nullptr;
+
+		// An incomplete frame is not written.
+		if (this->format == Format::OGG)
+			WriteOggPage(0x04, this->oggGranule, nullptr, 0);
+
+		// Queue the remaining data even if MaxQueuedBuffers are waiting.
+		if (!this->buffer.empty())
+		{
+			this->queuedBuffers.push_back(std::move(this->buffer));
+			this->buffer.clear();
+		}
+
+		MS_DEBUG_TAG(rtp, "closing recording [path:\"%s\", packets:%zu, writtenBytes:%zu, droppedBytes:%zu]",
+			this->path.c_str(), this->packets, this->writtenBytes, this->droppedBytes);
+
+		WriteNext();
+	}
+
+	Json::Value Recorder::toJson() const
+	{
+		MS_TRACE();
+
+		static const Json::StaticString k_path("path");
+		static const Json::StaticString k_format("format");
+		static const Json::StaticString k_ssrc("ssrc");
+		static const Json::StaticString k_packets("packets");
+		static const Json::StaticString k_frames("frames");
+		static const Json::StaticString k_writtenBytes("writtenBytes");
+		static const Json::StaticString k_droppedBytes("droppedBytes");
+		static const Json::StaticString k_failed("failed");
+
+		Json::Value json(Json::objectValue);
+
+		json[k_path] = this->path;
+		json[k_format] = Recorder::GetFormatString(this->format);
+
+		if (this->hasSsrc)
+			json[k_ssrc] = (Json::UInt)this->ssrc;
+
+		json[k_packets] = (Json::UInt)this->packets;
+		json[k_frames] = (Json::UInt)this->frames;
+		json[k_writtenBytes] = (Json::UInt)this->writtenBytes;
+		json[k_droppedBytes] = (Json::UInt)this->droppedBytes;
+		json[k_failed] = this->failed;
+
+		return json;
+	}
+
+	void Recorder::ReceivePacket(const RTC::RtpPacket* packet)
+	{
+		MS_TRACE();
+
+		if (this->closing || this->failed)
+			return;
+
+		if (this->format == Format::RTPDUMP)
+		{
+			WriteRtpDumpPacket(packet);
+
+			return;
+		}
+
+		if (!CheckStream(packet) || !packet->GetPayloadLength())
+			return;
+
+		switch (this->format)
+		{
+			case Format::IVF:
+				ReceiveVideoFramePacket(packet);
+				break;
+			case Format::OGG:
+				WriteOggPacket(packet);
+				break;
+			case Format::H264:
+				WriteH264Packet(packet);
+				break;
+			default:
+				;
+		}
+	}
+
+	/**
+	 * Returns a pointer to len bytes at the end of the buffer or nullptr if the
+	 * record must be dropped.
+	 */
+	uint8_t* Recorder::Append(size_t len)
+	{
+		MS_TRACE();
+
+		if (this->failed || (this->buffer.size() + len > Recorder::BufferSize && !Flush()))
+		{
+			this->droppedBytes += len;
+
+			return nullptr;
+		}
+
+		size_t size = this->buffer.size();
+
+		// NOTE: A record bigger than BufferSize makes it grow.
+		this->buffer.resize(size + len);
+
+		return this->buffer.data() + size;
+	}
+
+	/**
+	 * Queues the current buffer to be written. Returns false if too many are
+	 * already waiting.
+	 */
+	bool Recorder::Flush()
+	{
+		MS_TRACE();
+
+		if (this->buffer.empty())
+			return true;
+
+		if (this->queuedBuffers.size() >= Recorder::MaxQueuedBuffers)
+			return false;
+
+		this->queuedBuffers.push_back(std::move(this->buffer));
+		this->buffer.clear();
+		this->buffer.reserve(Recorder::BufferSize);
+
+		WriteNext();
+
+		return true;
+	}
+
+	void Recorder::WriteNext()
+	{
+		MS_TRACE();
+
+		if (this->fileWriter->IsWriting())
+			return;
+
+		if (this->failed)
+			this->queuedBuffers.clear();
+
+		if (this->queuedBuffers.empty())
+		{
+			if (this->closing)
+				Finish();
+
+			return;
+		}
+
+		int64_t offset = this->fileOffset;
+
+		this->writeSize = this->queuedBuffers.front().size();
+		this->fileOffset += this->writeSize;
+		this->fileWriter->Write(std::move(this->queuedBuffers.front()), offset);
+		this->queuedBuffers.pop_front();
+	}
+
+	/**
+	 * Once everything is written, update the IVF header and close the file.
+	 */
+	void Recorder::Finish()
+	{
+		MS_TRACE();
+
+		if (this->format == Format::IVF && !this->ivfHeaderUpdated && !this->failed)
+		{
+			std::vector<uint8_t> header(32);
+
+			this->ivfHeaderUpdated = true;
+			WriteIvfHeader(header.data());
+			this->writeSize = header.size();
+			this->fileWriter->Write(std::move(header), 0);
+
+			return;
+		}
+
+		this->fileWriter->Close();
+	}
+
+	uint64_t Recorder::UnwrapTimestamp(uint32_t timestamp)
+	{
+		MS_TRACE();
+
+		if (!this->hasTimestamp)
+		{
+			this->hasTimestamp = true;
+			this->lastTimestamp = timestamp;
+
+			return 0;
+		}
+
+		int32_t delta = static_cast<int32_t>(timestamp - this->lastTimestamp);
+
+		// Late packets do not move the timestamp backwards.
+		if (delta > 0)
+		{
+			this->unwrappedTimestamp += delta;
+			this->lastTimestamp = timestamp;
+		}
+
+		return this->unwrappedTimestamp;
+	}
+
+	/**
+	 * Whether the packet belongs to the recorded stream and must be written.
+	 */
+	bool Recorder::CheckStream(const RTC::RtpPacket* packet)
+	{
+		MS_TRACE();
+
+		uint16_t seq = packet->GetSequenceNumber();
+
+		if (!this->hasSsrc)
+		{
+			this->hasSsrc = true;
+			this->ssrc = packet->GetSsrc();
+			this->lastSeq = seq - 1;
+
+			if (this->format != Format::OGG)
+				WaitKeyFrame();
+		}
+		else if (packet->GetSsrc() != this->ssrc)
+		{
+			return false;
+		}
+
+		uint16_t delta = seq - this->lastSeq;
+
+		// Old or repeated packet (retransmissions come too late to be written).
+		if (delta == 0 || delta >= 0x8000)
+			return false;
+
+		this->lastSeq = seq;
+
+		if (delta != 1 && this->format != Format::OGG)
+			WaitKeyFrame();
+
+		return packet->GetPayloadType() == this->codec.payloadType;
+	}
+
+	void Recorder::WaitKeyFrame()
+	{
+		MS_TRACE();
+
+		this->frame.clear();
+
+		if (this->waitingKeyFrame)
+			return;
+
+		this->waitingKeyFrame = true;
+
+		this->listener->onRecorderKeyFrameRequired(this, this->ssrc);
+	}
+
+	void Recorder::WriteRtpDumpHeader()
+	{
+		MS_TRACE();
+
+		static const std::string firstLine = "#!rtpplay1.0 0.0.0.0/0\n";
+
+		struct timeval tv;
+		uint8_t* data = Append(firstLine.size() + 16);
+
+		gettimeofday(&tv, nullptr);
+
+		std::memcpy(data, firstLine.c_str(), firstLine.size());
+		data += firstLine.size();
+
+		// Start time, source address, port and padding.
+		Utils::Byte::Set4Bytes(data, 0, tv.tv_sec);
+		Utils::Byte::Set4Bytes(data, 4, tv.tv_usec);
+		Utils::Byte::Set4Bytes(data, 8, 0);
+		Utils::Byte::Set2Bytes(data, 12, 0);
+		Utils::Byte::Set2Bytes(data, 14, 0);
+	}
+
+	void Recorder::WriteRtpDumpPacket(const RTC::RtpPacket* packet)
+	{
+		MS_TRACE();
+
+		size_t size = packet->GetSize();
+		uint8_t* data = Append(8 + size);
+
+		if (!data)
+			return;
+
+		// Record length, packet length and offset (ms) since the start.
+		Utils::Byte::Set2Bytes(data, 0, static_cast<uint16_t>(8 + size));
+		Utils::Byte::Set2Bytes(data, 2, static_cast<uint16_t>(size));
+		Utils::Byte::Set4Bytes(data, 4, static_cast<uint32_t>(DepLibUV::GetTime() - this->startTime));
+		std::memcpy(data + 8, packet->GetData(), size);
+
+		this->packets++;
+	}
+
+	void Recorder::WriteIvfHeader(uint8_t* data) const
+	{
+		MS_TRACE();
+
+		std::memcpy(data, "DKIF", 4);
+		// Version and header size.
+		setLE16(data + 4, 0);
+		setLE16(data + 6, 32);
+
+		if (this->codec.mime.subtype == RTC::RtpCodecMime::Subtype::VP9)
+			std::memcpy(data + 8, "VP90", 4);
+		else
+			std::memcpy(data + 8, "VP80", 4);
+
+		setLE16(data + 12, this->width);
+		setLE16(data + 14, this->height);
+		// Time base (1 / 90000).
+		setLE32(data + 16, 90000);
+		setLE32(data + 20, 1);
+		setLE32(data + 24, this->frames);
+		setLE32(data + 28, 0);
+	}
+
+	void Recorder::ReceiveVideoFramePacket(const RTC::RtpPacket* packet)
+	{
+		MS_TRACE();
+
+		auto descriptor = packet->GetPayloadDescriptor();
+
+		// Just the base spatial layer of VP9 (a frame with several ones would
+		// need a superframe index).
+		if (!descriptor || (descriptor->hasSpatialLayers && descriptor->spatialLayer != 0))
+			return;
+
+		if (this->waitingKeyFrame)
+		{
+			if (!descriptor->isKeyFrame)
+				return;
+
+			this->waitingKeyFrame = false;
+		}
+
+		const uint8_t* payload = packet->GetPayload() + descriptor->payloadOffset;
+		size_t len = packet->GetPayloadLength() - descriptor->payloadOffset;
+
+		if (descriptor->startOfFrame)
+		{
+			this->frame.clear();
+			this->frameTimestamp = packet->GetTimestamp();
+
+			// VP8 key frame start code and dimensions.
+			if (
+				descriptor->isKeyFrame &&
+				this->codec.mime.subtype == RTC::RtpCodecMime::Subtype::VP8 &&
+				len >= 10 && payload[3] == 0x9D && payload[4] == 0x01 && payload[5] == 0x2A
+			)
+			{
+				this->width = (payload[6] | payload[7] << 8) & 0x3FFF;
+				this->height = (payload[8] | payload[9] << 8) & 0x3FFF;
+			}
+		}
+		else if (this->frame.empty() || packet->GetTimestamp() != this->frameTimestamp)
+		{
+			return;
+		}
+
+		this->frame.insert(this->frame.end(), payload, payload + len);
+		this->packets++;
+
+		bool endOfFrame;
+
+		if (this->codec.mime.subtype == RTC::RtpCodecMime::Subtype::VP9)
+			endOfFrame = descriptor->endOfFrame;
+		else
+			endOfFrame = packet->HasMarker();
+
+		if (endOfFrame)
+			WriteIvfFrame();
+	}
+
+	void Recorder::WriteIvfFrame()
+	{
+		MS_TRACE();
+
+		uint64_t timestamp = UnwrapTimestamp(this->frameTimestamp);
+		uint8_t* data = Append(12 + this->frame.size());
+
+		if (!data)
+		{
+			WaitKeyFrame();
+
+			return;
+		}
+
+		setLE32(data, this->frame.size());
+		setLE64(data + 4, timestamp);
+		std::memcpy(data + 12, this->frame.data(), this->frame.size());
+
+		this->frame.clear();
+		this->frames++;
+	}
+
+	void Recorder::WriteOggHeaders()
+	{
+		MS_TRACE();
+
+		static const char vendor[] = "mediasoup";
+		static constexpr size_t vendorLength = sizeof(vendor) - 1;
+
+		uint8_t opusHead[19];
+		uint8_t opusTags[16 + vendorLength];
+		uint8_t numChannels = this->codec.numChannels > 1 ? 2 : 1;
+
+		this->oggSerial = Utils::Crypto::GetRandomUInt(100000000, 999999999);
+
+		// Version, channels, pre-skip, input sample rate, gain and mapping family.
+		std::memcpy(opusHead, "OpusHead", 8);
+		opusHead[8] = 1;
+		opusHead[9] = numChannels;
+		setLE16(opusHead + 10, 0);
+		setLE32(opusHead + 12, 48000);
+		setLE16(opusHead + 16, 0);
+		opusHead[18] = 0;
+
+		// Vendor string and no user comments.
+		std::memcpy(opusTags, "OpusTags", 8);
+		setLE32(opusTags + 8, vendorLength);
+		std::memcpy(opusTags + 12, vendor, vendorLength);
+		setLE32(opusTags + 12 + vendorLength, 0);
+
+		WriteOggPage(0x02, 0, opusHead, sizeof(opusHead));
+		WriteOggPage(0x00, 0, opusTags, sizeof(opusTags));
+	}
+
+	/**
+	 * Writes a page with a single packet (or none if data is nullptr).
+	 */
+	void Recorder::WriteOggPage(uint8_t headerType, uint64_t granule, const uint8_t* data, size_t len)
+	{
+		MS_TRACE();
+
+		size_t numSegments = data ? len / 255 + 1 : 0;
+
+		if (numSegments > 255)
+		{
+			this->droppedBytes += len;
+
+			return;
+		}
+
+		uint8_t* page = Append(27 + numSegments + len);
+
+		if (!page)
+			return;
+
+		std::memcpy(page, "OggS", 4);
+		page[4] = 0;
+		page[5] = headerType;
+		setLE64(page + 6, granule);
+		setLE32(page + 14, this->oggSerial);
+		setLE32(page + 18, this->oggPageSeq++);
+		setLE32(page + 22, 0);
+		page[26] = numSegments;
+
+		// Lacing values.
+		for (size_t i = 0; i < numSegments; ++i)
+		{
+			page[27 + i] = (i + 1 < numSegments) ? 255 : len % 255;
+		}
+
+		if (len)
+			std::memcpy(page + 27 + numSegments, data, len);
+
+		uint32_t crc = 0;
+
+		for (size_t i = 0; i < 27 + numSegments + len; ++i)
+		{
+			crc = (crc << 8) ^ Recorder::oggCrcTable[((crc >> 24) ^ page[i]) & 0xFF];
+		}
+
+		setLE32(page + 22, crc);
+	}
+
+	void Recorder::WriteOggPacket(const RTC::RtpPacket* packet)
+	{
+		MS_TRACE();
+
+		const uint8_t* payload = packet->GetPayload();
+		size_t len = packet->GetPayloadLength();
+
+		// The Opus RTP clock rate is always 48000 (RFC 7587), so the granule
+		// position (end of the packet) comes from the RTP timestamp.
+		uint64_t granule = UnwrapTimestamp(packet->GetTimestamp()) + getOpusSamples(payload, len);
+
+		// Keep it monotonic (late packets).
+		if (granule < this->oggGranule)
+			granule = this->oggGranule;
+
+		WriteOggPage(0x00, granule, payload, len);
+
+		this->oggGranule = granule;
+		this->packets++;
+		this->frames++;
+	}
+
+	void Recorder::WriteH264Packet(const RTC::RtpPacket* packet)
+	{
+		MS_TRACE();
+
+		auto descriptor = packet->GetPayloadDescriptor();
+
+		if (this->waitingKeyFrame)
+		{
+			if (!descriptor || !descriptor->isKeyFrame)
+				return;
+
+			this->waitingKeyFrame = false;
+		}
+
+		const uint8_t* payload = packet->GetPayload();
+		size_t len = packet->GetPayloadLength();
+		size_t droppedBytes = this->droppedBytes;
+		uint8_t nal = payload[0] & 0x1F;
+		uint8_t* data;
+
+		// Single NAL unit.
+		if (nal >= 1 && nal <= 23)
+		{
+			if ((data = Append(4 + len)))
+			{
+				Utils::Byte::Set4Bytes(data, 0, 1);
+				std::memcpy(data + 4, payload, len);
+			}
+		}
+		// STAP-A.
+		else if (nal == 24)
+		{
+			size_t offset = 1;
+
+			while (offset + 2 < len)
+			{
+				size_t naluSize = Utils::Byte::Get2Bytes(payload, offset);
+
+				offset += 2;
+
+				if (naluSize == 0 || offset + naluSize > len)
+					break;
+
+				if ((data = Append(4 + naluSize)))
+				{
+					Utils::Byte::Set4Bytes(data, 0, 1);
+					std::memcpy(data + 4, payload + offset, naluSize);
+				}
+
+				offset += naluSize;
+			}
+		}
+		// FU-A (the NAL unit header is rebuilt out of the first fragment).
+		else if (nal == 28 && len > 2)
+		{
+			if (payload[1] & 0x80)
+			{
+				if ((data = Append(5 + len - 2)))
+				{
+					Utils::Byte::Set4Bytes(data, 0, 1);
+					data[4] = (payload[0] & 0xE0) | (payload[1] & 0x1F);
+					std::memcpy(data + 5, payload + 2, len - 2);
+				}
+			}
+			else if ((data = Append(len - 2)))
+			{
+				std::memcpy(data, payload + 2, len - 2);
+			}
+		}
+		else
+		{
+			return;
+		}
+
+		if (this->droppedBytes != droppedBytes)
+		{
+			WaitKeyFrame();
+
+			return;
+		}
+
+		this->packets++;
+
+		if (packet->HasMarker())
+			this->frames++;
+	}
+
+	inline
+	void Recorder::onTimer(Timer* timer)
+	{
+		MS_TRACE();
+
+		Flush();
+
+		this->flushTimer->Start(Recorder::FlushInterval);
+	}
+
+	inline
+	void Recorder::onFileWriterWrite(FileWriter* fileWriter, size_t written, int err)
+	{
+		MS_TRACE();
+
+		this->writtenBytes += written;
+
+		if (err)
+		{
+			MS_ERROR("recording stopped [path:\"%s\"]", this->path.c_str());
+
+			this->failed = true;
+			this->droppedBytes += this->writeSize - written;
+		}
+
+		WriteNext();
+	}
+
+	inline
+	void Recorder::onFileWriterClosed(FileWriter* fileWriter)
+	{
+		MS_TRACE();
+
+		MS_DEBUG_TAG(rtp, "recording closed [path:\"%s\"]", this->path.c_str());
+
+		delete this;
+	}
+}
@@ -0,0 +1,193 @@
+#define MS_CLASS "RTC::RedEncoder"
+// #define MS_LOG_DEV
+#define MS_LOG_HOT_PATH
+
+#include "RTC/RedEncoder.hpp"
+#include "Utils.hpp"
+#include "Logger.hpp"
+#include <cstring> // std::memcpy()
+#include <algorithm> // std::min()
+
+namespace RTC
+{
+	/* Class variables. */
+
+	constexpr size_t RedEncoder::MaxDistance;
+	constexpr size_t RedEncoder::MaxBlockLength;
+	constexpr size_t RedEncoder::MaxPacketSize;
+
+	// Room for a RTP header (with extensions) bigger than MaxPacketSize.
+	uint8_t RedEncoder::buffer[65536];
+
+	/* Instance methods. */
+
+	RedEncoder::RedEncoder(uint8_t payloadType) :
+		payloadType(payloadType)
+	{
+		MS_TRACE();
+	}
+
+	Json::Value RedEncoder::toJson() const
+	{
+		MS_TRACE();
+
+		static const Json::StaticString k_payloadType("payloadType");
+		static const Json::StaticString k_distance("distance");
+		static const Json::StaticString k_redPackets("redPackets");
+		static const Json::StaticString k_redundantBytes("redundantBytes");
+
+		Json::Value json(Json::objectValue);
+
+		json[k_payloadType] = (Json::UInt)this->payloadType;
+		json[k_distance] = (Json::UInt)this->distance;
+		json[k_redPackets] = (Json::UInt)this->redPackets;
+		json[k_redundantBytes] = (Json::UInt)this->redundantBytes;
+
+		return json;
+	}
+
+	/**
+	 * Fraction lost as reported in RTCP (loss / 256). No redundancy without
+	 * loss, one payload up to 10% and up to MaxDistance beyond that.
+	 */
+	void RedEncoder::SetFractionLost(uint8_t fractionLost)
+	{
+		MS_TRACE();
+
+		size_t distance;
+
+		if (fractionLost == 0)
+			distance = 0;
+		else if (fractionLost < 26)
+			distance = 1;
+		else if (fractionLost < 52)
+			distance = 2;
+		else
+			distance = RedEncoder::MaxDistance;
+
+		if (distance != this->distance)
+		{
+			MS_DEBUG_TAG(rtp, "RED distance changed [fractionLost:%" PRIu8 ", distance:%zu]",
+				fractionLost, distance);
+		}
+
+		this->distance = distance;
+	}
+
+	/**
+	 * Returns the RED packet for the given one (the caller must delete it and
+	 * it is just valid until the next call), or nullptr if it must be sent as
+	 * it is.
+	 */
+	RTC::RtpPacket* RedEncoder::Encode(const RTC::RtpPacket* packet)
+	{
+		MS_TRACE();
+
+		uint16_t seq = packet->GetSequenceNumber();
+		uint32_t timestamp = packet->GetTimestamp();
+		size_t payloadLength = packet->GetPayloadLength();
+		RTC::RtpPacket* redPacket = nullptr;
+
+		// Redundant payloads must belong to the previous packets.
+		if (this->historySize && seq != static_cast<uint16_t>(this->lastSeq + 1))
+			this->historySize = 0;
+
+		if (this->distance && payloadLength)
+		{
+			size_t headerLength = packet->GetPayload() - packet->GetData();
+			size_t numBlocks = std::min(this->distance, this->historySize);
+			size_t redundantLength = 0;
+			size_t first = 0;
+
+			for (size_t i = 0; i < numBlocks; ++i)
+			{
+				redundantLength += this->history[(this->historyIdx + RedEncoder::MaxDistance - numBlocks + i) % RedEncoder::MaxDistance].length;
+			}
+
+			// Leave out the oldest payloads if they don't fit or their timestamp
+			// offset does not fit in 14 bits.
+			for (; first < numBlocks; ++first)
+			{
+				auto& block = this->history[(this->historyIdx + RedEncoder::MaxDistance - numBlocks + first) % RedEncoder::MaxDistance];
+				uint32_t offset = timestamp - block.timestamp;
+				size_t size = headerLength + (numBlocks - first) * 4 + 1 + redundantLength + payloadLength;
+
+				if (offset > 0 && offset <= 0x3FFF && size <= RedEncoder::MaxPacketSize)
+					break;
+
+				redundantLength -= block.length;
+			}
+
+			uint8_t* ptr = RedEncoder::buffer;
+
+			// Copy the RTP header (without padding) and set the RED payload type.
+			std::memcpy(ptr, packet->GetData(), headerLength);
+			ptr[0] &= 0xDF;
+			ptr[1] = (ptr[1] & 0x80) | this->payloadType;
+			ptr += headerLength;
+
+			// Block headers (oldest first).
+			for (size_t i = first; i < numBlocks; ++i)
+			{
+				auto& block = this->history[(this->historyIdx + RedEncoder::MaxDistance - numBlocks + i) % RedEncoder::MaxDistance];
+				uint32_t offset = timestamp - block.timestamp;
+
+				ptr[0] = 0x80 | block.payloadType;
+				Utils::Byte::Set3Bytes(ptr, 1, (offset << 10) | block.length);
+				ptr += 4;
+			}
+
+			// Primary block header.
+			ptr[0] = packet->GetPayloadType();
+			ptr += 1;
+
+			// Redundant payloads and the primary one.
+			for (size_t i = first; i < numBlocks; ++i)
+			{
+				auto& block = this->history[(this->historyIdx + RedEncoder::MaxDistance - numBlocks + i) % RedEncoder::MaxDistance];
+
+				std::memcpy(ptr, block.data, block.length);
+				ptr += block.length;
+			}
+
+			std::memcpy(ptr, packet->GetPayload(), payloadLength);
+			ptr += payloadLength;
+
+			redPacket = RTC::RtpPacket::Parse(RedEncoder::buffer, ptr - RedEncoder::buffer);
+
+			this->redPackets++;
+			this->redundantBytes += redundantLength;
+		}
+
+		StorePayload(packet);
+
+		return redPacket;
+	}
+
+	void RedEncoder::StorePayload(const RTC::RtpPacket* packet)
+	{
+		MS_TRACE();
+
+		size_t payloadLength = packet->GetPayloadLength();
+
+		this->lastSeq = packet->GetSequenceNumber();
+
+		// A packet that cannot be stored breaks the sequence.
+		if (payloadLength == 0 || payloadLength > RedEncoder::MaxBlockLength)
+		{
+			this->historySize = 0;
+
+			return;
+		}
+
+		auto& block = this->history[this->historyIdx];
+
+		block.payloadType = packet->GetPayloadType();
+		block.timestamp = packet->GetTimestamp();
+		block.length = payloadLength;
+		std::memcpy(block.data, packet->GetPayload(), payloadLength);
+
+		this->historyIdx = (this->historyIdx + 1) % RedEncoder::MaxDistance;
+		this->historySize = std::min(this->historySize + 1, RedEncoder::MaxDistance);
+	}
+}
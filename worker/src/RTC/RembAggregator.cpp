@@ -0,0 +1,132 @@
+#define MS_CLASS "RTC::RembAggregator"
+// #define MS_LOG_DEV
+
+#include "RTC/RembAggregator.hpp"
+#include "Utils.hpp"
+#include "MediaSoupError.hpp"
+#include "Logger.hpp"
+#include <algorithm> // std::sort()
+
+namespace RTC
+{
+	/* Class variables. */
+
+	std::unordered_map<std::string, RembAggregator::Policy> RembAggregator::string2Policy =
+	{
+		{ "min",              RembAggregator::Policy::MIN              },
+		{ "percentile",       RembAggregator::Policy::PERCENTILE       },
+		{ "min-non-outliers", RembAggregator::Policy::MIN_NON_OUTLIERS }
+	};
+
+	std::map<RembAggregator::Policy, Json::StaticString> RembAggregator::policy2Json =
+	{
+		{ RembAggregator::Policy::MIN,              Json::StaticString("min")              },
+		{ RembAggregator::Policy::PERCENTILE,       Json::StaticString("percentile")       },
+		{ RembAggregator::Policy::MIN_NON_OUTLIERS, Json::StaticString("min-non-outliers") }
+	};
+
+	/* Class methods. */
+
+	RembAggregator::Policy RembAggregator::GetPolicy(std::string& str)
+	{
+		MS_TRACE();
+
+		// Force lowcase policy.
+		Utils::String::ToLowerCase(str);
+
+		auto it = RembAggregator::string2Policy.find(str);
+
+		if (it == RembAggregator::string2Policy.end())
+			MS_THROW_ERROR("invalid REMB policy [policy:%s]", str.c_str());
+
+		return it->second;
+	}
+
+	Json::StaticString& RembAggregator::GetJsonString(RembAggregator::Policy policy)
+	{
+		MS_TRACE();
+
+		return RembAggregator::policy2Json.at(policy);
+	}
+
+	/* Instance methods. */
+
+	RembAggregator::RembAggregator(Policy policy, uint8_t percentile) :
+		policy(policy),
+		percentile(percentile)
+	{
+		MS_TRACE();
+
+		if (this->percentile > 100)
+			this->percentile = 100;
+	}
+
+	Json::Value RembAggregator::toJson() const
+	{
+		MS_TRACE();
+
+		static const Json::StaticString k_policy("policy");
+		static const Json::StaticString k_percentile("percentile");
+
+		Json::Value json(Json::objectValue);
+
+		json[k_policy] = RembAggregator::GetJsonString(this->policy);
+
+		if (this->policy == Policy::PERCENTILE)
+			json[k_percentile] = (Json::UInt)this->percentile;
+
+		return json;
+	}
+
+	/**
+	 * Returns 0 if no bitrate is given. The given vector is sorted.
+	 */
+	uint32_t RembAggregator::Aggregate(std::vector<uint32_t>& bitrates) const
+	{
+		MS_TRACE();
+
+		if (bitrates.empty())
+			return 0;
+
+		std::sort(bitrates.begin(), bitrates.end());
+
+		size_t count = bitrates.size();
+
+		switch (this->policy)
+		{
+			case Policy::MIN:
+			{
+				return bitrates[0];
+			}
+
+			case Policy::PERCENTILE:
+			{
+				// Nearest rank.
+				size_t rank = (this->percentile * count + 99) / 100;
+
+				return bitrates[rank > 0 ? rank - 1 : 0];
+			}
+
+			case Policy::MIN_NON_OUTLIERS:
+			{
+				// Not enough values to tell outliers.
+				if (count < 4)
+					return bitrates[0];
+
+				double q1 = bitrates[count / 4];
+				double q3 = bitrates[(3 * count) / 4];
+				double fence = q1 - 1.5 * (q3 - q1);
+
+				for (auto bitrate : bitrates)
+				{
+					if (bitrate >= fence)
+						return bitrate;
+				}
+
+				return bitrates[0];
+			}
+		}
+
+		return bitrates[0];
+	}
+}
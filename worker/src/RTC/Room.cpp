@@ -2,12 +2,16 @@
 // #define MS_LOG_DEV
 
 #include "RTC/Room.hpp"
+#include "RTC/Metrics.hpp"
 #include "MediaSoupError.hpp"
+#include "DepLibUV.hpp"
 #include "Logger.hpp"
 #include "Utils.hpp"
 #include <string>
 #include <vector>
 #include <set>
+#include <map>
+#include <algorithm> // std::min(), std::find(), std::find_if(), std::sort(), std::lower_bound()
 
 namespace RTC
 {
@@ -31,7 +35,7 @@ namespace RTC
 			Json::CharReader* jsonReader = builder.newCharReader();
 
 			// NOTE: These lines are auto-generated from data/supportedCapabilities.js.
-			const std::string supportedRtpCapabilities = R"({"codecs":[{"kind":"audio","name":"audio/opus","clockRate":48000,"numChannels":2,"rtcpFeedback":[]},{"kind":"audio","name":"audio/PCMU","clockRate":8000,"rtcpFeedback":[]},{"kind":"audio","name":"audio/PCMA","clockRate":8000,"rtcpFeedback":[]},{"kind":"audio","name":"audio/ISAC","clockRate":32000,"rtcpFeedback":[]},{"kind":"audio","name":"audio/ISAC","clockRate":16000,"rtcpFeedback":[]},{"kind":"audio","name":"audio/G722","clockRate":8000,"rtcpFeedback":[]},{"kind":"audio","name":"audio/iLBC","clockRate":8000,"rtcpFeedback":[]},{"kind":"audio","name":"audio/SILK","clockRate":24000,"rtcpFeedback":[]},{"kind":"audio","name":"audio/SILK","clockRate":16000,"rtcpFeedback":[]},{"kind":"audio","name":"audio/SILK","clockRate":12000,"rtcpFeedback":[]},{"kind":"audio","name":"audio/SILK","clockRate":8000,"rtcpFeedback":[]},{"kind":"audio","name":"audio/CN","clockRate":32000,"rtcpFeedback":[]},{"kind":"audio","name":"audio/CN","clockRate":16000,"rtcpFeedback":[]},{"kind":"audio","name":"audio/CN","clockRate":8000,"rtcpFeedback":[]},{"kind":"audio","name":"audio/CN","clockRate":32000,"rtcpFeedback":[]},{"kind":"audio","name":"audio/telephone-event","clockRate":48000,"rtcpFeedback":[]},{"kind":"audio","name":"audio/telephone-event","clockRate":32000,"rtcpFeedback":[]},{"kind":"audio","name":"audio/telephone-event","clockRate":16000,"rtcpFeedback":[]},{"kind":"audio","name":"audio/telephone-event","clockRate":8000,"rtcpFeedback":[]},{"kind":"video","name":"video/VP8","clockRate":90000,"rtcpFeedback":[{"type":"nack"},{"type":"nack","parameter":"pli"},{"type":"nack","parameter":"sli"},{"type":"nack","parameter":"rpsi"},{"type":"nack","parameter":"app"},{"type":"ccm","parameter":"fir"},{"type":"ack","parameter":"rpsi"},{"type":"ack","parameter":"app"},{"type":"goog-remb"}]},{"kind":"video","name":"video/VP9","clockRate":90000,"rtcpFeedback":[{"type":"nack"},{"type":"nack","parameter":"pli"},{"type":"nack","parameter":"sli"},{"type":"nack","parameter":"rpsi"},{"type":"nack","parameter":"app"},{"type":"ccm","parameter":"fir"},{"type":"ack","parameter":"rpsi"},{"type":"ack","parameter":"app"},{"type":"goog-remb"}]},{"kind":"video","name":"video/H264","clockRate":90000,"parameters":{"packetizationMode":0},"rtcpFeedback":[{"type":"nack"},{"type":"nack","parameter":"pli"},{"type":"nack","parameter":"sli"},{"type":"nack","parameter":"rpsi"},{"type":"nack","parameter":"app"},{"type":"ccm","parameter":"fir"},{"type":"ack","parameter":"rpsi"},{"type":"ack","parameter":"app"},{"type":"goog-remb"}]},{"kind":"video","name":"video/H264","clockRate":90000,"parameters":{"packetizationMode":1},"rtcpFeedback":[{"type":"nack"},{"type":"nack","parameter":"pli"},{"type":"nack","parameter":"sli"},{"type":"nack","parameter":"rpsi"},{"type":"nack","parameter":"app"},{"type":"ccm","parameter":"fir"},{"type":"ack","parameter":"rpsi"},{"type":"ack","parameter":"app"},{"type":"goog-remb"}]},{"kind":"video","name":"video/H265","clockRate":90000,"rtcpFeedback":[{"type":"nack"},{"type":"nack","parameter":"pli"},{"type":"nack","parameter":"sli"},{"type":"nack","parameter":"rpsi"},{"type":"nack","parameter":"app"},{"type":"ccm","parameter":"fir"},{"type":"ack","parameter":"rpsi"},{"type":"ack","parameter":"app"},{"type":"goog-remb"}]}],"headerExtensions":[{"kind":"audio","uri":"urn:ietf:params:rtp-hdrext:ssrc-audio-level","preferredId":1,"preferredEncrypt":false},{"kind":"video","uri":"urn:ietf:params:rtp-hdrext:toffset","preferredId":2,"preferredEncrypt":false},{"kind":"","uri":"http://www.webrtc.org/experiments/rtp-hdrext/abs-send-time","preferredId":3,"preferredEncrypt":false},{"kind":"video","uri":"urn:3gpp:video-orientation","preferredId":4,"preferredEncrypt":false},{"kind":"","uri":"urn:ietf:params:rtp-hdrext:sdes:rtp-stream-id","preferredId":5,"preferredEncrypt":false}],"fecMechanisms":[]})";
+			const std::string supportedRtpCapabilities = R"({"codecs":[{"kind":"audio","name":"audio/opus","clockRate":48000,"numChannels":2,"rtcpFeedback":[]},{"kind":"audio","name":"audio/PCMU","clockRate":8000,"rtcpFeedback":[]},{"kind":"audio","name":"audio/PCMA","clockRate":8000,"rtcpFeedback":[]},{"kind":"audio","name":"audio/ISAC","clockRate":32000,"rtcpFeedback":[]},{"kind":"audio","name":"audio/ISAC","clockRate":16000,"rtcpFeedback":[]},{"kind":"audio","name":"audio/G722","clockRate":8000,"rtcpFeedback":[]},{"kind":"audio","name":"audio/iLBC","clockRate":8000,"rtcpFeedback":[]},{"kind":"audio","name":"audio/SILK","clockRate":24000,"rtcpFeedback":[]},{"kind":"audio","name":"audio/SILK","clockRate":16000,"rtcpFeedback":[]},{"kind":"audio","name":"audio/SILK","clockRate":12000,"rtcpFeedback":[]},{"kind":"audio","name":"audio/SILK","clockRate":8000,"rtcpFeedback":[]},{"kind":"audio","name":"audio/CN","clockRate":32000,"rtcpFeedback":[]},{"kind":"audio","name":"audio/CN","clockRate":16000,"rtcpFeedback":[]},{"kind":"audio","name":"audio/CN","clockRate":8000,"rtcpFeedback":[]},{"kind":"audio","name":"audio/CN","clockRate":32000,"rtcpFeedback":[]},{"kind":"audio","name":"audio/telephone-event","clockRate":48000,"rtcpFeedback":[]},{"kind":"audio","name":"audio/telephone-event","clockRate":32000,"rtcpFeedback":[]},{"kind":"audio","name":"audio/telephone-event","clockRate":16000,"rtcpFeedback":[]},{"kind":"audio","name":"audio/telephone-event","clockRate":8000,"rtcpFeedback":[]},{"kind":"video","name":"video/VP8","clockRate":90000,"rtcpFeedback":[{"type":"nack"},{"type":"nack","parameter":"pli"},{"type":"nack","parameter":"sli"},{"type":"nack","parameter":"rpsi"},{"type":"nack","parameter":"app"},{"type":"ccm","parameter":"fir"},{"type":"ack","parameter":"rpsi"},{"type":"ack","parameter":"app"},{"type":"goog-remb"},{"type":"transport-cc"}]},{"kind":"video","name":"video/VP9","clockRate":90000,"rtcpFeedback":[{"type":"nack"},{"type":"nack","parameter":"pli"},{"type":"nack","parameter":"sli"},{"type":"nack","parameter":"rpsi"},{"type":"nack","parameter":"app"},{"type":"ccm","parameter":"fir"},{"type":"ack","parameter":"rpsi"},{"type":"ack","parameter":"app"},{"type":"goog-remb"},{"type":"transport-cc"}]},{"kind":"video","name":"video/H264","clockRate":90000,"parameters":{"packetizationMode":0},"rtcpFeedback":[{"type":"nack"},{"type":"nack","parameter":"pli"},{"type":"nack","parameter":"sli"},{"type":"nack","parameter":"rpsi"},{"type":"nack","parameter":"app"},{"type":"ccm","parameter":"fir"},{"type":"ack","parameter":"rpsi"},{"type":"ack","parameter":"app"},{"type":"goog-remb"},{"type":"transport-cc"}]},{"kind":"video","name":"video/H264","clockRate":90000,"parameters":{"packetizationMode":1},"rtcpFeedback":[{"type":"nack"},{"type":"nack","parameter":"pli"},{"type":"nack","parameter":"sli"},{"type":"nack","parameter":"rpsi"},{"type":"nack","parameter":"app"},{"type":"ccm","parameter":"fir"},{"type":"ack","parameter":"rpsi"},{"type":"ack","parameter":"app"},{"type":"goog-remb"},{"type":"transport-cc"}]},{"kind":"video","name":"video/H265","clockRate":90000,"rtcpFeedback":[{"type":"nack"},{"type":"nack","parameter":"pli"},{"type":"nack","parameter":"sli"},{"type":"nack","parameter":"rpsi"},{"type":"nack","parameter":"app"},{"type":"ccm","parameter":"fir"},{"type":"ack","parameter":"rpsi"},{"type":"ack","parameter":"app"},{"type":"goog-remb"},{"type":"transport-cc"}]}],"headerExtensions":[{"kind":"audio","uri":"urn:ietf:params:rtp-hdrext:ssrc-audio-level","preferredId":1,"preferredEncrypt":false},{"kind":"video","uri":"urn:ietf:params:rtp-hdrext:toffset","preferredId":2,"preferredEncrypt":false},{"kind":"","uri":"http://www.webrtc.org/experiments/rtp-hdrext/abs-send-time","preferredId":3,"preferredEncrypt":false},{"kind":"video","uri":"urn:3gpp:video-orientation","preferredId":4,"preferredEncrypt":false},{"kind":"","uri":"urn:ietf:params:rtp-hdrext:sdes:rtp-stream-id","preferredId":5,"preferredEncrypt":false},{"kind":"video","uri":"http://www.ietf.org/id/draft-holmer-rmcat-transport-wide-cc-extensions-01","preferredId":6,"preferredEncrypt":false},{"kind":"","uri":"urn:ietf:params:rtp-hdrext:sdes:mid","preferredId":7,"preferredEncrypt":false}],"fecMechanisms":["red","flexfec"]})";
 
 			Json::Value json;
 			std::string json_parse_error;
@@ -63,11 +67,53 @@ namespace RTC
 	Room::Room(Listener* listener, Channel::Notifier* notifier, uint32_t roomId, Json::Value& data) :
 		roomId(roomId),
 		listener(listener),
-		notifier(notifier)
+		notifier(notifier),
+		audioLevelObserver(this)
 	{
 		MS_TRACE();
 
 		static const Json::StaticString k_mediaCodecs("mediaCodecs");
+		static const Json::StaticString k_keyFrameCacheSize("keyFrameCacheSize");
+		static const Json::StaticString k_keyFrameRequestWindow("keyFrameRequestWindow");
+		static const Json::StaticString k_rembPolicy("rembPolicy");
+		static const Json::StaticString k_rembPercentile("rembPercentile");
+		static const Json::StaticString k_audioLastN("audioLastN");
+		static const Json::StaticString k_audioSilenceThreshold("audioSilenceThreshold");
+		static const Json::StaticString k_videoLastN("videoLastN");
+
+		// `keyFrameCacheSize` is optional (0 disables it).
+		if (data[k_keyFrameCacheSize].isUInt())
+			this->keyFrameCacheSize = data[k_keyFrameCacheSize].asUInt();
+
+		// `keyFrameRequestWindow` is optional (0 disables merging).
+		if (data[k_keyFrameRequestWindow].isUInt())
+			this->keyFrameRequestWindow = std::min<Json::UInt>(data[k_keyFrameRequestWindow].asUInt(), 60000);
+
+		// `rembPolicy` and `rembPercentile` are optional.
+		if (data[k_rembPolicy].isString())
+		{
+			std::string policy = data[k_rembPolicy].asString();
+			uint8_t percentile = 20;
+
+			if (data[k_rembPercentile].isUInt())
+				percentile = std::min<Json::UInt>(data[k_rembPercentile].asUInt(), 100);
+
+			// NOTE: This may throw.
+			this->rembAggregator = RTC::RembAggregator(RTC::RembAggregator::GetPolicy(policy), percentile);
+		}
+
+		// `audioLastN` is optional (0 forwards all the audio streams).
+		if (data[k_audioLastN].isUInt())
+			this->audioLevelObserver = RTC::AudioLevelObserver(this, data[k_audioLastN].asUInt());
+
+		// `audioSilenceThreshold` is optional (in dBov, 0 disables it).
+		// NOTE: This may throw.
+		if (data[k_audioSilenceThreshold].isInt())
+			this->audioLevelObserver.SetSilenceThreshold(data[k_audioSilenceThreshold].asInt());
+
+		// `videoLastN` is optional (0 forwards the video of all the Peers).
+		if (data[k_videoLastN].isUInt())
+			this->videoLastN = RTC::VideoLastN(data[k_videoLastN].asUInt());
 
 		// `mediaCodecs` is optional.
 		if (data[k_mediaCodecs].isArray())
@@ -103,11 +149,15 @@ namespace RTC
 			// NOTE: This may throw.
 			SetCapabilities(mediaCodecs);
 		}
+
+		RTC::Metrics::numRooms++;
 	}
 
 	Room::~Room()
 	{
 		MS_TRACE();
+
+		RTC::Metrics::numRooms--;
 	}
 
 	void Room::Destroy()
@@ -118,6 +168,24 @@ namespace RTC
 
 		Json::Value event_data(Json::objectValue);
 
+		// Don't pause/resume RtpSenders while closing.
+		this->videoLastN = RTC::VideoLastN();
+
+		// Stop receiving packets from the linked RtpReceivers (their RtpSenders
+		// are closed with the Peers).
+		for (auto& kv : this->linkedRtpReceivers)
+		{
+			auto rtpReceiver = kv.first;
+			auto sourceRoom = kv.second.sourceRoom;
+			auto it = sourceRoom->mapRtpReceiverLinkedRooms.find(rtpReceiver);
+
+			it->second.erase(this);
+
+			if (it->second.empty())
+				sourceRoom->mapRtpReceiverLinkedRooms.erase(it);
+		}
+		this->linkedRtpReceivers.clear();
+
 		// Close all the Peers.
 		// NOTE: Upon Peer closure the onPeerClosed() method is called which
 		// removes it from the map, so this is the safe way to iterate the map
@@ -146,9 +214,17 @@ namespace RTC
 
 		static const Json::StaticString k_roomId("roomId");
 		static const Json::StaticString k_capabilities("capabilities");
+		static const Json::StaticString k_keyFrameCacheSize("keyFrameCacheSize");
+		static const Json::StaticString k_keyFrameRequestWindow("keyFrameRequestWindow");
+		static const Json::StaticString k_remb("remb");
+		static const Json::StaticString k_audioLevels("audioLevels");
+		static const Json::StaticString k_videoLastN("videoLastN");
+		static const Json::StaticString k_speakers("speakers");
 		static const Json::StaticString k_peers("peers");
 		static const Json::StaticString k_mapRtpReceiverRtpSenders("mapRtpReceiverRtpSenders");
 		static const Json::StaticString k_mapRtpSenderRtpReceiver("mapRtpSenderRtpReceiver");
+		static const Json::StaticString k_linkedRtpReceivers("linkedRtpReceivers");
+		static const Json::StaticString k_mapRtpReceiverLinkedRooms("mapRtpReceiverLinkedRooms");
 
 		Json::Value json(Json::objectValue);
 		Json::Value json_peers(Json::arrayValue);
@@ -161,6 +237,29 @@ namespace RTC
 		// Add `capabilities`.
 		json[k_capabilities] = this->capabilities.toJson();
 
+		// Add `keyFrameCacheSize`.
+		json[k_keyFrameCacheSize] = (Json::UInt)this->keyFrameCacheSize;
+
+		// Add `keyFrameRequestWindow`.
+		json[k_keyFrameRequestWindow] = (Json::UInt)this->keyFrameRequestWindow;
+
+		// Add `remb`.
+		json[k_remb] = this->rembAggregator.toJson();
+
+		// Add `audioLevels`.
+		json[k_audioLevels] = this->audioLevelObserver.toJson();
+
+		// Add `videoLastN`.
+		json[k_videoLastN] = (Json::UInt)this->videoLastN.GetLastN();
+
+		// Add `speakers`.
+		json[k_speakers] = Json::arrayValue;
+
+		for (auto peerId : this->videoLastN.GetSpeakers())
+		{
+			json[k_speakers].append(this->peers.at(peerId)->peerName);
+		}
+
 		// Add `peers`.
 		for (auto& kv : this->peers)
 		{
@@ -196,9 +295,452 @@ namespace RTC
 		}
 		json[k_mapRtpSenderRtpReceiver] = json_mapRtpSenderRtpReceiver;
 
+		// Add `linkedRtpReceivers` (id of the source Room of each one).
+		json[k_linkedRtpReceivers] = Json::objectValue;
+
+		for (auto& kv : this->linkedRtpReceivers)
+		{
+			auto rtpReceiver = kv.first;
+			auto sourceRoom = kv.second.sourceRoom;
+
+			json[k_linkedRtpReceivers][std::to_string(rtpReceiver->rtpReceiverId)] = std::to_string(sourceRoom->roomId);
+		}
+
+		// Add `mapRtpReceiverLinkedRooms`.
+		json[k_mapRtpReceiverLinkedRooms] = Json::objectValue;
+
+		for (auto& kv : this->mapRtpReceiverLinkedRooms)
+		{
+			auto rtpReceiver = kv.first;
+			auto& rooms = kv.second;
+			Json::Value json_rooms(Json::arrayValue);
+
+			for (auto room : rooms)
+			{
+				json_rooms.append(std::to_string(room->roomId));
+			}
+
+			json[k_mapRtpReceiverLinkedRooms][std::to_string(rtpReceiver->rtpReceiverId)] = json_rooms;
+		}
+
 		return json;
 	}
 
+	/**
+	 * Replies the room.dump request with the JSON of the Room, written into the
+	 * channel as it is generated. The dump can be reduced by means of these
+	 * options (all of them optional):
+	 *
+	 * - fields: Array with the entries of the Room to include.
+	 * - peerFields: Array with the entries of each Peer to include.
+	 * - limit: Max number of Peers to include (0 means all).
+	 * - cursor: Include the Peers with id not lower than this one (given by
+	 *   the nextCursor entry of the previous page).
+	 *
+	 * If paginated, the maps just include the RtpReceivers and RtpSenders of the
+	 * included Peers and the linked RtpReceivers forwarded to them.
+	 */
+	void Room::Dump(Channel::Request* request) const
+	{
+		MS_TRACE();
+
+		static const Json::StaticString k_fields("fields");
+		static const Json::StaticString k_peerFields("peerFields");
+		static const Json::StaticString k_limit("limit");
+		static const Json::StaticString k_cursor("cursor");
+		static const Json::StaticString k_roomId("roomId");
+		static const Json::StaticString k_capabilities("capabilities");
+		static const Json::StaticString k_keyFrameCacheSize("keyFrameCacheSize");
+		static const Json::StaticString k_keyFrameRequestWindow("keyFrameRequestWindow");
+		static const Json::StaticString k_remb("remb");
+		static const Json::StaticString k_audioLevels("audioLevels");
+		static const Json::StaticString k_videoLastN("videoLastN");
+		static const Json::StaticString k_speakers("speakers");
+		static const Json::StaticString k_peers("peers");
+		static const Json::StaticString k_nextCursor("nextCursor");
+		// Entries of the Room (in order).
+		static const std::vector<std::string> allFields =
+		{
+			"roomId", "capabilities", "keyFrameCacheSize", "keyFrameRequestWindow",
+			"remb", "audioLevels", "videoLastN", "speakers", "peers",
+			"mapRtpReceiverRtpSenders", "mapRtpSenderRtpReceiver",
+			"linkedRtpReceivers", "mapRtpReceiverLinkedRooms"
+		};
+
+		std::vector<std::string> fields;
+		std::vector<std::string> peerFields;
+		bool filterPeerFields = false;
+		size_t limit = 0;
+		uint32_t cursor = 0;
+		bool paginated = false;
+
+		// Read `fields`.
+		if (request->data[k_fields].isArray())
+		{
+			for (auto& json_field : request->data[k_fields])
+			{
+				if (!json_field.isString() ||
+					std::find(allFields.begin(), allFields.end(), json_field.asString()) == allFields.end())
+				{
+					request->Reject("invalid data.fields");
+					return;
+				}
+			}
+
+			// Keep the order of allFields.
+			for (auto& field : allFields)
+			{
+				for (auto& json_field : request->data[k_fields])
+				{
+					if (json_field.asString() == field)
+					{
+						fields.push_back(field);
+						break;
+					}
+				}
+			}
+		}
+		else if (request->data[k_fields].isNull())
+		{
+			fields = allFields;
+		}
+		else
+		{
+			request->Reject("invalid data.fields");
+			return;
+		}
+
+		// Read `peerFields`.
+		if (request->data[k_peerFields].isArray())
+		{
+			for (auto& json_field : request->data[k_peerFields])
+			{
+				if (!json_field.isString())
+				{
+					request->Reject("invalid data.peerFields");
+					return;
+				}
+
+				peerFields.push_back(json_field.asString());
+			}
+
+			filterPeerFields = true;
+		}
+		else if (!request->data[k_peerFields].isNull())
+		{
+			request->Reject("invalid data.peerFields");
+			return;
+		}
+
+		// Read `limit` and `cursor`.
+		if (request->data[k_limit].isUInt())
+		{
+			limit = request->data[k_limit].asUInt();
+			paginated = limit != 0;
+		}
+		else if (!request->data[k_limit].isNull())
+		{
+			request->Reject("invalid data.limit");
+			return;
+		}
+
+		if (request->data[k_cursor].isUInt())
+		{
+			cursor = request->data[k_cursor].asUInt();
+			paginated = true;
+		}
+		else if (!request->data[k_cursor].isNull())
+		{
+			request->Reject("invalid data.cursor");
+			return;
+		}
+
+		// Get the Peers of the page (sorted by id so the cursor is stable).
+		std::vector<uint32_t> peerIds;
+
+		peerIds.reserve(this->peers.size());
+
+		for (auto& kv : this->peers)
+		{
+			peerIds.push_back(kv.first);
+		}
+
+		std::sort(peerIds.begin(), peerIds.end());
+
+		auto pageBegin = std::lower_bound(peerIds.begin(), peerIds.end(), cursor);
+		auto pageEnd = peerIds.end();
+
+		if (limit != 0 && (size_t)(pageEnd - pageBegin) > limit)
+			pageEnd = pageBegin + limit;
+
+		// If paginated, the entries of the maps to include.
+		std::unordered_set<const RTC::RtpReceiver*> rtpReceivers;
+		std::unordered_set<const RTC::RtpSender*> rtpSenders;
+
+		if (paginated)
+		{
+			for (auto it = pageBegin; it != pageEnd; ++it)
+			{
+				RTC::Peer* peer = this->peers.at(*it);
+
+				for (auto rtpReceiver : peer->GetRtpReceivers())
+				{
+					rtpReceivers.insert(rtpReceiver);
+				}
+				for (auto rtpSender : peer->GetRtpSenders())
+				{
+					rtpSenders.insert(rtpSender);
+				}
+			}
+
+			// Linked RtpReceivers belong to Peers of other Rooms, so they are
+			// included if forwarded to the page Peers.
+			for (auto& kv : this->linkedRtpReceivers)
+			{
+				auto it = this->mapRtpReceiverRtpSenders.find(kv.first);
+
+				if (it == this->mapRtpReceiverRtpSenders.end())
+					continue;
+
+				for (auto rtpSender : it->second)
+				{
+					if (rtpSenders.find(rtpSender) != rtpSenders.end())
+					{
+						rtpReceivers.insert(kv.first);
+						break;
+					}
+				}
+			}
+		}
+
+		// Write the dump.
+		Channel::ResponseWriter writer(request);
+
+		writer.StartObject(fields.size() + (pageEnd != peerIds.end() ? 1 : 0));
+
+		for (auto& field : fields)
+		{
+			writer.Key(field.c_str());
+
+			if (field == "roomId")
+			{
+				writer.Value((Json::UInt)this->roomId);
+			}
+			else if (field == "capabilities")
+			{
+				writer.Value(this->capabilities.toJson());
+			}
+			else if (field == "keyFrameCacheSize")
+			{
+				writer.Value((Json::UInt)this->keyFrameCacheSize);
+			}
+			else if (field == "keyFrameRequestWindow")
+			{
+				writer.Value((Json::UInt)this->keyFrameRequestWindow);
+			}
+			else if (field == "remb")
+			{
+				writer.Value(this->rembAggregator.toJson());
+			}
+			else if (field == "audioLevels")
+			{
+				writer.Value(this->audioLevelObserver.toJson());
+			}
+			else if (field == "videoLastN")
+			{
+				writer.Value((Json::UInt)this->videoLastN.GetLastN());
+			}
+			else if (field == "speakers")
+			{
+				Json::Value json_speakers(Json::arrayValue);
+
+				for (auto peerId : this->videoLastN.GetSpeakers())
+				{
+					json_speakers.append(this->peers.at(peerId)->peerName);
+				}
+
+				writer.Value(json_speakers);
+			}
+			else if (field == "peers")
+			{
+				// Write the Peers one by one.
+				writer.StartArray(pageEnd - pageBegin);
+
+				for (auto it = pageBegin; it != pageEnd; ++it)
+				{
+					RTC::Peer* peer = this->peers.at(*it);
+					Json::Value json_peer = peer->toJson();
+
+					if (filterPeerFields)
+					{
+						Json::Value json_filteredPeer(Json::objectValue);
+
+						for (auto& peerField : peerFields)
+						{
+							if (json_peer.isMember(peerField))
+								json_filteredPeer[peerField] = json_peer[peerField];
+						}
+
+						json_peer = json_filteredPeer;
+					}
+
+					writer.Value(json_peer);
+				}
+
+				writer.End();
+			}
+			else if (paginated)
+			{
+				WriteMap(writer, field, &rtpReceivers, &rtpSenders);
+			}
+			else
+			{
+				WriteMap(writer, field);
+			}
+		}
+
+		// Add `nextCursor` if there are more Peers.
+		if (pageEnd != peerIds.end())
+		{
+			writer.Key(k_nextCursor.c_str());
+			writer.Value((Json::UInt)*pageEnd);
+		}
+
+		writer.End();
+		writer.Finish();
+	}
+
+	/**
+	 * Writes the given map of RtpReceivers and RtpSenders entry by entry. If
+	 * given, just the entries of the given RtpReceivers and RtpSenders are
+	 * included.
+	 */
+	void Room::WriteMap(Channel::ResponseWriter& writer, const std::string& field,
+		const std::unordered_set<const RTC::RtpReceiver*>* rtpReceivers,
+		const std::unordered_set<const RTC::RtpSender*>* rtpSenders) const
+	{
+		MS_TRACE();
+
+		auto includeRtpReceiver = [rtpReceivers](const RTC::RtpReceiver* rtpReceiver)
+		{
+			return !rtpReceivers || rtpReceivers->find(rtpReceiver) != rtpReceivers->end();
+		};
+		auto includeRtpSender = [rtpSenders](const RTC::RtpSender* rtpSender)
+		{
+			return !rtpSenders || rtpSenders->find(rtpSender) != rtpSenders->end();
+		};
+		size_t size = 0;
+
+		if (field == "mapRtpReceiverRtpSenders")
+		{
+			for (auto& kv : this->mapRtpReceiverRtpSenders)
+			{
+				if (includeRtpReceiver(kv.first))
+					size++;
+			}
+
+			writer.StartObject(size);
+
+			for (auto& kv : this->mapRtpReceiverRtpSenders)
+			{
+				auto rtpReceiver = kv.first;
+				auto& rtpSenders = kv.second;
+				Json::Value json_rtpSenders(Json::arrayValue);
+
+				if (!includeRtpReceiver(rtpReceiver))
+					continue;
+
+				for (auto& rtpSender : rtpSenders)
+				{
+					json_rtpSenders.append(std::to_string(rtpSender->rtpSenderId));
+				}
+
+				writer.Key(std::to_string(rtpReceiver->rtpReceiverId).c_str());
+				writer.Value(json_rtpSenders);
+			}
+
+			writer.End();
+		}
+		else if (field == "mapRtpSenderRtpReceiver")
+		{
+			for (auto& kv : this->mapRtpSenderRtpReceiver)
+			{
+				if (includeRtpSender(kv.first))
+					size++;
+			}
+
+			writer.StartObject(size);
+
+			for (auto& kv : this->mapRtpSenderRtpReceiver)
+			{
+				auto rtpSender = kv.first;
+				auto rtpReceiver = kv.second;
+
+				if (!includeRtpSender(rtpSender))
+					continue;
+
+				writer.Key(std::to_string(rtpSender->rtpSenderId).c_str());
+				writer.Value(std::to_string(rtpReceiver->rtpReceiverId));
+			}
+
+			writer.End();
+		}
+		else if (field == "linkedRtpReceivers")
+		{
+			for (auto& kv : this->linkedRtpReceivers)
+			{
+				if (includeRtpReceiver(kv.first))
+					size++;
+			}
+
+			writer.StartObject(size);
+
+			for (auto& kv : this->linkedRtpReceivers)
+			{
+				auto rtpReceiver = kv.first;
+				auto sourceRoom = kv.second.sourceRoom;
+
+				if (!includeRtpReceiver(rtpReceiver))
+					continue;
+
+				writer.Key(std::to_string(rtpReceiver->rtpReceiverId).c_str());
+				writer.Value(std::to_string(sourceRoom->roomId));
+			}
+
+			writer.End();
+		}
+		else if (field == "mapRtpReceiverLinkedRooms")
+		{
+			for (auto& kv : this->mapRtpReceiverLinkedRooms)
+			{
+				if (includeRtpReceiver(kv.first))
+					size++;
+			}
+
+			writer.StartObject(size);
+
+			for (auto& kv : this->mapRtpReceiverLinkedRooms)
+			{
+				auto rtpReceiver = kv.first;
+				auto& rooms = kv.second;
+				Json::Value json_rooms(Json::arrayValue);
+
+				if (!includeRtpReceiver(rtpReceiver))
+					continue;
+
+				for (auto room : rooms)
+				{
+					json_rooms.append(std::to_string(room->roomId));
+				}
+
+				writer.Key(std::to_string(rtpReceiver->rtpReceiverId).c_str());
+				writer.Value(json_rooms);
+			}
+
+			writer.End();
+		}
+	}
+
 	void Room::HandleRequest(Channel::Request* request)
 	{
 		MS_TRACE();
@@ -222,9 +764,7 @@ namespace RTC
 
 			case Channel::Request::MethodId::room_dump:
 			{
-				Json::Value json = toJson();
-
-				request->Accept(json);
+				Dump(request);
 
 				break;
 			}
@@ -273,6 +813,7 @@ namespace RTC
 
 				// Store the new Peer.
 				this->peers[peerId] = peer;
+				this->videoLastN.AddPeer(peerId);
 
 				MS_DEBUG_DEV("Peer created [peerId:%u, peerName:'%s']", peerId, peerName.c_str());
 
@@ -289,14 +830,20 @@ namespace RTC
 			case Channel::Request::MethodId::transport_close:
 			case Channel::Request::MethodId::transport_dump:
 			case Channel::Request::MethodId::transport_setRemoteDtlsParameters:
+			case Channel::Request::MethodId::transport_setPacer:
+			case Channel::Request::MethodId::transport_dumpPacketTrace:
 			case Channel::Request::MethodId::rtpReceiver_close:
 			case Channel::Request::MethodId::rtpReceiver_dump:
 			case Channel::Request::MethodId::rtpReceiver_receive:
 			case Channel::Request::MethodId::rtpReceiver_setRtpRawEvent:
 			case Channel::Request::MethodId::rtpReceiver_setRtpObjectEvent:
+			case Channel::Request::MethodId::rtpReceiver_setRtpRawRing:
+			case Channel::Request::MethodId::rtpReceiver_setRecording:
 			case Channel::Request::MethodId::rtpSender_dump:
 			case Channel::Request::MethodId::rtpSender_setTransport:
 			case Channel::Request::MethodId::rtpSender_disable:
+			case Channel::Request::MethodId::rtpSender_setTargetEncoding:
+			case Channel::Request::MethodId::rtpSender_setTargetLayers:
 			{
 				RTC::Peer* peer;
 
@@ -330,33 +877,99 @@ namespace RTC
 		}
 	}
 
-	RTC::Peer* Room::GetPeerFromRequest(Channel::Request* request, uint32_t* peerId) const
+	/**
+	 * Forwards a RtpReceiver of the given Room to the Peers of this Room. The
+	 * link is removed once the RtpReceiver or any of both Rooms is closed.
+	 */
+	void Room::LinkRtpReceiver(Channel::Request* request, RTC::Room* sourceRoom)
 	{
 		MS_TRACE();
 
-		static const Json::StaticString k_peerId("peerId");
-
-		auto json_peerId = request->internal[k_peerId];
+		static const Json::StaticString k_rtpReceiverId("rtpReceiverId");
 
-		if (!json_peerId.isUInt())
-			MS_THROW_ERROR("Request has not numeric .peerId field");
+		if (!request->internal[k_rtpReceiverId].isUInt())
+		{
+			request->Reject("Request has not numeric internal.rtpReceiverId");
+			return;
+		}
 
-		// If given, fill peerId.
-		if (peerId)
-			*peerId = json_peerId.asUInt();
+		RTC::Peer* sourcePeer;
+		RTC::RtpReceiver* rtpReceiver = sourceRoom->GetRtpReceiver(
+			request->internal[k_rtpReceiverId].asUInt(), &sourcePeer);
 
-		auto it = this->peers.find(json_peerId.asUInt());
-		if (it != this->peers.end())
+		if (!rtpReceiver)
 		{
-			RTC::Peer* peer = it->second;
+			request->Reject("RtpReceiver does not exist in the source Room");
+			return;
+		}
 
-			return peer;
+		// It must be ready (its Room has created its RtpSenders).
+		if (sourceRoom->mapRtpReceiverRtpSenders.find(rtpReceiver) == sourceRoom->mapRtpReceiverRtpSenders.end())
+		{
+			request->Reject("RtpReceiver has no parameters yet");
+			return;
 		}
-		else
+
+		if (this->linkedRtpReceivers.find(rtpReceiver) != this->linkedRtpReceivers.end())
 		{
-			return nullptr;
+			request->Reject("RtpReceiver already linked");
+			return;
 		}
-	}
+
+		auto& linked = this->linkedRtpReceivers[rtpReceiver];
+
+		linked.sourceRoom = sourceRoom;
+		linked.sourcePeer = sourcePeer;
+
+		sourceRoom->mapRtpReceiverLinkedRooms[rtpReceiver].insert(this);
+
+		// Ensure the entry will exist even with an empty array.
+		this->mapRtpReceiverRtpSenders[rtpReceiver];
+
+		for (auto& kv : this->peers)
+		{
+			RTC::Peer* sender_peer = kv.second;
+
+			// Skip Peer with capabilities not set yet.
+			if (!sender_peer->HasCapabilities())
+				continue;
+
+			AddLinkedRtpSender(sender_peer, rtpReceiver, sourcePeer);
+		}
+
+		MS_DEBUG_DEV("RtpReceiver linked [rtpReceiverId:%" PRIu32 ", sourceRoomId:%" PRIu32 "]",
+			rtpReceiver->rtpReceiverId, sourceRoom->roomId);
+
+		request->Accept();
+	}
+
+	RTC::Peer* Room::GetPeerFromRequest(Channel::Request* request, uint32_t* peerId) const
+	{
+		MS_TRACE();
+
+		static const Json::StaticString k_peerId("peerId");
+
+		auto json_peerId = request->internal[k_peerId];
+
+		if (!json_peerId.isUInt())
+			MS_THROW_ERROR("Request has not numeric .peerId field");
+
+		// If given, fill peerId.
+		if (peerId)
+			*peerId = json_peerId.asUInt();
+
+		auto it = this->peers.find(json_peerId.asUInt());
+		if (it != this->peers.end())
+		{
+			RTC::Peer* peer = it->second;
+
+			return peer;
+		}
+		else
+		{
+			return nullptr;
+		}
+	}
 
 	void Room::SetCapabilities(std::vector<RTC::RtpCodecParameters>& mediaCodecs)
 	{
@@ -430,6 +1043,119 @@ namespace RTC
 				// Append the codec to the room capabilities.
 				this->capabilities.codecs.push_back(mediaCodec);
 			}
+
+			// Add a RTX codec for each video codec.
+			static std::string k_rtx = "video/rtx";
+			static std::string k_apt = "apt";
+
+			for (auto& mediaCodec : mediaCodecs)
+			{
+				if (mediaCodec.kind != RTC::Media::Kind::VIDEO)
+					continue;
+
+				RTC::RtpCodecParameters rtxCodec;
+
+				rtxCodec.kind = RTC::Media::Kind::VIDEO;
+				rtxCodec.mime.SetName(k_rtx);
+				rtxCodec.clockRate = mediaCodec.clockRate;
+				rtxCodec.parameters.SetInteger(k_apt, mediaCodec.payloadType);
+
+				while (dynamicPayloadTypeIt != dynamicPayloadTypes.end())
+				{
+					uint8_t payloadType = *dynamicPayloadTypeIt;
+
+					++dynamicPayloadTypeIt;
+
+					if (roomPayloadTypes.find(payloadType) == roomPayloadTypes.end())
+					{
+						rtxCodec.payloadType = payloadType;
+						rtxCodec.hasPayloadType = true;
+
+						break;
+					}
+				}
+
+				if (!rtxCodec.hasPayloadType)
+					MS_THROW_ERROR("no more available dynamic payload types for given media codecs");
+
+				roomPayloadTypes.insert(rtxCodec.payloadType);
+
+				this->capabilities.codecs.push_back(rtxCodec);
+			}
+
+			// Add a FlexFEC codec if there is video.
+			static std::string k_flexfec = "video/flexfec-03";
+
+			if (roomKinds.find(RTC::Media::Kind::VIDEO) != roomKinds.end())
+			{
+				RTC::RtpCodecParameters fecCodec;
+
+				fecCodec.kind = RTC::Media::Kind::VIDEO;
+				fecCodec.mime.SetName(k_flexfec);
+				fecCodec.clockRate = 90000;
+
+				while (dynamicPayloadTypeIt != dynamicPayloadTypes.end())
+				{
+					uint8_t payloadType = *dynamicPayloadTypeIt;
+
+					++dynamicPayloadTypeIt;
+
+					if (roomPayloadTypes.find(payloadType) == roomPayloadTypes.end())
+					{
+						fecCodec.payloadType = payloadType;
+						fecCodec.hasPayloadType = true;
+
+						break;
+					}
+				}
+
+				if (!fecCodec.hasPayloadType)
+					MS_THROW_ERROR("no more available dynamic payload types for given media codecs");
+
+				roomPayloadTypes.insert(fecCodec.payloadType);
+
+				this->capabilities.codecs.push_back(fecCodec);
+			}
+
+			// Add a RED codec if there is Opus.
+			static std::string k_red = "audio/red";
+
+			auto opusIt = std::find_if(mediaCodecs.begin(), mediaCodecs.end(), [](const RTC::RtpCodecParameters& mediaCodec)
+			{
+				return mediaCodec.mime.subtype == RTC::RtpCodecMime::Subtype::OPUS;
+			});
+
+			if (opusIt != mediaCodecs.end())
+			{
+				RTC::RtpCodecParameters redCodec;
+
+				redCodec.kind = RTC::Media::Kind::AUDIO;
+				redCodec.mime.SetName(k_red);
+				redCodec.clockRate = opusIt->clockRate;
+				redCodec.numChannels = opusIt->numChannels;
+
+				while (dynamicPayloadTypeIt != dynamicPayloadTypes.end())
+				{
+					uint8_t payloadType = *dynamicPayloadTypeIt;
+
+					++dynamicPayloadTypeIt;
+
+					if (roomPayloadTypes.find(payloadType) == roomPayloadTypes.end())
+					{
+						redCodec.payloadType = payloadType;
+						redCodec.hasPayloadType = true;
+
+						break;
+					}
+				}
+
+				if (!redCodec.hasPayloadType)
+					MS_THROW_ERROR("no more available dynamic payload types for given media codecs");
+
+				roomPayloadTypes.insert(redCodec.payloadType);
+
+				this->capabilities.codecs.push_back(redCodec);
+			}
 		}
 
 		// Add supported RTP header extensions.
@@ -439,11 +1165,117 @@ namespace RTC
 		this->capabilities.fecMechanisms = Room::supportedRtpCapabilities.fecMechanisms;
 	}
 
+	/**
+	 * Pauses or resumes the video RtpSenders of every Peer according to the
+	 * current last-N.
+	 */
+	void Room::UpdateVideoLastN()
+	{
+		MS_TRACE();
+
+		if (!this->videoLastN.GetLastN())
+			return;
+
+		std::unordered_map<RTC::RtpReceiver*, RTC::Peer*> mapRtpReceiverPeer;
+
+		for (auto& kv : this->peers)
+		{
+			RTC::Peer* peer = kv.second;
+
+			for (auto rtpReceiver : peer->GetRtpReceivers())
+			{
+				mapRtpReceiverPeer[rtpReceiver] = peer;
+			}
+		}
+
+		for (auto& kv : this->peers)
+		{
+			RTC::Peer* sender_peer = kv.second;
+
+			for (auto rtpSender : sender_peer->GetRtpSenders())
+			{
+				if (rtpSender->kind != RTC::Media::Kind::VIDEO)
+					continue;
+
+				auto it = this->mapRtpSenderRtpReceiver.find(rtpSender);
+
+				if (it == this->mapRtpSenderRtpReceiver.end())
+					continue;
+
+				auto it2 = mapRtpReceiverPeer.find(it->second);
+
+				if (it2 == mapRtpReceiverPeer.end())
+					continue;
+
+				rtpSender->SetPaused(!this->videoLastN.IsForwarded(it2->second->peerId, sender_peer->peerId));
+			}
+		}
+	}
+
+	RTC::RtpReceiver* Room::GetRtpReceiver(uint32_t rtpReceiverId, RTC::Peer** peer) const
+	{
+		MS_TRACE();
+
+		for (auto& kv : this->peers)
+		{
+			for (auto rtpReceiver : kv.second->GetRtpReceivers())
+			{
+				if (rtpReceiver->rtpReceiverId == rtpReceiverId)
+				{
+					*peer = kv.second;
+
+					return rtpReceiver;
+				}
+			}
+		}
+
+		return nullptr;
+	}
+
+	void Room::AddLinkedRtpSender(RTC::Peer* peer, RTC::RtpReceiver* rtpReceiver, RTC::Peer* sourcePeer)
+	{
+		MS_TRACE();
+
+		uint32_t rtpSenderId = Utils::Crypto::GetRandomUInt(10000000, 99999999);
+		RTC::RtpSender* rtpSender = new RTC::RtpSender(peer, this->notifier, rtpSenderId, rtpReceiver->kind);
+
+		// Store into the maps.
+		this->mapRtpReceiverRtpSenders[rtpReceiver].insert(rtpSender);
+		this->mapRtpSenderRtpReceiver[rtpSender] = rtpReceiver;
+
+		// Attach the RtpSender to peer.
+		peer->AddRtpSender(rtpSender, sourcePeer->peerName, rtpReceiver->GetParameters());
+	}
+
+	void Room::UpdateLinkedRtpReceiver(RTC::RtpReceiver* rtpReceiver)
+	{
+		MS_TRACE();
+
+		for (auto rtpSender : this->mapRtpReceiverRtpSenders[rtpReceiver])
+		{
+			rtpSender->Send(rtpReceiver->GetParameters());
+		}
+	}
+
+	void Room::UnlinkRtpReceiver(RTC::RtpReceiver* rtpReceiver)
+	{
+		MS_TRACE();
+
+		this->linkedRtpReceivers.erase(rtpReceiver);
+
+		CloseRtpSenders(rtpReceiver);
+	}
+
 	void Room::onPeerClosed(RTC::Peer* peer)
 	{
 		MS_TRACE();
 
 		this->peers.erase(peer->peerId);
+
+		this->videoLastN.RemovePeer(peer->peerId);
+
+		// Its place in the last-N may be taken by other Peer.
+		UpdateVideoLastN();
 	}
 
 	void Room::onPeerCapabilities(RTC::Peer* peer, RTC::RtpCapabilities* capabilities)
@@ -452,18 +1284,34 @@ namespace RTC
 
 		// Remove those peer's capabilities not supported by the room.
 
+		static std::string k_apt = "apt";
+
+		// Peer's media codec PTs mapped to the room ones.
+		std::map<uint8_t, uint8_t> mapPayloadTypes;
+
 		// Remove unsupported codecs and set the same PT.
 		for (auto it = capabilities->codecs.begin(); it != capabilities->codecs.end();)
 		{
 			auto& peerCodecCapability = *it;
 			auto it2 = this->capabilities.codecs.begin();
 
+			// RTX codecs are handled below.
+			if (peerCodecCapability.mime.subtype == RTC::RtpCodecMime::Subtype::RTX)
+			{
+				++it;
+
+				continue;
+			}
+
 			for (; it2 != this->capabilities.codecs.end(); ++it2)
 			{
 				auto& roomCodecCapability = *it2;
 
 				if (roomCodecCapability.Matches(peerCodecCapability))
 				{
+					if (peerCodecCapability.hasPayloadType)
+						mapPayloadTypes[peerCodecCapability.payloadType] = roomCodecCapability.payloadType;
+
 					// Set the same payload type.
 					peerCodecCapability.payloadType = roomCodecCapability.payloadType;
 					peerCodecCapability.hasPayloadType = true;
@@ -481,6 +1329,47 @@ namespace RTC
 				it = capabilities->codecs.erase(it);
 		}
 
+		// Keep RTX codecs whose apt points to a supported codec and set the room
+		// PT and apt.
+		for (auto it = capabilities->codecs.begin(); it != capabilities->codecs.end();)
+		{
+			auto& peerCodecCapability = *it;
+
+			if (peerCodecCapability.mime.subtype != RTC::RtpCodecMime::Subtype::RTX)
+			{
+				++it;
+
+				continue;
+			}
+
+			auto aptIt = mapPayloadTypes.find(peerCodecCapability.parameters.GetInteger(k_apt));
+			auto it2 = this->capabilities.codecs.begin();
+
+			if (aptIt != mapPayloadTypes.end())
+			{
+				for (; it2 != this->capabilities.codecs.end(); ++it2)
+				{
+					auto& roomCodecCapability = *it2;
+
+					if (
+						roomCodecCapability.Matches(peerCodecCapability) &&
+						roomCodecCapability.parameters.GetInteger(k_apt) == aptIt->second)
+					{
+						peerCodecCapability.payloadType = roomCodecCapability.payloadType;
+						peerCodecCapability.hasPayloadType = true;
+						peerCodecCapability.parameters.SetInteger(k_apt, aptIt->second);
+
+						break;
+					}
+				}
+			}
+
+			if (aptIt != mapPayloadTypes.end() && it2 != this->capabilities.codecs.end())
+				++it;
+			else
+				it = capabilities->codecs.erase(it);
+		}
+
 		// Remove unsupported header extensions.
 		capabilities->ReduceHeaderExtensions(this->capabilities.headerExtensions);
 
@@ -502,6 +1391,9 @@ namespace RTC
 				uint32_t rtpSenderId = Utils::Crypto::GetRandomUInt(10000000, 99999999);
 				RTC::RtpSender* rtpSender = new RTC::RtpSender(peer, this->notifier, rtpSenderId, rtpReceiver->kind);
 
+				if (rtpReceiver->kind == RTC::Media::Kind::VIDEO)
+					rtpSender->SetPaused(!this->videoLastN.IsForwarded(receiver_peer->peerId, peer->peerId));
+
 				// Store into the maps.
 				this->mapRtpReceiverRtpSenders[rtpReceiver].insert(rtpSender);
 				this->mapRtpSenderRtpReceiver[rtpSender] = rtpReceiver;
@@ -510,6 +1402,12 @@ namespace RTC
 				peer->AddRtpSender(rtpSender, receiver_peer->peerName, rtpReceiver->GetParameters());
 			}
 		}
+
+		// Also the RtpReceivers linked from other Rooms.
+		for (auto& kv : this->linkedRtpReceivers)
+		{
+			AddLinkedRtpSender(peer, kv.first, kv.second.sourcePeer);
+		}
 	}
 
 	void Room::onPeerRtpReceiverParameters(RTC::Peer* peer, RTC::RtpReceiver* rtpReceiver)
@@ -518,6 +1416,12 @@ namespace RTC
 
 		MS_ASSERT(rtpReceiver->GetParameters(), "rtpReceiver->GetParameters() returns no RtpParameters");
 
+		if (rtpReceiver->kind == RTC::Media::Kind::VIDEO)
+		{
+			rtpReceiver->SetKeyFrameCacheSize(this->keyFrameCacheSize);
+			rtpReceiver->SetKeyFrameRequestWindow(this->keyFrameRequestWindow);
+		}
+
 		// If this is a new RtpReceiver, iterate all the peers but this one and
 		// create a RtpSender associated to this RtpReceiver for each Peer.
 		if (this->mapRtpReceiverRtpSenders.find(rtpReceiver) == this->mapRtpReceiverRtpSenders.end())
@@ -541,6 +1445,9 @@ namespace RTC
 				uint32_t rtpSenderId = Utils::Crypto::GetRandomUInt(10000000, 99999999);
 				RTC::RtpSender* rtpSender = new RTC::RtpSender(sender_peer, this->notifier, rtpSenderId, rtpReceiver->kind);
 
+				if (rtpReceiver->kind == RTC::Media::Kind::VIDEO)
+					rtpSender->SetPaused(!this->videoLastN.IsForwarded(peer->peerId, sender_peer->peerId));
+
 				// Store into the maps.
 				this->mapRtpReceiverRtpSenders[rtpReceiver].insert(rtpSender);
 				this->mapRtpSenderRtpReceiver[rtpSender] = rtpReceiver;
@@ -558,6 +1465,16 @@ namespace RTC
 				// Provide the RtpSender with the parameters of the RtpReceiver.
 				rtpSender->Send(rtpReceiver->GetParameters());
 			}
+
+			auto it = this->mapRtpReceiverLinkedRooms.find(rtpReceiver);
+
+			if (it != this->mapRtpReceiverLinkedRooms.end())
+			{
+				for (auto room : it->second)
+				{
+					room->UpdateLinkedRtpReceiver(rtpReceiver);
+				}
+			}
 		}
 	}
 
@@ -565,6 +1482,29 @@ namespace RTC
 	{
 		MS_TRACE();
 
+		if (rtpReceiver->kind == RTC::Media::Kind::AUDIO)
+			this->audioLevelObserver.RemoveStream(rtpReceiver->rtpReceiverId);
+
+		// Close the RtpSenders of the Rooms it is linked to.
+		auto it = this->mapRtpReceiverLinkedRooms.find(rtpReceiver);
+
+		if (it != this->mapRtpReceiverLinkedRooms.end())
+		{
+			for (auto room : it->second)
+			{
+				room->UnlinkRtpReceiver(rtpReceiver);
+			}
+
+			this->mapRtpReceiverLinkedRooms.erase(it);
+		}
+
+		CloseRtpSenders(rtpReceiver);
+	}
+
+	void Room::CloseRtpSenders(RTC::RtpReceiver* rtpReceiver)
+	{
+		MS_TRACE();
+
 		// If the RtpReceiver is in the map, iterate the map and close all the
 		// RtpSenders associated to the closed RtpReceiver.
 		if (this->mapRtpReceiverRtpSenders.find(rtpReceiver) != this->mapRtpReceiverRtpSenders.end())
@@ -602,6 +1542,81 @@ namespace RTC
 		this->mapRtpSenderRtpReceiver.erase(rtpSender);
 	}
 
+	void Room::onPeerRtpSenderKeyFrameRequired(RTC::Peer* peer, RTC::RtpSender* rtpSender, size_t encodingIndex)
+	{
+		MS_TRACE();
+
+		MS_ASSERT(this->mapRtpSenderRtpReceiver.find(rtpSender) != this->mapRtpSenderRtpReceiver.end(), "RtpSender not present in the map");
+
+		auto& rtpReceiver = this->mapRtpSenderRtpReceiver[rtpSender];
+
+		rtpReceiver->RequestKeyFrame(encodingIndex);
+	}
+
+	void Room::onPeerRtpSenderRemb(RTC::Peer* peer, RTC::RtpSender* rtpSender, uint32_t bitrate)
+	{
+		MS_TRACE();
+
+		MS_ASSERT(this->mapRtpSenderRtpReceiver.find(rtpSender) != this->mapRtpSenderRtpReceiver.end(), "RtpSender not present in the map");
+
+		auto& rtpReceiver = this->mapRtpSenderRtpReceiver[rtpSender];
+
+		rtpSender->ReceiveRemb(bitrate);
+
+		// The REMB of a linked RtpReceiver is aggregated by its own Room.
+		auto it = this->linkedRtpReceivers.find(rtpReceiver);
+
+		if (it != this->linkedRtpReceivers.end())
+			it->second.sourceRoom->UpdateRemb(rtpReceiver);
+		else
+			UpdateRemb(rtpReceiver);
+	}
+
+	void Room::UpdateRemb(RTC::RtpReceiver* rtpReceiver)
+	{
+		MS_TRACE();
+
+		auto transport = rtpReceiver->GetTransport();
+
+		if (!transport)
+			return;
+
+		uint64_t now = DepLibUV::GetTime();
+		std::vector<uint32_t> bitrates;
+
+		GetRembBitrates(rtpReceiver, now, bitrates);
+
+		auto it = this->mapRtpReceiverLinkedRooms.find(rtpReceiver);
+
+		if (it != this->mapRtpReceiverLinkedRooms.end())
+		{
+			for (auto room : it->second)
+			{
+				room->GetRembBitrates(rtpReceiver, now, bitrates);
+			}
+		}
+
+		transport->SetRtpReceiverRemb(rtpReceiver, this->rembAggregator.Aggregate(bitrates));
+	}
+
+	void Room::GetRembBitrates(RTC::RtpReceiver* rtpReceiver, uint64_t now, std::vector<uint32_t>& bitrates)
+	{
+		MS_TRACE();
+
+		auto it = this->mapRtpReceiverRtpSenders.find(rtpReceiver);
+
+		if (it == this->mapRtpReceiverRtpSenders.end())
+			return;
+
+		for (auto& rtpSender : it->second)
+		{
+			uint32_t rembBitrate = rtpSender->GetRembBitrate(now);
+
+			if (rtpSender->GetActive() && rembBitrate)
+				bitrates.push_back(rembBitrate);
+		}
+	}
+
 	void Room::onPeerRtpPacket(RTC::Peer* peer, RTC::RtpReceiver* rtpReceiver, RTC::RtpPacket* packet)
 	{
 		MS_TRACE();
@@ -609,12 +1624,64 @@ namespace RTC
 		MS_ASSERT(this->mapRtpReceiverRtpSenders.find(rtpReceiver) != this->mapRtpReceiverRtpSenders.end(), "RtpReceiver not present in the map");
 
 		auto& rtpSenders = this->mapRtpReceiverRtpSenders[rtpReceiver];
+		auto it = this->mapRtpReceiverLinkedRooms.find(rtpReceiver);
+
+		// Forward it to the Rooms it is linked to (the audio policies of this
+		// Room don't apply to them).
+		if (it != this->mapRtpReceiverLinkedRooms.end())
+		{
+			for (auto room : it->second)
+			{
+				room->ForwardRtpPacket(rtpReceiver, packet);
+			}
+		}
+
+		// Just the loudest audio streams are forwarded if audioLastN is set, and
+		// silent packets are dropped if audioSilenceThreshold is set.
+		if (rtpReceiver->kind == RTC::Media::Kind::AUDIO)
+		{
+			bool resumed;
+
+			if (!this->audioLevelObserver.ReceivePacket(rtpReceiver->rtpReceiverId, packet, DepLibUV::GetTime(), &resumed))
+				return;
+
+			// Continue the sequence numbers of the RtpSenders without the gap of the
+			// dropped packets.
+			if (resumed)
+			{
+				for (auto& rtpSender : rtpSenders)
+				{
+					rtpSender->Resync();
+				}
+			}
+		}
+
+		ForwardRtpPacket(rtpReceiver, packet);
+	}
+
+	void Room::ForwardRtpPacket(RTC::RtpReceiver* rtpReceiver, RTC::RtpPacket* packet)
+	{
+		MS_TRACE();
+
+		auto& rtpSenders = this->mapRtpReceiverRtpSenders[rtpReceiver];
+		// Simulcast encoding (layer) the packet belongs to.
+		size_t encodingIndex = rtpReceiver->GetEncodingIndex(packet->GetSsrc());
+		// Cached key frame to prime new RtpSenders with (not needed if this
+		// packet is a key frame itself).
+		const RTC::KeyFrameCache* keyFrameCache = nullptr;
+		auto descriptor = packet->GetPayloadDescriptor();
+
+		if (descriptor && !descriptor->isKeyFrame)
+			keyFrameCache = rtpReceiver->GetKeyFrameCache(packet->GetSsrc());
 
 		// Send the RtpPacket to all the RtpSenders associated to the RtpReceiver
 		// from which it was received.
 		for (auto& rtpSender : rtpSenders)
 		{
-			rtpSender->SendRtpPacket(packet);
+			if (keyFrameCache && rtpSender->NeedsPriming(encodingIndex))
+				rtpSender->Prime(keyFrameCache, packet, encodingIndex);
+
+			rtpSender->SendRtpPacket(packet, encodingIndex);
 		}
 	}
 
@@ -635,7 +1702,25 @@ namespace RTC
 
 		auto& rtpReceiver = this->mapRtpSenderRtpReceiver[rtpSender];
 
-		rtpReceiver->ReceiveRtcpFeedback(packet);
+		switch (packet->GetMessageType())
+		{
+			// Request a key frame of the encoding being forwarded.
+			case RTCP::FeedbackPs::MessageType::PLI:
+			case RTCP::FeedbackPs::MessageType::FIR:
+			{
+				rtpReceiver->RequestKeyFrame(rtpSender->GetCurrentEncoding());
+
+				break;
+			}
+
+			default:
+			{
+				// The RtpSender may rewrite the SSRC.
+				packet->SetMediaSsrc(rtpSender->GetSourceSsrc());
+
+				rtpReceiver->ReceiveRtcpFeedback(packet);
+			}
+		}
 	}
 
 	void Room::onPeerRtcpFeedback(RTC::Peer* peer, RTC::RtpSender* rtpSender, RTC::RTCP::FeedbackRtpPacket* packet)
@@ -658,4 +1743,39 @@ namespace RTC
 
 		MS_ASSERT(this->mapRtpReceiverRtpSenders.find(rtpReceiver) != this->mapRtpReceiverRtpSenders.end(), "RtpReceiver not present in the map");
 	}
+
+	void Room::onAudioLevelObserverDominantSpeaker(RTC::AudioLevelObserver* audioLevelObserver, uint32_t streamId)
+	{
+		MS_TRACE();
+
+		static const Json::StaticString k_class("class");
+		static const Json::StaticString k_peerName("peerName");
+		static const Json::StaticString k_rtpReceiverId("rtpReceiverId");
+
+		Json::Value event_data(Json::objectValue);
+
+		// Look for the Peer of the RtpReceiver.
+		for (auto& kv : this->peers)
+		{
+			RTC::Peer* peer = kv.second;
+
+			for (auto rtpReceiver : peer->GetRtpReceivers())
+			{
+				if (rtpReceiver->rtpReceiverId != streamId)
+					continue;
+
+				event_data[k_class] = "Room";
+				event_data[k_peerName] = peer->peerName;
+				event_data[k_rtpReceiverId] = (Json::UInt)streamId;
+
+				this->notifier->Emit(this->roomId, "dominantspeakerchange", event_data);
+
+				// Move it to the front of the last-N.
+				if (this->videoLastN.SetDominantSpeaker(peer->peerId))
+					UpdateVideoLastN();
+
+				return;
+			}
+		}
+	}
 }
@@ -75,6 +75,21 @@ namespace RTC
 		this->oldestTime = newOldestTime;
 	}
 
+	Json::Value RtpDataCounter::toJson() const
+	{
+		MS_TRACE();
+
+		static const Json::StaticString k_packets("packets");
+		static const Json::StaticString k_bytes("bytes");
+
+		Json::Value json(Json::objectValue);
+
+		json[k_packets] = (Json::UInt)this->packets;
+		json[k_bytes] = (Json::UInt)this->bytes;
+
+		return json;
+	}
+
 	void RtpDataCounter::Update(RTC::RtpPacket* packet)
 	{
 		uint64_t now = DepLibUV::GetTime();
@@ -44,6 +44,7 @@ namespace RTC
 		{ "rtx",             RtpCodecMime::Subtype::RTX             },
 		{ "ulpfec",          RtpCodecMime::Subtype::ULPFEC          },
 		{ "flexfec",         RtpCodecMime::Subtype::FLEXFEC         },
+		{ "flexfec-03",      RtpCodecMime::Subtype::FLEXFEC         },
 		{ "red",             RtpCodecMime::Subtype::RED             }
 	};
 
@@ -68,7 +69,7 @@ namespace RTC
 		// Feature codecs:
 		{ RtpCodecMime::Subtype::RTX,             "rtx"             },
 		{ RtpCodecMime::Subtype::ULPFEC,          "ulpfec"          },
-		{ RtpCodecMime::Subtype::FLEXFEC,         "flexfec"         },
+		{ RtpCodecMime::Subtype::FLEXFEC,         "flexfec-03"      },
 		{ RtpCodecMime::Subtype::RED,             "red"             }
 	};
 
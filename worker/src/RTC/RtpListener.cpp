@@ -1,5 +1,6 @@
 #define MS_CLASS "RTC::RtpListener"
 // #define MS_LOG_DEV
+#define MS_LOG_HOT_PATH
 
 #include "RTC/RtpListener.hpp"
 #include "MediaSoupError.hpp"
@@ -7,6 +8,27 @@
 
 namespace RTC
 {
+	/* Class methods. */
+
+	/**
+	 * Whether the ridTable keys of the given parameters include their muxId.
+	 */
+	bool RtpListener::HasMidKey(const RTC::RtpParameters* rtpParameters)
+	{
+		MS_TRACE();
+
+		if (rtpParameters->muxId.empty())
+			return false;
+
+		for (auto& exten : rtpParameters->headerExtensions)
+		{
+			if (exten.type == RTC::RtpHeaderExtensionUri::Type::MID)
+				return true;
+		}
+
+		return false;
+	}
+
 	/* Instance methods. */
 
 	Json::Value RtpListener::toJson() const
@@ -16,11 +38,13 @@ namespace RTC
 		static const Json::StaticString k_ssrcTable("ssrcTable");
 		static const Json::StaticString k_muxIdTable("muxIdTable");
 		static const Json::StaticString k_ptTable("ptTable");
+		static const Json::StaticString k_ridTable("ridTable");
 
 		Json::Value json(Json::objectValue);
 		Json::Value json_ssrcTable(Json::objectValue);
 		Json::Value json_muxIdTable(Json::objectValue);
 		Json::Value json_ptTable(Json::objectValue);
+		Json::Value json_ridTable(Json::objectValue);
 
 		// Add `ssrcTable`.
 		for (auto& kv : this->ssrcTable)
@@ -52,6 +76,16 @@ namespace RTC
 		}
 		json[k_ptTable] = json_ptTable;
 
+		// Add `ridTable`.
+		for (auto& kv : this->ridTable)
+		{
+			auto rid = kv.first;
+			auto rtpReceiver = kv.second;
+
+			json_ridTable[rid] = std::to_string(rtpReceiver->rtpReceiverId);
+		}
+		json[k_ridTable] = json_ridTable;
+
 		return json;
 	}
 
@@ -68,6 +102,7 @@ namespace RTC
 		std::vector<uint32_t> previousSsrcs;
 		std::string previousMuxId;
 		std::vector<uint8_t> previousPayloadTypes;
+		std::vector<std::string> previousRids;
 
 		for (auto& kv : this->ssrcTable)
 		{
@@ -99,6 +134,15 @@ namespace RTC
 				previousPayloadTypes.push_back(payloadType);
 		}
 
+		for (auto& kv : this->ridTable)
+		{
+			auto& rid = kv.first;
+			auto& existingRtpReceiver = kv.second;
+
+			if (existingRtpReceiver == rtpReceiver)
+				previousRids.push_back(rid);
+		}
+
 		// First remove from the the listener tables all the entries pointing to
 		// the given RtpReceiver.
 		RemoveRtpReceiver(rtpReceiver);
@@ -122,7 +166,7 @@ namespace RTC
 					else
 					{
 						RemoveRtpReceiver(rtpReceiver);
-						RollbackRtpReceiver(rtpReceiver, previousSsrcs, previousMuxId, previousPayloadTypes);
+						RollbackRtpReceiver(rtpReceiver, previousSsrcs, previousMuxId, previousPayloadTypes, previousRids);
 
 						MS_THROW_ERROR("ssrc already exists in RTP listener [ssrc:%" PRIu32 "]", ssrc);
 					}
@@ -141,7 +185,7 @@ namespace RTC
 					else
 					{
 						RemoveRtpReceiver(rtpReceiver);
-						RollbackRtpReceiver(rtpReceiver, previousSsrcs, previousMuxId, previousPayloadTypes);
+						RollbackRtpReceiver(rtpReceiver, previousSsrcs, previousMuxId, previousPayloadTypes, previousRids);
 
 						MS_THROW_ERROR("ssrc already exists in RTP listener [ssrc:%" PRIu32 "]", ssrc);
 					}
@@ -160,7 +204,7 @@ namespace RTC
 					else
 					{
 						RemoveRtpReceiver(rtpReceiver);
-						RollbackRtpReceiver(rtpReceiver, previousSsrcs, previousMuxId, previousPayloadTypes);
+						RollbackRtpReceiver(rtpReceiver, previousSsrcs, previousMuxId, previousPayloadTypes, previousRids);
 
 						MS_THROW_ERROR("ssrc already exists in RTP listener [ssrc:%" PRIu32 "]", ssrc);
 					}
@@ -181,13 +225,39 @@ namespace RTC
 				else
 				{
 					RemoveRtpReceiver(rtpReceiver);
-					RollbackRtpReceiver(rtpReceiver, previousSsrcs, previousMuxId, previousPayloadTypes);
+					RollbackRtpReceiver(rtpReceiver, previousSsrcs, previousMuxId, previousPayloadTypes, previousRids);
 
 					MS_THROW_ERROR("muxId already exists in RTP listener [muxId:'%s']", muxId.c_str());
 				}
 			}
 		}
 
+		// Add entries into ridTable (just for encodings without SSRC).
+		{
+			std::string mid = HasMidKey(rtpParameters) ? rtpParameters->muxId : "";
+
+			for (auto& encoding : rtpParameters->encodings)
+			{
+				if (encoding.ssrc || encoding.encodingId.empty())
+					continue;
+
+				auto& rid = encoding.encodingId;
+				std::string ridKey = GetRidKey(mid, rid);
+
+				if (!this->HasRid(ridKey, rtpReceiver))
+				{
+					this->ridTable[ridKey] = rtpReceiver;
+				}
+				else
+				{
+					RemoveRtpReceiver(rtpReceiver);
+					RollbackRtpReceiver(rtpReceiver, previousSsrcs, previousMuxId, previousPayloadTypes, previousRids);
+
+					MS_THROW_ERROR("rid already exists in RTP listener [muxId:'%s', rid:'%s']", mid.c_str(), rid.c_str());
+				}
+			}
+		}
+
 		// Add entries into ptTable just if:
 		// - Not all the encoding.ssrc are given, or
 		// - Not all the encoding.rtx.ssrc are given, or
@@ -221,7 +291,7 @@ namespace RTC
 					else
 					{
 						RemoveRtpReceiver(rtpReceiver);
-						RollbackRtpReceiver(rtpReceiver, previousSsrcs, previousMuxId, previousPayloadTypes);
+						RollbackRtpReceiver(rtpReceiver, previousSsrcs, previousMuxId, previousPayloadTypes, previousRids);
 
 						MS_THROW_ERROR("payloadType already exists in RTP listener [payloadType:%" PRIu8 "]", payloadType);
 					}
@@ -260,24 +330,20 @@ namespace RTC
 			else
 				++it;
 		}
+
+		for (auto it = this->ridTable.begin(); it != this->ridTable.end();)
+		{
+			if (it->second == rtpReceiver)
+				it = this->ridTable.erase(it);
+			else
+				++it;
+		}
 	}
 
 	RTC::RtpReceiver* RtpListener::GetRtpReceiver(RTC::RtpPacket* packet)
 	{
 		MS_TRACE();
 
-		// TODO: REMOVE.
-		// uint8_t* rid_pointer = packet->GetExtensionElementValue(5);
-		// if (rid_pointer)
-		// {
-		// 	uint8_t rid_length = packet->GetExtensionElementLength(5);
-		// 	std::string rid_value = std::string((const char*)rid_pointer, (size_t)rid_length);
-
-		// 	MS_DEBUG_TAG(rtp, "RID [length:%zu, value:'%s', pointer[0]:'%c']", (size_t)rid_length, rid_value.c_str(), (char)rid_pointer[0]);
-		// 	if ((char)rid_pointer[0] == '\0')
-		// 		MS_WARN_TAG(rtp, "RID data[0] is 0");
-		// }
-
 		// First lookup into the SSRC table.
 		{
 			auto it = this->ssrcTable.find(packet->GetSsrc());
@@ -303,7 +369,45 @@ namespace RTC
 			}
 		}
 
-		// TODO: RID table? Sure.
+		// Otherwise lookup into the RID table.
+		if (!this->ridTable.empty())
+		{
+			std::string rid;
+			std::string mid;
+
+			for (auto& kv : this->ridTable)
+			{
+				auto rtpReceiver = kv.second;
+				uint8_t ridId = rtpReceiver->GetRidExtensionId();
+				uint8_t midId = rtpReceiver->GetMidExtensionId();
+
+				if (!ridId)
+					continue;
+
+				packet->AddExtensionMapping(RtpHeaderExtensionUri::Type::RTP_STREAM_ID, ridId);
+
+				if (!packet->ReadRid(rid))
+					continue;
+
+				mid.clear();
+
+				if (midId && !rtpReceiver->GetParameters()->muxId.empty())
+				{
+					packet->AddExtensionMapping(RtpHeaderExtensionUri::Type::MID, midId);
+
+					if (!packet->ReadMid(mid))
+						continue;
+				}
+
+				if (GetRidKey(mid, rid) == kv.first)
+				{
+					// Update SSRC table.
+					this->ssrcTable[packet->GetSsrc()] = rtpReceiver;
+
+					return rtpReceiver;
+				}
+			}
+		}
 
 		// Otherwise lookup into the muxId table.
 		// TODO: do it.
@@ -342,7 +446,7 @@ namespace RTC
 		return nullptr;
 	}
 
-	void RtpListener::RollbackRtpReceiver(RTC::RtpReceiver* rtpReceiver, std::vector<uint32_t>& previousSsrcs, std::string& previousMuxId, std::vector<uint8_t>& previousPayloadTypes)
+	void RtpListener::RollbackRtpReceiver(RTC::RtpReceiver* rtpReceiver, std::vector<uint32_t>& previousSsrcs, std::string& previousMuxId, std::vector<uint8_t>& previousPayloadTypes, std::vector<std::string>& previousRids)
 	{
 		MS_TRACE();
 
@@ -358,5 +462,10 @@ namespace RTC
 		{
 			this->ptTable[payloadType] = rtpReceiver;
 		}
+
+		for (auto& rid : previousRids)
+		{
+			this->ridTable[rid] = rtpReceiver;
+		}
 	}
 }
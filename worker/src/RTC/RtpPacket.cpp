@@ -1,7 +1,9 @@
 #define MS_CLASS "RTC::RtpPacket"
 // #define MS_LOG_DEV
+#define MS_LOG_HOT_PATH
 
 #include "RTC/RtpPacket.hpp"
+#include "RTC/Codecs/Tools.hpp"
 #include "Logger.hpp"
 #include <cstring> // std::memcpy()
 
@@ -163,6 +165,16 @@ namespace RTC
 		MS_DUMP("</RtpPacket>");
 	}
 
+	bool RtpPacket::ParsePayloadDescriptor(const RTC::RtpCodecMime& mime)
+	{
+		MS_TRACE();
+
+		this->payloadDescriptor = RTC::Codecs::PayloadDescriptor();
+		this->hasPayloadDescriptor = RTC::Codecs::Tools::ParsePayloadDescriptor(mime, this->payload, this->payloadLength, this->payloadDescriptor);
+
+		return this->hasPayloadDescriptor;
+	}
+
 	void RtpPacket::Serialize(uint8_t* buffer)
 	{
 		MS_TRACE();
@@ -288,9 +300,115 @@ namespace RTC
 		// Clone the extension map.
 		packet->extensionMap = this->extensionMap;
 
+		// Clone the payload descriptor (offsets are relative to the payload).
+		packet->payloadDescriptor = this->payloadDescriptor;
+		packet->hasPayloadDescriptor = this->hasPayloadDescriptor;
+
 		return packet;
 	}
 
+	/**
+	 * Turns this packet into a RFC 4588 RTX packet with the given payload type,
+	 * SSRC and sequence number. The original sequence number is prepended to
+	 * the payload so the buffer must have room for 2 more bytes. Padding is
+	 * removed.
+	 */
+	void RtpPacket::RtxEncode(uint8_t payloadType, uint32_t ssrc, uint16_t seq)
+	{
+		MS_TRACE();
+
+		uint8_t* payload = const_cast<uint8_t*>(GetData()) + this->size - this->payloadPadding - this->payloadLength;
+
+		std::memmove(payload + 2, payload, this->payloadLength);
+		Utils::Byte::Set2Bytes(payload, 0, GetSequenceNumber());
+
+		this->payload = payload;
+		this->payloadLength += 2;
+		this->size = this->size + 2 - this->payloadPadding;
+		this->payloadPadding = 0;
+		this->header->padding = 0;
+
+		SetPayloadType(payloadType);
+		SetSsrc(ssrc);
+		SetSequenceNumber(seq);
+	}
+
+	/**
+	 * Restores the original packet out of a RFC 4588 RTX packet. Returns false
+	 * if the payload does not even contain the original sequence number.
+	 */
+	bool RtpPacket::RtxDecode(uint8_t payloadType, uint32_t ssrc)
+	{
+		MS_TRACE();
+
+		if (this->payloadLength < 2)
+			return false;
+
+		uint16_t seq = Utils::Byte::Get2Bytes(this->payload, 0);
+
+		// Move the original payload (and padding) over the sequence number.
+		std::memmove(this->payload, this->payload + 2, this->payloadLength - 2 + this->payloadPadding);
+
+		this->payloadLength -= 2;
+		this->size -= 2;
+
+		if (this->payloadLength == 0)
+			this->payload = nullptr;
+
+		SetPayloadType(payloadType);
+		SetSsrc(ssrc);
+		SetSequenceNumber(seq);
+
+		return true;
+	}
+
+	/**
+	 * Keeps just the primary encoding of a RFC 2198 RED packet. Returns false if
+	 * the RED headers are wrong.
+	 */
+	bool RtpPacket::RedDecode()
+	{
+		MS_TRACE();
+
+		size_t offset = 0;
+		size_t redundantLength = 0;
+
+		// Redundant block headers (F=1) take 4 bytes and the primary one just 1.
+		while (true)
+		{
+			if (offset >= this->payloadLength)
+				return false;
+
+			if (!(this->payload[offset] & 0x80))
+				break;
+
+			if (offset + 4 > this->payloadLength)
+				return false;
+
+			redundantLength += Utils::Byte::Get2Bytes(this->payload, offset + 2) & 0x03FF;
+			offset += 4;
+		}
+
+		uint8_t payloadType = this->payload[offset] & 0x7F;
+		size_t primaryOffset = offset + 1 + redundantLength;
+
+		if (primaryOffset > this->payloadLength)
+			return false;
+
+		// Move the primary payload (and padding) to the start of the payload.
+		std::memmove(this->payload, this->payload + primaryOffset, this->payloadLength - primaryOffset + this->payloadPadding);
+
+		this->payloadLength -= primaryOffset;
+		this->size -= primaryOffset;
+
+		if (this->payloadLength == 0)
+			this->payload = nullptr;
+
+		SetPayloadType(payloadType);
+
+		return true;
+	}
+
 	void RtpPacket::ParseExtensions()
 	{
 		MS_TRACE();
@@ -0,0 +1,164 @@
+#define MS_CLASS "RTC::RtpRawRing"
+// #define MS_LOG_DEV
+
+#include "RTC/RtpRawRing.hpp"
+#include "MediaSoupError.hpp"
+#include "Logger.hpp"
+#include <cstring> // std::memcpy(), std::memset(), std::strerror()
+#include <cerrno>
+#include <sys/mman.h> // shm_open(), shm_unlink(), mmap(), munmap()
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h> // ftruncate(), close()
+
+#define RECORD_ALIGN(x) (((x) + 7) & ~((size_t)7))
+
+namespace RTC
+{
+	/* Class variables. */
+
+	constexpr uint32_t RtpRawRing::Magic;
+	constexpr uint32_t RtpRawRing::Version;
+	constexpr size_t RtpRawRing::HeaderSize;
+	constexpr size_t RtpRawRing::DefaultSize;
+	constexpr size_t RtpRawRing::MinSize;
+	constexpr size_t RtpRawRing::MaxSize;
+
+	static_assert(sizeof(RtpRawRing::Header) <= RtpRawRing::HeaderSize, "RtpRawRing::Header too big");
+	static_assert(sizeof(RtpRawRing::RecordHeader) == 16, "RtpRawRing::RecordHeader must be 16 bytes");
+
+	/* Instance methods. */
+
+	RtpRawRing::RtpRawRing(const std::string& name, size_t size) :
+		name(name)
+	{
+		MS_TRACE();
+
+		if (size < MinSize || size > MaxSize)
+			MS_THROW_ERROR("invalid ring size (must be between %zu and %zu bytes)", MinSize, MaxSize);
+
+		// Data area must be a multiple of the record alignment.
+		this->dataSize = (uint32_t)(size & ~((size_t)7));
+		this->memSize = HeaderSize + this->dataSize;
+
+		// Remove a stale object with the same name (if any).
+		shm_unlink(this->name.c_str());
+
+		this->fd = shm_open(this->name.c_str(), O_CREAT | O_EXCL | O_RDWR, S_IRUSR | S_IWUSR);
+		if (this->fd == -1)
+			MS_THROW_ERROR("shm_open() failed: %s", std::strerror(errno));
+
+		if (ftruncate(this->fd, (off_t)this->memSize) == -1)
+		{
+			int err = errno;
+
+			close(this->fd);
+			shm_unlink(this->name.c_str());
+
+			MS_THROW_ERROR("ftruncate() failed: %s", std::strerror(err));
+		}
+
+		void* mem = mmap(nullptr, this->memSize, PROT_READ | PROT_WRITE, MAP_SHARED, this->fd, 0);
+		if (mem == MAP_FAILED)
+		{
+			int err = errno;
+
+			close(this->fd);
+			shm_unlink(this->name.c_str());
+
+			MS_THROW_ERROR("mmap() failed: %s", std::strerror(err));
+		}
+
+		this->mem = static_cast<uint8_t*>(mem);
+		this->header = reinterpret_cast<Header*>(this->mem);
+		this->data = this->mem + HeaderSize;
+
+		std::memset(this->header, 0, sizeof(Header));
+		this->header->magic = Magic;
+		this->header->version = Version;
+		this->header->dataSize = this->dataSize;
+
+		MS_DEBUG_TAG(rtp, "ring created [name:%s, size:%" PRIu32 "]", this->name.c_str(), this->dataSize);
+	}
+
+	RtpRawRing::~RtpRawRing()
+	{
+		MS_TRACE();
+
+		if (this->mem)
+			munmap(this->mem, this->memSize);
+
+		if (this->fd != -1)
+			close(this->fd);
+
+		// The consumer keeps its mapping alive, but the name goes away.
+		shm_unlink(this->name.c_str());
+	}
+
+	bool RtpRawRing::Write(const RTC::RtpPacket* packet, uint64_t now)
+	{
+		MS_TRACE();
+
+		size_t packetSize = packet->GetSize();
+		size_t recordSize = RECORD_ALIGN(sizeof(RecordHeader) + packetSize);
+		uint64_t writePos = this->header->writePos;
+		uint64_t readPos = __atomic_load_n(&this->header->readPos, __ATOMIC_ACQUIRE);
+		size_t offset = (size_t)(writePos % this->dataSize);
+		size_t tail = this->dataSize - offset;
+		size_t needed = recordSize;
+
+		// Not enough contiguous room until the end, so a wrap record is needed.
+		if (tail < recordSize)
+			needed += tail;
+
+		if (needed > this->dataSize - (size_t)(writePos - readPos))
+		{
+			// Consumer is too slow, drop the packet.
+			__atomic_store_n(&this->header->dropped, this->header->dropped + 1, __ATOMIC_RELAXED);
+
+			return false;
+		}
+
+		if (tail < recordSize)
+		{
+			reinterpret_cast<RecordHeader*>(this->data + offset)->size = 0;
+			writePos += tail;
+			offset = 0;
+		}
+
+		RecordHeader* record = reinterpret_cast<RecordHeader*>(this->data + offset);
+
+		record->size = (uint32_t)packetSize;
+		record->ssrc = packet->GetSsrc();
+		record->time = now;
+		std::memcpy(this->data + offset + sizeof(RecordHeader), packet->GetData(), packetSize);
+
+		// Publish the record.
+		__atomic_store_n(&this->header->writePos, writePos + recordSize, __ATOMIC_RELEASE);
+
+		this->writtenPackets++;
+
+		return true;
+	}
+
+	Json::Value RtpRawRing::toJson() const
+	{
+		MS_TRACE();
+
+		static const Json::StaticString k_name("name");
+		static const Json::StaticString k_size("size");
+		static const Json::StaticString k_headerSize("headerSize");
+		static const Json::StaticString k_writtenPackets("writtenPackets");
+		static const Json::StaticString k_droppedPackets("droppedPackets");
+
+		Json::Value json(Json::objectValue);
+
+		json[k_name] = this->name;
+		json[k_size] = (Json::UInt)this->dataSize;
+		json[k_headerSize] = (Json::UInt)HeaderSize;
+		json[k_writtenPackets] = (Json::UInt64)this->writtenPackets;
+		json[k_droppedPackets] = (Json::UInt64)this->header->dropped;
+
+		return json;
+	}
+}
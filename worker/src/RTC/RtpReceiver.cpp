@@ -1,13 +1,20 @@
 #define MS_CLASS "RTC::RtpReceiver"
 // #define MS_LOG_DEV
+#define MS_LOG_HOT_PATH
 
 #include "RTC/RtpReceiver.hpp"
 #include "RTC/Transport.hpp"
 #include "RTC/RTCP/FeedbackRtp.hpp"
 #include "RTC/RTCP/FeedbackRtpNack.hpp"
 #include "RTC/RTCP/FeedbackPsPli.hpp"
+#include "RTC/RTCP/FeedbackPsFir.hpp"
+#include "DepLibUV.hpp"
 #include "MediaSoupError.hpp"
 #include "Logger.hpp"
+#include <string>
+#include <vector>
+#include <memory> // std::unique_ptr
+#include <unistd.h> // getpid()
 
 namespace RTC
 {
@@ -29,16 +36,31 @@ namespace RTC
 			this->maxRtcpInterval = RTC::RTCP::MAX_AUDIO_INTERVAL_MS;
 		else
 			this->maxRtcpInterval = RTC::RTCP::MAX_VIDEO_INTERVAL_MS;
+
+		this->counters.id = this->rtpReceiverId;
+		this->counters.kind = this->kind;
+		this->counters.counter = &this->receivedCounter;
+		this->counters.rtxCounter = &this->rtxReceivedCounter;
+		RTC::Metrics::AddRtpReceiver(&this->counters);
 	}
 
 	RtpReceiver::~RtpReceiver()
 	{
 		MS_TRACE();
 
+		RTC::Metrics::RemoveRtpReceiver(&this->counters);
+
 		if (this->rtpParameters)
 			delete this->rtpParameters;
 
 		ClearRtpStreams();
+
+		if (this->rtpRawRing)
+			delete this->rtpRawRing;
+
+		// It deletes itself once the file is closed.
+		if (this->recorder)
+			this->recorder->Close();
 	}
 
 	void RtpReceiver::Destroy()
@@ -70,11 +92,22 @@ namespace RTC
 		static const Json::StaticString k_hasTransport("hasTransport");
 		static const Json::StaticString k_rtpRawEventEnabled("rtpRawEventEnabled");
 		static const Json::StaticString k_rtpObjectEventEnabled("rtpObjectEventEnabled");
+		static const Json::StaticString k_rtpRawRing("rtpRawRing");
+		static const Json::StaticString k_recording("recording");
 		static const Json::StaticString k_rtpStreams("rtpStreams");
 		static const Json::StaticString k_rtpStream("rtpStream");
+		static const Json::StaticString k_keyFrameCaches("keyFrameCaches");
+		static const Json::StaticString k_keyFrameRequests("keyFrameRequests");
+		static const Json::StaticString k_useFir("useFir");
+		static const Json::StaticString k_requested("requested");
+		static const Json::StaticString k_forwarded("forwarded");
+		static const Json::StaticString k_received("received");
+		static const Json::StaticString k_rtxReceived("rtxReceived");
 
 		Json::Value json(Json::objectValue);
 		Json::Value json_rtpStreams(Json::arrayValue);
+		Json::Value json_keyFrameCaches(Json::objectValue);
+		Json::Value json_keyFrameRequests(Json::objectValue);
 
 		json[k_rtpReceiverId] = (Json::UInt)this->rtpReceiverId;
 
@@ -91,6 +124,16 @@ namespace RTC
 
 		json[k_rtpObjectEventEnabled] = this->rtpObjectEventEnabled;
 
+		if (this->rtpRawRing)
+			json[k_rtpRawRing] = this->rtpRawRing->toJson();
+		else
+			json[k_rtpRawRing] = null_data;
+
+		if (this->recorder)
+			json[k_recording] = this->recorder->toJson();
+		else
+			json[k_recording] = null_data;
+
 		for (auto& kv : this->rtpStreams)
 		{
 			auto rtpStream = kv.second;
@@ -99,6 +142,33 @@ namespace RTC
 		}
 		json[k_rtpStreams] = json_rtpStreams;
 
+		for (auto& kv : this->keyFrameCaches)
+		{
+			auto ssrc = kv.first;
+			auto keyFrameCache = kv.second;
+
+			json_keyFrameCaches[std::to_string(ssrc)] = keyFrameCache->toJson();
+		}
+		json[k_keyFrameCaches] = json_keyFrameCaches;
+
+		for (auto& kv : this->keyFrameRequests)
+		{
+			auto ssrc = kv.first;
+			auto& state = kv.second;
+			Json::Value json_state(Json::objectValue);
+
+			json_state[k_useFir] = state.useFir;
+			json_state[k_requested] = (Json::UInt)state.requested;
+			json_state[k_forwarded] = (Json::UInt)state.forwarded;
+
+			json_keyFrameRequests[std::to_string(ssrc)] = json_state;
+		}
+		json[k_keyFrameRequests] = json_keyFrameRequests;
+
+		json[k_received] = this->receivedCounter.toJson();
+
+		json[k_rtxReceived] = this->rtxReceivedCounter.toJson();
+
 		return json;
 	}
 
@@ -170,6 +240,22 @@ namespace RTC
 				// Free previous RTP streams.
 				ClearRtpStreams();
 
+				// Get the RID, MID and transport-wide-cc RTP header extension ids (if
+				// any).
+				this->ridExtensionId = 0;
+				this->midExtensionId = 0;
+				this->transportWideCc01ExtensionId = 0;
+
+				for (auto& exten : this->rtpParameters->headerExtensions)
+				{
+					if (exten.type == RTC::RtpHeaderExtensionUri::Type::RTP_STREAM_ID)
+						this->ridExtensionId = exten.id;
+					else if (exten.type == RTC::RtpHeaderExtensionUri::Type::MID)
+						this->midExtensionId = exten.id;
+					else if (exten.type == RTC::RtpHeaderExtensionUri::Type::TRANSPORT_WIDE_CC_01)
+						this->transportWideCc01ExtensionId = exten.id;
+				}
+
 				Json::Value data = this->rtpParameters->toJson();
 
 				request->Accept(data);
@@ -222,6 +308,153 @@ namespace RTC
 				break;
 			}
 
+			case Channel::Request::MethodId::rtpReceiver_setRtpRawRing:
+			{
+				static const Json::StaticString k_enabled("enabled");
+				static const Json::StaticString k_size("size");
+
+				if (!request->data[k_enabled].isBool())
+				{
+					request->Reject("Request has invalid data.enabled");
+
+					return;
+				}
+
+				// Always close the current ring (if any).
+				if (this->rtpRawRing)
+				{
+					delete this->rtpRawRing;
+					this->rtpRawRing = nullptr;
+				}
+
+				if (!request->data[k_enabled].asBool())
+				{
+					request->Accept();
+
+					return;
+				}
+
+				size_t size = RTC::RtpRawRing::DefaultSize;
+
+				if (request->data[k_size].isUInt())
+					size = (size_t)request->data[k_size].asUInt();
+
+				std::string name = "/mediasoup-" + std::to_string(getpid()) +
+					"-rtpraw-" + std::to_string(this->rtpReceiverId);
+
+				try
+				{
+					this->rtpRawRing = new RTC::RtpRawRing(name, size);
+				}
+				catch (const MediaSoupError &error)
+				{
+					request->Reject(error.what());
+
+					return;
+				}
+
+				Json::Value data = this->rtpRawRing->toJson();
+
+				request->Accept(data);
+
+				break;
+			}
+
+			case Channel::Request::MethodId::rtpReceiver_setRecording:
+			{
+				static const Json::StaticString k_enabled("enabled");
+				static const Json::StaticString k_path("path");
+				static const Json::StaticString k_format("format");
+
+				if (!request->data[k_enabled].isBool())
+				{
+					request->Reject("Request has invalid data.enabled");
+
+					return;
+				}
+
+				// Always close the current recording (if any).
+				if (this->recorder)
+				{
+					this->recorder->Close();
+					this->recorder = nullptr;
+				}
+
+				if (!request->data[k_enabled].asBool())
+				{
+					request->Accept();
+
+					return;
+				}
+
+				if (!request->data[k_path].isString() || request->data[k_path].asString().empty())
+				{
+					request->Reject("Request has invalid data.path");
+
+					return;
+				}
+
+				if (!this->rtpParameters)
+				{
+					request->Reject("RtpReceiver has no parameters");
+
+					return;
+				}
+
+				// Record the first media codec.
+				auto codecIt = this->rtpParameters->codecs.begin();
+
+				for (; codecIt != this->rtpParameters->codecs.end(); ++codecIt)
+				{
+					if (codecIt->mime.IsMediaCodec())
+						break;
+				}
+
+				if (codecIt == this->rtpParameters->codecs.end())
+				{
+					request->Reject("RtpReceiver has no media codec");
+
+					return;
+				}
+
+				auto& codec = *codecIt;
+				RTC::Recorder::Format format = RTC::Recorder::GetDefaultFormat(codec.mime);
+
+				if (request->data[k_format].isString())
+				{
+					if (!RTC::Recorder::GetFormat(request->data[k_format].asString(), format))
+					{
+						request->Reject("Request has invalid data.format");
+
+						return;
+					}
+
+					if (!RTC::Recorder::IsSupported(format, codec.mime))
+					{
+						request->Reject("format not supported by the codec");
+
+						return;
+					}
+				}
+
+				try
+				{
+					this->recorder = new RTC::Recorder(this, request->data[k_path].asString(), format, codec);
+				}
+				catch (const MediaSoupError &error)
+				{
+					request->Reject(error.what());
+
+					return;
+				}
+
+				Json::Value data = this->recorder->toJson();
+
+				request->Accept(data);
+
+				break;
+			}
+
 			default:
 			{
 				MS_ERROR("unknown method");
@@ -245,27 +478,103 @@ namespace RTC
 
 		// TODO: Check if stopped, etc (not yet done).
 
-		// Find the corresponding RtpStreamRecv.
 		auto ssrc = packet->GetSsrc();
+		auto rtxIt = this->rtxSsrcs.find(ssrc);
 
-		if (this->rtpStreams.find(ssrc) == this->rtpStreams.end())
+		// Restore the original packet out of a RTX one so it is handled as any
+		// other (late) packet of the media stream.
+		if (rtxIt != this->rtxSsrcs.end())
 		{
-			MS_WARN_TAG(rtp, "no RtpStream found for given RTP packet [ssrc:%" PRIu32 "]", ssrc);
+			auto payloadTypeIt = this->rtxPayloadTypes.find(packet->GetPayloadType());
 
-			return;
+			this->rtxReceivedCounter.Update(packet);
+
+			// NOTE: Padding only RTX packets (bandwidth probing) are discarded here.
+			if (payloadTypeIt == this->rtxPayloadTypes.end() || !packet->RtxDecode(payloadTypeIt->second, rtxIt->second))
+			{
+				MS_DEBUG_DEV("RTX packet discarded [ssrc:%" PRIu32 ", payloadType:%" PRIu8 "]",
+					ssrc, packet->GetPayloadType());
+
+				return;
+			}
+
+			ssrc = rtxIt->second;
+		}
+		else
+		{
+			this->receivedCounter.Update(packet);
+		}
+
+		// Keep just the primary encoding of RED packets (the RtpSenders add their
+		// own redundancy).
+		if (this->redPayloadTypes.find(packet->GetPayloadType()) != this->redPayloadTypes.end())
+		{
+			if (!packet->RedDecode())
+			{
+				MS_DEBUG_DEV("wrong RED packet discarded [ssrc:%" PRIu32 "]", ssrc);
+
+				return;
+			}
+		}
+
+		// Find the corresponding RtpStreamRecv.
+		RTC::RtpStreamRecv* rtpStream;
+		auto it = this->rtpStreams.find(ssrc);
+
+		if (it != this->rtpStreams.end())
+		{
+			rtpStream = it->second;
 		}
+		// It may be the first packet of an encoding announced with RID.
+		else
+		{
+			rtpStream = CreateRtpStreamForRid(packet);
 
-		auto rtpStream = this->rtpStreams[ssrc];
+			if (!rtpStream)
+			{
+				MS_WARN_TAG(rtp, "no RtpStream found for given RTP packet [ssrc:%" PRIu32 "]", ssrc);
+
+				return;
+			}
+		}
+
+		// Parse the codec payload once for all the RtpSenders (and before the
+		// RtpStreamRecv so its NACK list knows about key frames).
+		for (auto& codec : this->rtpParameters->codecs)
+		{
+			if (codec.payloadType == packet->GetPayloadType())
+			{
+				if (codec.mime.type == RTC::RtpCodecMime::Type::VIDEO)
+					packet->ParsePayloadDescriptor(codec.mime);
+
+				break;
+			}
+		}
 
 		// Process the packet.
-		// TODO: Must check what kind of packet we are checking. For example, RTX
-		// packets (once implemented) should have a different handling.
 		if (!rtpStream->ReceivePacket(packet))
 			return;
 
+		// Key frame requests may be waiting for this packet.
+		if (!this->keyFrameRequests.empty())
+			CheckKeyFrameRequest(packet);
+
 		// Notify the listener.
 		this->listener->onRtpPacket(this, packet);
 
+		// Cache the packet once forwarded so new RtpSenders primed with the cache
+		// are not given the current packet twice.
+		if (this->keyFrameCacheSize && packet->GetPayloadDescriptor())
+			CacheKeyFramePacket(packet);
+
+		// Write into the shared memory ring if enabled.
+		if (this->rtpRawRing)
+			this->rtpRawRing->Write(packet, DepLibUV::GetTime());
+
+		// Write into the recording file if enabled.
+		if (this->recorder)
+			this->recorder->ReceivePacket(packet);
+
 		// Emit "rtpraw" if enabled.
 		if (this->rtpRawEventEnabled)
 		{
@@ -301,9 +610,15 @@ namespace RTC
 		if (static_cast<float>((now - this->lastRtcpSentTime) * 1.15) < this->maxRtcpInterval)
 			return;
 
+		uint32_t rtt = this->transport ? this->transport->GetRtt() : 0;
+
 		for (auto& kv : this->rtpStreams)
 		{
 			auto rtpStream = kv.second;
+
+			if (rtt)
+				rtpStream->UpdateRtt(rtt);
+
 			RTC::RTCP::ReceiverReport* report = rtpStream->GetRtcpReceiverReport();
 
 			report->SetSsrc(rtpStream->GetSsrc());
@@ -354,13 +669,58 @@ namespace RTC
 		this->transport->SendRtcpPacket(packet);
 	}
 
+	void RtpReceiver::RequestKeyFrame(size_t encodingIndex)
+	{
+		MS_TRACE();
+
+		if (!this->rtpParameters)
+			return;
+
+		if (encodingIndex >= this->rtpParameters->encodings.size())
+			return;
+
+		// The stream may not exist yet (RID not seen).
+		HandleKeyFrameRequest(this->rtpParameters->encodings[encodingIndex].ssrc);
+	}
+
+	RTC::RtpStreamRecv* RtpReceiver::CreateRtpStreamForRid(RTC::RtpPacket* packet)
+	{
+		MS_TRACE();
+
+		if (!this->ridExtensionId)
+			return nullptr;
+
+		std::string rid;
+
+		packet->AddExtensionMapping(RTC::RtpHeaderExtensionUri::Type::RTP_STREAM_ID, this->ridExtensionId);
+
+		if (!packet->ReadRid(rid))
+			return nullptr;
+
+		for (auto& encoding : this->rtpParameters->encodings)
+		{
+			if (encoding.ssrc || encoding.encodingId != rid)
+				continue;
+
+			MS_DEBUG_TAG(rtp, "RID matched [rid:'%s', ssrc:%" PRIu32 "]", rid.c_str(), packet->GetSsrc());
+
+			// Fill the SSRC of the encoding so it is found from now on.
+			encoding.ssrc = packet->GetSsrc();
+
+			CreateRtpStream(encoding);
+
+			return this->rtpStreams[encoding.ssrc];
+		}
+
+		return nullptr;
+	}
+
 	void RtpReceiver::CreateRtpStream(RTC::RtpEncodingParameters& encoding)
 	{
 		MS_TRACE();
 
-		// Don't create an RtpStreamRecv if the encoding has no SSRC.
-		// TODO: For simulcast or, if not announced, this would be done
-		// dynamicall by the RtpListener when matching a RID with its SSRC.
+		// Don't create an RtpStreamRecv if the encoding has no SSRC. Encodings
+		// announced with RID get it once their first packet is received.
 		if (!encoding.ssrc)
 			return;
 
@@ -375,8 +735,10 @@ namespace RTC
 		auto& codec = this->rtpParameters->GetCodecForEncoding(encoding);
 		bool useNack = false;
 		bool usePli = false;
+		bool useFir = false;
 		bool useRemb = false;
 		uint8_t absSendTimeId = 0;
+		uint8_t ssrcAudioLevelId = 0;
 
 		for (auto& fb : codec.rtcpFeedback)
 		{
@@ -390,6 +752,10 @@ namespace RTC
 				MS_DEBUG_TAG(rtcp, "enabling PLI generation");
 				usePli = true;
 			}
+			else if (!useFir && fb.type == "ccm" && fb.parameter == "fir")
+			{
+				useFir = true;
+			}
 			else if (!useRemb && fb.type == "goog-remb")
 			{
 				MS_DEBUG_TAG(rbe, "enabling REMB");
@@ -403,6 +769,10 @@ namespace RTC
 			{
 				absSendTimeId = exten.id;
 			}
+			else if (!ssrcAudioLevelId && exten.type == RTC::RtpHeaderExtensionUri::Type::SSRC_AUDIO_LEVEL)
+			{
+				ssrcAudioLevelId = exten.id;
+			}
 		}
 
 		// Create stream params.
@@ -415,10 +785,39 @@ namespace RTC
 		params.useNack = useNack;
 		params.usePli = usePli;
 		params.absSendTimeId = absSendTimeId;
+		params.ssrcAudioLevelId = ssrcAudioLevelId;
 
 		// Create a RtpStreamRecv for receiving a media stream.
 		this->rtpStreams[ssrc] = new RTC::RtpStreamRecv(this, params);
 
+		// Retransmissions may come in a RTX stream.
+		if (encoding.hasRtx && encoding.rtx.ssrc)
+		{
+			static std::string k_apt = "apt";
+
+			for (auto& rtxCodec : this->rtpParameters->codecs)
+			{
+				if (
+					rtxCodec.mime.subtype == RTC::RtpCodecMime::Subtype::RTX &&
+					rtxCodec.parameters.GetInteger(k_apt) == codec.payloadType)
+				{
+					this->rtxSsrcs[encoding.rtx.ssrc] = ssrc;
+					this->rtxPayloadTypes[rtxCodec.payloadType] = codec.payloadType;
+				}
+			}
+		}
+
+		// Audio may come with RED.
+		for (auto& redCodec : this->rtpParameters->codecs)
+		{
+			if (redCodec.mime.subtype == RTC::RtpCodecMime::Subtype::RED)
+				this->redPayloadTypes.insert(redCodec.payloadType);
+		}
+
+		// Key frames can be requested just for video streams.
+		if (codec.mime.type == RTC::RtpCodecMime::Type::VIDEO)
+			this->keyFrameRequests[ssrc].useFir = useFir && !usePli;
+
 		// Enable REMB in the transport if requested.
 		if (useRemb)
 			this->transport->EnableRemb();
@@ -436,29 +835,193 @@ namespace RTC
 		}
 
 		this->rtpStreams.clear();
+		this->rtxSsrcs.clear();
+		this->rtxPayloadTypes.clear();
+		this->redPayloadTypes.clear();
+
+		// Cached packets may belong to the previous streams.
+		for (auto& kv : this->keyFrameCaches)
+		{
+			auto keyFrameCache = kv.second;
+
+			delete keyFrameCache;
+		}
+
+		this->keyFrameCaches.clear();
+
+		this->keyFrameRequests.clear();
+	}
+
+	void RtpReceiver::CacheKeyFramePacket(RTC::RtpPacket* packet)
+	{
+		MS_TRACE();
+
+		auto ssrc = packet->GetSsrc();
+		auto it = this->keyFrameCaches.find(ssrc);
+		RTC::KeyFrameCache* keyFrameCache;
+
+		if (it != this->keyFrameCaches.end())
+		{
+			keyFrameCache = it->second;
+		}
+		// Don't allocate the cache until the first key frame.
+		else
+		{
+			if (!packet->GetPayloadDescriptor()->isKeyFrame)
+				return;
+
+			keyFrameCache = new RTC::KeyFrameCache(this->keyFrameCacheSize);
+			this->keyFrameCaches[ssrc] = keyFrameCache;
+		}
+
+		keyFrameCache->ReceivePacket(packet);
 	}
 
-	void RtpReceiver::onNackRequired(RTC::RtpStreamRecv* rtpStream, uint16_t seq, uint16_t bitmask)
+	void RtpReceiver::HandleKeyFrameRequest(uint32_t ssrc)
 	{
+		MS_TRACE();
+
+		auto it = this->keyFrameRequests.find(ssrc);
+
+		if (it == this->keyFrameRequests.end())
+			return;
+
+		auto& state = it->second;
+		uint64_t now = DepLibUV::GetTime();
+
+		state.requested++;
+
+		// Merge it with the previous request (already in flight or satisfied by a
+		// recent key frame). If no key frame arrives within the window it is sent
+		// once the window ends.
+		// NOTE: Suppression just relies on the window (not on the RTT), so a
+		// request is sent again every window until a key frame arrives.
+		if (state.forwarded && now - state.lastSentTime < this->keyFrameRequestWindow)
+		{
+			state.pending = true;
+
+			return;
+		}
+
+		SendKeyFrameRequest(ssrc, state, now);
+	}
+
+	void RtpReceiver::CheckKeyFrameRequest(RTC::RtpPacket* packet)
+	{
+		MS_TRACE();
+
+		auto it = this->keyFrameRequests.find(packet->GetSsrc());
+
+		if (it == this->keyFrameRequests.end())
+			return;
+
+		auto& state = it->second;
+		auto descriptor = packet->GetPayloadDescriptor();
+
+		// The key frame satisfies all the requests received so far.
+		if (descriptor && descriptor->isKeyFrame)
+		{
+			state.pending = false;
+
+			return;
+		}
+
+		if (!state.pending)
+			return;
+
+		uint64_t now = DepLibUV::GetTime();
+
+		if (now - state.lastSentTime >= this->keyFrameRequestWindow)
+			SendKeyFrameRequest(packet->GetSsrc(), state, now);
+	}
+
+	void RtpReceiver::SendKeyFrameRequest(uint32_t ssrc, KeyFrameRequestState& state, uint64_t now)
+	{
+		MS_TRACE();
+
 		if (!this->transport)
 			return;
 
-		RTC::RTCP::FeedbackRtpNackPacket packet(0, rtpStream->GetSsrc());
-		RTC::RTCP::FeedbackRtpNackItem* nackItem = new RTC::RTCP::FeedbackRtpNackItem(seq, bitmask);
+		if (state.useFir)
+		{
+			MS_DEBUG_TAG(rtcp, "sending FIR [ssrc:%" PRIu32 "]", ssrc);
 
-		packet.AddItem(nackItem);
-		packet.Serialize(RtpReceiver::rtcpBuffer);
-		this->transport->SendRtcpPacket(&packet);
+			RTC::RTCP::FeedbackPsFirPacket packet(0, 0);
+			// Each new request has its own sequence number (RFC 5104).
+			RTC::RTCP::FeedbackPsFirItem* item = new RTC::RTCP::FeedbackPsFirItem(ssrc, ++state.firSeqNumber);
+
+			packet.AddItem(item);
+			packet.Serialize(RtpReceiver::rtcpBuffer);
+			this->transport->SendRtcpPacket(&packet);
+
+			delete item;
+		}
+		else
+		{
+			MS_DEBUG_TAG(rtcp, "sending PLI [ssrc:%" PRIu32 "]", ssrc);
+
+			RTC::RTCP::FeedbackPsPliPacket packet(0, ssrc);
+
+			packet.Serialize(RtpReceiver::rtcpBuffer);
+			this->transport->SendRtcpPacket(&packet);
+		}
+
+		state.pending = false;
+		state.lastSentTime = now;
+		state.forwarded++;
 	}
 
-	void RtpReceiver::onPliRequired(RTC::RtpStreamRecv* rtpStream)
+	void RtpReceiver::onNackRequired(RTC::RtpStreamRecv* rtpStream, const std::vector<uint16_t>& seqNumbers)
 	{
 		if (!this->transport)
 			return;
 
-		RTC::RTCP::FeedbackPsPliPacket packet(0, rtpStream->GetSsrc());
+		RTC::RTCP::FeedbackRtpNackPacket packet(0, rtpStream->GetSsrc());
+		// The packet does not own its items.
+		std::vector<std::unique_ptr<RTC::RTCP::FeedbackRtpNackItem>> items;
+		auto it = seqNumbers.begin();
+
+		// Pack the seq numbers into items (a seq number plus a bitmask of the
+		// following 16 ones).
+		while (it != seqNumbers.end())
+		{
+			uint16_t seq = *it;
+			uint16_t bitmask = 0;
+
+			for (++it; it != seqNumbers.end(); ++it)
+			{
+				uint16_t shift = *it - seq - 1;
+
+				if (shift > 15)
+					break;
+
+				bitmask |= (1 << shift);
+			}
+
+			items.emplace_back(new RTC::RTCP::FeedbackRtpNackItem(seq, bitmask));
+			packet.AddItem(items.back().get());
+		}
+
+		// Ensure that the RTCP packet fits into the RTCP buffer.
+		if (packet.GetSize() > MS_RTCP_BUFFER_SIZE)
+		{
+			MS_WARN_TAG(rtcp, "cannot send RTCP NACK packet, size too big (%zu bytes)",
+				packet.GetSize());
+
+			return;
+		}
 
 		packet.Serialize(RtpReceiver::rtcpBuffer);
 		this->transport->SendRtcpPacket(&packet);
 	}
+
+	void RtpReceiver::onPliRequired(RTC::RtpStreamRecv* rtpStream)
+	{
+		HandleKeyFrameRequest(rtpStream->GetSsrc());
+	}
+
+	void RtpReceiver::onRecorderKeyFrameRequired(RTC::Recorder* recorder, uint32_t ssrc)
+	{
+		HandleKeyFrameRequest(ssrc);
+	}
 }
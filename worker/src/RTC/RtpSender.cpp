@@ -1,13 +1,17 @@
 #define MS_CLASS "RTC::RtpSender"
 // #define MS_LOG_DEV
+#define MS_LOG_HOT_PATH
 
 #include "RTC/RtpSender.hpp"
+#include "RTC/Codecs/Tools.hpp"
 #include "RTC/RTCP/SenderReport.hpp"
 #include "RTC/RTCP/FeedbackRtpNack.hpp"
 #include "Utils.hpp"
+#include "DepLibUV.hpp"
 #include "MediaSoupError.hpp"
 #include "Logger.hpp"
 #include <unordered_set>
+#include <algorithm> // std::min()
 
 namespace RTC
 {
@@ -15,6 +19,8 @@ namespace RTC
 
 	// Can retransmit up to 17 RTP packets.
 	std::vector<RTC::RtpPacket*> RtpSender::rtpRetransmissionContainer(18);
+	// Max RTP packet size plus the RTX original sequence number.
+	uint8_t RtpSender::rtxBuffer[65536 + 2];
 
 	/* Instance methods. */
 
@@ -30,17 +36,31 @@ namespace RTC
 			this->maxRtcpInterval = RTC::RTCP::MAX_AUDIO_INTERVAL_MS;
 		else
 			this->maxRtcpInterval = RTC::RTCP::MAX_VIDEO_INTERVAL_MS;
+
+		this->counters.id = this->rtpSenderId;
+		this->counters.kind = this->kind;
+		this->counters.counter = &this->transmittedCounter;
+		this->counters.rtxCounter = &this->retransmittedCounter;
+		RTC::Metrics::AddRtpSender(&this->counters);
 	}
 
 	RtpSender::~RtpSender()
 	{
 		MS_TRACE();
 
+		RTC::Metrics::RemoveRtpSender(&this->counters);
+
 		if (this->rtpParameters)
 			delete this->rtpParameters;
 
 		if (this->rtpStream)
 			delete this->rtpStream;
+
+		if (this->fecGenerator)
+			delete this->fecGenerator;
+
+		if (this->redEncoder)
+			delete this->redEncoder;
 	}
 
 	void RtpSender::Destroy()
@@ -70,8 +90,21 @@ namespace RTC
 		static const Json::StaticString k_rtpParameters("rtpParameters");
 		static const Json::StaticString k_hasTransport("hasTransport");
 		static const Json::StaticString k_active("active");
+		static const Json::StaticString k_paused("paused");
 		static const Json::StaticString k_supportedPayloadTypes("supportedPayloadTypes");
 		static const Json::StaticString k_rtpStream("rtpStream");
+		static const Json::StaticString k_targetEncoding("targetEncoding");
+		static const Json::StaticString k_currentEncoding("currentEncoding");
+		static const Json::StaticString k_targetSpatialLayer("targetSpatialLayer");
+		static const Json::StaticString k_targetTemporalLayer("targetTemporalLayer");
+		static const Json::StaticString k_currentSpatialLayer("currentSpatialLayer");
+		static const Json::StaticString k_currentTemporalLayer("currentTemporalLayer");
+		static const Json::StaticString k_rembBitrate("rembBitrate");
+		static const Json::StaticString k_availableBitrate("availableBitrate");
+		static const Json::StaticString k_transmitted("transmitted");
+		static const Json::StaticString k_retransmitted("retransmitted");
+		static const Json::StaticString k_fec("fec");
+		static const Json::StaticString k_red("red");
 
 		Json::Value json(Json::objectValue);
 
@@ -88,6 +121,8 @@ namespace RTC
 
 		json[k_active] = this->GetActive();
 
+		json[k_paused] = this->paused;
+
 		json[k_supportedPayloadTypes] = Json::arrayValue;
 
 		for (auto payloadType : this->supportedPayloadTypes)
@@ -98,6 +133,36 @@ namespace RTC
 		if (this->rtpStream)
 			json[k_rtpStream] = this->rtpStream->toJson();
 
+		json[k_targetEncoding] = (Json::UInt)this->targetEncoding;
+
+		json[k_currentEncoding] = (Json::UInt)this->currentEncoding;
+
+		json[k_targetSpatialLayer] = (Json::UInt)this->targetSpatialLayer;
+
+		json[k_targetTemporalLayer] = (Json::UInt)this->targetTemporalLayer;
+
+		json[k_currentSpatialLayer] = (Json::UInt)this->currentSpatialLayer;
+
+		json[k_currentTemporalLayer] = (Json::UInt)this->currentTemporalLayer;
+
+		json[k_rembBitrate] = (Json::UInt)this->GetRembBitrate(DepLibUV::GetTime());
+
+		json[k_availableBitrate] = (Json::UInt)this->GetAvailableBitrate(DepLibUV::GetTime());
+
+		json[k_transmitted] = this->transmittedCounter.toJson();
+
+		json[k_retransmitted] = this->retransmittedCounter.toJson();
+
+		if (this->fecGenerator)
+			json[k_fec] = this->fecGenerator->toJson();
+		else
+			json[k_fec] = null_data;
+
+		if (this->redEncoder)
+			json[k_red] = this->redEncoder->toJson();
+		else
+			json[k_red] = null_data;
+
 		return json;
 	}
 
@@ -148,6 +213,77 @@ namespace RTC
 				break;
 			}
 
+			case Channel::Request::MethodId::rtpSender_setTargetEncoding:
+			{
+				static const Json::StaticString k_index("index");
+
+				if (!request->data[k_index].isUInt())
+				{
+					request->Reject("Request has invalid data.index");
+
+					return;
+				}
+
+				size_t index = request->data[k_index].asUInt();
+
+				if (index >= this->sourceEncodings)
+				{
+					request->Reject("encoding index out of range");
+
+					return;
+				}
+
+				if (this->targetEncoding != index)
+				{
+					this->targetEncoding = index;
+
+					// The switch happens on the next key frame of the target encoding.
+					if (this->started && this->GetActive())
+						this->listener->onRtpSenderKeyFrameRequired(this, index);
+				}
+
+				request->Accept();
+
+				break;
+			}
+
+			case Channel::Request::MethodId::rtpSender_setTargetLayers:
+			{
+				static const Json::StaticString k_spatialLayer("spatialLayer");
+				static const Json::StaticString k_temporalLayer("temporalLayer");
+
+				auto& jsonSpatialLayer = request->data[k_spatialLayer];
+				auto& jsonTemporalLayer = request->data[k_temporalLayer];
+
+				if (!jsonSpatialLayer.isNull() && !jsonSpatialLayer.isUInt())
+				{
+					request->Reject("Request has invalid data.spatialLayer");
+
+					return;
+				}
+
+				if (!jsonTemporalLayer.isNull() && !jsonTemporalLayer.isUInt())
+				{
+					request->Reject("Request has invalid data.temporalLayer");
+
+					return;
+				}
+
+				if (jsonSpatialLayer.isUInt())
+					this->targetSpatialLayer = std::min<Json::UInt>(jsonSpatialLayer.asUInt(), 255);
+
+				if (jsonTemporalLayer.isUInt())
+					this->targetTemporalLayer = std::min<Json::UInt>(jsonTemporalLayer.asUInt(), 255);
+
+				// Upper spatial layers depend on a key frame.
+				if (this->targetSpatialLayer > this->currentSpatialLayer && this->started && this->GetActive())
+					this->listener->onRtpSenderKeyFrameRequired(this, this->currentEncoding);
+
+				request->Accept();
+
+				break;
+			}
+
 			default:
 			{
 				MS_ERROR("unknown method");
@@ -190,6 +326,20 @@ namespace RTC
 			this->rtpStream = nullptr;
 		}
 
+		// Delete previous FecGenerator (if any).
+		if (this->fecGenerator)
+		{
+			delete this->fecGenerator;
+			this->fecGenerator = nullptr;
+		}
+
+		// Delete previous RedEncoder (if any).
+		if (this->redEncoder)
+		{
+			delete this->redEncoder;
+			this->redEncoder = nullptr;
+		}
+
 		// Clone given RTP parameters so we manage our own sender parameters.
 		this->rtpParameters = new RTC::RtpParameters(rtpParameters);
 
@@ -239,8 +389,22 @@ namespace RTC
 			}
 		}
 
-		// TODO: Temporal. To be refactored.
-		// Remove all the encodings but the first one.
+		// Simulcast: all the source encodings are forwarded to the remote peer as
+		// a single stream (the one selected via setTargetEncoding).
+		this->sourceEncodings = rtpParameters->encodings.empty() ? 1 : rtpParameters->encodings.size();
+
+		if (this->targetEncoding >= this->sourceEncodings)
+			this->targetEncoding = 0;
+
+		this->currentEncoding = this->targetEncoding;
+		this->started = false;
+		this->waitingKeyFrame = false;
+		this->currentSpatialLayer = this->targetSpatialLayer;
+		this->currentTemporalLayer = this->targetTemporalLayer;
+		this->pictureIdOffset = 0;
+		this->tl0PicIdxOffset = 0;
+		this->pictureDropped = false;
+
 		if (encodings.size() > 1)
 		{
 			RTC::RtpEncodingParameters encoding = encodings[0];
@@ -249,9 +413,44 @@ namespace RTC
 			encodings.push_back(encoding);
 		}
 
+		if (!encodings.empty())
+		{
+			auto& encoding = encodings[0];
+
+			// The source encoding may be announced with RID (so no SSRC yet).
+			if (!encoding.ssrc)
+				encoding.ssrc = Utils::Crypto::GetRandomUInt(100000000, 999999999);
+
+			// The RID just makes sense between the source peer and mediasoup.
+			encoding.encodingId.clear();
+			encoding.dependencyEncodingIds.clear();
+
+			SetRtx(encoding);
+			SetFec(encoding);
+			SetRed(encoding);
+		}
+
 		// Remove unsupported header extensions.
 		this->rtpParameters->ReduceHeaderExtensions(this->peerCapabilities->headerExtensions);
 
+		// Remove the RID and MID header extensions for the same reason.
+		auto& headerExtensions = this->rtpParameters->headerExtensions;
+
+		for (auto it = headerExtensions.begin(); it != headerExtensions.end();)
+		{
+			if (
+				it->type == RTC::RtpHeaderExtensionUri::Type::RTP_STREAM_ID ||
+				it->type == RTC::RtpHeaderExtensionUri::Type::MID
+			)
+			{
+				it = headerExtensions.erase(it);
+			}
+			else
+			{
+				++it;
+			}
+		}
+
 		// Set a random muxId.
 		this->rtpParameters->muxId = Utils::Crypto::GetRandomString(8);
 
@@ -281,24 +480,80 @@ namespace RTC
 		}
 	}
 
-	void RtpSender::SendRtpPacket(RTC::RtpPacket* packet)
+	void RtpSender::Prime(const RTC::KeyFrameCache* keyFrameCache, const RTC::RtpPacket* packet, size_t encodingIndex)
 	{
 		MS_TRACE();
 
-		if (!this->GetActive())
+		if (!keyFrameCache->HasKeyFrame() || !NeedsPriming(encodingIndex))
 			return;
 
-		MS_ASSERT(this->rtpStream, "no RtpStream set");
+		auto& packets = keyFrameCache->GetPackets();
+
+		// Avoid going through the cache for every packet if the codec is not
+		// supported by the remote peer.
+		if (this->supportedPayloadTypes.find(packets[0]->GetPayloadType()) == this->supportedPayloadTypes.end())
+			return;
+
+		// Without the full GOP just the key frame can be decoded.
+		size_t numPackets = keyFrameCache->IsGopComplete() ? packets.size() : keyFrameCache->GetKeyFramePackets();
 
-		// TODO: Must refactor for simulcast.
-		// Ignore the packet if the SSRC is not the single one in the sender
-		// RTP parameters.
-		if (packet->GetSsrc() != this->rtpParameters->encodings[0].ssrc)
+		MS_DEBUG_TAG(rtp, "priming with cached packets [ssrc:%" PRIu32 ", packets:%zu, gop:%s]",
+			packet->GetSsrc(), numPackets, keyFrameCache->IsGopComplete() ? "true" : "false");
+
+		for (size_t idx = 0; idx < numPackets; ++idx)
 		{
-			MS_WARN_TAG(rtp, "ignoring packet with unknown SSRC [ssrc:%" PRIu32 "]", packet->GetSsrc());
+			SendRtpPacket(packets[idx], encodingIndex);
+		}
 
+		if (!this->started || keyFrameCache->IsGopComplete())
 			return;
-		}
+
+		// Continue the output sequence right after the key frame and drop the
+		// source packets until the next key frame.
+		uint16_t seq = packet->GetSequenceNumber();
+
+		this->seqOffset = this->lastSeq + 1 - seq;
+		this->sourceSeqTracker.Sync(seq);
+		this->waitingKeyFrame = true;
+
+		this->listener->onRtpSenderKeyFrameRequired(this, encodingIndex);
+	}
+
+	void RtpSender::SetPaused(bool paused)
+	{
+		MS_TRACE();
+
+		if (this->paused == paused)
+			return;
+
+		bool wasActive = this->GetActive();
+
+		this->paused = paused;
+
+		if (wasActive == this->GetActive())
+			return;
+
+		EmitActiveChange();
+
+		if (!this->GetActive())
+			return;
+
+		// Continue the output stream without a gap for the packets not sent
+		// meanwhile (video waits for the requested key frame).
+		Resync();
+
+		if (this->kind == RTC::Media::Kind::VIDEO)
+			this->listener->onRtpSenderKeyFrameRequired(this, this->targetEncoding);
+	}
+
+	void RtpSender::SendRtpPacket(RTC::RtpPacket* packet, size_t encodingIndex)
+	{
+		MS_TRACE();
+
+		if (!this->GetActive())
+			return;
+
+		MS_ASSERT(this->rtpStream, "no RtpStream set");
 
 		// Map the payload type.
 		uint8_t payloadType = packet->GetPayloadType();
@@ -314,17 +569,147 @@ namespace RTC
 			return;
 		}
 
+		// Select the encoding to forward.
+		if (!this->started || this->resync || encodingIndex != this->currentEncoding || packet->GetSsrc() != this->sourceSsrc)
+		{
+			if (!SwitchEncoding(packet, encodingIndex))
+				return;
+		}
+
+		uint16_t seq = packet->GetSequenceNumber();
+		uint32_t timestamp = packet->GetTimestamp();
+		bool marker = packet->HasMarker();
+
+		bool isNewest;
+
+		// Ignore packets of the current encoding sent before the switching point.
+		if (!this->sourceSeqTracker.Receive(seq, &isNewest))
+			return;
+
+		// Codec payload info (parsed by the RtpReceiver).
+		const RTC::Codecs::PayloadDescriptor* descriptor = packet->GetPayloadDescriptor();
+
+		// Primed with just a key frame, so wait for the next one.
+		if (this->waitingKeyFrame)
+		{
+			if (!descriptor || !descriptor->isKeyFrame)
+			{
+				DropPacket(seq, isNewest);
+
+				return;
+			}
+
+			this->waitingKeyFrame = false;
+		}
+
+		// Drop layers above the target ones.
+		if (descriptor && !CheckLayers(*descriptor))
+		{
+			DropPacket(seq, isNewest);
+
+			return;
+		}
+
+		// Older packets get the offset that applied at their position (so the
+		// dropped packets newer than them are not taken into account).
+		uint16_t droppedAfter;
+
+		if (!this->sourceSeqTracker.GetDroppedAfter(seq, &droppedAfter))
+			return;
+
+		uint16_t outSeq = seq + this->seqOffset + droppedAfter;
+		uint32_t outTimestamp = timestamp + this->tsOffset;
+
+		// Rewrite the RTP header. The packet is shared among all the RtpSenders
+		// of the RtpReceiver so the original values are restored at the end.
+		packet->SetSsrc(this->rtpParameters->encodings[0].ssrc);
+		packet->SetSequenceNumber(outSeq);
+		packet->SetTimestamp(outTimestamp);
+
+		// Rewrite the payload descriptor.
+		if (descriptor)
+		{
+			uint8_t* payload = packet->GetPayload();
+
+			// Make picture ids continuous after switching encoding.
+			if (this->resyncPictureId)
+			{
+				this->pictureIdOffset = descriptor->pictureId - (this->lastPictureId + 1);
+				this->tl0PicIdxOffset = descriptor->tl0PicIdx - (this->lastTl0PicIdx + 1);
+				this->resyncPictureId = false;
+			}
+
+			if (descriptor->hasPictureId)
+			{
+				this->lastPictureId = (descriptor->pictureId - this->pictureIdOffset) & 0x7FFF;
+
+				RTC::Codecs::Tools::SetPictureId(payload, *descriptor, this->lastPictureId);
+			}
+
+			if (descriptor->hasTl0PicIdx)
+			{
+				this->lastTl0PicIdx = descriptor->tl0PicIdx - this->tl0PicIdxOffset;
+
+				RTC::Codecs::Tools::SetTl0PicIdx(payload, *descriptor, this->lastTl0PicIdx);
+			}
+
+			// The last forwarded spatial layer ends the picture.
+			if (descriptor->hasSpatialLayers && descriptor->endOfFrame && descriptor->spatialLayer == this->currentSpatialLayer)
+				packet->SetMarker(true);
+		}
+
+		// Add the redundant payloads of the previous packets (if any).
+		RTC::RtpPacket* redPacket = this->redEncoder ? this->redEncoder->Encode(packet) : nullptr;
+		RTC::RtpPacket* sentPacket = redPacket ? redPacket : packet;
+
 		// Process the packet.
 		// TODO: Must check what kind of packet we are checking. For example, RTX
 		// packets (once implemented) should have a different handling.
-		if (!this->rtpStream->ReceivePacket(packet))
-			return;
+		if (this->rtpStream->ReceivePacket(sentPacket))
+		{
+			auto priority = this->kind == RTC::Media::Kind::AUDIO ? RTC::Pacer::Priority::AUDIO : RTC::Pacer::Priority::VIDEO;
+
+			// Send the packet.
+			this->transport->SendRtpPacket(sentPacket, this->transportWideCcId, priority);
 
-		// Send the packet.
-		this->transport->SendRtpPacket(packet);
+			// Save RTP data.
+			this->transmittedCounter.Update(sentPacket);
 
-		// Save RTP data.
-		this->transmittedCounter.Update(packet);
+			// Protect it with FEC. The FEC packet is the XOR of the packets as sent
+			// (but for the transport-wide sequence number, stamped by the Transport
+			// on both of them).
+			if (this->fecGenerator)
+			{
+				RTC::RtpPacket* fecPacket = this->fecGenerator->AddPacket(sentPacket);
+
+				if (fecPacket)
+				{
+					this->transport->SendRtpPacket(fecPacket, this->transportWideCcId, priority);
+
+					delete fecPacket;
+				}
+			}
+
+			if (static_cast<uint16_t>(outSeq - this->lastSeq) < 0x8000)
+			{
+				this->lastSeq = outSeq;
+				this->lastTimestamp = outTimestamp;
+				this->lastPacketTime = DepLibUV::GetTime();
+			}
+		}
+
+		delete redPacket;
+
+		packet->SetSsrc(this->sourceSsrc);
+		packet->SetSequenceNumber(seq);
+		packet->SetTimestamp(timestamp);
+		packet->SetMarker(marker);
+
+		if (descriptor)
+		{
+			RTC::Codecs::Tools::SetPictureId(packet->GetPayload(), *descriptor, descriptor->pictureId);
+			RTC::Codecs::Tools::SetTl0PicIdx(packet->GetPayload(), *descriptor, descriptor->tl0PicIdx);
+		}
 	}
 
 	void RtpSender::GetRtcp(RTC::RTCP::CompoundPacket *packet, uint64_t now)
@@ -396,7 +781,189 @@ namespace RTC
 			return;
 		}
 
+		// Reports about the RTX stream are useless.
+		if (report->GetSsrc() != this->rtpStream->GetSsrc())
+			return;
+
 		this->rtpStream->ReceiveRtcpReceiverReport(report);
+
+		// Adapt the FEC protection and the RED redundancy to the loss seen by the
+		// remote peer.
+		if (this->fecGenerator)
+			this->fecGenerator->SetFractionLost(report->GetFractionLost());
+
+		if (this->redEncoder)
+			this->redEncoder->SetFractionLost(report->GetFractionLost());
+
+		// Share the RTT with the RtpReceivers of the Transport (it is just valid
+		// if the report refers to a Sender Report).
+		if (this->transport && report->GetLastSenderReport())
+			this->transport->SetRtt(this->rtpStream->GetRtt());
+	}
+
+	/**
+	 * Retransmissions are sent in a RTX stream if the remote peer supports RTX
+	 * for the codec of the encoding (regardless the source uses it or not).
+	 */
+	void RtpSender::SetRtx(RTC::RtpEncodingParameters& encoding)
+	{
+		MS_TRACE();
+
+		static std::string k_apt = "apt";
+
+		auto& codecs = this->rtpParameters->codecs;
+		uint8_t payloadType = this->rtpParameters->GetCodecForEncoding(encoding).payloadType;
+		RTC::RtpCodecParameters* rtxCodec = nullptr;
+
+		// Remove the RTX codecs of the source.
+		for (auto it = codecs.begin(); it != codecs.end();)
+		{
+			if (it->mime.subtype == RTC::RtpCodecMime::Subtype::RTX)
+			{
+				this->supportedPayloadTypes.erase(it->payloadType);
+				it = codecs.erase(it);
+			}
+			else
+			{
+				++it;
+			}
+		}
+
+		for (auto& codec : this->peerCapabilities->codecs)
+		{
+			if (
+				codec.mime.subtype == RTC::RtpCodecMime::Subtype::RTX &&
+				codec.parameters.HasInteger(k_apt) &&
+				codec.parameters.GetInteger(k_apt) == payloadType)
+			{
+				rtxCodec = &codec;
+
+				break;
+			}
+		}
+
+		if (!rtxCodec)
+		{
+			encoding.rtx = RTC::RtpRtxParameters();
+			encoding.hasRtx = false;
+
+			return;
+		}
+
+		codecs.push_back(*rtxCodec);
+		codecs.back().rtcpFeedback.clear();
+
+		encoding.hasRtx = true;
+
+		if (!encoding.rtx.ssrc)
+			encoding.rtx.ssrc = Utils::Crypto::GetRandomUInt(100000000, 999999999);
+	}
+
+	/**
+	 * Video is protected with FlexFEC in its own stream if the remote peer
+	 * supports it (regardless the source uses FEC or not).
+	 */
+	void RtpSender::SetFec(RTC::RtpEncodingParameters& encoding)
+	{
+		MS_TRACE();
+
+		static std::string k_flexfec = "flexfec";
+
+		auto& codecs = this->rtpParameters->codecs;
+		RTC::RtpCodecParameters* fecCodec = nullptr;
+
+		// Remove the FEC codecs of the source.
+		for (auto it = codecs.begin(); it != codecs.end();)
+		{
+			if (
+				it->mime.subtype == RTC::RtpCodecMime::Subtype::FLEXFEC ||
+				it->mime.subtype == RTC::RtpCodecMime::Subtype::ULPFEC
+			)
+			{
+				this->supportedPayloadTypes.erase(it->payloadType);
+				it = codecs.erase(it);
+			}
+			else
+			{
+				++it;
+			}
+		}
+
+		if (this->kind == RTC::Media::Kind::VIDEO)
+		{
+			for (auto& codec : this->peerCapabilities->codecs)
+			{
+				if (codec.mime.subtype == RTC::RtpCodecMime::Subtype::FLEXFEC)
+				{
+					fecCodec = &codec;
+
+					break;
+				}
+			}
+		}
+
+		if (!fecCodec)
+		{
+			encoding.fec = RTC::RtpFecParameters();
+			encoding.hasFec = false;
+
+			return;
+		}
+
+		codecs.push_back(*fecCodec);
+		codecs.back().rtcpFeedback.clear();
+
+		encoding.hasFec = true;
+		encoding.fec.mechanism = k_flexfec;
+
+		if (!encoding.fec.ssrc)
+			encoding.fec.ssrc = Utils::Crypto::GetRandomUInt(100000000, 999999999);
+	}
+
+	/**
+	 * Opus is sent with RFC 2198 redundancy if the remote peer supports RED. The
+	 * RED packets of the source were already unwrapped by the RtpReceiver.
+	 */
+	void RtpSender::SetRed(RTC::RtpEncodingParameters& encoding)
+	{
+		MS_TRACE();
+
+		auto& codecs = this->rtpParameters->codecs;
+		bool isOpus = this->rtpParameters->GetCodecForEncoding(encoding).mime.subtype == RTC::RtpCodecMime::Subtype::OPUS;
+		RTC::RtpCodecParameters* redCodec = nullptr;
+
+		if (isOpus)
+		{
+			for (auto& codecCapability : this->peerCapabilities->codecs)
+			{
+				if (codecCapability.mime.subtype == RTC::RtpCodecMime::Subtype::RED)
+				{
+					redCodec = &codecCapability;
+
+					break;
+				}
+			}
+		}
+
+		// Remove the RED codecs of the source.
+		for (auto it = codecs.begin(); it != codecs.end();)
+		{
+			if (it->mime.subtype == RTC::RtpCodecMime::Subtype::RED)
+			{
+				this->supportedPayloadTypes.erase(it->payloadType);
+				it = codecs.erase(it);
+			}
+			else
+			{
+				++it;
+			}
+		}
+
+		if (!redCodec)
+			return;
+
+		codecs.push_back(*redCodec);
+		codecs.back().rtcpFeedback.clear();
 	}
 
 	void RtpSender::CreateRtpStream(RTC::RtpEncodingParameters& encoding)
@@ -424,12 +991,18 @@ namespace RTC
 			}
 		}
 
+		this->transportWideCcId = 0;
+
 		for (auto& exten : this->rtpParameters->headerExtensions)
 		{
 			if (!absSendTimeId && exten.type == RTC::RtpHeaderExtensionUri::Type::ABS_SEND_TIME)
 			{
 				absSendTimeId = exten.id;
 			}
+			if (!this->transportWideCcId && exten.type == RTC::RtpHeaderExtensionUri::Type::TRANSPORT_WIDE_CC_01)
+			{
+				this->transportWideCcId = exten.id;
+			}
 		}
 
 		// Create stream params.
@@ -443,6 +1016,56 @@ namespace RTC
 		params.usePli = usePli;
 		params.absSendTimeId = absSendTimeId;
 
+		this->clockRate = codec.clockRate;
+
+		// RTX stream (if any).
+		this->rtxSsrc = 0;
+		this->rtxPayloadType = 0;
+
+		if (encoding.hasRtx && encoding.rtx.ssrc)
+		{
+			static std::string k_apt = "apt";
+
+			for (auto& rtxCodec : this->rtpParameters->codecs)
+			{
+				if (
+					rtxCodec.mime.subtype == RTC::RtpCodecMime::Subtype::RTX &&
+					rtxCodec.parameters.GetInteger(k_apt) == codec.payloadType)
+				{
+					this->rtxSsrc = encoding.rtx.ssrc;
+					this->rtxPayloadType = rtxCodec.payloadType;
+					this->rtxSeq = static_cast<uint16_t>(Utils::Crypto::GetRandomUInt(0, 0xFFFF));
+
+					break;
+				}
+			}
+		}
+
+		// FEC stream (if any).
+		if (encoding.hasFec && encoding.fec.ssrc)
+		{
+			for (auto& fecCodec : this->rtpParameters->codecs)
+			{
+				if (fecCodec.mime.subtype == RTC::RtpCodecMime::Subtype::FLEXFEC)
+				{
+					this->fecGenerator = new RTC::FecGenerator(encoding.fec.ssrc, fecCodec.payloadType, this->transportWideCcId);
+
+					break;
+				}
+			}
+		}
+
+		// RED encapsulation (if any).
+		for (auto& redCodec : this->rtpParameters->codecs)
+		{
+			if (redCodec.mime.subtype == RTC::RtpCodecMime::Subtype::RED)
+			{
+				this->redEncoder = new RTC::RedEncoder(redCodec.payloadType);
+
+				break;
+			}
+		}
+
 		// Create a RtpStreamSend for sending a single media stream.
 		if (useNack)
 			this->rtpStream = new RTC::RtpStreamSend(params, 200);
@@ -450,6 +1073,124 @@ namespace RTC
 			this->rtpStream = new RTC::RtpStreamSend(params, 0);
 	}
 
+	bool RtpSender::SwitchEncoding(RTC::RtpPacket* packet, size_t encodingIndex)
+	{
+		MS_TRACE();
+
+		// Just switch to the target encoding.
+		if (encodingIndex != this->targetEncoding)
+			return false;
+
+		// Once started, wait for a key frame so the remote decoder does not
+		// break. The first packet does not need it (the source will send one).
+		if (this->started && this->kind == RTC::Media::Kind::VIDEO)
+		{
+			const RTC::Codecs::PayloadDescriptor* descriptor = packet->GetPayloadDescriptor();
+
+			if (!descriptor || !descriptor->isKeyFrame)
+				return false;
+		}
+
+		uint16_t seq = packet->GetSequenceNumber();
+		uint32_t timestamp = packet->GetTimestamp();
+
+		// Make the output stream continuous. The first one is forwarded as is.
+		if (this->started)
+		{
+			uint64_t now = DepLibUV::GetTime();
+			uint32_t tsDelta = static_cast<uint32_t>((now - this->lastPacketTime) * this->clockRate / 1000);
+
+			if (tsDelta == 0)
+				tsDelta = 1;
+
+			this->seqOffset = this->lastSeq + 1 - seq;
+			this->tsOffset = this->lastTimestamp + tsDelta - timestamp;
+		}
+		else
+		{
+			this->seqOffset = 0;
+			this->tsOffset = 0;
+			this->lastSeq = seq - 1;
+			this->lastTimestamp = timestamp;
+			this->lastPacketTime = DepLibUV::GetTime();
+		}
+
+		MS_DEBUG_TAG(rtp, "switching encoding [from:%zu, to:%zu, ssrc:%" PRIu32 "]",
+			this->currentEncoding, encodingIndex, packet->GetSsrc());
+
+		this->currentEncoding = encodingIndex;
+		this->sourceSsrc = packet->GetSsrc();
+		this->sourceSeqTracker.Sync(seq);
+		this->resyncPictureId = this->started;
+		this->pictureDropped = false;
+		this->started = true;
+		this->resync = false;
+
+		return true;
+	}
+
+	bool RtpSender::CheckLayers(const RTC::Codecs::PayloadDescriptor& descriptor)
+	{
+		MS_TRACE();
+
+		// Key frames allow switching to any layer.
+		if (descriptor.isKeyFrame)
+		{
+			this->currentSpatialLayer = this->targetSpatialLayer;
+			this->currentTemporalLayer = this->targetTemporalLayer;
+		}
+		// Otherwise switch at the start of a picture.
+		else if (descriptor.startOfFrame && descriptor.spatialLayer == 0)
+		{
+			if (this->targetSpatialLayer < this->currentSpatialLayer)
+				this->currentSpatialLayer = this->targetSpatialLayer;
+
+			if (this->targetTemporalLayer < this->currentTemporalLayer)
+				this->currentTemporalLayer = this->targetTemporalLayer;
+			// Switching up requires a layer sync picture.
+			else if (
+				descriptor.layerSync &&
+				descriptor.temporalLayer > this->currentTemporalLayer &&
+				descriptor.temporalLayer <= this->targetTemporalLayer
+			)
+			{
+				this->currentTemporalLayer = descriptor.temporalLayer;
+			}
+		}
+
+		if (descriptor.temporalLayer > this->currentTemporalLayer)
+		{
+			// The whole picture is dropped so next picture ids must be decreased.
+			if (descriptor.hasPictureId && (!this->pictureDropped || descriptor.pictureId != this->lastDroppedPictureId))
+			{
+				this->pictureIdOffset++;
+				this->lastDroppedPictureId = descriptor.pictureId;
+				this->pictureDropped = true;
+			}
+
+			return false;
+		}
+
+		if (descriptor.spatialLayer > this->currentSpatialLayer)
+			return false;
+
+		return true;
+	}
+
+	void RtpSender::DropPacket(uint16_t seq, bool isNewest)
+	{
+		MS_TRACE();
+
+		// Don't leave a gap in the sequence numbers or the remote peer would NACK
+		// the packet. An older packet cannot be skipped (newer ones were already
+		// sent) so it leaves a gap.
+		if (!isNewest)
+			return;
+
+		this->sourceSeqTracker.Drop(seq);
+		this->seqOffset--;
+	}
+
 	void RtpSender::RetransmitRtpPacket(RTC::RtpPacket* packet)
 	{
 		MS_TRACE();
@@ -457,14 +1198,27 @@ namespace RTC
 		if (!this->GetActive())
 			return;
 
+		MS_ASSERT(this->rtpStream, "no RtpStream set");
+
 		// If the peer supports RTX create a RTX packet and insert the given media
-		// packet as payload. Otherwise just send the packet as usual.
-		// TODO: No RTX for now so just send as usual.
+		// packet as payload (in a copy since the stored one may be requested
+		// again). Otherwise just send the packet as usual.
+		if (this->rtxSsrc)
+		{
+			RTC::RtpPacket* rtxPacket = packet->Clone(RtpSender::rtxBuffer);
 
-		MS_ASSERT(this->rtpStream, "no RtpStream set");
+			rtxPacket->RtxEncode(this->rtxPayloadType, this->rtxSsrc, this->rtxSeq++);
 
-		// Send the packet.
-		this->transport->SendRtpPacket(packet);
+			this->transport->SendRtpPacket(rtxPacket, this->transportWideCcId, RTC::Pacer::Priority::RETRANSMISSION);
+			this->retransmittedCounter.Update(rtxPacket);
+
+			delete rtxPacket;
+		}
+		else
+		{
+			this->transport->SendRtpPacket(packet, this->transportWideCcId, RTC::Pacer::Priority::RETRANSMISSION);
+			this->retransmittedCounter.Update(packet);
+		}
 	}
 
 	inline
@@ -2,6 +2,7 @@
 
 #define MS_CLASS "RTC::RtpStream"
 // #define MS_LOG_DEV
+#define MS_LOG_HOT_PATH
 
 #include "RTC/RtpStream.hpp"
 #include "Logger.hpp"
@@ -165,6 +166,7 @@ namespace RTC
 		static const Json::StaticString k_useNack("useNack");
 		static const Json::StaticString k_usePli("usePli");
 		static const Json::StaticString k_absSendTimeId("absSendTimeId");
+		static const Json::StaticString k_ssrcAudioLevelId("ssrcAudioLevelId");
 
 		Json::Value json(Json::objectValue);
 
@@ -175,6 +177,7 @@ namespace RTC
 		json[k_useNack] = this->useNack;
 		json[k_usePli] = this->usePli;
 		json[k_absSendTimeId] = (Json::UInt)this->absSendTimeId;
+		json[k_ssrcAudioLevelId] = (Json::UInt)this->ssrcAudioLevelId;
 
 		return json;
 	}
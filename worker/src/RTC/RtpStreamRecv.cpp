@@ -1,10 +1,11 @@
 #define MS_CLASS "RTC::RtpStreamRecv"
 // #define MS_LOG_DEV
+#define MS_LOG_HOT_PATH
 
 #include "RTC/RtpStreamRecv.hpp"
+#include "RTC/Metrics.hpp"
 #include "DepLibUV.hpp"
 #include "Logger.hpp"
-#include <bitset> // std::bitset()
 
 namespace RTC
 {
@@ -15,11 +16,16 @@ namespace RTC
 		listener(listener)
 	{
 		MS_TRACE();
+
+		if (this->params.useNack)
+			this->nackGenerator = new RTC::NackGenerator(this);
 	}
 
 	RtpStreamRecv::~RtpStreamRecv()
 	{
 		MS_TRACE();
+
+		delete this->nackGenerator;
 	}
 
 	Json::Value RtpStreamRecv::toJson() const
@@ -31,6 +37,7 @@ namespace RTC
 		static const Json::StaticString k_maxTimestamp("maxTimestamp");
 		static const Json::StaticString k_transit("transit");
 		static const Json::StaticString k_jitter("jitter");
+		static const Json::StaticString k_nack("nack");
 
 		Json::Value json(Json::objectValue);
 
@@ -40,6 +47,9 @@ namespace RTC
 		json[k_transit] = (Json::UInt)this->transit;
 		json[k_jitter] = (Json::UInt)this->jitter;
 
+		if (this->nackGenerator)
+			json[k_nack] = this->nackGenerator->toJson();
+
 		return json;
 	}
 
@@ -61,9 +71,15 @@ namespace RTC
 				RtpHeaderExtensionUri::Type::ABS_SEND_TIME, this->params.absSendTimeId);
 		}
 
+		if (this->params.ssrcAudioLevelId)
+		{
+			packet->AddExtensionMapping(
+				RtpHeaderExtensionUri::Type::SSRC_AUDIO_LEVEL, this->params.ssrcAudioLevelId);
+		}
+
 		// May trigger a NACK to the sender.
-		if (this->params.useNack)
-			MayTriggerNack(packet);
+		if (this->nackGenerator)
+			this->nackGenerator->ReceivePacket(packet, DepLibUV::GetTime());
 
 		return true;
 	}
@@ -101,6 +117,8 @@ namespace RTC
 		report->SetLastSeq((uint32_t)this->max_seq + this->cycles);
 		report->SetJitter(this->jitter);
 
+		RTC::Metrics::jitter.Add(this->jitter);
+
 		if (this->last_sr_received)
 		{
 			// Get delay in milliseconds.
@@ -129,6 +147,12 @@ namespace RTC
 		this->last_sr_timestamp += report->GetNtpFrac() >> 16;
 	}
 
+	void RtpStreamRecv::UpdateRtt(uint32_t rtt)
+	{
+		if (this->nackGenerator)
+			this->nackGenerator->UpdateRtt(rtt);
+	}
+
 	void RtpStreamRecv::CalculateJitter(uint32_t rtpTimestamp)
 	{
 		if (!this->params.clockRate)
@@ -142,65 +166,27 @@ namespace RTC
 		this->jitter += (1./16.) * ((double)d - this->jitter);
 	}
 
-	void RtpStreamRecv::MayTriggerNack(RTC::RtpPacket* packet)
+	void RtpStreamRecv::onInitSeq()
 	{
-		uint32_t seq32 = (uint32_t)packet->GetSequenceNumber() + this->cycles;
-
-		// If this is the first packet, just update last seen extended seq number.
-		if (this->last_seq32 == 0)
-		{
-			this->last_seq32 = (seq32 != 0 ? seq32 : 1);
-			return;
-		}
-
-		int32_t diff_seq32 = seq32 - this->last_seq32;
-
-		// If the received seq is older than the last seen, ignore.
-		if (diff_seq32 < 1)
-			return;
-		// Otherwise, update the last seen seq.
-		else
-			this->last_seq32 = seq32;
-
-		// Just received next expected seq, do nothing.
-		if (diff_seq32 == 1)
-			return;
-
-		// If 16 or more packets was lost, ask for a PLI (if supported).
-		if (diff_seq32 >= 16 && this->params.usePli)
-		{
-			MS_DEBUG_TAG(rtcp, "PLI triggered [ssrc:%" PRIu32 ", diff_seq32:%" PRIu32 "]",
-				this->params.ssrc, diff_seq32);
+		if (this->nackGenerator)
+			this->nackGenerator->Reset();
+	}
 
-			this->listener->onPliRequired(this);
+	void RtpStreamRecv::onNackGeneratorNackRequired(RTC::NackGenerator* nackGenerator, const std::vector<uint16_t>& seqNumbers)
+	{
+		MS_DEBUG_TAG(rtcp, "NACK triggered [ssrc:%" PRIu32 ", first seq:%" PRIu16 ", num packets:%zu]",
+			this->params.ssrc, seqNumbers.front(), seqNumbers.size());
 
-			// TODO: Now we should stop sending NACK for a while (ideally after a full keyframe
-			// is received...).
+		this->listener->onNackRequired(this, seqNumbers);
+	}
 
+	void RtpStreamRecv::onNackGeneratorKeyFrameRequired(RTC::NackGenerator* nackGenerator)
+	{
+		if (!this->params.usePli)
 			return;
-		}
-
-		// Some packet(s) is/are missing, trigger a NACK.
-		uint8_t nack_bitmask_count = std::min(diff_seq32 - 2, 16);
-		uint32_t nack_seq32 = this->last_seq32 - nack_bitmask_count - 1;
-		std::bitset<16> nack_bitset(0);
-
-		for (uint8_t i = 0; i < nack_bitmask_count; ++i)
-		{
-			nack_bitset[i] = 1;
-		}
 
-		uint16_t nack_seq = (uint16_t)nack_seq32;
-		uint16_t nack_bitmask = (uint16_t)nack_bitset.to_ulong();
+		MS_DEBUG_TAG(rtcp, "PLI triggered [ssrc:%" PRIu32 "]", this->params.ssrc);
 
-		MS_DEBUG_TAG(rtcp, "NACK triggered [ssrc:%" PRIu32 ", seq:%" PRIu16 ", bitmask:" MS_UINT16_TO_BINARY_PATTERN "]",
-			this->params.ssrc, nack_seq, MS_UINT16_TO_BINARY(nack_bitmask));
-
-		this->listener->onNackRequired(this, nack_seq, nack_bitmask);
-	}
-
-	void RtpStreamRecv::onInitSeq()
-	{
-		this->last_seq32 = 0;
+		this->listener->onPliRequired(this);
 	}
 }
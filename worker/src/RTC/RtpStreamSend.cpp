@@ -1,7 +1,9 @@
 #define MS_CLASS "RTC::RtpStreamSend"
 // #define MS_LOG_DEV
+#define MS_LOG_HOT_PATH
 
 #include "RTC/RtpStreamSend.hpp"
+#include "RTC/Metrics.hpp"
 #include "Logger.hpp"
 #include "DepLibUV.hpp"
 #include "Utils.hpp"
@@ -93,6 +95,10 @@ namespace RTC
 		// RTT in milliseconds.
 		this->rtt = ((rtt >> 16) * 1000);
 		this->rtt += (static_cast<float>(rtt & 0x0000FFFF) / 65536) * 1000;
+
+		// It is just valid if the report refers to a Sender Report.
+		if (lastSr)
+			RTC::Metrics::rtt.Add(this->rtt);
 	}
 
 	// This method looks for the requested RTP packets and inserts them into the
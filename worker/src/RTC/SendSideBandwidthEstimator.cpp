@@ -0,0 +1,172 @@
+#define MS_CLASS "RTC::SendSideBandwidthEstimator"
+// #define MS_LOG_DEV
+#define MS_LOG_HOT_PATH
+
+#include "RTC/SendSideBandwidthEstimator.hpp"
+#include "RTC/RemoteBitrateEstimator/RateControlInput.hpp"
+#include "Logger.hpp"
+#include <algorithm> // std::min(), std::max()
+
+// Send times are in ms so a timestamp group lasts 5 ticks.
+#define TIMESTAMP_GROUP_LENGTH 5
+
+namespace RTC
+{
+	/* Class variables. */
+
+	constexpr size_t SendSideBandwidthEstimator::HistorySize;
+	constexpr uint32_t SendSideBandwidthEstimator::StartBitrate;
+	constexpr uint32_t SendSideBandwidthEstimator::MinBitrate;
+	constexpr size_t SendSideBandwidthEstimator::LossWindowPackets;
+	constexpr uint64_t SendSideBandwidthEstimator::LossIncreaseInterval;
+	constexpr uint64_t SendSideBandwidthEstimator::LossDecreaseInterval;
+
+	/* Instance methods. */
+
+	SendSideBandwidthEstimator::SendSideBandwidthEstimator() :
+		history(HistorySize),
+		interArrival(new InterArrival(TIMESTAMP_GROUP_LENGTH, 1.0, true)),
+		estimator(new OveruseEstimator(OverUseDetectorOptions()))
+	{
+		MS_TRACE();
+
+		this->rateControl.SetStartBitrate(StartBitrate);
+		this->rateControl.SetMinBitrate(MinBitrate);
+	}
+
+	Json::Value SendSideBandwidthEstimator::toJson() const
+	{
+		MS_TRACE();
+
+		static const Json::StaticString k_availableBitrate("availableBitrate");
+		static const Json::StaticString k_delayBasedBitrate("delayBasedBitrate");
+		static const Json::StaticString k_lossBasedBitrate("lossBasedBitrate");
+		static const Json::StaticString k_fractionLost("fractionLost");
+		static const Json::StaticString k_feedbacks("feedbacks");
+
+		Json::Value json(Json::objectValue);
+
+		json[k_availableBitrate] = (Json::UInt)this->availableBitrate;
+		json[k_delayBasedBitrate] = (Json::UInt)this->delayBasedBitrate;
+		json[k_lossBasedBitrate] = (Json::UInt)this->lossBasedBitrate;
+		json[k_fractionLost] = (Json::UInt)this->fractionLost;
+		json[k_feedbacks] = (Json::UInt)this->feedbacks;
+
+		return json;
+	}
+
+	/**
+	 * Remembers a packet about to be sent and returns the transport-wide
+	 * sequence number it must carry.
+	 */
+	uint16_t SendSideBandwidthEstimator::PacketSent(size_t size, uint64_t now)
+	{
+		MS_TRACE();
+
+		uint16_t seq = this->wideSeqNumber++;
+		auto& sentPacket = this->history[seq & (HistorySize - 1)];
+
+		sentPacket.sendTime = now;
+		sentPacket.size = size;
+		sentPacket.sequenceNumber = seq;
+		sentPacket.valid = true;
+
+		return seq;
+	}
+
+	void SendSideBandwidthEstimator::ReceiveFeedback(const RTC::RTCP::FeedbackRtpTransportPacket* feedback, uint64_t now)
+	{
+		MS_TRACE();
+
+		++this->feedbacks;
+
+		for (auto& result : feedback->GetPacketResults())
+		{
+			auto& sentPacket = this->history[result.sequenceNumber & (HistorySize - 1)];
+
+			// Unknown, too old or already reported.
+			if (!sentPacket.valid || sentPacket.sequenceNumber != result.sequenceNumber)
+				continue;
+
+			sentPacket.valid = false;
+			++this->lossWindowPackets;
+
+			if (!result.received)
+			{
+				++this->lossWindowLost;
+
+				continue;
+			}
+
+			this->ackedBitrate.Update(sentPacket.size, now);
+
+			uint32_t tsDelta = 0;
+			int64_t tDelta = 0;
+			int sizeDelta = 0;
+
+			if (this->interArrival->ComputeDeltas(
+				static_cast<uint32_t>(sentPacket.sendTime), result.receivedAtMs, now, sentPacket.size,
+				&tsDelta, &tDelta, &sizeDelta))
+			{
+				double tsDeltaMs = static_cast<double>(tsDelta);
+
+				this->estimator->Update(tDelta, tsDeltaMs, sizeDelta, this->detector.State(), result.receivedAtMs);
+				this->detector.Detect(this->estimator->GetOffset(), tsDeltaMs, this->estimator->GetNumOfDeltas(), result.receivedAtMs);
+			}
+		}
+
+		// Delay based estimation.
+		const RateControlInput input(this->detector.State(), this->ackedBitrate.GetRate(now), this->estimator->GetVarNoise());
+
+		this->rateControl.Update(&input, now);
+		this->delayBasedBitrate = this->rateControl.UpdateBandwidthEstimate(now);
+
+		// Loss based estimation.
+		UpdateLossBased(now);
+
+		uint32_t previousBitrate = this->availableBitrate;
+
+		this->availableBitrate = std::min(this->delayBasedBitrate, this->lossBasedBitrate);
+
+		if (this->availableBitrate != previousBitrate)
+		{
+			MS_DEBUG_DEV("available bitrate [bitrate:%" PRIu32 ", delay based:%" PRIu32 ", loss based:%" PRIu32 "]",
+				this->availableBitrate, this->delayBasedBitrate, this->lossBasedBitrate);
+		}
+	}
+
+	void SendSideBandwidthEstimator::UpdateLossBased(uint64_t now)
+	{
+		MS_TRACE();
+
+		if (this->lossWindowPackets < LossWindowPackets)
+			return;
+
+		this->fractionLost = static_cast<uint8_t>((this->lossWindowLost * 255) / this->lossWindowPackets);
+		this->lossWindowPackets = 0;
+		this->lossWindowLost = 0;
+
+		// Below 2% loss: increase by 8% (so it does not keep growing while the
+		// delay based estimation limits the bitrate).
+		if (this->fractionLost < 5)
+		{
+			if (now - this->lastLossIncreaseTime < LossIncreaseInterval)
+				return;
+
+			this->lossBasedBitrate = static_cast<uint32_t>(this->availableBitrate * 1.08 + 1000);
+			this->lastLossIncreaseTime = now;
+		}
+		// Above 10% loss: decrease by half the loss fraction.
+		else if (this->fractionLost > 26)
+		{
+			if (now - this->lastLossDecreaseTime < LossDecreaseInterval)
+				return;
+
+			this->lossBasedBitrate = static_cast<uint32_t>(
+				(static_cast<uint64_t>(this->availableBitrate) * (512 - this->fractionLost)) / 512);
+			this->lastLossDecreaseTime = now;
+		}
+
+		this->lossBasedBitrate = std::max(this->lossBasedBitrate, MinBitrate);
+	}
+}
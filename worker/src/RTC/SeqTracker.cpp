@@ -0,0 +1,46 @@
+#define MS_CLASS "RTC::SeqTracker"
+// #define MS_LOG_DEV
+
+#include "RTC/SeqTracker.hpp"
+#include "Logger.hpp"
+
+namespace RTC
+{
+	/* Class variables. */
+
+	constexpr uint16_t SeqTracker::MaxReorder;
+	constexpr size_t SeqTracker::MaxDropped;
+
+	/* Instance methods. */
+
+	/**
+	 * Sets the switching point: the given packet is the first one accepted.
+	 */
+	void SeqTracker::Sync(uint16_t seq)
+	{
+		MS_TRACE();
+
+		this->syncSeq = seq;
+		this->maxSeq = seq - 1;
+		this->dropped.clear();
+	}
+
+	/**
+	 * Records the newest packet as dropped.
+	 */
+	void SeqTracker::Drop(uint16_t seq)
+	{
+		MS_TRACE();
+
+		MS_ASSERT(seq == this->maxSeq, "not the newest packet");
+
+		this->dropped.push_back(seq);
+
+		// Forget the oldest one and ignore the packets before it from now on.
+		if (this->dropped.size() > SeqTracker::MaxDropped)
+		{
+			this->syncSeq = this->dropped.front() + 1;
+			this->dropped.pop_front();
+		}
+	}
+}
@@ -1,5 +1,6 @@
 #define MS_CLASS "RTC::SrtpSession"
 // #define MS_LOG_DEV
+#define MS_LOG_HOT_PATH
 
 #include "RTC/SrtpSession.hpp"
 #include "DepLibSRTP.hpp"
@@ -1,18 +1,25 @@
 #define MS_CLASS "RTC::Transport"
 // #define MS_LOG_DEV
+#define MS_LOG_HOT_PATH
 
 #include "RTC/Transport.hpp"
-#include "RTC/RTCP/FeedbackPsRemb.hpp"
 #include "Settings.hpp"
 #include "DepLibUV.hpp"
 #include "Utils.hpp"
 #include "MediaSoupError.hpp"
 #include "Logger.hpp"
 #include <cmath> // std::pow()
+#include <algorithm> // std::min()
 
 #define ICE_CANDIDATE_DEFAULT_LOCAL_PRIORITY 20000
 #define ICE_CANDIDATE_LOCAL_PRIORITY_PREFER_FAMILY_INCREMENT 10000
 #define ICE_CANDIDATE_LOCAL_PRIORITY_PREFER_PROTOCOL_INCREMENT 5000
+// Min interval (ms) between REMB packets triggered by the remote receivers.
+#define REMB_MIN_INTERVAL 1000
+// Pacing bitrate over the estimated one (so the pacer just smooths bursts).
+#define PACING_FACTOR 2.5
+// Max age (ms) of the REMB of the remote peer to derive the pacing bitrate.
+#define REMOTE_REMB_TIMEOUT 10000
 
 /* Static helpers. */
 
@@ -201,11 +208,16 @@ namespace RTC
 
 		// Hack to avoid that Destroy() above attempts to delete this.
 		this->allocated = true;
+
+		this->counters.transportId = this->transportId;
+		RTC::Metrics::AddTransport(&this->counters);
 	}
 
 	Transport::~Transport()
 	{
 		MS_TRACE();
+
+		RTC::Metrics::RemoveTransport(&this->counters);
 	}
 
 	void Transport::Destroy()
@@ -238,6 +250,8 @@ namespace RTC
 
 		this->selectedTuple = nullptr;
 
+		this->pacer.reset();
+
 		// Notify.
 		event_data[k_class] = "Transport";
 		this->notifier->Emit(this->transportId, "close", event_data);
@@ -281,7 +295,13 @@ namespace RTC
 		static const Json::StaticString v_closed("closed");
 		static const Json::StaticString v_failed("failed");
 		static const Json::StaticString k_useRemb("useRemb");
+		static const Json::StaticString k_rembBitrate("rembBitrate");
+		static const Json::StaticString k_sendSideBandwidthEstimator("sendSideBandwidthEstimator");
+		static const Json::StaticString k_transportFeedbackGenerator("transportFeedbackGenerator");
+		static const Json::StaticString k_pacer("pacer");
+		static const Json::StaticString k_rtt("rtt");
 		static const Json::StaticString k_rtpListener("rtpListener");
+		static const Json::StaticString k_packetTrace("packetTrace");
 
 		Json::Value json(Json::objectValue);
 
@@ -364,9 +384,30 @@ namespace RTC
 		// Add `useRemb`.
 		json[k_useRemb] = (this->remoteBitrateEstimator ? true : false);
 
+		// Add `rembBitrate`.
+		json[k_rembBitrate] = (Json::UInt)this->lastRembBitrate;
+
+		// Add `sendSideBandwidthEstimator`.
+		if (this->sendSideBandwidthEstimator)
+			json[k_sendSideBandwidthEstimator] = this->sendSideBandwidthEstimator->toJson();
+
+		// Add `transportFeedbackGenerator`.
+		if (this->transportFeedbackGenerator)
+			json[k_transportFeedbackGenerator] = this->transportFeedbackGenerator->toJson();
+
+		// Add `pacer`.
+		if (this->pacer)
+			json[k_pacer] = this->pacer->toJson();
+
+		// Add `rtt`.
+		json[k_rtt] = (Json::UInt)this->rtt;
+
 		// Add `rtpListener`.
 		json[k_rtpListener] = this->rtpListener.toJson();
 
+		// Add packetTrace.
+		json[k_packetTrace] = this->packetTrace.toJson();
+
 		return json;
 	}
 
@@ -490,6 +531,89 @@ namespace RTC
 				break;
 			}
 
+			case Channel::Request::MethodId::transport_setPacer:
+			{
+				static const Json::StaticString k_enabled("enabled");
+				static const Json::StaticString k_bitrate("bitrate");
+
+				if (!request->data[k_enabled].isBool())
+				{
+					request->Reject("missing data.enabled");
+					return;
+				}
+
+				if (!request->data[k_bitrate].isNull() && !request->data[k_bitrate].isUInt())
+				{
+					request->Reject("invalid data.bitrate");
+					return;
+				}
+
+				if (request->data[k_enabled].asBool())
+				{
+					this->pacerBitrate = request->data[k_bitrate].isUInt() ? request->data[k_bitrate].asUInt() : 0;
+
+					if (!this->pacer)
+						this->pacer.reset(new RTC::Pacer(this));
+
+					this->pacer->SetBitrate(GetPacingBitrate(DepLibUV::GetTime()));
+				}
+				else if (this->pacer)
+				{
+					// Send the queued packets.
+					this->pacer->SetBitrate(0);
+					this->pacer.reset();
+					this->pacerBitrate = 0;
+				}
+
+				request->Accept();
+
+				break;
+			}
+
+			case Channel::Request::MethodId::transport_dumpPacketTrace:
+			{
+				static const Json::StaticString k_path("path");
+				static const Json::StaticString k_format("format");
+				static const Json::StaticString k_numRecords("numRecords");
+
+				RTC::PacketTrace::Format format = RTC::PacketTrace::Format::PCAP;
+
+				if (!request->data[k_path].isString() || request->data[k_path].asString().empty())
+				{
+					request->Reject("missing data.path");
+					return;
+				}
+
+				if (
+					!request->data[k_format].isNull() &&
+					(!request->data[k_format].isString() || !RTC::PacketTrace::GetFormat(request->data[k_format].asString(), format))
+				)
+				{
+					request->Reject("invalid data.format");
+					return;
+				}
+
+				size_t numRecords;
+
+				try
+				{
+					numRecords = this->packetTrace.Dump(request->data[k_path].asString(), format);
+				}
+				catch (const MediaSoupError &error)
+				{
+					request->Reject(error.what());
+					return;
+				}
+
+				Json::Value data(Json::objectValue);
+
+				data[k_numRecords] = (Json::UInt)numRecords;
+
+				request->Accept(data);
+
+				break;
+			}
+
 			default:
 			{
 				MS_ERROR("unknown method");
@@ -499,7 +623,27 @@ namespace RTC
 		}
 	}
 
-	void Transport::SendRtpPacket(RTC::RtpPacket* packet)
+	void Transport::SendRtpPacket(RTC::RtpPacket* packet, uint8_t transportWideCcId, RTC::Pacer::Priority priority)
+	{
+		MS_TRACE();
+
+		if (!this->pacer)
+		{
+			TransmitRtpPacket(packet, transportWideCcId);
+
+			return;
+		}
+
+		this->pacer->SetBitrate(GetPacingBitrate(DepLibUV::GetTime()));
+		this->pacer->SendRtpPacket(packet, transportWideCcId, priority);
+	}
+
+	/**
+	 * If transportWideCcId is given and the packet carries that header extension
+	 * it is stamped with the transport-wide sequence number of this Transport
+	 * (and restored once sent since the packet may be forwarded to others).
+	 */
+	void Transport::TransmitRtpPacket(RTC::RtpPacket* packet, uint8_t transportWideCcId)
 	{
 		MS_TRACE();
 
@@ -515,12 +659,40 @@ namespace RTC
 			return;
 		}
 
+		uint16_t sourceWideSeqNumber;
+		bool stamped = false;
+
+		if (transportWideCcId)
+		{
+			packet->AddExtensionMapping(RTC::RtpHeaderExtensionUri::Type::TRANSPORT_WIDE_CC_01, transportWideCcId);
+
+			if (packet->ReadTransportWideCc01(&sourceWideSeqNumber))
+			{
+				if (!this->sendSideBandwidthEstimator)
+					this->sendSideBandwidthEstimator.reset(new RTC::SendSideBandwidthEstimator());
+
+				uint16_t wideSeqNumber = this->sendSideBandwidthEstimator->PacketSent(packet->GetSize(), DepLibUV::GetTime());
+
+				packet->UpdateTransportWideCc01(wideSeqNumber);
+				stamped = true;
+			}
+		}
+
 		const uint8_t* data = packet->GetData();
 		size_t len = packet->GetSize();
+		bool encrypted = this->srtpSendSession->EncryptRtp(&data, &len);
+
+		if (stamped)
+			packet->UpdateTransportWideCc01(sourceWideSeqNumber);
 
-		if (!this->srtpSendSession->EncryptRtp(&data, &len))
+		if (!encrypted)
 			return;
 
+		this->packetTrace.Add(RTC::PacketTrace::Direction::OUT, RTC::PacketTrace::Type::RTP, data, len);
+		this->counters.rtpPacketsSent++;
+		this->counters.rtpBytesSent += len;
+		RTC::Metrics::PacketForwarded();
+
 		this->selectedTuple->Send(data, len);
 	}
 
@@ -546,6 +718,10 @@ namespace RTC
 		if (!this->srtpSendSession->EncryptRtcp(&data, &len))
 			return;
 
+		this->packetTrace.Add(RTC::PacketTrace::Direction::OUT, RTC::PacketTrace::Type::RTCP, data, len);
+		this->counters.rtcpPacketsSent++;
+		this->counters.rtcpBytesSent += len;
+
 		this->selectedTuple->Send(data, len);
 	}
 
@@ -571,6 +747,10 @@ namespace RTC
 		if (!this->srtpSendSession->EncryptRtcp(&data, &len))
 			return;
 
+		this->packetTrace.Add(RTC::PacketTrace::Direction::OUT, RTC::PacketTrace::Type::RTCP, data, len);
+		this->counters.rtcpPacketsSent++;
+		this->counters.rtcpBytesSent += len;
+
 		this->selectedTuple->Send(data, len);
 	}
 
@@ -629,6 +809,136 @@ namespace RTC
 		}
 	}
 
+	void Transport::SetRtpReceiverRemb(RTC::RtpReceiver* rtpReceiver, uint32_t bitrate)
+	{
+		MS_TRACE();
+
+		// No limit from the remote receivers.
+		if (!bitrate)
+			this->rtpReceiversRemb.erase(rtpReceiver);
+		else
+			this->rtpReceiversRemb[rtpReceiver] = bitrate;
+
+		uint64_t now = DepLibUV::GetTime();
+
+		if (now - this->lastRembSentTime >= REMB_MIN_INTERVAL)
+			SendRemb(now);
+	}
+
+	void Transport::ReceiveTransportFeedback(RTC::RTCP::FeedbackRtpTransportPacket* feedback)
+	{
+		MS_TRACE();
+
+		// Nothing was sent with transport-wide sequence numbers.
+		if (!this->sendSideBandwidthEstimator)
+			return;
+
+		this->sendSideBandwidthEstimator->ReceiveFeedback(feedback, DepLibUV::GetTime());
+	}
+
+	void Transport::ReceiveRemb(RTC::RTCP::FeedbackPsRembPacket* remb)
+	{
+		MS_TRACE();
+
+		uint64_t bitrate = remb->GetBitrate();
+
+		this->remoteRembBitrate = bitrate > UINT32_MAX ? UINT32_MAX : static_cast<uint32_t>(bitrate);
+		this->remoteRembTime = DepLibUV::GetTime();
+	}
+
+	/**
+	 * The one given by the app or derived from the transport-cc or REMB
+	 * estimation (0 if none).
+	 */
+	uint32_t Transport::GetPacingBitrate(uint64_t now) const
+	{
+		MS_TRACE();
+
+		if (this->pacerBitrate)
+			return this->pacerBitrate;
+
+		uint32_t bitrate = GetAvailableBitrate();
+
+		if (!bitrate && this->remoteRembTime && now - this->remoteRembTime <= REMOTE_REMB_TIMEOUT)
+			bitrate = this->remoteRembBitrate;
+
+		return static_cast<uint32_t>(std::min(bitrate * PACING_FACTOR, static_cast<double>(UINT32_MAX)));
+	}
+
+	void Transport::SendRemb(uint64_t now)
+	{
+		MS_TRACE();
+
+		// REMB not negotiated with the remote peer.
+		if (!this->remoteBitrateEstimator)
+			return;
+
+		uint64_t bitrate = this->estimatedBitrate;
+		std::vector<uint32_t> ssrcs = this->estimatedSsrcs;
+
+		// Limit the estimated bitrate to what the remote receivers can take. It
+		// is just known if all the video RtpReceivers have remote receivers with
+		// REMB.
+		if (!this->rtpReceiversRemb.empty())
+		{
+			uint64_t receiversBitrate = 0;
+			bool limited = true;
+
+			for (auto rtpReceiver : this->rtpReceivers)
+			{
+				if (rtpReceiver->kind == RTC::Media::Kind::VIDEO &&
+					this->rtpReceiversRemb.find(rtpReceiver) == this->rtpReceiversRemb.end())
+				{
+					limited = false;
+
+					break;
+				}
+			}
+
+			if (limited)
+			{
+				for (auto& kv : this->rtpReceiversRemb)
+				{
+					receiversBitrate += kv.second;
+				}
+
+				if (!bitrate || receiversBitrate < bitrate)
+					bitrate = receiversBitrate;
+			}
+
+			// Without estimation announce the SSRCs of the limited RtpReceivers.
+			if (ssrcs.empty())
+			{
+				for (auto& kv : this->rtpListener.ssrcTable)
+				{
+					if (this->rtpReceiversRemb.find(kv.second) != this->rtpReceiversRemb.end())
+						ssrcs.push_back(kv.first);
+				}
+			}
+		}
+
+		if (!bitrate || ssrcs.empty())
+			return;
+
+		if (bitrate > UINT32_MAX)
+			bitrate = UINT32_MAX;
+
+		MS_DEBUG_TAG(rbe, "sending RTCP REMB packet [bitrate:%" PRIu64 "]", bitrate);
+		for (auto ssrc: ssrcs)
+		{
+			MS_DEBUG_TAG(rbe, "  ssrc : %" PRIu32, ssrc);
+		}
+
+		RTC::RTCP::FeedbackPsRembPacket packet(0, 0);
+		packet.SetBitrate(bitrate);
+		packet.SetSsrcs(ssrcs);
+		packet.Serialize(Transport::rtcpBuffer);
+		this->SendRtcpPacket(&packet);
+
+		this->lastRembBitrate = static_cast<uint32_t>(bitrate);
+		this->lastRembSentTime = now;
+	}
+
 	inline
 	void Transport::onPacketRecv(RTC::TransportTuple* tuple, const uint8_t* data, size_t len)
 	{
@@ -642,12 +952,24 @@ namespace RTC
 		// Check if it's RTCP.
 		else if (RTCP::Packet::IsRtcp(data, len))
 		{
+			this->packetTrace.Add(RTC::PacketTrace::Direction::IN, RTC::PacketTrace::Type::RTCP, data, len);
+			this->counters.rtcpPacketsReceived++;
+			this->counters.rtcpBytesReceived += len;
+
 			onRtcpDataRecv(tuple, data, len);
 		}
 		// Check if it's RTP.
 		else if (RtpPacket::IsRtp(data, len))
 		{
+			this->packetTrace.Add(RTC::PacketTrace::Direction::IN, RTC::PacketTrace::Type::RTP, data, len);
+			this->counters.rtpPacketsReceived++;
+			this->counters.rtpBytesReceived += len;
+			RTC::Metrics::packetSize.Add(len);
+
+			// The packets sent while handling it are forwarded out of it.
+			RTC::Metrics::BeginForwarding();
 			onRtpDataRecv(tuple, data, len);
+			RTC::Metrics::EndForwarding();
 		}
 		// Check if it's DTLS.
 		else if (DtlsTransport::IsDtls(data, len))
@@ -770,6 +1092,23 @@ namespace RTC
 		// Trick for clients performing aggressive ICE regardless we are ICE-Lite.
 		this->iceServer->ForceSelectedTuple(tuple);
 
+		// Report its arrival to the remote sender (transport-cc).
+		if (rtpReceiver->GetTransportWideCc01ExtensionId())
+		{
+			uint16_t wideSeqNumber;
+
+			packet->AddExtensionMapping(
+				RTC::RtpHeaderExtensionUri::Type::TRANSPORT_WIDE_CC_01, rtpReceiver->GetTransportWideCc01ExtensionId());
+
+			if (packet->ReadTransportWideCc01(&wideSeqNumber))
+			{
+				if (!this->transportFeedbackGenerator)
+					this->transportFeedbackGenerator.reset(new RTC::TransportFeedbackGenerator(this));
+
+				this->transportFeedbackGenerator->ReceivePacket(wideSeqNumber, packet->GetSsrc(), DepLibUV::GetTime());
+			}
+		}
+
 		// Pass the RTP packet to the corresponding RtpReceiver.
 		rtpReceiver->ReceiveRtpPacket(packet);
 
@@ -962,6 +1301,8 @@ namespace RTC
 		// Unset the selected tuple.
 		this->selectedTuple = nullptr;
 
+		this->pacer.reset();
+
 		// Notify.
 		event_data[k_class] = "Transport";
 		event_data[k_iceState] = v_disconnected;
@@ -1111,16 +1452,24 @@ namespace RTC
 	{
 		MS_TRACE();
 
-		MS_DEBUG_TAG(rbe, "sending RTCP REMB packet [bitrate:%" PRIu32 "]", bitrate);
-		for (auto ssrc: ssrcs)
-		{
-			MS_DEBUG_TAG(rbe, "  ssrc : %" PRIu32, ssrc);
-		}
+		this->estimatedBitrate = bitrate;
+		this->estimatedSsrcs = ssrcs;
 
-		RTC::RTCP::FeedbackPsRembPacket packet(0, 0);
-		packet.SetBitrate(bitrate);
-		packet.SetSsrcs(ssrcs);
-		packet.Serialize(Transport::rtcpBuffer);
-		this->SendRtcpPacket(&packet);
+		SendRemb(DepLibUV::GetTime());
+	}
+
+	void Transport::onTransportFeedbackGeneratorFeedback(RTC::TransportFeedbackGenerator* transportFeedbackGenerator, RTC::RTCP::FeedbackRtpTransportPacket* packet)
+	{
+		MS_TRACE();
+
+		packet->Serialize(Transport::rtcpBuffer);
+		this->SendRtcpPacket(packet);
+	}
+
+	void Transport::onPacerRtpPacket(RTC::Pacer* pacer, RTC::RtpPacket* packet, uint8_t transportWideCcId)
+	{
+		MS_TRACE();
+
+		TransmitRtpPacket(packet, transportWideCcId);
 	}
 }
@@ -0,0 +1,125 @@
+#define MS_CLASS "RTC::TransportFeedbackGenerator"
+// #define MS_LOG_DEV
+#define MS_LOG_HOT_PATH
+
+#include "RTC/TransportFeedbackGenerator.hpp"
+#include "Logger.hpp"
+#include <vector>
+
+namespace RTC
+{
+	/* Class variables. */
+
+	constexpr uint64_t TransportFeedbackGenerator::Interval;
+	constexpr size_t TransportFeedbackGenerator::MaxStatusCount;
+
+	/* Instance methods. */
+
+	TransportFeedbackGenerator::TransportFeedbackGenerator(Listener* listener) :
+		listener(listener)
+	{
+		MS_TRACE();
+	}
+
+	Json::Value TransportFeedbackGenerator::toJson() const
+	{
+		MS_TRACE();
+
+		static const Json::StaticString k_pendingPackets("pendingPackets");
+		static const Json::StaticString k_feedbackPacketsSent("feedbackPacketsSent");
+
+		Json::Value json(Json::objectValue);
+
+		json[k_pendingPackets] = (Json::UInt)this->arrivals.size();
+		json[k_feedbackPacketsSent] = (Json::UInt)this->feedbackPacketsSent;
+
+		return json;
+	}
+
+	void TransportFeedbackGenerator::ReceivePacket(uint16_t wideSeqNumber, uint32_t mediaSsrc, uint64_t now)
+	{
+		MS_TRACE();
+
+		int64_t seq;
+
+		if (!this->started)
+		{
+			this->started = true;
+			this->lastSeq = wideSeqNumber;
+			this->baseSeq = wideSeqNumber;
+			this->lastFeedbackTime = now;
+		}
+
+		// Unwrap it relative to the latest received one.
+		seq = this->lastSeq + static_cast<int16_t>(wideSeqNumber - static_cast<uint16_t>(this->lastSeq));
+
+		if (seq > this->lastSeq)
+			this->lastSeq = seq;
+
+		// Already reported.
+		if (seq < this->baseSeq)
+		{
+			MS_DEBUG_DEV("ignoring already reported packet [wideSeqNumber:%" PRIu16 "]", wideSeqNumber);
+
+			return;
+		}
+
+		// Keep the first arrival of duplicated packets.
+		this->arrivals.emplace(seq, now);
+		this->mediaSsrc = mediaSsrc;
+
+		if (
+			now - this->lastFeedbackTime >= TransportFeedbackGenerator::Interval ||
+			static_cast<size_t>(this->lastSeq - this->baseSeq + 1) >= TransportFeedbackGenerator::MaxStatusCount
+		)
+		{
+			SendFeedback(now);
+		}
+	}
+
+	void TransportFeedbackGenerator::SendFeedback(uint64_t now)
+	{
+		MS_TRACE();
+
+		if (this->arrivals.empty())
+			return;
+
+		int64_t lastSeq = this->arrivals.rbegin()->first;
+
+		// After a big jump do not report the whole gap, just the latest packets.
+		if (static_cast<size_t>(lastSeq - this->baseSeq + 1) > TransportFeedbackGenerator::MaxStatusCount)
+		{
+			this->baseSeq = lastSeq - TransportFeedbackGenerator::MaxStatusCount + 1;
+			this->arrivals.erase(this->arrivals.begin(), this->arrivals.lower_bound(this->baseSeq));
+		}
+
+		std::vector<RTC::RTCP::FeedbackRtpTransportPacket::PacketResult> results;
+
+		results.reserve(lastSeq - this->baseSeq + 1);
+
+		for (int64_t seq = this->baseSeq; seq <= lastSeq; ++seq)
+		{
+			RTC::RTCP::FeedbackRtpTransportPacket::PacketResult result;
+			auto it = this->arrivals.find(seq);
+
+			result.sequenceNumber = static_cast<uint16_t>(seq);
+
+			if (it != this->arrivals.end())
+			{
+				result.received = true;
+				result.receivedAtMs = static_cast<int64_t>(it->second);
+			}
+
+			results.push_back(result);
+		}
+
+		RTC::RTCP::FeedbackRtpTransportPacket packet(0, this->mediaSsrc, this->feedbackPacketCount++, results);
+
+		this->baseSeq = lastSeq + 1;
+		this->arrivals.clear();
+		this->lastFeedbackTime = now;
+		this->feedbackPacketsSent++;
+
+		this->listener->onTransportFeedbackGeneratorFeedback(this, &packet);
+	}
+}
@@ -1,5 +1,6 @@
 #define MS_CLASS "RTC::UdpSocket"
 // #define MS_LOG_DEV
+#define MS_LOG_HOT_PATH
 
 #include "RTC/UdpSocket.hpp"
 #include "Settings.hpp"
@@ -0,0 +1,81 @@
+#define MS_CLASS "RTC::VideoLastN"
+// #define MS_LOG_DEV
+
+#include "RTC/VideoLastN.hpp"
+#include "Logger.hpp"
+#include <algorithm> // std::find(), std::rotate()
+
+namespace RTC
+{
+	/* Instance methods. */
+
+	VideoLastN::VideoLastN(size_t lastN) :
+		lastN(lastN)
+	{
+		MS_TRACE();
+	}
+
+	void VideoLastN::AddPeer(uint32_t peerId)
+	{
+		MS_TRACE();
+
+		this->speakers.push_back(peerId);
+	}
+
+	void VideoLastN::RemovePeer(uint32_t peerId)
+	{
+		MS_TRACE();
+
+		auto it = std::find(this->speakers.begin(), this->speakers.end(), peerId);
+
+		if (it != this->speakers.end())
+			this->speakers.erase(it);
+	}
+
+	/**
+	 * Moves the Peer to the front. Returns false if it was already there (or it
+	 * is unknown) so the selection did not change.
+	 */
+	bool VideoLastN::SetDominantSpeaker(uint32_t peerId)
+	{
+		MS_TRACE();
+
+		auto it = std::find(this->speakers.begin(), this->speakers.end(), peerId);
+
+		if (it == this->speakers.end() || it == this->speakers.begin())
+			return false;
+
+		std::rotate(this->speakers.begin(), it, it + 1);
+
+		return true;
+	}
+
+	/**
+	 * Whether the video of the receiver Peer (the one sending it to the room)
+	 * is forwarded to the sender Peer (the one it is sent to).
+	 */
+	bool VideoLastN::IsForwarded(uint32_t receiverPeerId, uint32_t senderPeerId) const
+	{
+		MS_TRACE();
+
+		if (!this->lastN)
+			return true;
+
+		size_t position = 0;
+
+		// The sender Peer does not take a place in its own last-N.
+		for (auto peerId : this->speakers)
+		{
+			if (peerId == senderPeerId)
+				continue;
+
+			if (position++ >= this->lastN)
+				return false;
+
+			if (peerId == receiverPeerId)
+				return true;
+		}
+
+		return false;
+	}
+}
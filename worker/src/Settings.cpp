@@ -67,6 +67,7 @@ void Settings::SetConfiguration(int argc, char* argv[])
 		{ "rtcMaxPort",          optional_argument, nullptr, 'M' },
 		{ "dtlsCertificateFile", optional_argument, nullptr, 'c' },
 		{ "dtlsPrivateKeyFile",  optional_argument, nullptr, 'p' },
+		{ "channelFormat",       optional_argument, nullptr, 'f' },
 		{ 0, 0, 0, 0 }
 	};
 
@@ -130,6 +131,11 @@ void Settings::SetConfiguration(int argc, char* argv[])
 				Settings::configuration.dtlsPrivateKeyFile = value_string;
 				break;
 
+			case 'f':
+				value_string = std::string(optarg);
+				SetChannelFormat(value_string);
+				break;
+
 			// Invalid option.
 			case '?':
 				if (isprint(optopt))
@@ -227,6 +233,7 @@ void Settings::PrintConfiguration()
 		MS_DEBUG_TAG(info, "  dtlsCertificateFile : \"%s\"", Settings::configuration.dtlsCertificateFile.c_str());
 		MS_DEBUG_TAG(info, "  dtlsPrivateKeyFile  : \"%s\"", Settings::configuration.dtlsPrivateKeyFile.c_str());
 	}
+	MS_DEBUG_TAG(info, "  channelFormat       : \"%s\"", Settings::configuration.channelFormat.c_str());
 
 	MS_DEBUG_TAG(info, "</configuration>");
 }
@@ -371,6 +378,19 @@ void Settings::SetLogLevel(std::string &level)
 	Settings::configuration.logLevel = Settings::string2LogLevel[level];
 }
 
+void Settings::SetChannelFormat(std::string &format)
+{
+	MS_TRACE();
+
+	// Lowcase given format.
+	Utils::String::ToLowerCase(format);
+
+	if (format != "json" && format != "binary")
+		MS_THROW_ERROR("invalid value '%s' for channelFormat", format.c_str());
+
+	Settings::configuration.channelFormat = format;
+}
+
 void Settings::SetRtcIPv4(const std::string &ip)
 {
 	MS_TRACE();
@@ -0,0 +1,147 @@
+#define MS_CLASS "FileWriter"
+// #define MS_LOG_DEV
+
+#include "handles/FileWriter.hpp"
+#include "MediaSoupError.hpp"
+#include "DepLibUV.hpp"
+#include "Logger.hpp"
+#include <fcntl.h> // O_WRONLY, O_CREAT, O_TRUNC
+
+/* Static methods for UV callbacks. */
+
+static inline
+void on_write(uv_fs_t* req)
+{
+	auto fileWriter = static_cast<FileWriter*>(req->data);
+	ssize_t result = req->result;
+
+	uv_fs_req_cleanup(req);
+
+	fileWriter->onUvWrite(result);
+}
+
+static inline
+void on_close(uv_fs_t* req)
+{
+	auto fileWriter = static_cast<FileWriter*>(req->data);
+
+	uv_fs_req_cleanup(req);
+
+	fileWriter->onUvClose();
+}
+
+/* Instance methods. */
+
+FileWriter::FileWriter(Listener* listener, const std::string& path) :
+	listener(listener)
+{
+	MS_TRACE();
+
+	uv_fs_t openReq;
+	int fd = uv_fs_open(DepLibUV::GetLoop(), &openReq, path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644, nullptr);
+
+	uv_fs_req_cleanup(&openReq);
+
+	if (fd < 0)
+		MS_THROW_ERROR("uv_fs_open() failed: %s", uv_strerror(fd));
+
+	this->fd = fd;
+	this->writeReq.data = (void*)this;
+	this->closeReq.data = (void*)this;
+}
+
+void FileWriter::Close()
+{
+	MS_TRACE();
+
+	if (this->closing)
+		return;
+
+	this->closing = true;
+
+	// Otherwise closed once written.
+	if (!this->writing)
+		uv_fs_close(DepLibUV::GetLoop(), &this->closeReq, this->fd, (uv_fs_cb)on_close);
+}
+
+void FileWriter::Write(std::vector<uint8_t>&& data, int64_t offset)
+{
+	MS_TRACE();
+
+	MS_ASSERT(!this->writing, "already writing");
+	MS_ASSERT(!this->closing, "closing");
+
+	this->data = std::move(data);
+	this->pos = 0;
+	this->offset = offset;
+	this->writing = true;
+
+	WriteRest();
+}
+
+/**
+ * Writes the rest of data (a write may be partial).
+ */
+void FileWriter::WriteRest()
+{
+	MS_TRACE();
+
+	uv_buf_t buf = uv_buf_init(
+		reinterpret_cast<char*>(this->data.data() + this->pos), this->data.size() - this->pos);
+
+	int err = uv_fs_write(
+		DepLibUV::GetLoop(), &this->writeReq, this->fd, &buf, 1, this->offset, (uv_fs_cb)on_write);
+
+	if (err)
+		onUvWrite(err);
+}
+
+inline
+void FileWriter::onUvWrite(ssize_t result)
+{
+	MS_TRACE();
+
+	// No progress is an error too.
+	if (result == 0)
+		result = UV_EIO;
+
+	if (result > 0)
+	{
+		this->pos += result;
+		this->offset += result;
+
+		if (this->pos < this->data.size())
+		{
+			WriteRest();
+
+			return;
+		}
+	}
+
+	int err = result < 0 ? static_cast<int>(result) : 0;
+	// Close() called while writing.
+	bool closing = this->closing;
+
+	if (err)
+		MS_ERROR("uv_fs_write() failed: %s", uv_strerror(err));
+
+	this->writing = false;
+	this->data.clear();
+
+	if (this->listener)
+		this->listener->onFileWriterWrite(this, this->pos, err);
+
+	if (closing)
+		uv_fs_close(DepLibUV::GetLoop(), &this->closeReq, this->fd, (uv_fs_cb)on_close);
+}
+
+inline
+void FileWriter::onUvClose()
+{
+	MS_TRACE();
+
+	if (this->listener)
+		this->listener->onFileWriterClosed(this);
+
+	delete this;
+}
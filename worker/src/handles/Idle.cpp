@@ -0,0 +1,86 @@
+#define MS_CLASS "Idle"
+// #define MS_LOG_DEV
+
+#include "handles/Idle.hpp"
+#include "MediaSoupError.hpp"
+#include "DepLibUV.hpp"
+#include "Logger.hpp"
+
+/* Static methods for UV callbacks. */
+
+static inline
+void on_idle(uv_idle_t* handle)
+{
+	static_cast<Idle*>(handle->data)->onUvIdle();
+}
+
+static inline
+void on_close(uv_handle_t* handle)
+{
+	delete handle;
+}
+
+/* Instance methods. */
+
+Idle::Idle(Listener* listener) :
+	listener(listener)
+{
+	MS_TRACE_STD();
+
+	int err;
+
+	this->uvHandle = new uv_idle_t;
+	uvHandle->data = (void*)this;
+
+	err = uv_idle_init(DepLibUV::GetLoop(), this->uvHandle);
+	if (err)
+	{
+		delete this->uvHandle;
+		this->uvHandle = nullptr;
+		MS_THROW_ERROR_STD("uv_idle_init() failed: %s", uv_strerror(err));
+	}
+
+	// Don't keep the loop alive just because of this handle.
+	uv_unref((uv_handle_t*)this->uvHandle);
+}
+
+void Idle::Destroy()
+{
+	MS_TRACE_STD();
+
+	uv_close((uv_handle_t*)this->uvHandle, (uv_close_cb)on_close);
+
+	// Delete this.
+	delete this;
+}
+
+void Idle::Start()
+{
+	MS_TRACE_STD();
+
+	int err;
+
+	err = uv_idle_start(this->uvHandle, (uv_idle_cb)on_idle);
+	if (err)
+		MS_THROW_ERROR_STD("uv_idle_start() failed: %s", uv_strerror(err));
+}
+
+void Idle::Stop()
+{
+	MS_TRACE_STD();
+
+	int err;
+
+	err = uv_idle_stop(this->uvHandle);
+	if (err)
+		MS_THROW_ERROR_STD("uv_idle_stop() failed: %s", uv_strerror(err));
+}
+
+inline
+void Idle::onUvIdle()
+{
+	MS_TRACE_STD();
+
+	// Notify the listener.
+	this->listener->onIdle(this);
+}
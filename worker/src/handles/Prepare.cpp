@@ -0,0 +1,86 @@
+#define MS_CLASS "Prepare"
+// #define MS_LOG_DEV
+
+#include "handles/Prepare.hpp"
+#include "MediaSoupError.hpp"
+#include "DepLibUV.hpp"
+#include "Logger.hpp"
+
+/* Static methods for UV callbacks. */
+
+static inline
+void on_prepare(uv_prepare_t* handle)
+{
+	static_cast<Prepare*>(handle->data)->onUvPrepare();
+}
+
+static inline
+void on_close(uv_handle_t* handle)
+{
+	delete handle;
+}
+
+/* Instance methods. */
+
+Prepare::Prepare(Listener* listener) :
+	listener(listener)
+{
+	MS_TRACE_STD();
+
+	int err;
+
+	this->uvHandle = new uv_prepare_t;
+	uvHandle->data = (void*)this;
+
+	err = uv_prepare_init(DepLibUV::GetLoop(), this->uvHandle);
+	if (err)
+	{
+		delete this->uvHandle;
+		this->uvHandle = nullptr;
+		MS_THROW_ERROR_STD("uv_prepare_init() failed: %s", uv_strerror(err));
+	}
+
+	// Don't keep the loop alive just because of this handle.
+	uv_unref((uv_handle_t*)this->uvHandle);
+}
+
+void Prepare::Destroy()
+{
+	MS_TRACE_STD();
+
+	uv_close((uv_handle_t*)this->uvHandle, (uv_close_cb)on_close);
+
+	// Delete this.
+	delete this;
+}
+
+void Prepare::Start()
+{
+	MS_TRACE_STD();
+
+	int err;
+
+	err = uv_prepare_start(this->uvHandle, (uv_prepare_cb)on_prepare);
+	if (err)
+		MS_THROW_ERROR_STD("uv_prepare_start() failed: %s", uv_strerror(err));
+}
+
+void Prepare::Stop()
+{
+	MS_TRACE_STD();
+
+	int err;
+
+	err = uv_prepare_stop(this->uvHandle);
+	if (err)
+		MS_THROW_ERROR_STD("uv_prepare_stop() failed: %s", uv_strerror(err));
+}
+
+inline
+void Prepare::onUvPrepare()
+{
+	MS_TRACE_STD();
+
+	// Notify the listener.
+	this->listener->onPrepare(this);
+}
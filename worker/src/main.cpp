@@ -11,6 +11,8 @@
 #include "RTC/UdpSocket.hpp"
 #include "RTC/TcpServer.hpp"
 #include "RTC/DtlsTransport.hpp"
+#include "RTC/KeyFrameCache.hpp"
+#include "RTC/Pacer.hpp"
 #include "RTC/SrtpSession.hpp"
 #include "Loop.hpp"
 #include "MediaSoupError.hpp"
@@ -66,6 +68,10 @@ int main(int argc, char* argv[])
 	// Print the effective configuration.
 	Settings::PrintConfiguration();
 
+	// Use the negotiated Channel format.
+	if (Settings::configuration.channelFormat == "binary")
+		channel->SetFormat(Channel::UnixStreamSocket::Format::BINARY);
+
 	MS_DEBUG_TAG(info, "starting " MS_PROCESS_NAME " [pid:%ld]", (long)getpid());
 
 	#if defined(MS_LITTLE_ENDIAN)
@@ -159,6 +165,8 @@ void destroy()
 
 	// Free static stuff.
 	RTC::DtlsTransport::ClassDestroy();
+	RTC::KeyFrameCache::ClassDestroy();
+	RTC::Pacer::ClassDestroy();
 	Utils::Crypto::ClassDestroy();
 	DepLibUV::ClassDestroy();
 	DepOpenSSL::ClassDestroy();
@@ -0,0 +1,215 @@
+#include "include/catch.hpp"
+#include "common.hpp"
+#include "RTC/AudioLevelObserver.hpp"
+#include "RTC/RtpPacket.hpp"
+#include <vector>
+
+using namespace RTC;
+
+// RTP packet with a one-byte ssrc-audio-level extension (id 1).
+static uint8_t buffer[] =
+{
+	0b10010000, 0b01100100, 0, 1,
+	0, 0, 0, 4,
+	0, 0, 0, 5,
+	0xBE, 0xDE, 0, 1,
+	0x10, 0, 0, 0,
+	0x11
+};
+
+// Same packet without header extension.
+static uint8_t buffer2[] =
+{
+	0b10000000, 0b01100100, 0, 1,
+	0, 0, 0, 4,
+	0, 0, 0, 5,
+	0x11
+};
+
+class AudioLevelObserverListener :
+	public AudioLevelObserver::Listener
+{
+public:
+	virtual void onAudioLevelObserverDominantSpeaker(AudioLevelObserver* audioLevelObserver, uint32_t streamId) override
+	{
+		this->dominantSpeakers.push_back(streamId);
+	}
+
+public:
+	std::vector<uint32_t> dominantSpeakers;
+};
+
+// Volume is given in -dBov (127 is silence).
+static bool receivePacket(AudioLevelObserver& observer, uint32_t streamId, uint8_t volume, uint64_t now, bool* resumed = nullptr)
+{
+	bool dummy;
+
+	buffer[17] = volume;
+
+	RtpPacket* packet = RtpPacket::Parse(buffer, sizeof(buffer));
+
+	packet->AddExtensionMapping(RtpHeaderExtensionUri::Type::SSRC_AUDIO_LEVEL, 1);
+
+	bool forwarded = observer.ReceivePacket(streamId, packet, now, resumed ? resumed : &dummy);
+
+	delete packet;
+
+	return forwarded;
+}
+
+SCENARIO("audio level observer", "[rtp][audiolevel]")
+{
+	SECTION("just the lastN loudest streams are forwarded")
+	{
+		AudioLevelObserverListener listener;
+		AudioLevelObserver observer(&listener, 2);
+		uint64_t now = 1000;
+		bool resumed;
+
+		// The first streams take the free slots.
+		REQUIRE(receivePacket(observer, 1, 10, now) == true);
+		REQUIRE(receivePacket(observer, 2, 40, now) == true);
+		REQUIRE(receivePacket(observer, 3, 90, now) == false);
+
+		REQUIRE(listener.dominantSpeakers == std::vector<uint32_t>({ 1 }));
+
+		// Stream 3 gets louder than stream 2, but not for long.
+		for (uint64_t i = 0; i < 5; ++i)
+		{
+			now += 20;
+
+			REQUIRE(receivePacket(observer, 1, 10, now) == true);
+			REQUIRE(receivePacket(observer, 2, 40, now) == true);
+			REQUIRE(receivePacket(observer, 3, 20, now) == false);
+		}
+
+		// Stream 2 was selected less than MinHoldTime ago.
+		while (now < 1000 + AudioLevelObserver::MinHoldTime)
+		{
+			REQUIRE(receivePacket(observer, 3, 20, now) == false);
+
+			receivePacket(observer, 1, 10, now);
+			receivePacket(observer, 2, 40, now);
+			now += 20;
+		}
+
+		// Now stream 3 replaces stream 2 in the next evaluation.
+		for (uint64_t i = 0; i < AudioLevelObserver::Interval / 20 + 1; ++i)
+		{
+			receivePacket(observer, 1, 10, now);
+			receivePacket(observer, 2, 40, now);
+			now += 20;
+		}
+
+		REQUIRE(receivePacket(observer, 3, 20, now, &resumed) == true);
+		REQUIRE(resumed == true);
+		REQUIRE(receivePacket(observer, 3, 20, now, &resumed) == true);
+		REQUIRE(resumed == false);
+		REQUIRE(receivePacket(observer, 2, 40, now) == false);
+
+		REQUIRE(observer.IsForwarded(1) == true);
+		REQUIRE(observer.IsForwarded(2) == false);
+		REQUIRE(observer.IsForwarded(3) == true);
+		REQUIRE(observer.toJson()["selectionChanges"].asUInt() == 1);
+
+		// Removing a selected stream frees its slot.
+		observer.RemoveStream(1);
+		now += AudioLevelObserver::Interval;
+
+		REQUIRE(receivePacket(observer, 2, 40, now) == true);
+	}
+
+	SECTION("dominant speaker changes with hysteresis")
+	{
+		AudioLevelObserverListener listener;
+		AudioLevelObserver observer(&listener);
+		uint64_t now = 1000;
+
+		REQUIRE(observer.HasDominantSpeaker() == false);
+
+		// Similar levels do not change the dominant speaker.
+		for (uint64_t i = 0; i < 100; ++i)
+		{
+			REQUIRE(receivePacket(observer, 1, 30, now) == true);
+			REQUIRE(receivePacket(observer, 2, 28, now) == true);
+			now += 20;
+		}
+
+		REQUIRE(listener.dominantSpeakers == std::vector<uint32_t>({ 1 }));
+
+		// Stream 1 goes silent.
+		for (uint64_t i = 0; i < 100; ++i)
+		{
+			receivePacket(observer, 1, 127, now);
+			receivePacket(observer, 2, 28, now);
+			now += 20;
+		}
+
+		REQUIRE(listener.dominantSpeakers == std::vector<uint32_t>({ 1, 2 }));
+		REQUIRE(observer.GetDominantSpeaker() == 2);
+
+		// Stream 2 stops sending so it is considered silent.
+		for (uint64_t i = 0; i < 100; ++i)
+		{
+			receivePacket(observer, 1, 50, now);
+			now += 20;
+		}
+
+		REQUIRE(listener.dominantSpeakers == std::vector<uint32_t>({ 1, 2, 1 }));
+		REQUIRE(observer.toJson()["dominantSpeakerChanges"].asUInt() == 3);
+	}
+
+	SECTION("silent packets are suppressed after the grace period")
+	{
+		AudioLevelObserverListener listener;
+		AudioLevelObserver observer(&listener);
+		uint64_t now = 1000;
+		bool resumed;
+
+		REQUIRE_THROWS(observer.SetSilenceThreshold(-128));
+
+		observer.SetSilenceThreshold(-127);
+
+		for (; now < 1000 + AudioLevelObserver::SilenceGracePeriod; now += 20)
+		{
+			REQUIRE(receivePacket(observer, 1, 127, now) == true);
+		}
+
+		for (; now < 1480 + AudioLevelObserver::ComfortInterval; now += 20)
+		{
+			REQUIRE(receivePacket(observer, 1, 127, now) == false);
+		}
+
+		// Comfort packet.
+		REQUIRE(receivePacket(observer, 1, 127, now, &resumed) == true);
+		REQUIRE(resumed == true);
+
+		now += 20;
+		REQUIRE(receivePacket(observer, 1, 127, now) == false);
+
+		// Voice is forwarded right away.
+		now += 20;
+		REQUIRE(receivePacket(observer, 1, 30, now, &resumed) == true);
+		REQUIRE(resumed == true);
+
+		REQUIRE(observer.toJson()["suppressedPackets"].asUInt() == 20);
+		REQUIRE(observer.toJson()["forwardedPackets"].asUInt() == 27);
+	}
+
+	SECTION("streams without audio level are always forwarded")
+	{
+		AudioLevelObserverListener listener;
+		AudioLevelObserver observer(&listener, 1);
+		bool resumed;
+
+		REQUIRE(receivePacket(observer, 1, 10, 1000) == true);
+
+		RtpPacket* packet = RtpPacket::Parse(buffer2, sizeof(buffer2));
+
+		REQUIRE(observer.ReceivePacket(2, packet, 1000, &resumed) == true);
+		REQUIRE(observer.IsForwarded(2) == true);
+		REQUIRE(listener.dominantSpeakers == std::vector<uint32_t>({ 1 }));
+
+		delete packet;
+	}
+}
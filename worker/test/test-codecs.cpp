@@ -0,0 +1,259 @@
+#include "include/catch.hpp"
+#include "include/helpers.hpp"
+#include "common.hpp"
+#include "RTC/Codecs/Tools.hpp"
+#include "RTC/RtpDictionaries.hpp"
+#include "RTC/RtpPacket.hpp"
+#include <string>
+
+using namespace RTC;
+using namespace RTC::Codecs;
+
+static uint8_t buffer[65536];
+
+static RtpCodecMime getMime(const char* name)
+{
+	RtpCodecMime mime;
+	std::string str(name);
+
+	mime.SetName(str);
+
+	return mime;
+}
+
+SCENARIO("codec payload descriptors", "[codecs]")
+{
+	SECTION("parse a VP8 key frame with long picture id, TL0PICIDX and TID")
+	{
+		RtpCodecMime mime = getMime("video/VP8");
+		// X=1, S=1, PID=0 | I=1, L=1, T=1 | M=1, PictureID=0x1234 | TL0PICIDX=7 |
+		// TID=0, Y=1 | VP8 payload header (P=0).
+		uint8_t payload[] = { 0x90, 0xE0, 0x92, 0x34, 0x07, 0x20, 0x10, 0x02, 0x00 };
+		PayloadDescriptor descriptor;
+
+		REQUIRE(Tools::ParsePayloadDescriptor(mime, payload, sizeof(payload), descriptor));
+		REQUIRE(descriptor.startOfFrame);
+		REQUIRE(descriptor.isKeyFrame);
+		REQUIRE(descriptor.hasPictureId);
+		REQUIRE(descriptor.hasLongPictureId);
+		REQUIRE(descriptor.pictureId == 0x1234);
+		REQUIRE(descriptor.hasTl0PicIdx);
+		REQUIRE(descriptor.tl0PicIdx == 7);
+		REQUIRE(descriptor.temporalLayer == 0);
+		REQUIRE(descriptor.layerSync);
+		REQUIRE(descriptor.payloadOffset == 6);
+		REQUIRE(Tools::IsKeyFrame(mime, payload, sizeof(payload)));
+
+		Tools::SetPictureId(payload, descriptor, 0x0102);
+		Tools::SetTl0PicIdx(payload, descriptor, 9);
+
+		REQUIRE(payload[2] == 0x81);
+		REQUIRE(payload[3] == 0x02);
+		REQUIRE(payload[4] == 9);
+	}
+
+	SECTION("parse a VP8 delta frame in temporal layer 2")
+	{
+		RtpCodecMime mime = getMime("video/VP8");
+		// X=1, S=1, PID=0 | I=1, T=1 | PictureID=0x12 | TID=2, Y=0 | P=1.
+		uint8_t payload[] = { 0x90, 0xA0, 0x12, 0x80, 0x01 };
+		PayloadDescriptor descriptor;
+
+		REQUIRE(Tools::ParsePayloadDescriptor(mime, payload, sizeof(payload), descriptor));
+		REQUIRE(descriptor.startOfFrame);
+		REQUIRE(!descriptor.isKeyFrame);
+		REQUIRE(!descriptor.hasLongPictureId);
+		REQUIRE(descriptor.pictureId == 0x12);
+		REQUIRE(!descriptor.hasTl0PicIdx);
+		REQUIRE(descriptor.temporalLayer == 2);
+		REQUIRE(!descriptor.layerSync);
+		REQUIRE(descriptor.payloadOffset == 4);
+	}
+
+	SECTION("parse a VP9 non flexible mode descriptor")
+	{
+		RtpCodecMime mime = getMime("video/VP9");
+		// I=1, P=1, L=1, B=1, E=1 | M=1, PictureID=0x0305 | TID=1, U=1, SID=2 |
+		// TL0PICIDX=200.
+		uint8_t payload[] = { 0xEC, 0x83, 0x05, 0x34, 0xC8, 0x00 };
+		PayloadDescriptor descriptor;
+
+		REQUIRE(Tools::ParsePayloadDescriptor(mime, payload, sizeof(payload), descriptor));
+		REQUIRE(descriptor.startOfFrame);
+		REQUIRE(descriptor.endOfFrame);
+		REQUIRE(!descriptor.isKeyFrame);
+		REQUIRE(descriptor.pictureId == 0x0305);
+		REQUIRE(descriptor.temporalLayer == 1);
+		REQUIRE(descriptor.layerSync);
+		REQUIRE(descriptor.spatialLayer == 2);
+		REQUIRE(descriptor.hasTl0PicIdx);
+		REQUIRE(descriptor.tl0PicIdx == 200);
+		REQUIRE(descriptor.payloadOffset == 5);
+	}
+
+	SECTION("parse a VP9 flexible mode descriptor with scalability structure")
+	{
+		RtpCodecMime mime = getMime("video/VP9");
+		// I=1, P=1, F=1, B=1, V=1 | PictureID=5 | P_DIFF=1, N=1 | P_DIFF=2 |
+		// N_S=1, Y=1, G=1 | 2 x WIDTH, HEIGHT | N_G=1 | R=1 | P_DIFF=1.
+		uint8_t payload[] =
+		{
+			0xDA, 0x05, 0x03, 0x04,
+			0x38, 0x01, 0x40, 0x00, 0xB4, 0x02, 0x80, 0x01, 0x68,
+			0x01, 0x04, 0x01,
+			0xAA
+		};
+		PayloadDescriptor descriptor;
+
+		REQUIRE(Tools::ParsePayloadDescriptor(mime, payload, sizeof(payload), descriptor));
+		REQUIRE(descriptor.startOfFrame);
+		REQUIRE(!descriptor.endOfFrame);
+		REQUIRE(descriptor.pictureId == 5);
+		REQUIRE(!descriptor.hasTl0PicIdx);
+		REQUIRE(descriptor.payloadOffset == 16);
+
+		// Without the VP9 bitstream.
+		REQUIRE(!Tools::ParsePayloadDescriptor(mime, payload, sizeof(payload) - 1, descriptor));
+	}
+
+	SECTION("truncated descriptors and other codecs are rejected")
+	{
+		RtpCodecMime vp8 = getMime("video/VP8");
+		RtpCodecMime opus = getMime("audio/opus");
+		uint8_t payload[] = { 0x90, 0xE0, 0x92 };
+		PayloadDescriptor descriptor;
+
+		REQUIRE(!Tools::ParsePayloadDescriptor(vp8, payload, sizeof(payload), descriptor));
+		REQUIRE(!Tools::ParsePayloadDescriptor(opus, payload, sizeof(payload), descriptor));
+		REQUIRE(Tools::IsKeyFrame(opus, payload, sizeof(payload)));
+	}
+
+	SECTION("parse H264 STAP-A and FU-A payloads")
+	{
+		RtpCodecMime mime = getMime("video/H264");
+		// STAP-A with a SPS.
+		uint8_t stapA[] = { 0x78, 0x00, 0x02, 0x67, 0x42, 0x00, 0x02, 0x68, 0xCE };
+		// FU-A start of an IDR slice.
+		uint8_t fuAStart[] = { 0x7C, 0x85, 0x88 };
+		// FU-A middle of an IDR slice.
+		uint8_t fuAMiddle[] = { 0x7C, 0x05, 0x88 };
+		// STAP-A announcing a NAL unit longer than the payload.
+		uint8_t wrongStapA[] = { 0x78, 0x00, 0x10, 0x67, 0x42 };
+		PayloadDescriptor descriptor;
+
+		REQUIRE(Tools::ParsePayloadDescriptor(mime, stapA, sizeof(stapA), descriptor));
+		REQUIRE(descriptor.isKeyFrame);
+
+		descriptor = PayloadDescriptor();
+
+		REQUIRE(Tools::ParsePayloadDescriptor(mime, fuAStart, sizeof(fuAStart), descriptor));
+		REQUIRE(descriptor.startOfFrame);
+		REQUIRE(!descriptor.endOfFrame);
+		REQUIRE(descriptor.isKeyFrame);
+
+		descriptor = PayloadDescriptor();
+
+		REQUIRE(Tools::ParsePayloadDescriptor(mime, fuAMiddle, sizeof(fuAMiddle), descriptor));
+		REQUIRE(!descriptor.startOfFrame);
+		REQUIRE(!descriptor.isKeyFrame);
+
+		REQUIRE(!Tools::ParsePayloadDescriptor(mime, wrongStapA, sizeof(wrongStapA), descriptor));
+	}
+
+	SECTION("parse packet-vp8.raw")
+	{
+		size_t len;
+
+		if (!Helpers::ReadBinaryFile("data/packet-vp8.raw", buffer, &len))
+			FAIL("cannot open file");
+
+		RtpPacket* packet = RtpPacket::Parse(buffer, len);
+
+		if (!packet)
+			FAIL("not a RTP packet");
+
+		REQUIRE(!packet->GetPayloadDescriptor());
+		REQUIRE(packet->ParsePayloadDescriptor(getMime("video/VP8")));
+
+		const PayloadDescriptor* descriptor = packet->GetPayloadDescriptor();
+
+		REQUIRE(descriptor);
+		REQUIRE(descriptor->isKeyFrame);
+		REQUIRE(descriptor->pictureId == 4660);
+		REQUIRE(descriptor->tl0PicIdx == 7);
+		REQUIRE(descriptor->temporalLayer == 0);
+		REQUIRE(descriptor->layerSync);
+
+		// The descriptor is kept in clones.
+		uint8_t cloneBuffer[256];
+		RtpPacket* clonedPacket = packet->Clone(cloneBuffer);
+
+		REQUIRE(clonedPacket->GetPayloadDescriptor());
+		REQUIRE(clonedPacket->GetPayloadDescriptor()->pictureId == 4660);
+
+		delete clonedPacket;
+		delete packet;
+	}
+
+	SECTION("parse packet-vp9.raw")
+	{
+		size_t len;
+
+		if (!Helpers::ReadBinaryFile("data/packet-vp9.raw", buffer, &len))
+			FAIL("cannot open file");
+
+		RtpPacket* packet = RtpPacket::Parse(buffer, len);
+
+		if (!packet)
+			FAIL("not a RTP packet");
+
+		REQUIRE(packet->ParsePayloadDescriptor(getMime("video/VP9")));
+
+		const PayloadDescriptor* descriptor = packet->GetPayloadDescriptor();
+
+		REQUIRE(!descriptor->isKeyFrame);
+		REQUIRE(descriptor->pictureId == 773);
+		REQUIRE(descriptor->hasSpatialLayers);
+		REQUIRE(descriptor->spatialLayer == 2);
+		REQUIRE(descriptor->temporalLayer == 1);
+		REQUIRE(descriptor->tl0PicIdx == 200);
+
+		delete packet;
+	}
+
+	SECTION("parse packet-h264-stapa.raw and packet-h264-fua.raw")
+	{
+		size_t len;
+		RtpCodecMime mime = getMime("video/H264");
+
+		if (!Helpers::ReadBinaryFile("data/packet-h264-stapa.raw", buffer, &len))
+			FAIL("cannot open file");
+
+		RtpPacket* packet = RtpPacket::Parse(buffer, len);
+
+		if (!packet)
+			FAIL("not a RTP packet");
+
+		REQUIRE(packet->ParsePayloadDescriptor(mime));
+		REQUIRE(packet->GetPayloadDescriptor()->isKeyFrame);
+		REQUIRE(!packet->GetPayloadDescriptor()->hasPictureId);
+
+		delete packet;
+
+		if (!Helpers::ReadBinaryFile("data/packet-h264-fua.raw", buffer, &len))
+			FAIL("cannot open file");
+
+		packet = RtpPacket::Parse(buffer, len);
+
+		if (!packet)
+			FAIL("not a RTP packet");
+
+		REQUIRE(packet->HasMarker());
+		REQUIRE(packet->ParsePayloadDescriptor(mime));
+		REQUIRE(!packet->GetPayloadDescriptor()->startOfFrame);
+		REQUIRE(packet->GetPayloadDescriptor()->endOfFrame);
+		REQUIRE(!packet->GetPayloadDescriptor()->isKeyFrame);
+
+		delete packet;
+	}
+}
@@ -0,0 +1,272 @@
+#include "include/catch.hpp"
+#include "common.hpp"
+#include "RTC/FecGenerator.hpp"
+#include "RTC/RtpPacket.hpp"
+#include "Utils.hpp"
+#include <vector>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+
+using namespace RTC;
+
+static std::vector<uint8_t> createPacket(uint16_t seq, uint32_t timestamp, bool marker, size_t payloadLength)
+{
+	std::vector<uint8_t> data(12 + payloadLength);
+
+	// V=2, PT=100.
+	data[0] = 0x80;
+	data[1] = marker ? 0x80 | 100 : 100;
+	Utils::Byte::Set2Bytes(data.data(), 2, seq);
+	Utils::Byte::Set4Bytes(data.data(), 4, timestamp);
+	Utils::Byte::Set4Bytes(data.data(), 8, 12345678);
+
+	for (size_t i = 0; i < payloadLength; ++i)
+	{
+		data[12 + i] = static_cast<uint8_t>(seq * 7 + i);
+	}
+
+	return data;
+}
+
+// Same with a transport-wide sequence number (one-byte extension id 5).
+static std::vector<uint8_t> createPacketWithWideSeqNumber(uint16_t seq, uint16_t wideSeqNumber, size_t payloadLength)
+{
+	std::vector<uint8_t> data = createPacket(seq, 1000, false, payloadLength);
+	uint8_t extension[] = { 0xBE, 0xDE, 0x00, 0x01, 0x51, 0x00, 0x00, 0x00 };
+
+	data[0] |= 0x10;
+	Utils::Byte::Set2Bytes(extension, 5, wideSeqNumber);
+	data.insert(data.begin() + 12, extension, extension + sizeof(extension));
+
+	return data;
+}
+
+// Returns the FEC packet data (empty if none).
+static std::vector<uint8_t> addPacket(FecGenerator& fecGenerator, const std::vector<uint8_t>& data)
+{
+	std::vector<uint8_t> fecData;
+	RtpPacket* packet = RtpPacket::Parse(data.data(), data.size());
+	RtpPacket* fecPacket = fecGenerator.AddPacket(packet);
+
+	if (fecPacket)
+	{
+		fecData.assign(fecPacket->GetData(), fecPacket->GetData() + fecPacket->GetSize());
+
+		delete fecPacket;
+	}
+
+	delete packet;
+
+	return fecData;
+}
+
+SCENARIO("FlexFEC generation", "[rtp][fec]")
+{
+	SECTION("group size follows the fraction lost")
+	{
+		FecGenerator fecGenerator(1111, 110);
+
+		REQUIRE(fecGenerator.GetGroupSize() == 0);
+
+		// 5% loss.
+		fecGenerator.SetFractionLost(13);
+		REQUIRE(fecGenerator.GetGroupSize() == 9);
+
+		fecGenerator.SetFractionLost(1);
+		REQUIRE(fecGenerator.GetGroupSize() == FecGenerator::MaxGroupSize);
+
+		fecGenerator.SetFractionLost(255);
+		REQUIRE(fecGenerator.GetGroupSize() == FecGenerator::MinGroupSize);
+
+		fecGenerator.SetFractionLost(0);
+		REQUIRE(fecGenerator.GetGroupSize() == 0);
+		REQUIRE(addPacket(fecGenerator, createPacket(1, 1000, true, 100)).empty());
+	}
+
+	SECTION("a lost packet can be recovered")
+	{
+		FecGenerator fecGenerator(1111, 110);
+		std::vector<std::vector<uint8_t>> packets;
+		std::vector<uint8_t> fecData;
+
+		// Group size 4.
+		fecGenerator.SetFractionLost(32);
+		REQUIRE(fecGenerator.GetGroupSize() == 4);
+
+		for (uint16_t seq = 65534; seq != 2; ++seq)
+		{
+			packets.push_back(createPacket(seq, 1000 + seq / 2, seq == 1, 100 + seq % 3 * 50));
+
+			fecData = addPacket(fecGenerator, packets.back());
+
+			if (seq != 1)
+				REQUIRE(fecData.empty());
+		}
+
+		REQUIRE(fecData.size() == 12 + 20 + 200);
+
+		RtpPacket* fecPacket = RtpPacket::Parse(fecData.data(), fecData.size());
+
+		REQUIRE(fecPacket);
+		REQUIRE(fecPacket->GetSsrc() == 1111);
+		REQUIRE(fecPacket->GetPayloadType() == 110);
+		REQUIRE(fecPacket->GetTimestamp() == 1000);
+
+		delete fecPacket;
+
+		const uint8_t* fec = fecData.data() + 12;
+
+		// R=0, F=0, SSRCCount=1, SN base and mask with k=1.
+		REQUIRE((fec[0] & 0xC0) == 0);
+		REQUIRE(fec[8] == 1);
+		REQUIRE(Utils::Byte::Get4Bytes(fec, 12) == 12345678);
+		REQUIRE(Utils::Byte::Get2Bytes(fec, 16) == 65534);
+		REQUIRE(Utils::Byte::Get2Bytes(fec, 18) == (0x8000 | 0x7800));
+
+		// Recover the third packet out of the others.
+		const std::vector<uint8_t>& lost = packets[2];
+		std::vector<uint8_t> recovered(fecData.begin() + 12, fecData.end());
+
+		for (size_t idx = 0; idx < packets.size(); ++idx)
+		{
+			if (idx == 2)
+				continue;
+
+			auto& packet = packets[idx];
+			uint16_t length = packet.size() - 12;
+
+			recovered[0] ^= packet[0];
+			recovered[1] ^= packet[1];
+			recovered[2] ^= length >> 8;
+			recovered[3] ^= length & 0xFF;
+
+			for (size_t i = 4; i < 8; ++i)
+			{
+				recovered[i] ^= packet[i];
+			}
+
+			FecGenerator::Xor(recovered.data() + 20, packet.data() + 12, packet.size() - 12);
+		}
+
+		REQUIRE((recovered[0] & 0x3F) == (lost[0] & 0x3F));
+		REQUIRE(recovered[1] == lost[1]);
+		REQUIRE(Utils::Byte::Get2Bytes(recovered.data(), 2) == lost.size() - 12);
+		REQUIRE(std::memcmp(recovered.data() + 4, lost.data() + 4, 4) == 0);
+		REQUIRE(std::memcmp(recovered.data() + 20, lost.data() + 12, lost.size() - 12) == 0);
+	}
+
+	SECTION("groups are closed at the end of a frame")
+	{
+		FecGenerator fecGenerator(1111, 110);
+
+		// Group size 8.
+		fecGenerator.SetFractionLost(16);
+
+		REQUIRE(addPacket(fecGenerator, createPacket(1, 1000, false, 100)).empty());
+		REQUIRE(addPacket(fecGenerator, createPacket(2, 1000, true, 100)).empty());
+		REQUIRE(addPacket(fecGenerator, createPacket(3, 2000, false, 100)).empty());
+		REQUIRE(!addPacket(fecGenerator, createPacket(4, 2000, true, 100)).empty());
+
+		// A gap beyond the mask starts a new group.
+		REQUIRE(addPacket(fecGenerator, createPacket(5, 3000, false, 100)).empty());
+		REQUIRE(addPacket(fecGenerator, createPacket(30, 3000, false, 100)).empty());
+		REQUIRE(addPacket(fecGenerator, createPacket(31, 3000, false, 100)).empty());
+		REQUIRE(addPacket(fecGenerator, createPacket(31, 3000, false, 100)).empty());
+		REQUIRE(addPacket(fecGenerator, createPacket(32, 3000, false, 100)).empty());
+
+		auto fecData = addPacket(fecGenerator, createPacket(33, 3000, true, 100));
+
+		REQUIRE(!fecData.empty());
+		REQUIRE(Utils::Byte::Get2Bytes(fecData.data(), 12 + 16) == 30);
+		REQUIRE(fecGenerator.toJson()["protectedPackets"].asUInt() == 9);
+		REQUIRE(fecGenerator.toJson()["fecPackets"].asUInt() == 2);
+	}
+
+	SECTION("the transport-wide sequence number is not protected")
+	{
+		FecGenerator fecGenerator(1111, 110, 5);
+		std::vector<uint8_t> data = createPacketWithWideSeqNumber(1, 1001, 100);
+		RtpPacket* packet = RtpPacket::Parse(data.data(), data.size());
+
+		// Group size 2.
+		fecGenerator.SetFractionLost(255);
+
+		REQUIRE(!fecGenerator.AddPacket(packet));
+
+		// Restored once protected.
+		REQUIRE(Utils::Byte::Get2Bytes(data.data(), 12 + 5) == 1001);
+
+		delete packet;
+
+		auto fecData = addPacket(fecGenerator, createPacketWithWideSeqNumber(2, 1002, 100));
+
+		// RTP header, extension, FEC header and payload.
+		REQUIRE(fecData.size() == 12 + 8 + 20 + 8 + 100);
+
+		RtpPacket* fecPacket = RtpPacket::Parse(fecData.data(), fecData.size());
+		uint16_t wideSeqNumber;
+
+		REQUIRE(fecPacket);
+		fecPacket->AddExtensionMapping(RtpHeaderExtensionUri::Type::TRANSPORT_WIDE_CC_01, 5);
+		REQUIRE(fecPacket->ReadTransportWideCc01(&wideSeqNumber));
+		REQUIRE(wideSeqNumber == 0);
+		REQUIRE(fecPacket->GetPayloadLength() == 20 + 8 + 100);
+
+		delete fecPacket;
+
+		// Both packets have the same extension header, so it XORs as zero when
+		// the sequence numbers are not protected.
+		const uint8_t* recovery = fecData.data() + 12 + 8 + 20;
+
+		for (size_t i = 0; i < 8; ++i)
+		{
+			REQUIRE(recovery[i] == 0);
+		}
+	}
+}
+
+// Run with: mediasoup-worker-test "[benchmark]"
+SCENARIO("FlexFEC generation cost", "[.][benchmark]")
+{
+	static constexpr size_t NumPackets = 200000;
+	static constexpr size_t PayloadLength = 1188;
+
+	std::vector<std::vector<uint8_t>> packets;
+
+	for (uint16_t seq = 0; seq < 1000; ++seq)
+	{
+		packets.push_back(createPacket(seq, seq / 10 * 3000, seq % 10 == 9, PayloadLength));
+	}
+
+	for (size_t groupSize : { FecGenerator::MinGroupSize, size_t(5), FecGenerator::MaxGroupSize })
+	{
+		FecGenerator fecGenerator(1111, 110);
+
+		fecGenerator.SetFractionLost(128 / groupSize);
+
+		auto start = std::chrono::steady_clock::now();
+		size_t bytes = 0;
+
+		for (size_t i = 0; i < NumPackets; ++i)
+		{
+			auto& data = packets[i % packets.size()];
+			RtpPacket* packet = RtpPacket::Parse(data.data(), data.size());
+			RtpPacket* fecPacket = fecGenerator.AddPacket(packet);
+
+			bytes += data.size();
+
+			delete fecPacket;
+			delete packet;
+		}
+
+		auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(
+			std::chrono::steady_clock::now() - start).count();
+		double megabits = bytes * 8 / 1e6;
+
+		std::printf("FEC generation [groupSize:%zu]: %.2f us per Mbit (%.0f Mbps per core)\n",
+			fecGenerator.GetGroupSize(), elapsed / 1e3 / megabits, megabits / (elapsed / 1e9));
+
+		REQUIRE(fecGenerator.toJson()["fecPackets"].asUInt() > 0);
+	}
+}
@@ -0,0 +1,117 @@
+#include "include/catch.hpp"
+#include "common.hpp"
+#include "RTC/KeyFrameCache.hpp"
+#include "RTC/RtpDictionaries.hpp"
+#include "RTC/RtpPacket.hpp"
+#include "Utils.hpp"
+#include <string>
+
+using namespace RTC;
+
+static uint8_t buffer[65536];
+
+// Builds a VP8 packet (without extended control bits) and parses its payload
+// descriptor.
+static RtpPacket* createPacket(uint16_t seq, uint32_t timestamp, bool startOfFrame, bool keyFrame)
+{
+	RtpCodecMime mime;
+	std::string name("video/VP8");
+
+	mime.SetName(name);
+
+	// V=2, PT=96.
+	buffer[0] = 0x80;
+	buffer[1] = 96;
+	Utils::Byte::Set2Bytes(buffer, 2, seq);
+	Utils::Byte::Set4Bytes(buffer, 4, timestamp);
+	Utils::Byte::Set4Bytes(buffer, 8, 12345678);
+	// S bit | VP8 payload header (inverse key frame flag) | data.
+	buffer[12] = startOfFrame ? 0x10 : 0x00;
+	buffer[13] = keyFrame ? 0x00 : 0x01;
+	buffer[14] = 0xAA;
+
+	RtpPacket* packet = RtpPacket::Parse(buffer, 15);
+
+	packet->ParsePayloadDescriptor(mime);
+
+	return packet;
+}
+
+static void receivePacket(KeyFrameCache& cache, uint16_t seq, uint32_t timestamp, bool startOfFrame, bool keyFrame)
+{
+	RtpPacket* packet = createPacket(seq, timestamp, startOfFrame, keyFrame);
+
+	cache.ReceivePacket(packet);
+
+	delete packet;
+}
+
+SCENARIO("key frame cache", "[keyframecache]")
+{
+	SECTION("packets before the first key frame are not cached")
+	{
+		KeyFrameCache cache(10);
+
+		receivePacket(cache, 1, 1000, true, false);
+		receivePacket(cache, 2, 1000, false, false);
+
+		REQUIRE(!cache.HasKeyFrame());
+		REQUIRE(cache.GetPackets().empty());
+	}
+
+	SECTION("the key frame and the following packets are cached")
+	{
+		KeyFrameCache cache(10);
+
+		receivePacket(cache, 1, 1000, true, false);
+		receivePacket(cache, 2, 2000, true, true);
+		receivePacket(cache, 3, 2000, false, true);
+		receivePacket(cache, 4, 3000, true, false);
+		receivePacket(cache, 5, 4000, true, false);
+		// Retransmission of a packet older than the key frame.
+		receivePacket(cache, 1, 1000, true, false);
+
+		REQUIRE(cache.HasKeyFrame());
+		REQUIRE(cache.IsGopComplete());
+		REQUIRE(cache.GetPackets().size() == 4);
+		REQUIRE(cache.GetKeyFramePackets() == 2);
+		REQUIRE(cache.GetPackets()[0]->GetSequenceNumber() == 2);
+		REQUIRE(cache.GetPackets()[0]->GetPayloadDescriptor()->isKeyFrame);
+		REQUIRE(cache.GetPackets()[3]->GetSequenceNumber() == 5);
+
+		// A new key frame replaces the cached GOP.
+		receivePacket(cache, 6, 5000, true, true);
+
+		REQUIRE(cache.GetPackets().size() == 1);
+		REQUIRE(cache.GetKeyFramePackets() == 1);
+		REQUIRE(cache.GetPackets()[0]->GetSequenceNumber() == 6);
+	}
+
+	SECTION("just the key frame is kept if the GOP does not fit")
+	{
+		KeyFrameCache cache(3);
+
+		receivePacket(cache, 10, 2000, true, true);
+		receivePacket(cache, 11, 2000, false, true);
+		receivePacket(cache, 12, 3000, true, false);
+		receivePacket(cache, 13, 4000, true, false);
+		receivePacket(cache, 14, 5000, true, false);
+
+		REQUIRE(cache.HasKeyFrame());
+		REQUIRE(!cache.IsGopComplete());
+		REQUIRE(cache.GetPackets().size() == 2);
+		REQUIRE(cache.GetKeyFramePackets() == 2);
+	}
+
+	SECTION("a key frame bigger than the cache is dropped")
+	{
+		KeyFrameCache cache(2);
+
+		receivePacket(cache, 10, 2000, true, true);
+		receivePacket(cache, 11, 2000, false, true);
+		receivePacket(cache, 12, 2000, false, true);
+
+		REQUIRE(!cache.HasKeyFrame());
+		REQUIRE(cache.GetPackets().empty());
+	}
+}
@@ -0,0 +1,80 @@
+#include "include/catch.hpp"
+#include "common.hpp"
+#include "Logger.hpp"
+#include <string>
+#include <cstring>
+
+SCENARIO("deferred log entries formatting", "[logger]")
+{
+	uint8_t args[MS_LOGGER_ARGS_SIZE];
+	char buffer[256];
+	size_t len = 0;
+
+	SECTION("integers, strings, doubles and pointers")
+	{
+		len = Logger::PackNumber(args, len, 'u', 4000000000u);
+		len = Logger::PackNumber(args, len, 'i', (uint64_t)(int64_t)-12);
+		len = Logger::PackString(args, len, "alice");
+		len = Logger::PackNumber(args, len, 'u', 0xABCD);
+
+		double value = 1.5;
+		uint64_t bits;
+
+		std::memcpy(&bits, &value, sizeof(bits));
+		len = Logger::PackNumber(args, len, 'f', bits);
+
+		Logger::Format(buffer, sizeof(buffer), "ssrc:%" PRIu32 " %d '%s' 0x%04hx %.2f 100%%", args, len);
+
+		REQUIRE(std::string(buffer) == "ssrc:4000000000 -12 'alice' 0xabcd 1.50 100%");
+	}
+
+	SECTION("width and precision given as arguments")
+	{
+		len = Logger::PackNumber(args, len, 'i', 6);
+		len = Logger::PackNumber(args, len, 'u', 42);
+		len = Logger::PackNumber(args, len, 'i', 3);
+		len = Logger::PackString(args, len, "abcdef");
+
+		Logger::Format(buffer, sizeof(buffer), "[%*zu] [%.*s]", args, len);
+
+		REQUIRE(std::string(buffer) == "[    42] [abc]");
+	}
+
+	SECTION("missing arguments and truncation")
+	{
+		len = Logger::PackNumber(args, len, 'u', 1);
+
+		Logger::Format(buffer, sizeof(buffer), "%u %u", args, len);
+
+		REQUIRE(std::string(buffer) == "1 (?)");
+
+		int written = Logger::Format(buffer, 4, "abcdef", args, 0);
+
+		REQUIRE(written == 3);
+		REQUIRE(std::string(buffer) == "abc");
+	}
+
+	SECTION("long strings are neither truncated when packed nor when formatted")
+	{
+		std::string value(600, 'x');
+		char longBuffer[2048];
+
+		len = Logger::PackString(args, len, value.c_str());
+
+		Logger::Format(longBuffer, sizeof(longBuffer), "'%s'", args, len);
+
+		REQUIRE(std::string(longBuffer) == "'" + value + "'");
+
+		// Arguments that do not fit are reported so the entry is formatted when
+		// logged.
+		std::string tooLong(MS_LOGGER_ARGS_SIZE, 'x');
+
+		len = Logger::PackString(args, 0, tooLong.c_str());
+
+		REQUIRE(len > MS_LOGGER_ARGS_SIZE);
+
+		len = Logger::PackNumber(args, len, 'u', 1);
+
+		REQUIRE(len > MS_LOGGER_ARGS_SIZE);
+	}
+}
@@ -0,0 +1,122 @@
+#include "include/catch.hpp"
+#include "common.hpp"
+#include "RTC/Metrics.hpp"
+#include <string>
+#include <algorithm>
+
+using namespace RTC;
+
+SCENARIO("worker metrics", "[metrics]")
+{
+	SECTION("histogram buckets are log-linear")
+	{
+		REQUIRE(Metrics::Histogram::GetBucketUpperBound(0) == 0);
+		REQUIRE(Metrics::Histogram::GetBucketUpperBound(3) == 3);
+		REQUIRE(Metrics::Histogram::GetBucketUpperBound(4) == 4);
+		REQUIRE(Metrics::Histogram::GetBucketUpperBound(7) == 7);
+		REQUIRE(Metrics::Histogram::GetBucketUpperBound(8) == 9);
+		REQUIRE(Metrics::Histogram::GetBucketUpperBound(11) == 15);
+		REQUIRE(Metrics::Histogram::GetBucketUpperBound(12) == 19);
+		REQUIRE(Metrics::Histogram::GetBucketUpperBound(Metrics::Histogram::NumBuckets - 1) == 0xFFFFFFFF);
+
+		Metrics::Histogram histogram("test");
+
+		histogram.Add(2);
+		histogram.Add(9);
+		histogram.Add(8);
+		histogram.Add(1000);
+		histogram.Add(0x1FFFFFFFF);
+
+		auto json = histogram.toJson();
+
+		REQUIRE(json["count"].asUInt() == 5);
+		REQUIRE(json["sum"].asUInt64() == 2 + 9 + 8 + 1000 + 0x1FFFFFFFF);
+		REQUIRE(json["buckets"].size() == 4);
+		REQUIRE(json["buckets"][0][0].asUInt() == 2);
+		REQUIRE(json["buckets"][0][1].asUInt() == 1);
+		REQUIRE(json["buckets"][1][0].asUInt() == 9);
+		REQUIRE(json["buckets"][1][1].asUInt() == 2);
+		// 1000 is in [ 896, 1023 ].
+		REQUIRE(json["buckets"][2][0].asUInt() == 1023);
+		REQUIRE(json["buckets"][3][0].asUInt() == 0xFFFFFFFF);
+	}
+
+	SECTION("histograms are written in Prometheus format")
+	{
+		Metrics::Histogram histogram("test_ms");
+		std::string out;
+
+		histogram.Add(1);
+		histogram.Add(5);
+		histogram.WritePrometheus(out, "worker=\"1\"");
+
+		std::string expected =
+			"test_ms_bucket{worker=\"1\",le=\"0\"} 0\n"
+			"test_ms_bucket{worker=\"1\",le=\"1\"} 1\n"
+			"test_ms_bucket{worker=\"1\",le=\"2\"} 1\n"
+			"test_ms_bucket{worker=\"1\",le=\"3\"} 1\n"
+			"test_ms_bucket{worker=\"1\",le=\"4\"} 1\n"
+			"test_ms_bucket{worker=\"1\",le=\"5\"} 2\n";
+
+		// Empty buckets after the highest one are written too (but for the last
+		// one).
+		for (size_t idx = 6; idx < Metrics::Histogram::NumBuckets - 1; ++idx)
+		{
+			expected += "test_ms_bucket{worker=\"1\",le=\"" +
+				std::to_string(Metrics::Histogram::GetBucketUpperBound(idx)) + "\"} 2\n";
+		}
+
+		expected +=
+			"test_ms_bucket{worker=\"1\",le=\"+Inf\"} 2\n"
+			"test_ms_sum{worker=\"1\"} 6\n"
+			"test_ms_count{worker=\"1\"} 2\n";
+
+		REQUIRE(out == expected);
+		REQUIRE(out.find("le=\"3758096383\"} 2\n") != std::string::npos);
+
+		// An empty histogram has the same buckets.
+		Metrics::Histogram empty("test_ms");
+		std::string emptyOut;
+
+		empty.WritePrometheus(emptyOut, "worker=\"1\"");
+
+		REQUIRE(std::count(emptyOut.begin(), emptyOut.end(), '\n') == std::count(out.begin(), out.end(), '\n'));
+	}
+
+	SECTION("registered counters are exported")
+	{
+		Metrics::TransportCounters transportCounters;
+		RtpDataCounter counter;
+		RtpDataCounter rtxCounter;
+		Metrics::StreamCounters streamCounters;
+
+		transportCounters.transportId = 1234;
+		transportCounters.rtpPacketsReceived = 10;
+		transportCounters.rtcpBytesSent = 200;
+		streamCounters.id = 5678;
+		streamCounters.kind = Media::Kind::VIDEO;
+		streamCounters.counter = &counter;
+		streamCounters.rtxCounter = &rtxCounter;
+
+		Metrics::AddTransport(&transportCounters);
+		Metrics::AddRtpSender(&streamCounters);
+
+		auto json = Metrics::toJson();
+		auto text = Metrics::GetPrometheusText();
+
+		Metrics::RemoveTransport(&transportCounters);
+		Metrics::RemoveRtpSender(&streamCounters);
+
+		REQUIRE(json["transports"].size() == 1);
+		REQUIRE(json["transports"][0]["transportId"].asUInt() == 1234);
+		REQUIRE(json["transports"][0]["rtpPacketsReceived"].asUInt() == 10);
+		REQUIRE(json["rtpSenders"].size() == 1);
+		REQUIRE(json["rtpSenders"][0]["kind"].asString() == "video");
+		REQUIRE(text.find("# TYPE mediasoup_transport_rtp_packets_received_total counter\n") != std::string::npos);
+		REQUIRE(text.find(",transport=\"1234\"} 10\n") != std::string::npos);
+		REQUIRE(text.find("mediasoup_transport_rtcp_bytes_sent_total{") != std::string::npos);
+		REQUIRE(text.find(",rtp_sender=\"5678\",kind=\"video\"} 0\n") != std::string::npos);
+		REQUIRE(text.find("# TYPE mediasoup_forwarding_latency_us histogram\n") != std::string::npos);
+		REQUIRE(Metrics::toJson()["transports"].size() == 0);
+	}
+}
@@ -0,0 +1,86 @@
+#include "include/catch.hpp"
+#include "common.hpp"
+#include "Channel/MsgPack.hpp"
+#include <string>
+#include <json/json.h>
+
+using namespace Channel;
+
+SCENARIO("MessagePack Channel codec", "[channel][msgpack]")
+{
+	SECTION("encode and decode a request")
+	{
+		Json::Value json(Json::objectValue);
+		Json::Value internal(Json::objectValue);
+		Json::Value data(Json::objectValue);
+		Json::Value encodings(Json::arrayValue);
+		Json::Value encoding(Json::objectValue);
+
+		internal["roomId"] = (Json::UInt)4000000000u;
+		internal["peerName"] = "alice";
+		encoding["ssrc"] = (Json::UInt)1234;
+		encoding["maxBitrate"] = 1.5;
+		encoding["active"] = true;
+		encoding["priority"] = -300;
+		encoding["rid"] = Json::Value(Json::nullValue);
+		encodings.append(encoding);
+		data["encodings"] = encodings;
+		data["muxId"] = std::string(300, 'x');
+		json["id"] = (Json::UInt)1;
+		json["method"] = "rtpReceiver.receive";
+		json["internal"] = internal;
+		json["data"] = data;
+
+		std::string buffer;
+		Json::Value decoded;
+
+		MsgPack::Encode(json, buffer);
+
+		REQUIRE(MsgPack::IsMsgPack((const uint8_t*)buffer.data(), buffer.size()));
+		REQUIRE(MsgPack::Decode((const uint8_t*)buffer.data(), buffer.size(), decoded));
+		REQUIRE(decoded["id"].isUInt());
+		REQUIRE(decoded["id"].asUInt() == 1);
+		REQUIRE(decoded["method"].asString() == "rtpReceiver.receive");
+		REQUIRE(decoded["internal"]["roomId"].asUInt() == 4000000000u);
+		REQUIRE(decoded["internal"]["peerName"].asString() == "alice");
+		REQUIRE(decoded["data"]["encodings"].isArray());
+		REQUIRE(decoded["data"]["encodings"][0]["ssrc"].asUInt() == 1234);
+		REQUIRE(decoded["data"]["encodings"][0]["maxBitrate"].asDouble() == 1.5);
+		REQUIRE(decoded["data"]["encodings"][0]["active"].asBool() == true);
+		REQUIRE(decoded["data"]["encodings"][0]["priority"].asInt() == -300);
+		REQUIRE(decoded["data"]["encodings"][0]["rid"].isNull());
+		REQUIRE(decoded["data"]["muxId"].asString().size() == 300);
+		REQUIRE(decoded == json);
+	}
+
+	SECTION("JSON messages and logs are not MessagePack")
+	{
+		REQUIRE(!MsgPack::IsMsgPack((const uint8_t*)"{\"id\":1}", 8));
+		REQUIRE(!MsgPack::IsMsgPack((const uint8_t*)"Dfoo", 4));
+	}
+
+	SECTION("truncated and malformed messages are rejected")
+	{
+		Json::Value json(Json::objectValue);
+		std::string buffer;
+		Json::Value decoded;
+
+		json["method"] = "worker.dump";
+		MsgPack::Encode(json, buffer);
+
+		for (size_t len = 0; len < buffer.size(); ++len)
+		{
+			REQUIRE(!MsgPack::Decode((const uint8_t*)buffer.data(), len, decoded));
+		}
+
+		// Map with a non string key.
+		uint8_t wrong[] = { 0x81, 0x01, 0x02 };
+
+		REQUIRE(!MsgPack::Decode(wrong, sizeof(wrong), decoded));
+
+		// Array announcing more items than available.
+		uint8_t huge[] = { 0xDD, 0xFF, 0xFF, 0xFF, 0xFF };
+
+		REQUIRE(!MsgPack::Decode(huge, sizeof(huge), decoded));
+	}
+}
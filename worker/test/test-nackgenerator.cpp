@@ -0,0 +1,143 @@
+#include "include/catch.hpp"
+#include "common.hpp"
+#include "RTC/NackGenerator.hpp"
+#include "RTC/RtpPacket.hpp"
+#include "Utils.hpp"
+#include <vector>
+
+using namespace RTC;
+
+static uint8_t buffer[] =
+{
+	0b10000000, 0b00000001, 0, 0,
+	0, 0, 0, 4,
+	0, 0, 0, 5
+};
+
+class NackGeneratorListener :
+	public NackGenerator::Listener
+{
+public:
+	virtual void onNackGeneratorNackRequired(NackGenerator* nackGenerator, const std::vector<uint16_t>& seqNumbers) override
+	{
+		this->nacked.insert(this->nacked.end(), seqNumbers.begin(), seqNumbers.end());
+	}
+
+	virtual void onNackGeneratorKeyFrameRequired(NackGenerator* nackGenerator) override
+	{
+		this->keyFramesRequired++;
+	}
+
+public:
+	std::vector<uint16_t> nacked;
+	size_t keyFramesRequired = 0;
+};
+
+static bool receivePacket(NackGenerator& nackGenerator, uint16_t seq, uint64_t now)
+{
+	Utils::Byte::Set2Bytes(buffer, 2, seq);
+
+	RtpPacket* packet = RtpPacket::Parse(buffer, sizeof(buffer));
+	bool recovered = nackGenerator.ReceivePacket(packet, now);
+
+	delete packet;
+
+	return recovered;
+}
+
+SCENARIO("NACK generator", "[rtp][rtcp][nack]")
+{
+	SECTION("missing packets are requested again once per RTT")
+	{
+		NackGeneratorListener listener;
+		NackGenerator nackGenerator(&listener);
+
+		nackGenerator.UpdateRtt(50);
+
+		receivePacket(nackGenerator, 65534, 1000);
+		receivePacket(nackGenerator, 2, 1000);
+
+		// Requested as soon as the gap is noticed (across the seq wrap).
+		REQUIRE(listener.nacked == std::vector<uint16_t>({ 65535, 0, 1 }));
+		REQUIRE(nackGenerator.GetNackListSize() == 3);
+
+		// Not yet a RTT.
+		nackGenerator.ProcessRetries(1020);
+		REQUIRE(listener.nacked.size() == 3);
+
+		REQUIRE(receivePacket(nackGenerator, 0, 1040) == true);
+
+		nackGenerator.ProcessRetries(1050);
+		REQUIRE(listener.nacked.size() == 5);
+		REQUIRE(listener.nacked[3] == 65535);
+		REQUIRE(listener.nacked[4] == 1);
+
+		REQUIRE(receivePacket(nackGenerator, 65535, 1060) == true);
+		REQUIRE(receivePacket(nackGenerator, 1, 1060) == true);
+		// Duplicated.
+		REQUIRE(receivePacket(nackGenerator, 1, 1070) == false);
+
+		REQUIRE(nackGenerator.GetNackListSize() == 0);
+		REQUIRE(nackGenerator.toJson()["recoveredPackets"].asUInt() == 3);
+		REQUIRE(nackGenerator.toJson()["requestedPackets"].asUInt() == 5);
+		REQUIRE(listener.keyFramesRequired == 0);
+	}
+
+	SECTION("packets are given up after max retries")
+	{
+		NackGeneratorListener listener;
+		NackGenerator nackGenerator(&listener);
+		uint64_t now = 1000;
+
+		receivePacket(nackGenerator, 100, now);
+		receivePacket(nackGenerator, 102, now);
+
+		for (size_t i = 0; i < NackGenerator::MaxRetries; ++i)
+		{
+			now += NackGenerator::DefaultRtt;
+			nackGenerator.ProcessRetries(now);
+		}
+
+		REQUIRE(listener.nacked.size() == NackGenerator::MaxRetries);
+		REQUIRE(nackGenerator.GetNackListSize() == 0);
+		REQUIRE(nackGenerator.toJson()["expiredPackets"].asUInt() == 1);
+		REQUIRE(listener.keyFramesRequired == 1);
+
+		// Too late.
+		REQUIRE(receivePacket(nackGenerator, 101, now) == false);
+		REQUIRE(nackGenerator.toJson()["latePackets"].asUInt() == 1);
+	}
+
+	SECTION("packets are given up when too old")
+	{
+		NackGeneratorListener listener;
+		NackGenerator nackGenerator(&listener);
+
+		nackGenerator.UpdateRtt(600);
+
+		receivePacket(nackGenerator, 100, 1000);
+		receivePacket(nackGenerator, 102, 1000);
+
+		nackGenerator.ProcessRetries(1600);
+		REQUIRE(listener.nacked.size() == 2);
+
+		nackGenerator.ProcessRetries(1000 + NackGenerator::MaxAge + 1);
+		REQUIRE(listener.nacked.size() == 2);
+		REQUIRE(nackGenerator.GetNackListSize() == 0);
+		REQUIRE(listener.keyFramesRequired == 1);
+	}
+
+	SECTION("a key frame is required if too many packets are missing")
+	{
+		NackGeneratorListener listener;
+		NackGenerator nackGenerator(&listener);
+
+		receivePacket(nackGenerator, 100, 1000);
+		receivePacket(nackGenerator, 102, 1000);
+		receivePacket(nackGenerator, 103 + NackGenerator::MaxNackPackets, 1000);
+
+		REQUIRE(nackGenerator.GetNackListSize() == 0);
+		REQUIRE(listener.nacked.size() == 1);
+		REQUIRE(listener.keyFramesRequired == 1);
+	}
+}
@@ -0,0 +1,104 @@
+#include "include/catch.hpp"
+#include "common.hpp"
+#include "RTC/Pacer.hpp"
+#include "RTC/RtpPacket.hpp"
+#include "Utils.hpp"
+#include <vector>
+
+using namespace RTC;
+
+static uint8_t buffer[1000];
+
+class PacerListener :
+	public Pacer::Listener
+{
+public:
+	virtual void onPacerRtpPacket(Pacer* pacer, RtpPacket* packet, uint8_t transportWideCcId) override
+	{
+		this->sent.push_back(packet->GetSequenceNumber());
+	}
+
+public:
+	std::vector<uint16_t> sent;
+};
+
+static void sendPacket(Pacer& pacer, uint16_t seq, Pacer::Priority priority)
+{
+	// V=2, PT=96.
+	buffer[0] = 0x80;
+	buffer[1] = 96;
+	Utils::Byte::Set2Bytes(buffer, 2, seq);
+	Utils::Byte::Set4Bytes(buffer, 4, 1000);
+	Utils::Byte::Set4Bytes(buffer, 8, 12345678);
+
+	RtpPacket* packet = RtpPacket::Parse(buffer, sizeof(buffer));
+
+	pacer.SendRtpPacket(packet, 0, priority);
+
+	delete packet;
+}
+
+SCENARIO("pacer", "[pacer]")
+{
+	SECTION("packets are not paced without bitrate")
+	{
+		PacerListener listener;
+		Pacer pacer(&listener);
+
+		for (uint16_t seq = 1; seq <= 10; ++seq)
+		{
+			sendPacket(pacer, seq, Pacer::Priority::VIDEO);
+		}
+
+		REQUIRE(listener.sent.size() == 10);
+	}
+
+	SECTION("bursts are queued and sent by priority")
+	{
+		PacerListener listener;
+		Pacer pacer(&listener);
+
+		// 1500 bytes of initial budget and 12.5 bytes per ms.
+		pacer.SetBitrate(100000);
+
+		sendPacket(pacer, 1, Pacer::Priority::VIDEO);
+		sendPacket(pacer, 2, Pacer::Priority::VIDEO);
+		sendPacket(pacer, 3, Pacer::Priority::VIDEO);
+		sendPacket(pacer, 4, Pacer::Priority::RETRANSMISSION);
+		sendPacket(pacer, 5, Pacer::Priority::AUDIO);
+
+		REQUIRE(listener.sent.size() == 2);
+		REQUIRE(pacer.toJson()["queuedPackets"].asUInt() == 3);
+
+		// Disabling pacing sends the queued packets.
+		pacer.SetBitrate(0);
+
+		REQUIRE(listener.sent.size() == 5);
+		REQUIRE(listener.sent[2] == 5);
+		REQUIRE(listener.sent[3] == 4);
+		REQUIRE(listener.sent[4] == 3);
+	}
+
+	SECTION("the oldest video packets are dropped when the queue is full")
+	{
+		PacerListener listener;
+		Pacer pacer(&listener);
+		uint16_t seq = 1;
+
+		pacer.SetBitrate(100000);
+
+		for (size_t i = 0; i < Pacer::MaxQueuedPackets + 12; ++i)
+		{
+			sendPacket(pacer, seq++, Pacer::Priority::VIDEO);
+		}
+
+		REQUIRE(pacer.toJson()["queuedPackets"].asUInt() == Pacer::MaxQueuedPackets);
+		REQUIRE(pacer.toJson()["droppedPackets"].asUInt() == 10);
+
+		pacer.SetBitrate(0);
+
+		// The two first ones were sent right away and the next ten dropped.
+		REQUIRE(listener.sent[1] == 2);
+		REQUIRE(listener.sent[2] == 13);
+	}
+}
@@ -0,0 +1,158 @@
+#include "include/catch.hpp"
+#include "common.hpp"
+#include "RTC/PacketTrace.hpp"
+#include "DepLibUV.hpp"
+#include "Utils.hpp"
+#include <string>
+#include <vector>
+#include <fstream>
+#include <iterator>
+#include <cstring>
+#include <cstdio> // std::remove()
+#include <unistd.h> // getpid()
+
+using namespace RTC;
+
+// Waits for the file to be written and returns it.
+static std::vector<uint8_t> readFile(const std::string& path)
+{
+	uv_run(DepLibUV::GetLoop(), UV_RUN_DEFAULT);
+
+	std::ifstream in(path, std::ios::binary);
+	std::vector<uint8_t> file((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+
+	std::remove(path.c_str());
+
+	return file;
+}
+
+SCENARIO("packet trace", "[rtp][rtcp][packettrace]")
+{
+	std::string path = "/tmp/mediasoup-test-packettrace-" + std::to_string(getpid());
+	// Too big for the stack.
+	PacketTrace* packetTrace = new PacketTrace();
+	uint8_t rtp[] =
+	{
+		0x80, 0xE4, 0x00, 0x0A,
+		0x00, 0x00, 0x0B, 0xB8,
+		0x00, 0xBC, 0x61, 0x4E,
+		0xAA, 0xBB, 0xCC, 0xDD
+	};
+	uint8_t rtcp[] =
+	{
+		0x81, 0xC9, 0x00, 0x07,
+		0x00, 0x00, 0x00, 0x01,
+		0x00, 0xBC, 0x61, 0x4E
+	};
+
+	SECTION("formats")
+	{
+		PacketTrace::Format format;
+
+		REQUIRE(PacketTrace::GetFormat("pcap", format));
+		REQUIRE(format == PacketTrace::Format::PCAP);
+		REQUIRE(PacketTrace::GetFormat("json", format));
+		REQUIRE(format == PacketTrace::Format::JSON);
+		REQUIRE(!PacketTrace::GetFormat("txt", format));
+		REQUIRE_THROWS(packetTrace->Dump("/nonexistent/file", PacketTrace::Format::PCAP));
+	}
+
+	SECTION("only the latest packets are kept")
+	{
+		for (size_t i = 0; i < PacketTrace::Size + 10; ++i)
+		{
+			packetTrace->Add(PacketTrace::Direction::IN, PacketTrace::Type::RTP, rtp, sizeof(rtp));
+		}
+
+		REQUIRE(packetTrace->toJson()["numRecords"].asUInt() == PacketTrace::Size + 10);
+		REQUIRE(packetTrace->Dump(path, PacketTrace::Format::PCAP) == PacketTrace::Size);
+
+		auto file = readFile(path);
+
+		REQUIRE(file.size() == 24 + PacketTrace::Size * (16 + 28 + 12));
+	}
+
+	SECTION("headers are written into a pcap file")
+	{
+		packetTrace->Add(PacketTrace::Direction::IN, PacketTrace::Type::RTP, rtp, sizeof(rtp));
+		packetTrace->Add(PacketTrace::Direction::OUT, PacketTrace::Type::RTCP, rtcp, sizeof(rtcp));
+
+		REQUIRE(packetTrace->Dump(path, PacketTrace::Format::PCAP) == 2);
+
+		auto file = readFile(path);
+		uint32_t magic;
+		uint32_t linkType;
+
+		REQUIRE(file.size() == 24 + (16 + 28 + 12) + (16 + 28 + 8));
+
+		std::memcpy(&magic, file.data(), 4);
+		std::memcpy(&linkType, file.data() + 20, 4);
+
+		REQUIRE(magic == 0xA1B2C3D4);
+		REQUIRE(linkType == 101);
+
+		// First packet: IPv4 and UDP headers followed by the RTP header.
+		const uint8_t* ip = file.data() + 24 + 16;
+
+		REQUIRE(ip[0] == 0x45);
+		REQUIRE(Utils::Byte::Get2Bytes(ip, 2) == 28 + sizeof(rtp));
+		REQUIRE(ip[9] == 17);
+		REQUIRE(Utils::Byte::Get4Bytes(ip, 12) == 0x0A000002);
+		REQUIRE(Utils::Byte::Get4Bytes(ip, 16) == 0x0A000001);
+
+		uint32_t checksum = 0;
+
+		for (size_t i = 0; i < 20; i += 2)
+		{
+			checksum += Utils::Byte::Get2Bytes(ip, i);
+		}
+		while (checksum >> 16)
+		{
+			checksum = (checksum & 0xFFFF) + (checksum >> 16);
+		}
+
+		REQUIRE(checksum == 0xFFFF);
+		REQUIRE(Utils::Byte::Get2Bytes(ip, 24) == 8 + sizeof(rtp));
+		REQUIRE(std::memcmp(ip + 28, rtp, 12) == 0);
+
+		// Second packet: sent RTCP.
+		ip += 28 + 12 + 16;
+
+		REQUIRE(Utils::Byte::Get4Bytes(ip, 12) == 0x0A000001);
+		REQUIRE(std::memcmp(ip + 28, rtcp, 8) == 0);
+	}
+
+	SECTION("headers are written into a JSON file")
+	{
+		packetTrace->Add(PacketTrace::Direction::IN, PacketTrace::Type::RTP, rtp, sizeof(rtp));
+		packetTrace->Add(PacketTrace::Direction::OUT, PacketTrace::Type::RTCP, rtcp, sizeof(rtcp));
+
+		REQUIRE(packetTrace->Dump(path, PacketTrace::Format::JSON) == 2);
+
+		auto file = readFile(path);
+		std::string str(file.begin(), file.end());
+		Json::CharReaderBuilder builder;
+		Json::Value json;
+		std::string errors;
+		std::unique_ptr<Json::CharReader> reader(builder.newCharReader());
+
+		REQUIRE(reader->parse(str.data(), str.data() + str.size(), &json, &errors));
+		REQUIRE(json["records"].size() == 2);
+		REQUIRE(json["records"][0]["direction"].asString() == "in");
+		REQUIRE(json["records"][0]["type"].asString() == "rtp");
+		REQUIRE(json["records"][0]["size"].asUInt() == sizeof(rtp));
+		REQUIRE(json["records"][0]["payloadType"].asUInt() == 100);
+		REQUIRE(json["records"][0]["marker"].asBool() == true);
+		REQUIRE(json["records"][0]["sequenceNumber"].asUInt() == 10);
+		REQUIRE(json["records"][0]["timestamp"].asUInt() == 3000);
+		REQUIRE(json["records"][0]["ssrc"].asUInt() == 12345678);
+		REQUIRE(json["records"][1]["direction"].asString() == "out");
+		REQUIRE(json["records"][1]["type"].asString() == "rtcp");
+		REQUIRE(json["records"][1]["rtcpType"].asUInt() == 201);
+		REQUIRE(json["records"][1]["count"].asUInt() == 1);
+		REQUIRE(json["records"][1]["ssrc"].asUInt() == 1);
+		REQUIRE(json["records"][0]["time"].asUInt64() <= json["records"][1]["time"].asUInt64());
+	}
+
+	delete packetTrace;
+}
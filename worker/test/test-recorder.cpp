@@ -0,0 +1,226 @@
+#include "include/catch.hpp"
+#include "common.hpp"
+#include "RTC/Recorder.hpp"
+#include "RTC/RtpPacket.hpp"
+#include "DepLibUV.hpp"
+#include "Utils.hpp"
+#include <string>
+#include <vector>
+#include <fstream>
+#include <iterator>
+#include <cstring>
+#include <cstdio> // std::remove()
+#include <unistd.h> // getpid()
+
+using namespace RTC;
+
+class RecorderListener :
+	public Recorder::Listener
+{
+public:
+	virtual void onRecorderKeyFrameRequired(Recorder* recorder, uint32_t ssrc) override
+	{
+		this->keyFrameRequests++;
+	}
+
+public:
+	size_t keyFrameRequests = 0;
+};
+
+static RtpCodecParameters createCodec(const char* name, uint8_t payloadType)
+{
+	RtpCodecParameters codec;
+	std::string str(name);
+
+	codec.mime.SetName(str);
+	codec.payloadType = payloadType;
+	codec.numChannels = 2;
+
+	return codec;
+}
+
+static void receivePacket(
+	Recorder* recorder, const RtpCodecParameters& codec, uint16_t seq, uint32_t timestamp, bool marker,
+	const std::vector<uint8_t>& payload)
+{
+	std::vector<uint8_t> data(12 + payload.size());
+
+	data[0] = 0x80;
+	data[1] = marker ? 0x80 | codec.payloadType : codec.payloadType;
+	Utils::Byte::Set2Bytes(data.data(), 2, seq);
+	Utils::Byte::Set4Bytes(data.data(), 4, timestamp);
+	Utils::Byte::Set4Bytes(data.data(), 8, 12345678);
+	std::memcpy(data.data() + 12, payload.data(), payload.size());
+
+	RtpPacket* packet = RtpPacket::Parse(data.data(), data.size());
+
+	if (codec.mime.type == RtpCodecMime::Type::VIDEO)
+		packet->ParsePayloadDescriptor(codec.mime);
+
+	recorder->ReceivePacket(packet);
+
+	delete packet;
+}
+
+// Closes the recorder, waits for the file to be written and returns it.
+static std::vector<uint8_t> close(Recorder* recorder, const std::string& path)
+{
+	recorder->Close();
+
+	uv_run(DepLibUV::GetLoop(), UV_RUN_DEFAULT);
+
+	std::ifstream in(path, std::ios::binary);
+	std::vector<uint8_t> file((std::istreambuf_iterator<char>(in)), std::istreambuf_iterator<char>());
+
+	std::remove(path.c_str());
+
+	return file;
+}
+
+static uint32_t getLE32(const uint8_t* data)
+{
+	return data[0] | data[1] << 8 | data[2] << 16 | static_cast<uint32_t>(data[3]) << 24;
+}
+
+SCENARIO("recording to disk", "[rtp][recorder]")
+{
+	std::string path = "/tmp/mediasoup-test-recorder-" + std::to_string(getpid());
+	RecorderListener listener;
+
+	SECTION("formats are checked against the codec")
+	{
+		Recorder::Format format;
+
+		REQUIRE(Recorder::GetFormat("ivf", format));
+		REQUIRE(format == Recorder::Format::IVF);
+		REQUIRE(!Recorder::GetFormat("mp4", format));
+		REQUIRE(Recorder::GetDefaultFormat(createCodec("video/VP9", 101).mime) == Recorder::Format::IVF);
+		REQUIRE(Recorder::GetDefaultFormat(createCodec("audio/PCMU", 0).mime) == Recorder::Format::RTPDUMP);
+		REQUIRE(Recorder::IsSupported(Recorder::Format::OGG, createCodec("audio/opus", 100).mime));
+		REQUIRE(!Recorder::IsSupported(Recorder::Format::OGG, createCodec("video/VP8", 101).mime));
+		REQUIRE_THROWS(new Recorder(&listener, "/nonexistent/file", Recorder::Format::IVF, createCodec("video/VP8", 101)));
+	}
+
+	SECTION("VP8 frames are written into an IVF file from the first key frame")
+	{
+		auto codec = createCodec("video/VP8", 101);
+		Recorder* recorder = new Recorder(&listener, path, Recorder::Format::IVF, codec);
+
+		// Delta frame (X=0, S=1 | P=1).
+		receivePacket(recorder, codec, 1, 3000, true, { 0x10, 0x01, 0xAA });
+
+		REQUIRE(listener.keyFrameRequests == 1);
+
+		// Key frame of 640x480 in two packets.
+		receivePacket(recorder, codec, 2, 6000, false, { 0x10, 0x00, 0x00, 0x00, 0x9D, 0x01, 0x2A, 0x80, 0x02, 0xE0, 0x01 });
+		receivePacket(recorder, codec, 3, 6000, true, { 0x00, 0xBB, 0xCC });
+		// Delta frame.
+		receivePacket(recorder, codec, 4, 9000, true, { 0x10, 0x01, 0xDD });
+		// Delta frame after a loss.
+		receivePacket(recorder, codec, 6, 15000, true, { 0x10, 0x01, 0xEE });
+
+		REQUIRE(listener.keyFrameRequests == 2);
+		REQUIRE(recorder->toJson()["frames"].asUInt() == 2);
+
+		auto file = close(recorder, path);
+
+		REQUIRE(file.size() == 32 + 12 + 12 + 12 + 2);
+		REQUIRE(std::memcmp(file.data(), "DKIF", 4) == 0);
+		REQUIRE(std::memcmp(file.data() + 8, "VP80", 4) == 0);
+		REQUIRE((file[12] | file[13] << 8) == 640);
+		REQUIRE((file[14] | file[15] << 8) == 480);
+		REQUIRE(getLE32(file.data() + 24) == 2);
+		// Frames (size, timestamp and data).
+		REQUIRE(getLE32(file.data() + 32) == 12);
+		REQUIRE(getLE32(file.data() + 36) == 0);
+		REQUIRE(file[44] == 0x00);
+		REQUIRE(file[55] == 0xCC);
+		REQUIRE(getLE32(file.data() + 56) == 2);
+		REQUIRE(getLE32(file.data() + 60) == 3000);
+		REQUIRE(file[69] == 0xDD);
+	}
+
+	SECTION("Opus packets are written into an Ogg file")
+	{
+		auto codec = createCodec("audio/opus", 100);
+		Recorder* recorder = new Recorder(&listener, path, Recorder::Format::OGG, codec);
+
+		// 20 ms CELT packets (config 31), the second one lost.
+		receivePacket(recorder, codec, 1, 1000, false, { 0xF8, 0x01, 0x02 });
+		receivePacket(recorder, codec, 3, 2920, false, { 0xF8, 0x03 });
+
+		REQUIRE(listener.keyFrameRequests == 0);
+
+		auto file = close(recorder, path);
+		std::vector<size_t> pages;
+
+		for (size_t offset = 0; offset + 27 <= file.size();)
+		{
+			REQUIRE(std::memcmp(file.data() + offset, "OggS", 4) == 0);
+
+			pages.push_back(offset);
+
+			size_t numSegments = file[offset + 26];
+			size_t size = 27 + numSegments;
+
+			for (size_t i = 0; i < numSegments; ++i)
+			{
+				size += file[offset + 27 + i];
+			}
+
+			offset += size;
+		}
+
+		// OpusHead, OpusTags, two packets and the end of stream.
+		REQUIRE(pages.size() == 5);
+		REQUIRE(file[pages[0] + 5] == 0x02);
+		REQUIRE(std::memcmp(file.data() + pages[0] + 28, "OpusHead", 8) == 0);
+		REQUIRE(file[pages[0] + 28 + 9] == 2);
+		REQUIRE(std::memcmp(file.data() + pages[1] + 28, "OpusTags", 8) == 0);
+		// Granule positions (end of each packet).
+		REQUIRE(getLE32(file.data() + pages[2] + 6) == 960);
+		REQUIRE(getLE32(file.data() + pages[3] + 6) == 1920 + 960);
+		REQUIRE(file[pages[3] + 29] == 0x03);
+		REQUIRE(file[pages[4] + 5] == 0x04);
+		REQUIRE(getLE32(file.data() + pages[4] + 18) == 4);
+	}
+
+	SECTION("H264 packets are written as an Annex B stream")
+	{
+		auto codec = createCodec("video/H264", 107);
+		Recorder* recorder = new Recorder(&listener, path, Recorder::Format::H264, codec);
+
+		// STAP-A with SPS and PPS.
+		receivePacket(recorder, codec, 1, 3000, false, { 0x78, 0x00, 0x02, 0x67, 0x42, 0x00, 0x02, 0x68, 0xCE });
+		// FU-A IDR slice.
+		receivePacket(recorder, codec, 2, 3000, false, { 0x7C, 0x85, 0x88, 0x01 });
+		receivePacket(recorder, codec, 3, 3000, true, { 0x7C, 0x45, 0x02 });
+
+		auto file = close(recorder, path);
+		std::vector<uint8_t> expected =
+		{
+			0x00, 0x00, 0x00, 0x01, 0x67, 0x42,
+			0x00, 0x00, 0x00, 0x01, 0x68, 0xCE,
+			0x00, 0x00, 0x00, 0x01, 0x65, 0x88, 0x01, 0x02
+		};
+
+		REQUIRE(file == expected);
+	}
+
+	SECTION("any stream is written into a rtpdump file")
+	{
+		auto codec = createCodec("audio/PCMU", 0);
+		Recorder* recorder = new Recorder(&listener, path, Recorder::Format::RTPDUMP, codec);
+
+		receivePacket(recorder, codec, 1, 160, false, { 0x01, 0x02 });
+
+		auto file = close(recorder, path);
+		std::string firstLine = "#!rtpplay1.0 0.0.0.0/0\n";
+
+		REQUIRE(file.size() == firstLine.size() + 16 + 8 + 14);
+		REQUIRE(std::memcmp(file.data(), firstLine.c_str(), firstLine.size()) == 0);
+		REQUIRE(Utils::Byte::Get2Bytes(file.data(), firstLine.size() + 16) == 8 + 14);
+		REQUIRE(Utils::Byte::Get2Bytes(file.data(), firstLine.size() + 18) == 14);
+		REQUIRE(file.back() == 0x02);
+	}
+}
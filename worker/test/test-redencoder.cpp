@@ -0,0 +1,122 @@
+#include "include/catch.hpp"
+#include "common.hpp"
+#include "RTC/RedEncoder.hpp"
+#include "RTC/RtpPacket.hpp"
+#include "Utils.hpp"
+#include <vector>
+
+using namespace RTC;
+
+static std::vector<uint8_t> createPacket(uint16_t seq, uint32_t timestamp, size_t payloadLength)
+{
+	std::vector<uint8_t> data(12 + payloadLength);
+
+	// V=2, PT=100.
+	data[0] = 0x80;
+	data[1] = 100;
+	Utils::Byte::Set2Bytes(data.data(), 2, seq);
+	Utils::Byte::Set4Bytes(data.data(), 4, timestamp);
+	Utils::Byte::Set4Bytes(data.data(), 8, 12345678);
+
+	for (size_t i = 0; i < payloadLength; ++i)
+	{
+		data[12 + i] = static_cast<uint8_t>(seq);
+	}
+
+	return data;
+}
+
+// Returns the RED packet data (empty if sent as is).
+static std::vector<uint8_t> encode(RedEncoder& redEncoder, uint16_t seq, uint32_t timestamp, size_t payloadLength = 50)
+{
+	std::vector<uint8_t> data = createPacket(seq, timestamp, payloadLength);
+	std::vector<uint8_t> redData;
+	RtpPacket* packet = RtpPacket::Parse(data.data(), data.size());
+	RtpPacket* redPacket = redEncoder.Encode(packet);
+
+	if (redPacket)
+	{
+		redData.assign(redPacket->GetData(), redPacket->GetData() + redPacket->GetSize());
+
+		delete redPacket;
+	}
+
+	delete packet;
+
+	return redData;
+}
+
+SCENARIO("RED encoding", "[rtp][red]")
+{
+	SECTION("distance follows the fraction lost")
+	{
+		RedEncoder redEncoder(63);
+
+		REQUIRE(redEncoder.GetDistance() == 1);
+
+		redEncoder.SetFractionLost(0);
+		REQUIRE(redEncoder.GetDistance() == 0);
+		REQUIRE(encode(redEncoder, 1, 960).empty());
+
+		redEncoder.SetFractionLost(30);
+		REQUIRE(redEncoder.GetDistance() == 2);
+
+		redEncoder.SetFractionLost(200);
+		REQUIRE(redEncoder.GetDistance() == RedEncoder::MaxDistance);
+	}
+
+	SECTION("previous payloads are carried")
+	{
+		RedEncoder redEncoder(63);
+
+		redEncoder.SetFractionLost(30);
+
+		// The first packet has just the primary block.
+		auto redData = encode(redEncoder, 1, 960);
+
+		REQUIRE(redData.size() == 12 + 1 + 50);
+		REQUIRE((redData[1] & 0x7F) == 63);
+		REQUIRE(redData[12] == 100);
+
+		encode(redEncoder, 2, 1920);
+		redData = encode(redEncoder, 3, 2880, 40);
+
+		// Two redundant blocks (oldest first) and the primary one.
+		REQUIRE(redData.size() == 12 + 4 + 4 + 1 + 50 + 50 + 40);
+		REQUIRE(redData[12] == (0x80 | 100));
+		REQUIRE(Utils::Byte::Get3Bytes(redData.data(), 13) == ((1920 << 10) | 50));
+		REQUIRE(redData[16] == (0x80 | 100));
+		REQUIRE(Utils::Byte::Get3Bytes(redData.data(), 17) == ((960 << 10) | 50));
+		REQUIRE(redData[20] == 100);
+		REQUIRE(redData[21] == 1);
+		REQUIRE(redData[71] == 2);
+		REQUIRE(redData[121] == 3);
+
+		// And the RtpReceiver gets the primary one back.
+		RtpPacket* packet = RtpPacket::Parse(redData.data(), redData.size());
+
+		REQUIRE(packet->RedDecode() == true);
+		REQUIRE(packet->GetPayloadType() == 100);
+		REQUIRE(packet->GetPayloadLength() == 40);
+		REQUIRE(packet->GetPayload()[0] == 3);
+
+		delete packet;
+
+		REQUIRE(redEncoder.toJson()["redundantBytes"].asUInt() == 150);
+	}
+
+	SECTION("redundancy does not span gaps")
+	{
+		RedEncoder redEncoder(63);
+
+		encode(redEncoder, 1, 960);
+
+		// Sequence gap.
+		REQUIRE(encode(redEncoder, 3, 2880).size() == 12 + 1 + 50);
+
+		// Timestamp offset beyond 14 bits.
+		REQUIRE(encode(redEncoder, 4, 2880 + 0x4000).size() == 12 + 1 + 50);
+
+		REQUIRE(encode(redEncoder, 5, 2880 + 0x4000 + 960).size() == 12 + 4 + 1 + 50 + 50);
+	}
+}
@@ -0,0 +1,71 @@
+#include "include/catch.hpp"
+#include "common.hpp"
+#include "RTC/RembAggregator.hpp"
+#include <string>
+#include <vector>
+
+using namespace RTC;
+
+SCENARIO("REMB aggregation", "[remb]")
+{
+	SECTION("policies are parsed from strings")
+	{
+		std::string min("min");
+		std::string percentile("Percentile");
+		std::string minNonOutliers("min-non-outliers");
+		std::string wrong("max");
+
+		REQUIRE(RembAggregator::GetPolicy(min) == RembAggregator::Policy::MIN);
+		REQUIRE(RembAggregator::GetPolicy(percentile) == RembAggregator::Policy::PERCENTILE);
+		REQUIRE(RembAggregator::GetPolicy(minNonOutliers) == RembAggregator::Policy::MIN_NON_OUTLIERS);
+		REQUIRE_THROWS(RembAggregator::GetPolicy(wrong));
+	}
+
+	SECTION("no bitrates")
+	{
+		RembAggregator aggregator;
+		std::vector<uint32_t> bitrates;
+
+		REQUIRE(aggregator.Aggregate(bitrates) == 0);
+	}
+
+	SECTION("min")
+	{
+		RembAggregator aggregator(RembAggregator::Policy::MIN);
+		std::vector<uint32_t> bitrates = { 900000, 100000, 500000 };
+
+		REQUIRE(aggregator.Aggregate(bitrates) == 100000);
+	}
+
+	SECTION("percentile")
+	{
+		RembAggregator aggregator(RembAggregator::Policy::PERCENTILE, 20);
+		std::vector<uint32_t> bitrates =
+			{ 1000, 2000, 3000, 4000, 5000, 6000, 7000, 8000, 9000, 10000 };
+
+		REQUIRE(aggregator.Aggregate(bitrates) == 2000);
+
+		RembAggregator aggregator2(RembAggregator::Policy::PERCENTILE, 0);
+
+		REQUIRE(aggregator2.Aggregate(bitrates) == 1000);
+
+		RembAggregator aggregator3(RembAggregator::Policy::PERCENTILE, 100);
+
+		REQUIRE(aggregator3.Aggregate(bitrates) == 10000);
+	}
+
+	SECTION("min of non outliers")
+	{
+		RembAggregator aggregator(RembAggregator::Policy::MIN_NON_OUTLIERS);
+		// Q1 = 1000000, Q3 = 1300000, so the fence is 550000.
+		std::vector<uint32_t> bitrates =
+			{ 1200000, 50000, 1000000, 1300000, 1100000, 900000, 1250000, 1400000 };
+
+		REQUIRE(aggregator.Aggregate(bitrates) == 900000);
+
+		// Not enough values to tell outliers.
+		std::vector<uint32_t> few = { 1200000, 50000, 1000000 };
+
+		REQUIRE(aggregator.Aggregate(few) == 50000);
+	}
+}
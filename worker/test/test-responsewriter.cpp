@@ -0,0 +1,264 @@
+#include "include/catch.hpp"
+#include "common.hpp"
+#include "Channel/ResponseWriter.hpp"
+#include "Channel/MsgPack.hpp"
+#include <string>
+#include <vector>
+#include <memory>
+#include <cstdio> // std::freopen()
+#include <csignal> // SIGABRT
+#include <unistd.h> // fork(), _exit()
+#include <sys/wait.h> // waitpid()
+#include <json/json.h>
+
+using namespace Channel;
+
+// Keeps the data written by a ResponseWriter.
+class Output :
+	public ResponseWriter::Listener
+{
+public:
+	virtual void onResponseWriterPayload(ResponseWriter* responseWriter, const std::string& payload) override
+	{
+		this->payloads.push_back(payload);
+	}
+
+	virtual void onResponseWriterChunk(ResponseWriter* responseWriter, const uint8_t* data, size_t len, bool last) override
+	{
+		this->chunks.push_back(std::string((const char*)data, len));
+		this->lasts.push_back(last);
+	}
+
+	// The whole response.
+	std::string GetData() const
+	{
+		std::string data;
+
+		for (auto& payload : this->payloads)
+		{
+			data.append(payload);
+		}
+		for (auto& chunk : this->chunks)
+		{
+			data.append(chunk);
+		}
+
+		return data;
+	}
+
+public:
+	std::vector<std::string> payloads;
+	std::vector<std::string> chunks;
+	std::vector<bool> lasts;
+};
+
+// Parsed numbers are signed, so compare the serialized responses.
+static std::string parse(const std::string& data, bool binary)
+{
+	Json::Value json;
+
+	if (binary)
+	{
+		REQUIRE(MsgPack::Decode((const uint8_t*)data.data(), data.size(), json));
+	}
+	else
+	{
+		Json::CharReaderBuilder builder;
+		std::unique_ptr<Json::CharReader> reader(builder.newCharReader());
+		std::string error;
+
+		REQUIRE(reader->parse(data.data(), data.data() + data.size(), &json, &error));
+	}
+
+	return Json::writeString(Json::StreamWriterBuilder(), json);
+}
+
+static std::string response(uint32_t id, const Json::Value& data)
+{
+	Json::Value json(Json::objectValue);
+
+	json["id"] = (Json::UInt)id;
+	json["accepted"] = true;
+	json["data"] = data;
+
+	return Json::writeString(Json::StreamWriterBuilder(), json);
+}
+
+// Whether the given function aborts (i.e. a MS_ASSERT fails).
+static bool aborts(void (*fn)())
+{
+	pid_t pid = fork();
+
+	if (pid == 0)
+	{
+		// Don't print the assertion.
+		std::freopen("/dev/null", "w", stderr);
+
+		fn();
+
+		_exit(0);
+	}
+
+	int status;
+
+	waitpid(pid, &status, 0);
+
+	return WIFSIGNALED(status) && WTERMSIG(status) == SIGABRT;
+}
+
+SCENARIO("Channel response writer", "[channel][responsewriter]")
+{
+	for (bool binary : { false, true })
+	{
+		SECTION(std::string("small responses are a single message (") + (binary ? "MessagePack" : "JSON") + ")")
+		{
+			Output output;
+			ResponseWriter writer(&output, 7, binary);
+			Json::Value data(Json::objectValue);
+
+			data["roomId"] = (Json::UInt)1234;
+			data["peers"] = Json::arrayValue;
+			data["peers"].append("alice");
+			data["peers"].append(Json::objectValue);
+			data["peers"][1]["peerName"] = "bob";
+
+			writer.StartObject(2);
+			writer.Key("roomId");
+			writer.Value((Json::UInt)1234);
+			writer.Key("peers");
+			writer.StartArray(2);
+			writer.Value("alice");
+			writer.StartObject(1);
+			writer.Key("peerName");
+			writer.Value("bob");
+			writer.End();
+			writer.End();
+			writer.End();
+			writer.Finish();
+
+			REQUIRE(output.payloads.size() == 1);
+			REQUIRE(output.chunks.empty());
+			REQUIRE(parse(output.GetData(), binary) == response(7, data));
+		}
+
+		SECTION(std::string("big responses are sent in chunks (") + (binary ? "MessagePack" : "JSON") + ")")
+		{
+			static constexpr size_t NumValues = 200;
+
+			Output output;
+			ResponseWriter writer(&output, 8, binary);
+			Json::Value data(Json::arrayValue);
+
+			writer.StartArray(NumValues);
+
+			for (size_t i = 0; i < NumValues; ++i)
+			{
+				Json::Value value(std::string(1000, 'a' + i % 26));
+
+				data.append(value);
+				writer.Value(value);
+
+				// Nothing is sent until ChunkSize bytes are written.
+				if (i < ResponseWriter::ChunkSize / 1010)
+					REQUIRE(output.chunks.empty());
+			}
+
+			writer.End();
+			writer.Finish();
+
+			REQUIRE(output.payloads.empty());
+			REQUIRE(output.chunks.size() == 4);
+
+			// A chunk is sent once ChunkSize bytes are reached (so just the last
+			// value of each one crosses the boundary).
+			for (size_t i = 0; i < output.chunks.size() - 1; ++i)
+			{
+				REQUIRE(output.chunks[i].size() >= ResponseWriter::ChunkSize);
+				REQUIRE(output.chunks[i].size() < ResponseWriter::ChunkSize + 1010);
+				REQUIRE(!output.lasts[i]);
+			}
+
+			REQUIRE(output.lasts.back());
+			REQUIRE(parse(output.GetData(), binary) == response(8, data));
+		}
+	}
+
+	SECTION("the last chunk may be empty")
+	{
+		Output output;
+		ResponseWriter writer(&output, 9, true);
+		Json::Value value(std::string(ResponseWriter::ChunkSize, 'x'));
+		Json::Value data(Json::arrayValue);
+
+		data.append(value);
+		writer.StartArray(1);
+		writer.Value(value);
+
+		REQUIRE(output.chunks.size() == 1);
+
+		writer.End();
+		writer.Finish();
+
+		REQUIRE(output.chunks.size() == 2);
+		REQUIRE(output.chunks[1].empty());
+		REQUIRE(output.lasts == std::vector<bool>({ false, true }));
+		REQUIRE(parse(output.GetData(), true) == response(9, data));
+	}
+
+	SECTION("the number of entries is checked")
+	{
+		// Fewer entries than announced.
+		REQUIRE(aborts([]()
+		{
+			Output output;
+			ResponseWriter writer(&output, 1, false);
+
+			writer.StartObject(2);
+			writer.Key("a");
+			writer.Value(1);
+			writer.End();
+		}));
+
+		// More entries than announced.
+		REQUIRE(aborts([]()
+		{
+			Output output;
+			ResponseWriter writer(&output, 1, true);
+
+			writer.StartArray(1);
+			writer.Value(1);
+			writer.Value(2);
+			writer.End();
+		}));
+
+		// Not ended.
+		REQUIRE(aborts([]()
+		{
+			Output output;
+			ResponseWriter writer(&output, 1, false);
+
+			writer.StartArray(0);
+			writer.Finish();
+		}));
+
+		// Key out of an object.
+		REQUIRE(aborts([]()
+		{
+			Output output;
+			ResponseWriter writer(&output, 1, false);
+
+			writer.StartArray(1);
+			writer.Key("a");
+		}));
+
+		REQUIRE(!aborts([]()
+		{
+			Output output;
+			ResponseWriter writer(&output, 1, false);
+
+			writer.StartArray(0);
+			writer.End();
+			writer.Finish();
+		}));
+	}
+}
@@ -10,6 +10,7 @@
 #include "RTC/RTCP/FeedbackRtpTmmb.hpp"
 #include "RTC/RTCP/FeedbackRtpTllei.hpp"
 #include "RTC/RTCP/FeedbackRtpEcn.hpp"
+#include "RTC/RTCP/FeedbackRtpTransport.hpp"
 #include "RTC/RTCP/FeedbackPsSli.hpp"
 #include "RTC/RTCP/FeedbackPsRpsi.hpp"
 #include "RTC/RTCP/FeedbackPsFir.hpp"
@@ -19,6 +20,7 @@
 #include "RTC/RTCP/FeedbackPsAfb.hpp"
 #include "RTC/RTCP/FeedbackPsRemb.hpp"
 #include <string>
+#include <vector>
 
 using namespace RTC::RTCP;
 
@@ -519,6 +521,110 @@ SCENARIO("parse RTCP packets", "[parser][rtcp]")
 		delete item;
 	}
 
+	SECTION("parse FeedbackRtpTransportPacket")
+	{
+		uint8_t buffer[] =
+		{
+			0x8F, 0xcd, 0x00, 0x06, // RTCP common header
+			0x00, 0x00, 0x00, 0x01, // Sender SSRC
+			0x00, 0x00, 0x00, 0x00, // Media SSRC
+			0x00, 0x64, 0x00, 0x05, // Base sequence number, packet status count
+			0x00, 0x00, 0x10, 0x03, // Reference time, fb pkt count
+			0xd2, 0x50,             // Status vector chunk (two bits symbols)
+			0x04,                   // Small delta (1ms)
+			0xff, 0xf8,             // Large delta (-2ms)
+			0x08,                   // Small delta (2ms)
+			0x00,                   // Small delta (0ms)
+			0x00                    // Padding
+		};
+
+		FeedbackRtpTransportPacket* packet = FeedbackRtpTransportPacket::Parse(buffer, sizeof(buffer));
+
+		REQUIRE(packet);
+		REQUIRE(packet->GetMessageType() == FeedbackRtp::MessageType::TCC);
+		REQUIRE(packet->GetBaseSequenceNumber() == 100);
+		REQUIRE(packet->GetPacketStatusCount() == 5);
+		REQUIRE(packet->GetReferenceTime() == 16);
+		REQUIRE(packet->GetFeedbackPacketCount() == 3);
+
+		auto& results = packet->GetPacketResults();
+
+		REQUIRE(results.size() == 5);
+		REQUIRE(results[0].sequenceNumber == 100);
+		REQUIRE(results[0].received);
+		REQUIRE(results[0].receivedAtMs == 1025);
+		REQUIRE(results[1].sequenceNumber == 101);
+		REQUIRE(!results[1].received);
+		REQUIRE(results[2].received);
+		REQUIRE(results[2].receivedAtMs == 1023);
+		REQUIRE(results[3].receivedAtMs == 1025);
+		REQUIRE(results[4].sequenceNumber == 104);
+		REQUIRE(results[4].receivedAtMs == 1025);
+
+		delete packet;
+
+		// More statuses than receive deltas.
+		buffer[15] = 0x07;
+		buffer[20] = 0xd5;
+		buffer[21] = 0x55;
+
+		packet = FeedbackRtpTransportPacket::Parse(buffer, sizeof(buffer));
+
+		REQUIRE(!packet);
+	}
+
+	SECTION("create FeedbackRtpTransportPacket")
+	{
+		std::vector<FeedbackRtpTransportPacket::PacketResult> results;
+		// Received at (ms), -1 means not received.
+		int64_t arrivals[] = { 1025, -1, 1023, 1030, 1200, -1, -1, -1, -1, -1, -1, -1, -1, 1210 };
+		uint16_t seq = 65530;
+
+		for (auto arrival : arrivals)
+		{
+			FeedbackRtpTransportPacket::PacketResult result;
+
+			result.sequenceNumber = seq++;
+
+			if (arrival >= 0)
+			{
+				result.received = true;
+				result.receivedAtMs = arrival;
+			}
+
+			results.push_back(result);
+		}
+
+		FeedbackRtpTransportPacket packet(1, 2, 7, results);
+		uint8_t buffer[256];
+
+		packet.Serialize(buffer);
+
+		REQUIRE(packet.GetSize() % 4 == 0);
+
+		FeedbackRtpTransportPacket* parsed = FeedbackRtpTransportPacket::Parse(buffer, packet.GetSize());
+
+		REQUIRE(parsed);
+		REQUIRE(parsed->GetMediaSsrc() == 2);
+		REQUIRE(parsed->GetBaseSequenceNumber() == 65530);
+		REQUIRE(parsed->GetPacketStatusCount() == 14);
+		REQUIRE(parsed->GetReferenceTime() == 16);
+		REQUIRE(parsed->GetFeedbackPacketCount() == 7);
+
+		auto& parsedResults = parsed->GetPacketResults();
+
+		REQUIRE(parsedResults.size() == results.size());
+
+		for (size_t i = 0; i < results.size(); ++i)
+		{
+			REQUIRE(parsedResults[i].sequenceNumber == results[i].sequenceNumber);
+			REQUIRE(parsedResults[i].received == results[i].received);
+			REQUIRE(parsedResults[i].receivedAtMs == results[i].receivedAtMs);
+		}
+
+		delete parsed;
+	}
+
 	SECTION("parse FeedbackPsSliItem")
 	{
 		uint8_t buffer[] =
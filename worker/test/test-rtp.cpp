@@ -3,6 +3,7 @@
 #include "common.hpp"
 #include "RTC/RtpPacket.hpp"
 #include "RTC/RtpDictionaries.hpp"
+#include <string>
 
 using namespace RTC;
 
@@ -285,4 +286,140 @@ SCENARIO("parse RTP packets", "[parser][rtp]")
 
 		delete packet;
 	}
+
+	SECTION("read RID and MID extensions")
+	{
+		uint8_t buffer[] =
+		{
+			0b10010000, 0b00000001, 0, 8,
+			0, 0, 0, 4,
+			0, 0, 0, 5,
+			0xBE, 0xDE, 0, 2, // Extension header
+			0x51, 'l', 'o', 0x70,
+			'1', 0, 0, 0,
+			0xFF, 0xFF, 0xFF, 0xFF
+		};
+
+		RtpPacket* packet = RtpPacket::Parse(buffer, sizeof(buffer));
+		std::string rid;
+		std::string mid;
+
+		if (!packet)
+			FAIL("not a RTP packet");
+
+		REQUIRE(!packet->ReadRid(rid));
+
+		packet->AddExtensionMapping(RtpHeaderExtensionUri::Type::RTP_STREAM_ID, 5);
+		packet->AddExtensionMapping(RtpHeaderExtensionUri::Type::MID, 7);
+
+		REQUIRE(packet->ReadRid(rid));
+		REQUIRE(rid == "lo");
+		REQUIRE(packet->ReadMid(mid));
+		REQUIRE(mid == "1");
+
+		delete packet;
+	}
+
+	SECTION("encode and decode RTX packets")
+	{
+		uint8_t buffer[64] =
+		{
+			0b10110000, 0b01100100, 0, 8, // Padding bit, PT:100, seq:8
+			0, 0, 0, 4,
+			0, 0, 0, 5,
+			0xBE, 0xDE, 0, 1, // Extension header
+			0x10, 0xFF, 0, 0,
+			1, 2, 3, 4, // Payload
+			0, 2 // Padding
+		};
+
+		RtpPacket* packet = RtpPacket::Parse(buffer, 26);
+
+		if (!packet)
+			FAIL("not a RTP packet");
+
+		REQUIRE(packet->GetPayloadLength() == 4);
+
+		packet->RtxEncode(101, 6, 1000);
+
+		REQUIRE(packet->GetPayloadType() == 101);
+		REQUIRE(packet->GetSsrc() == 6);
+		REQUIRE(packet->GetSequenceNumber() == 1000);
+		REQUIRE(packet->GetPayloadLength() == 6);
+		REQUIRE(packet->GetSize() == 26);
+		REQUIRE(Utils::Byte::Get2Bytes(packet->GetPayload(), 0) == 8);
+		REQUIRE(packet->GetPayload()[2] == 1);
+		REQUIRE(packet->GetPayload()[5] == 4);
+
+		delete packet;
+
+		// Parse it again as if received.
+		packet = RtpPacket::Parse(buffer, 26);
+
+		if (!packet)
+			FAIL("not a RTP packet");
+
+		REQUIRE(packet->RtxDecode(100, 5) == true);
+		REQUIRE(packet->GetPayloadType() == 100);
+		REQUIRE(packet->GetSsrc() == 5);
+		REQUIRE(packet->GetSequenceNumber() == 8);
+		REQUIRE(packet->GetPayloadLength() == 4);
+		REQUIRE(packet->GetSize() == 24);
+		REQUIRE(packet->GetPayload()[0] == 1);
+		REQUIRE(packet->GetPayload()[3] == 4);
+		REQUIRE(packet->GetExtensionHeaderLength() == 4);
+
+		delete packet;
+	}
+	SECTION("decode RED packets")
+	{
+		uint8_t buffer[] =
+		{
+			0b10010000, 0b01100101, 0, 8, // PT:101, seq:8
+			0, 0, 0, 4,
+			0, 0, 0, 5,
+			0xBE, 0xDE, 0, 1, // Extension header
+			0x10, 0xFF, 0, 0,
+			0xE4, 0x03, 0xC0, 0x02, // Redundant block (PT:100, offset:240, length:2)
+			0x64, // Primary block (PT:100)
+			9, 9, // Redundant payload
+			1, 2, 3 // Primary payload
+		};
+
+		RtpPacket* packet = RtpPacket::Parse(buffer, sizeof(buffer));
+
+		if (!packet)
+			FAIL("not a RTP packet");
+
+		REQUIRE(packet->RedDecode() == true);
+		REQUIRE(packet->GetPayloadType() == 100);
+		REQUIRE(packet->GetSequenceNumber() == 8);
+		REQUIRE(packet->GetPayloadLength() == 3);
+		REQUIRE(packet->GetSize() == 23);
+		REQUIRE(packet->GetPayload()[0] == 1);
+		REQUIRE(packet->GetPayload()[2] == 3);
+
+		delete packet;
+
+		// Block length beyond the payload.
+		uint8_t buffer2[] =
+		{
+			0b10000000, 0b01100101, 0, 8,
+			0, 0, 0, 4,
+			0, 0, 0, 5,
+			0xE4, 0x03, 0xC0, 0x10, // Redundant block (PT:100, offset:240, length:16)
+			0x64,
+			9, 9,
+			1, 2, 3
+		};
+
+		packet = RtpPacket::Parse(buffer2, sizeof(buffer2));
+
+		if (!packet)
+			FAIL("not a RTP packet");
+
+		REQUIRE(packet->RedDecode() == false);
+
+		delete packet;
+	}
 }
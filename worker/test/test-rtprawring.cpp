@@ -0,0 +1,91 @@
+#include "include/catch.hpp"
+#include "include/helpers.hpp"
+#include "common.hpp"
+#include "RTC/RtpRawRing.hpp"
+#include "RTC/RtpPacket.hpp"
+#include <cstring>
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+using namespace RTC;
+
+static uint8_t buffer[65536];
+
+SCENARIO("RTP raw shared memory ring", "[rtp][ring]")
+{
+	size_t len;
+
+	if (!Helpers::ReadBinaryFile("data/packet1.raw", buffer, &len))
+		FAIL("cannot open file");
+
+	RtpPacket* packet = RtpPacket::Parse(buffer, len);
+
+	if (!packet)
+		FAIL("not a RTP packet");
+
+	std::string name = "/mediasoup-test-rtpraw-" + std::to_string(getpid());
+	RtpRawRing* ring = new RtpRawRing(name, RtpRawRing::MinSize);
+
+	// Map it as the consumer would do.
+	int fd = shm_open(name.c_str(), O_RDWR, 0);
+
+	REQUIRE(fd != -1);
+
+	size_t memSize = RtpRawRing::HeaderSize + RtpRawRing::MinSize;
+	uint8_t* mem = (uint8_t*)mmap(nullptr, memSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+
+	REQUIRE(mem != MAP_FAILED);
+
+	RtpRawRing::Header* header = (RtpRawRing::Header*)mem;
+	uint8_t* data = mem + RtpRawRing::HeaderSize;
+	size_t recordSize = (sizeof(RtpRawRing::RecordHeader) + packet->GetSize() + 7) & ~((size_t)7);
+
+	REQUIRE(header->magic == RtpRawRing::Magic);
+	REQUIRE(header->version == RtpRawRing::Version);
+	REQUIRE(header->dataSize == RtpRawRing::MinSize);
+
+	SECTION("written packets can be read back")
+	{
+		REQUIRE(ring->Write(packet, 1234) == true);
+		REQUIRE(header->writePos == recordSize);
+
+		RtpRawRing::RecordHeader* record = (RtpRawRing::RecordHeader*)data;
+
+		REQUIRE(record->size == packet->GetSize());
+		REQUIRE(record->ssrc == packet->GetSsrc());
+		REQUIRE(record->time == 1234);
+		REQUIRE(std::memcmp(data + sizeof(RtpRawRing::RecordHeader), packet->GetData(), packet->GetSize()) == 0);
+	}
+
+	SECTION("packets are dropped when the consumer does not read")
+	{
+		size_t fits = RtpRawRing::MinSize / recordSize;
+
+		for (size_t i = 0; i < fits; ++i)
+		{
+			REQUIRE(ring->Write(packet, 0) == true);
+		}
+
+		REQUIRE(ring->Write(packet, 0) == false);
+		REQUIRE(header->dropped == 1);
+
+		// Consume everything and write again, which wraps.
+		header->readPos = header->writePos;
+
+		REQUIRE(ring->Write(packet, 0) == true);
+
+		size_t tail = RtpRawRing::MinSize - (fits * recordSize);
+
+		REQUIRE(header->writePos == (fits * recordSize) + tail + recordSize);
+		REQUIRE(((RtpRawRing::RecordHeader*)data)->size == packet->GetSize());
+	}
+
+	munmap(mem, memSize);
+	close(fd);
+	delete ring;
+	delete packet;
+
+	// The object name must be gone.
+	REQUIRE(shm_open(name.c_str(), O_RDWR, 0) == -1);
+}
@@ -5,7 +5,7 @@
 #include "RTC/RtpStream.hpp"
 #include "RTC/RtpStreamRecv.hpp"
 #include "Logger.hpp"
-#include <bitset> // std::bitset()
+#include <vector>
 
 using namespace RTC;
 
@@ -15,15 +15,12 @@ SCENARIO("receive RTP packets and trigger NACK", "[rtp][rtpstream]")
 		public RtpStreamRecv::Listener
 	{
 	public:
-		virtual void onNackRequired(RtpStreamRecv* rtpStream, uint16_t seq, uint16_t bitmask) override
+		virtual void onNackRequired(RtpStreamRecv* rtpStream, const std::vector<uint16_t>& seqNumbers) override
 		{
-			std::bitset<16> nack_bitset(bitmask);
-
-			INFO("NACK required [seq:" << seq << ", bitmask:" << nack_bitset << "]");
+			INFO("NACK required [first seq:" << seqNumbers.front() << ", num packets:" << seqNumbers.size() << "]");
 
 			REQUIRE(this->should_trigger == true);
-			REQUIRE(seq == this->expected_nack_seq);
-			REQUIRE(bitmask == this->expected_nack_bitmask);
+			REQUIRE(seqNumbers == this->expected_nack_seq_numbers);
 
 			this->should_trigger = false;
 		}
@@ -34,9 +31,8 @@ SCENARIO("receive RTP packets and trigger NACK", "[rtp][rtpstream]")
 		}
 
 	public:
-		bool     should_trigger = false;
-		uint16_t expected_nack_seq = 0;
-		uint16_t expected_nack_bitmask = 0;
+		bool should_trigger = false;
+		std::vector<uint16_t> expected_nack_seq_numbers;
 	};
 
 	SECTION("loose packets newer than 16 seq units")
@@ -74,8 +70,7 @@ SCENARIO("receive RTP packets and trigger NACK", "[rtp][rtpstream]")
 
 		packet->SetSequenceNumber(104);
 		listener.should_trigger = true;
-		listener.expected_nack_seq = 102;
-		listener.expected_nack_bitmask = 0b0000000000000001;
+		listener.expected_nack_seq_numbers = { 102, 103 };
 		rtpStream.ReceivePacket(packet);
 		REQUIRE(listener.should_trigger == false);
 
@@ -90,8 +85,7 @@ SCENARIO("receive RTP packets and trigger NACK", "[rtp][rtpstream]")
 
 		packet->SetSequenceNumber(108);
 		listener.should_trigger = true;
-		listener.expected_nack_seq = 105;
-		listener.expected_nack_bitmask = 0b0000000000000011;
+		listener.expected_nack_seq_numbers = { 105, 106, 107 };
 		rtpStream.ReceivePacket(packet);
 		REQUIRE(listener.should_trigger == false);
 
@@ -127,8 +121,13 @@ SCENARIO("receive RTP packets and trigger NACK", "[rtp][rtpstream]")
 
 		packet->SetSequenceNumber(120);
 		listener.should_trigger = true;
-		listener.expected_nack_seq = 103;
-		listener.expected_nack_bitmask = 0b1111111111111111;
+		listener.expected_nack_seq_numbers.clear();
+
+		for (uint16_t seq = 101; seq < 120; ++seq)
+		{
+			listener.expected_nack_seq_numbers.push_back(seq);
+		}
+
 		rtpStream.ReceivePacket(packet);
 		REQUIRE(listener.should_trigger == false);
 
@@ -164,8 +163,13 @@ SCENARIO("receive RTP packets and trigger NACK", "[rtp][rtpstream]")
 
 		packet->SetSequenceNumber(20);
 		listener.should_trigger = true;
-		listener.expected_nack_seq = 3;
-		listener.expected_nack_bitmask = 0b1111111111111111;
+		listener.expected_nack_seq_numbers.clear();
+
+		for (uint16_t seq = 0; seq < 20; ++seq)
+		{
+			listener.expected_nack_seq_numbers.push_back(seq);
+		}
+
 		rtpStream.ReceivePacket(packet);
 		REQUIRE(listener.should_trigger == false);
 
@@ -0,0 +1,145 @@
+#include "include/catch.hpp"
+#include "common.hpp"
+#include "RTC/SeqTracker.hpp"
+#include <set>
+#include <vector>
+
+using namespace RTC;
+
+SCENARIO("RtpSender source sequence numbers tracking", "[seqtracker]")
+{
+	SeqTracker tracker;
+	bool isNewest;
+
+	SECTION("packets before the switching point are ignored")
+	{
+		tracker.Sync(1000);
+
+		REQUIRE(tracker.Receive(1000, &isNewest));
+		REQUIRE(isNewest);
+		REQUIRE(tracker.Receive(1002, &isNewest));
+		REQUIRE(isNewest);
+		// Reordered, but after the switching point.
+		REQUIRE(tracker.Receive(1001, &isNewest));
+		REQUIRE(!isNewest);
+		// Before the switching point.
+		REQUIRE(!tracker.Receive(999, &isNewest));
+		REQUIRE(!tracker.Receive(500, &isNewest));
+		REQUIRE(tracker.GetMaxSeq() == 1002);
+	}
+
+	SECTION("packets keep being accepted after many wraps")
+	{
+		uint16_t seq = 65000;
+		size_t accepted = 0;
+
+		tracker.Sync(seq);
+
+		// About an hour of audio at 50 packets per second.
+		for (uint32_t i = 0; i < 3 * 65536; ++i, ++seq)
+		{
+			if (tracker.Receive(seq, &isNewest) && isNewest)
+				accepted++;
+		}
+
+		REQUIRE(accepted == 3 * 65536);
+
+		// Reordered packets are still accepted.
+		REQUIRE(tracker.Receive(seq - 10, &isNewest));
+		REQUIRE(!isNewest);
+		REQUIRE(tracker.Receive(seq - SeqTracker::MaxReorder, &isNewest));
+		// But too old ones are not.
+		REQUIRE(!tracker.Receive(seq - SeqTracker::MaxReorder - 2, &isNewest));
+	}
+
+	SECTION("a jump forward is accepted")
+	{
+		tracker.Sync(0);
+
+		REQUIRE(tracker.Receive(0, &isNewest));
+		REQUIRE(tracker.Receive(0x7000, &isNewest));
+		REQUIRE(isNewest);
+		REQUIRE(tracker.Receive(0x7001, &isNewest));
+		REQUIRE(isNewest);
+		REQUIRE(tracker.Receive(0x6FF0, &isNewest));
+		REQUIRE(!isNewest);
+	}
+
+	SECTION("late packets keep the offset of their position after a drop")
+	{
+		uint16_t seqOffset = 100;
+		std::vector<uint16_t> sent;
+
+		// Same as RtpSender::SendRtpPacket().
+		auto send = [&](uint16_t seq, bool drop)
+		{
+			uint16_t droppedAfter;
+
+			if (!tracker.Receive(seq, &isNewest))
+				return;
+
+			if (drop)
+			{
+				if (isNewest)
+				{
+					tracker.Drop(seq);
+					seqOffset--;
+				}
+
+				return;
+			}
+
+			if (!tracker.GetDroppedAfter(seq, &droppedAfter))
+				return;
+
+			sent.push_back(seq + seqOffset + droppedAfter);
+		};
+
+		tracker.Sync(10);
+
+		send(10, false);
+		send(11, false);
+		// 12 (base layer) is delayed and 13 (upper layer) is dropped.
+		send(13, true);
+		send(14, false);
+		send(16, true);
+		send(15, false);
+		// The late base layer packet.
+		send(12, false);
+		send(17, false);
+		// A retransmission of a dropped packet is not sent.
+		send(13, false);
+
+		REQUIRE(sent == std::vector<uint16_t>({ 110, 111, 113, 114, 112, 115 }));
+		REQUIRE(std::set<uint16_t>(sent.begin(), sent.end()).size() == sent.size());
+	}
+
+	SECTION("packets older than a forgotten drop are ignored")
+	{
+		uint16_t seq = 0;
+		uint16_t droppedAfter;
+
+		tracker.Sync(seq);
+
+		for (size_t i = 0; i <= SeqTracker::MaxDropped; ++i, seq += 2)
+		{
+			REQUIRE(tracker.Receive(seq, &isNewest));
+			REQUIRE(tracker.Receive(seq + 1, &isNewest));
+			tracker.Drop(seq + 1);
+		}
+
+		// The first drop (1) was forgotten.
+		REQUIRE(!tracker.Receive(0, &isNewest));
+		REQUIRE(tracker.Receive(2, &isNewest));
+		REQUIRE(tracker.GetDroppedAfter(2, &droppedAfter));
+		REQUIRE(droppedAfter == SeqTracker::MaxDropped);
+		REQUIRE(!tracker.GetDroppedAfter(3, &droppedAfter));
+
+		// A switching point forgets them all.
+		tracker.Sync(seq);
+
+		REQUIRE(tracker.Receive(seq, &isNewest));
+		REQUIRE(tracker.GetDroppedAfter(seq, &droppedAfter));
+		REQUIRE(droppedAfter == 0);
+	}
+}
@@ -0,0 +1,120 @@
+#include "include/catch.hpp"
+#include "common.hpp"
+#include "RTC/VideoLastN.hpp"
+#include <vector>
+
+using namespace RTC;
+
+// Ids of the Peers whose video is forwarded to the given one.
+static std::vector<uint32_t> forwardedTo(const VideoLastN& videoLastN, uint32_t senderPeerId)
+{
+	std::vector<uint32_t> peerIds;
+
+	for (auto peerId : videoLastN.GetSpeakers())
+	{
+		if (peerId != senderPeerId && videoLastN.IsForwarded(peerId, senderPeerId))
+			peerIds.push_back(peerId);
+	}
+
+	return peerIds;
+}
+
+SCENARIO("video last-N selection", "[lastn]")
+{
+	SECTION("videoLastN 0 forwards the video of all the Peers")
+	{
+		VideoLastN videoLastN;
+
+		videoLastN.AddPeer(1);
+		videoLastN.AddPeer(2);
+		videoLastN.AddPeer(3);
+
+		REQUIRE(videoLastN.IsForwarded(1, 2));
+		REQUIRE(videoLastN.IsForwarded(3, 1));
+		REQUIRE(forwardedTo(videoLastN, 4) == std::vector<uint32_t>({ 1, 2, 3 }));
+	}
+
+	SECTION("the most recent dominant speakers come first and then the Peers by arrival")
+	{
+		VideoLastN videoLastN(2);
+
+		videoLastN.AddPeer(1);
+		videoLastN.AddPeer(2);
+		videoLastN.AddPeer(3);
+		videoLastN.AddPeer(4);
+
+		REQUIRE(forwardedTo(videoLastN, 4) == std::vector<uint32_t>({ 1, 2 }));
+		// A Peer does not take a place in its own last-N.
+		REQUIRE(forwardedTo(videoLastN, 1) == std::vector<uint32_t>({ 2, 3 }));
+
+		REQUIRE(videoLastN.SetDominantSpeaker(3));
+		REQUIRE(videoLastN.SetDominantSpeaker(4));
+		REQUIRE(videoLastN.GetSpeakers() == std::vector<uint32_t>({ 4, 3, 1, 2 }));
+		REQUIRE(forwardedTo(videoLastN, 1) == std::vector<uint32_t>({ 4, 3 }));
+		REQUIRE(forwardedTo(videoLastN, 4) == std::vector<uint32_t>({ 3, 1 }));
+	}
+
+	SECTION("a new dominant speaker pauses and resumes the right streams")
+	{
+		VideoLastN videoLastN(1);
+
+		videoLastN.AddPeer(1);
+		videoLastN.AddPeer(2);
+		videoLastN.AddPeer(3);
+
+		REQUIRE(videoLastN.IsForwarded(1, 3));
+		REQUIRE(!videoLastN.IsForwarded(2, 3));
+
+		REQUIRE(videoLastN.SetDominantSpeaker(2));
+
+		// Paused.
+		REQUIRE(!videoLastN.IsForwarded(1, 3));
+		// Resumed.
+		REQUIRE(videoLastN.IsForwarded(2, 3));
+		// The dominant speaker keeps seeing the previous one.
+		REQUIRE(videoLastN.IsForwarded(1, 2));
+
+		// Already the dominant speaker or unknown, nothing changes.
+		REQUIRE(!videoLastN.SetDominantSpeaker(2));
+		REQUIRE(!videoLastN.SetDominantSpeaker(5));
+		REQUIRE(videoLastN.GetSpeakers() == std::vector<uint32_t>({ 2, 1, 3 }));
+	}
+
+	SECTION("fewer speakers than N")
+	{
+		VideoLastN videoLastN(5);
+
+		videoLastN.AddPeer(1);
+		videoLastN.AddPeer(2);
+		videoLastN.AddPeer(3);
+
+		REQUIRE(forwardedTo(videoLastN, 1) == std::vector<uint32_t>({ 2, 3 }));
+		REQUIRE(forwardedTo(videoLastN, 3) == std::vector<uint32_t>({ 1, 2 }));
+		// Unknown Peers are not forwarded.
+		REQUIRE(!videoLastN.IsForwarded(6, 1));
+	}
+
+	SECTION("a speaker leaving gives its place to the next Peer")
+	{
+		VideoLastN videoLastN(2);
+
+		videoLastN.AddPeer(1);
+		videoLastN.AddPeer(2);
+		videoLastN.AddPeer(3);
+		videoLastN.AddPeer(4);
+		videoLastN.SetDominantSpeaker(3);
+
+		REQUIRE(forwardedTo(videoLastN, 4) == std::vector<uint32_t>({ 3, 1 }));
+
+		videoLastN.RemovePeer(3);
+
+		REQUIRE(videoLastN.GetSpeakers() == std::vector<uint32_t>({ 1, 2, 4 }));
+		REQUIRE(forwardedTo(videoLastN, 4) == std::vector<uint32_t>({ 1, 2 }));
+		REQUIRE(!videoLastN.IsForwarded(3, 4));
+
+		// Removing an unknown Peer does nothing.
+		videoLastN.RemovePeer(3);
+
+		REQUIRE(videoLastN.GetSpeakers().size() == 3);
+	}
+}